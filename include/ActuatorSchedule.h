@@ -0,0 +1,94 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "Actuators.h"
+#include "TimerWheel.h"
+
+// =====================================
+//  ACTUATOR SCHEDULES
+// =====================================
+// Daily windows, each optionally cycling on/off inside it. One entry type
+// covers the cases we run:
+//
+//   light photoperiod   { ACT_LIGHT, 06:00, 20:00, 0, 0 }        on all window
+//   daytime pump cycle  { ACT_MOTOR, 06:00, 20:00, 15 min, 45 min }
+//   fan duty cycle      { ACT_FAN,   10:00, 18:00, 10 min, 20 min }
+//
+// Every entry has at most one timer on the wheel: its next on/off edge.
+// When it fires, the entry's phase is recomputed from the time of day, and
+// the next edge is armed. Nothing is evaluated between edges. An actuator is
+// wanted on while any of its entries is in an on phase. The result goes to
+// the ActuatorController as SRC_AUTO commands, and only for actuators that
+// are in auto mode and have entries. An actuator whose last entry goes
+// while it is wanted on gets one final off, so removing a schedule never
+// leaves its relay latched.
+//
+// Ticks are whole seconds of monotonic uptime. start() ties them to the
+// local time of day, and can be called again whenever the clock is corrected.
+struct ScheduleEntry {
+    Actuator actuator;
+    uint32_t startSec;   // window, seconds after local midnight; end may wrap
+    uint32_t endSec;     // past midnight, and end == start means all day
+    uint32_t onSec;      // 0: on for the whole window
+    uint32_t offSec;
+};
+
+class ActuatorSchedule {
+public:
+    static const uint16_t MAX_ENTRIES = 256;
+    static const uint32_t DAY_SEC     = 86400;
+    static const uint32_t NEVER       = TimerWheel::NEVER;
+
+    explicit ActuatorSchedule(ActuatorController& actuators);
+
+    // Index of the new entry, or -1 when full or malformed. Entries added
+    // after start() are armed straight away.
+    int  add(const ScheduleEntry& e);
+    // Both submit the result, including the off for an actuator left with
+    // no entries while it was wanted on.
+    bool remove(uint16_t index);
+    void clear();
+    // clear() and add() without switching off in between what the new
+    // entries keep on. Malformed entries are skipped.
+    void replace(const ScheduleEntry* entries, uint16_t count);
+
+    // (Re)anchors every entry: nowSec is uptime, timeOfDaySec the local time.
+    void start(uint32_t nowSec, uint32_t timeOfDaySec);
+    // Fires due edges, then submits any changes. Returns the uptime second at
+    // which to call again (NEVER when nothing is scheduled).
+    uint32_t advance(uint32_t nowSec);
+    // Submits the wanted state of every scheduled actuator in auto mode whose
+    // relay disagrees. Call after relays change, e.g. when auto is switched on.
+    void     sync();
+
+    // Where the schedules are in their day at uptime nowSec.
+    uint32_t timeOfDay(uint32_t nowSec) const { return (nowSec + todOffset_) % DAY_SEC; }
+    bool     wanted(Actuator a) const   { return onCount_[a] > 0; }
+    bool     scheduled(Actuator a) const { return entryCount_[a] > 0; }
+    uint16_t entries() const            { return used_; }
+    const TimerWheel& wheel() const     { return wheel_; }
+
+private:
+    struct Slot {
+        ScheduleEntry entry;
+        uint16_t      timer;
+        bool          used;
+        bool          on;
+    };
+
+    static void onEdge(void* ctx, uint32_t index);
+    void        drop();
+    void        arm(uint16_t index);
+    void        setPhase(Slot& s, bool on);
+
+    ActuatorController& actuators_;
+    TimerWheel          wheel_;
+    Slot                slots_[MAX_ENTRIES];
+    uint16_t            used_;
+    uint16_t            onCount_[ACT_COUNT];
+    uint16_t            entryCount_[ACT_COUNT];
+    bool                released_[ACT_COUNT];   // lost its entries while on; sync() sends the off
+    uint32_t            todOffset_;   // time of day at uptime 0
+    bool                started_;
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+#include "MpscQueue.h"
+#include "Registry.h"
+
+// =====================================
+//  ACTUATOR OWNER
+// =====================================
+// The web handler, the encoder menu and the auto-cycle never touch a relay.
+// They submit() commands, and process() applies them from a single task.
+// That task is the one ordered audit point for every relay change.
+//
+// Each process() call drains the queue as one batch. Commands for the same
+// actuator are folded into the final desired state, so a burst of clicks
+// costs at most one relay transition. A relay that changed less than its
+// minimum dwell ago keeps its new target pending until the dwell expires.
+// ackedSeq() is the highest sequence number whose effect is fully applied.
+
+// One per HYDRO_ACTUATORS row, in its order.
+enum Actuator : uint8_t {
+#define HYDRO_ACT_ID(id, ...) ACT_##id,
+    HYDRO_ACTUATORS(HYDRO_ACT_ID)
+#undef HYDRO_ACT_ID
+    ACT_COUNT
+};
+
+enum CommandOp : uint8_t {
+    OP_SET,       // relay on/off; manual sources also leave auto mode
+    OP_TOGGLE,    // relay relative to its state once earlier commands apply
+    OP_AUTO       // enable/disable the actuator's auto mode
+};
+
+enum CommandSource : uint8_t { SRC_WEB, SRC_ENCODER, SRC_AUTO, SRC_BOOT };
+
+struct ActuatorCommand {
+    uint8_t actuator;
+    uint8_t op;
+    uint8_t value;
+    uint8_t source;
+};
+
+class ActuatorController {
+public:
+    typedef void     (*OutputFn)(Actuator a, bool on);
+    typedef uint32_t (*ClockFn)();   // milliseconds
+    typedef void     (*AuditFn)(Actuator a, bool on, CommandSource src, uint32_t seq);
+    // Sees every command submit() accepts, on the submitting task.
+    typedef void     (*TapFn)(const ActuatorCommand& c);
+
+    static const size_t QUEUE_DEPTH = 32;
+
+    ActuatorController(OutputFn output, ClockFn clock);
+
+    // Owner task only, before the first process().
+    void restore(Actuator a, bool on, bool autoMode);
+    void setMinDwell(Actuator a, uint32_t ms) { minDwellMs_[a] = ms; }
+    void setAudit(AuditFn fn) { audit_ = fn; }
+    void setTap(TapFn fn)     { tap_ = fn; }
+
+    // Any task, never blocks. Returns the sequence number to wait on, or 0
+    // when the queue is full.
+    uint32_t submit(Actuator a, CommandOp op, bool value, CommandSource src);
+
+    // Owner task: drain, coalesce and drive the outputs.
+    void process();
+
+    // Safe from any task.
+    bool     state(Actuator a) const    { return stateBits_.load(std::memory_order_acquire) & (1u << a); }
+    bool     autoMode(Actuator a) const { return autoBits_.load(std::memory_order_acquire) & (1u << a); }
+    uint32_t ackedSeq() const           { return acked_.load(std::memory_order_acquire); }
+    uint32_t lastChangeMs(Actuator a) const { return lastChangeMs_[a]; }
+    // Owner task: a target is waiting out its dwell, so process() must run again.
+    bool     pending() const;
+    uint32_t droppedCommands() const    { return dropped_.load(std::memory_order_relaxed); }
+
+    static const char* name(Actuator a);
+    static bool        fromName(const char* name, Actuator& out);
+    // Web device names: a registry key ("motor") sets the relay, the key
+    // plus "Auto" ("motorAuto") switches its auto mode.
+    static bool        commandFromName(const char* name, Actuator& a, CommandOp& op);
+
+private:
+    struct Pending {
+        bool          active;
+        bool          target;
+        uint32_t      firstSeq;   // oldest command not yet reflected on the relay
+        uint32_t      lastSeq;
+        CommandSource source;
+    };
+
+    void apply(Actuator a, bool on, CommandSource src, uint32_t seq);
+    void setBit(std::atomic<uint8_t>& bits, Actuator a, bool on);
+
+    MpscQueue<ActuatorCommand, QUEUE_DEPTH> queue_;
+    OutputFn             output_;
+    ClockFn              clock_;
+    AuditFn              audit_;
+    TapFn                tap_;
+    Pending              pending_[ACT_COUNT];
+    uint32_t             minDwellMs_[ACT_COUNT];
+    uint32_t             lastChangeMs_[ACT_COUNT];
+    bool                 changed_[ACT_COUNT];
+    uint32_t             lastSeq_;
+    std::atomic<uint8_t> stateBits_;
+    std::atomic<uint8_t> autoBits_;
+    std::atomic<uint32_t> acked_;
+    std::atomic<uint32_t> dropped_;
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "Scheduler.h"
+#include "SensorHistory.h"
+#include "SensorAnalytics.h"
+#include "SensorLog.h"
+#include "Telemetry.h"
+#include "Seqlock.h"
+#include "SensorSnapshot.h"
+#include "Actuators.h"
+#include "ControlChannel.h"
+#include "SseBroadcast.h"
+#include "ConfigStore.h"
+#include "I2cEngine.h"
+#include "PhPipeline.h"
+#include "Metrics.h"
+#include "RotaryInput.h"
+#include "BootTimeline.h"
+#include "FlightRecorder.h"
+#include "InputTrace.h"
+#include "PowerManager.h"
+
+// =====================================
+//  APPLICATION CORE
+// =====================================
+// Menus, display, sensor acquisition, relays, the pump auto-cycle and
+// telemetry. Hardware is reached only through Hal.h, so the same code runs
+// on the ESP32 and in the native simulator.
+//
+// A platform brings up its HAL, calls appSetup() once, then keeps calling
+// appLoop() from its control context and sensorStep() from whichever context
+// owns the I2C bus (a core-0 task on the ESP32, the same loop in the
+// simulator).
+
+// ---------- SHARED STATE ----------
+// Read by the platform layer (web handlers, simulator reports).
+extern Scheduler               scheduler;
+extern ActuatorController      actuators;
+extern ControlChannel          control;         // fed by the platform's /ws handler
+extern SseBroadcaster          sse;             // fed by the platform's /events handler
+extern Seqlock<SensorSnapshot> sensorFeed;
+extern SensorHistory           history;
+extern SensorAnalytics         analytics;       // served at /alerts
+extern SensorLog               sensorLog;       // served at /export
+extern ConfigStore             configStore;     // served and edited at /config
+extern TelemetryEncoder        telemetry;
+extern I2cEngine               i2c;
+extern Seqlock<PhCalibration>  phCalibration;   // single writer: the platform's calibration store
+extern RotaryInput             encoderInput;    // fed by the platform's encoder interrupt
+extern BootTimeline            bootTimeline;
+extern FlightRecorder          flight;          // served at /debug/trace
+extern InputTrace              inputTrace;      // served at /trace
+extern PowerManager            power;           // woken by the platform's interrupts and sockets; served at /power
+#if HYDRO_METRICS
+extern MetricsRegistry         metrics;         // served at /metrics
+#endif
+
+// ---------- CONTROL TASKS ----------
+// The scheduler tasks appSetup() registers, in its order, so host checks can
+// run the same set. A task that parks polls at its period only while it has
+// work; otherwise it sleeps until appLoop() or another task triggers or
+// reschedules it. A period of 0 is a one-shot.
+struct AppTask {
+    const char*       name;
+    Scheduler::TaskFn fn;
+    uint8_t*          id;         // where the id is kept, for tasks others wake
+    uint32_t          periodMs;
+    uint32_t          firstMs;
+    bool              parks;
+    uint32_t          budgetUs;   // flight-recorder budget; 0 keeps the default
+    bool              quiet;      // record only its stalls
+};
+extern const AppTask APP_TASKS[];
+extern const uint8_t APP_TASK_COUNT;
+// nullptr for a name appSetup() does not register.
+const AppTask* appTask(const char* name);
+
+void     appSetup();
+// Runs every due control task and the ones woken through power; returns
+// microseconds until the next one, 0 if woken meanwhile.
+uint64_t appLoop();
+// One step of the I2C owner: runs queued transactions and advances the
+// sensor drivers. Returns the hal::micros() time at which it wants to run
+// again, or 0 if it should run again straight away. Also checks for a
+// control task running past its flight-recorder budget.
+uint32_t sensorStep();
+
+// Replaces the sensor drivers' readings in every acquisition cycle; the
+// simulator's trace replay. Set before appSetup().
+typedef void (*SampleSourceFn)(SensorSnapshot& s);
+void setSampleSource(SampleSourceFn fn);
+
+void requestDisplayUpdate();
+// Every LCD menu screen, for the simulator's LCD bench: screen i drawn from
+// readings s into fb's back buffer without flushing. Returns its name;
+// the positions of one menu share a name.
+class LcdFramebuffer;
+uint8_t     menuScreenCount();
+const char* drawMenuScreen(uint8_t screen, const SensorSnapshot& s, LcdFramebuffer& fb);
+// Names scheduler task ids in /debug/trace; nullptr for an unused slot.
+const char* traceTaskName(uint8_t id);
+// Records and logs the first time a start-up phase is reached; the
+// platform marks BOOT_NETWORK_UP.
+void markBoot(BootPhase p);
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+// =====================================
+//  BOOT TIMELINE
+// =====================================
+// When each stage of start-up was first reached, in microseconds since
+// power-up, so the time to first control and first telemetry can be
+// compared across firmware versions. Each phase is marked by the context
+// that reaches it and read from anywhere; a mark after the first is
+// ignored. Times saturate at UINT32_MAX - 1 (about 71 minutes), which only
+// the network phases can plausibly reach.
+
+enum BootPhase : uint8_t {
+    BOOT_APP_READY,       // appSetup() returned
+    BOOT_FIRST_CONTROL,   // the actuator task has run once
+    BOOT_FIRST_SENSORS,   // first complete sensor cycle published
+    BOOT_NETWORK_UP,      // station joined and has an address
+    BOOT_FIRST_SSE,       // first telemetry event sent to a dashboard
+    BOOT_PHASE_COUNT
+};
+
+class BootTimeline {
+public:
+    static const uint32_t NOT_YET = 0;
+
+    BootTimeline() {
+        for (uint8_t p = 0; p < BOOT_PHASE_COUNT; p++) at_[p].store(NOT_YET, std::memory_order_relaxed);
+    }
+
+    // True the first time the phase is marked.
+    bool mark(BootPhase p, uint64_t nowUs) {
+        if (at_[p].load(std::memory_order_relaxed) != NOT_YET) return false;
+        uint32_t us = nowUs >= UINT32_MAX - 1 ? UINT32_MAX - 1 : (uint32_t)nowUs;
+        uint32_t expected = NOT_YET;
+        return at_[p].compare_exchange_strong(expected, us + 1, std::memory_order_relaxed);
+    }
+
+    bool     reached(BootPhase p) const { return at_[p].load(std::memory_order_relaxed) != NOT_YET; }
+    // Microseconds since power-up, or 0 while not reached.
+    uint32_t atUs(BootPhase p) const {
+        uint32_t v = at_[p].load(std::memory_order_relaxed);
+        return v == NOT_YET ? 0 : v - 1;
+    }
+
+    static const char* name(BootPhase p) {
+        static const char* NAMES[BOOT_PHASE_COUNT] = {
+            "app ready", "first control", "first sensors", "network up", "first sse"
+        };
+        return p < BOOT_PHASE_COUNT ? NAMES[p] : "?";
+    }
+
+private:
+    std::atomic<uint32_t> at_[BOOT_PHASE_COUNT];   // time + 1, so 0 can mean "not yet"
+};
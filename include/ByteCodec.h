@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =====================================
+//  BYTE ENCODING
+// =====================================
+// The little-endian integers, varints and CRC shared by the formats that go
+// to flash or over the wire: the config blob, the sensor log and the input
+// trace. Varints are LEB128; signed values go through zigzag first, so small
+// deltas of either sign take one byte.
+
+inline void     put16(uint8_t* p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+inline void     put32(uint8_t* p, uint32_t v) { p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24; }
+inline uint16_t get16(const uint8_t* p)       { return p[0] | p[1] << 8; }
+inline uint32_t get32(const uint8_t* p)       { return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24; }
+
+inline uint32_t zigzag(int32_t v)    { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+inline int32_t  unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+// Writes at most 5 bytes; returns how many.
+inline uint8_t putVarint(uint8_t* p, uint32_t v) {
+    uint8_t n = 0;
+    while (v >= 0x80) { p[n++] = (uint8_t)v | 0x80; v >>= 7; }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+// Reads from buf[pos], not past end, and advances pos. False when the
+// varint is cut off or longer than 5 bytes.
+inline bool getVarint(const uint8_t* buf, uint16_t& pos, uint16_t end, uint32_t& v) {
+    v = 0;
+    for (uint8_t shift = 0; shift < 35 && pos < end; shift += 7) {
+        uint8_t b = buf[pos++];
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// CRC-32 (IEEE), bitwise: every user checks a block or blob once per write
+// or read, so a table would cost more flash than it saves time. Start from
+// 0xFFFFFFFF and invert the result, or use crc32() for one buffer.
+inline uint32_t crc32Update(uint32_t crc, const uint8_t* p, size_t len) {
+    while (len--) {
+        crc ^= *p++;
+        for (uint8_t k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+    }
+    return crc;
+}
+
+inline uint32_t crc32(const uint8_t* p, size_t len) { return ~crc32Update(0xFFFFFFFF, p, len); }
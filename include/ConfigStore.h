@@ -0,0 +1,134 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ActuatorSchedule.h"
+#include "MpscQueue.h"
+#include "Seqlock.h"
+#include "SensorAnalytics.h"
+
+// =====================================
+//  CONFIG STORAGE BACKEND
+// =====================================
+// One small blob: an NVS entry on the board, a file or RAM in the native
+// simulator. load() returns the stored length (0 if there is none) and
+// fills buf only when that fits in cap.
+class ConfigStorage {
+public:
+    virtual ~ConfigStorage() {}
+    virtual size_t load(uint8_t* buf, size_t cap) = 0;
+    virtual bool   save(const uint8_t* buf, size_t len) = 0;
+};
+
+// =====================================
+//  PERSISTENT CONFIGURATION
+// =====================================
+// Everything that has to survive a power cut: which actuators are in auto
+// mode, the relay state of the ones that are not, the schedule table, the
+// alert limits and where the schedules were in their day. Relays in auto
+// mode are not stored; the schedule decides them again.
+struct HydroConfig {
+    static const uint8_t  MAX_SCHEDULE = 16;
+    static const uint32_t TOD_UNKNOWN  = UINT32_MAX;
+
+    uint8_t       autoBits;    // bit n: actuator n in auto mode
+    uint8_t       relayBits;   // bit n: actuator n on, manual actuators only
+    uint8_t       scheduleCount;
+    ScheduleEntry schedule[MAX_SCHEDULE];
+    AlertLimits   limits;      // since v2
+    uint32_t      clockTod;    // since v3: schedule time of day at the last checkpoint, or TOD_UNKNOWN
+};
+
+// A schedule change from a web handler, applied by the config task.
+struct ConfigEdit {
+    enum Op : uint8_t { SET_ENTRY, REMOVE_ENTRY, RESET_SCHEDULE, SET_LIMITS };
+    uint8_t       op;
+    uint8_t       index;   // schedule entry (SET_ENTRY at scheduleCount appends) or channel
+    ScheduleEntry entry;
+    ChannelLimits limits;
+};
+
+// The stored blob is a 12-byte header and a little-endian payload:
+//
+//   0  magic 'HC', schema version (u16)
+//   4  payload length (u16), reserved
+//   8  CRC-32 of the payload
+//  12  v1: auto bits, relay bits, entry count, then per entry the
+//      actuator (u8) and start, end, on, off seconds (u32 each)
+//      v2: per sensor channel the alert limits: low, high, hysteresis,
+//      max rate (f32 each), stuck seconds (u16)
+//      v3: schedule time of day checkpoint (u32 seconds)
+//
+// The schema is append-only. A newer version adds fields after the old
+// ones, and decode() fills whatever an older blob lacks from the defaults,
+// so a firmware update migrates the stored config on its first save. A blob
+// from a newer firmware is read as far as this one understands it.
+//
+// begin() restores everything with one read. After that the control task
+// owns the working copy: update() hands it the current state, and commit()
+// writes it back once changes have been quiet for SAVE_QUIET_MS, or at the
+// latest SAVE_MAX_MS after the first unsaved one. A burst of edits costs one
+// flash write, and a steady trickle at most one a minute. Web handlers only
+// read the published copy and queue edits.
+class ConfigStore {
+public:
+    typedef uint32_t (*ClockFn)();   // milliseconds
+
+    static const uint16_t SCHEMA_VERSION = 3;
+    static const size_t   HEADER_SIZE    = 12;
+    static const size_t   ENTRY_SIZE     = 17;
+    static const size_t   LIMITS_SIZE    = 18;
+    static const size_t   MAX_BLOB       = 512;   // room for later schema versions
+    static const uint32_t SAVE_QUIET_MS  = 5000;
+    static const uint32_t SAVE_MAX_MS    = 60000;
+    static const size_t   EDIT_DEPTH     = 8;
+
+    static_assert(HEADER_SIZE + 3 + HydroConfig::MAX_SCHEDULE * ENTRY_SIZE +
+                  SensorAnalytics::CHANNELS * LIMITS_SIZE + 4 <= MAX_BLOB, "v3 blob must fit");
+
+    struct Stats {
+        uint16_t loadedVersion;   // 0: nothing stored, or it was invalid
+        uint32_t saves;
+        uint32_t saveErrors;
+        uint32_t updates;         // changes absorbed into those saves
+    };
+
+    ConfigStore(ConfigStorage& storage, ClockFn clock, const HydroConfig& defaults);
+
+    // One read of the backend. False when nothing valid was stored and the
+    // defaults are in use.
+    bool begin();
+
+    // ---------- control task ----------
+    const HydroConfig& current() const { return working_; }
+    void update(const HydroConfig& c);
+    // Saves if a change is due; force saves any pending change now.
+    bool commit(bool force = false);
+    bool nextEdit(ConfigEdit& e) { return edits_.pop(e); }
+    bool dirty() const { return dirty_; }
+
+    // ---------- any task ----------
+    HydroConfig        snapshot() const             { return published_.read(); }
+    bool               submit(const ConfigEdit& e)  { return edits_.push(e) != 0; }   // false when full
+    const HydroConfig& defaults() const             { return defaults_; }
+    const Stats&       stats() const                { return stats_; }
+
+    static size_t encode(const HydroConfig& c, uint8_t* blob);
+    static bool   decode(const uint8_t* blob, size_t len, const HydroConfig& defaults,
+                         HydroConfig& out, uint16_t& version);
+    // GET /config body.
+    static size_t toJson(const HydroConfig& c, char* buf, size_t cap);
+
+private:
+    ConfigStorage&                      storage_;
+    ClockFn                             clock_;
+    HydroConfig                         defaults_;
+    HydroConfig                         working_;
+    Seqlock<HydroConfig>                published_;
+    MpscQueue<ConfigEdit, EDIT_DEPTH>   edits_;
+    bool                                dirty_;
+    uint32_t                            firstDirtyMs_;
+    uint32_t                            lastDirtyMs_;
+    Stats                               stats_;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stdint.h>
+
+// =====================================
+//  WIFI CONNECTION MANAGER
+// =====================================
+// Keeps the station joined without ever waiting on the radio. poll() runs
+// from a scheduler task; each call looks at the link once and moves the
+// state machine along:
+//
+//   IDLE -> JOINING -> CONNECTED
+//             |  ^         |
+//             v  |         v  link lost: rejoin at once
+//           BACKOFF <------'  (via the cached access point)
+//
+// A join first goes straight to the BSSID and channel cached from the last
+// good connection, which skips the scan and takes a fraction of a second.
+// If that misses (the access point moved channel, or a different one is
+// nearer now) the next attempt scans. Failed scans back off exponentially
+// from BACKOFF_MIN_MS to BACKOFF_MAX_MS so a missing access point costs
+// nothing but an occasional attempt.
+//
+// With setApFallback(), the radio also opens its own access point once the
+// station has been down that long, so the dashboard stays reachable on
+// site. Station attempts continue; the AP closes when one succeeds.
+
+// The platform's radio. Every call returns straight away.
+class WifiRadio {
+public:
+    virtual ~WifiRadio() {}
+    // Start joining the configured network; with useHint, go straight to
+    // the cached access point instead of scanning.
+    virtual void begin(bool useHint) = 0;
+    virtual bool connected() = 0;
+    virtual void disconnect() = 0;
+    virtual bool hasHint() = 0;
+    // Called once per successful join, so the radio can cache where it joined.
+    virtual void joined() = 0;
+    virtual void startAp() = 0;
+    virtual void stopAp() = 0;
+};
+
+class ConnectionManager {
+public:
+    typedef uint32_t (*ClockFn)();        // milliseconds
+    typedef void     (*LinkFn)(bool up);  // called from poll()
+
+    enum State : uint8_t { CM_IDLE, CM_JOINING, CM_CONNECTED, CM_BACKOFF };
+
+    static const uint32_t HINT_TIMEOUT_MS = 3000;    // cached BSSID/channel join
+    static const uint32_t JOIN_TIMEOUT_MS = 15000;   // full scan and join
+    static const uint32_t BACKOFF_MIN_MS  = 1000;
+    static const uint32_t BACKOFF_MAX_MS  = 60000;
+
+    struct Stats {
+        uint32_t attempts;
+        uint32_t hintJoins;     // joined via the cached access point
+        uint32_t scanJoins;     // joined after a scan
+        uint32_t hintMisses;
+        uint32_t drops;         // link lost while connected
+        uint32_t lastJoinMs;    // how long the last successful attempt took
+    };
+
+    ConnectionManager(WifiRadio& radio, ClockFn clock, LinkFn onLink);
+
+    void setApFallback(uint32_t afterMs) { apAfterMs_ = afterMs; }   // 0 = never
+    void start();
+    void poll();
+
+    State        state() const    { return state_; }
+    bool         apActive() const { return apActive_; }
+    const Stats& stats() const    { return stats_; }
+
+    static const char* stateName(State s);
+
+private:
+    void join(uint32_t now);
+    void failed(uint32_t now);
+
+    WifiRadio& radio_;
+    ClockFn    clock_;
+    LinkFn     onLink_;
+
+    State    state_;
+    bool     usingHint_;
+    bool     hintStale_;    // the cached access point just missed; scan next
+    bool     apActive_;
+    uint32_t since_;        // start of the current attempt or wait
+    uint32_t downSince_;    // when the station was last connected, or start()
+    uint32_t backoffMs_;
+    uint32_t waitMs_;
+    uint32_t apAfterMs_;
+    Stats    stats_;
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Actuators.h"
+#include "MpscQueue.h"
+
+// =====================================
+//  WEBSOCKET CONTROL CHANNEL
+// =====================================
+// Relay commands and their acknowledgements over one WebSocket per
+// dashboard. Every frame is 6 bytes, little-endian:
+//
+//   0  type, with FROM_SERVER set on frames the board sends
+//   1  id (u16), chosen by whoever starts the exchange
+//   3  three argument bytes
+//
+//   CMD    client: device, op, value
+//   ACK    server: status, relay bits, auto bits (id of the CMD)
+//   PING   either side; answered with a PONG carrying the same id
+//   STATE  server: 0, relay bits, auto bits
+//
+// device and op are the Actuator and CommandOp values. Bit n of the relay
+// and auto bytes is actuator n. A CMD is acked once the controller has
+// applied it, so the ACK carries the resulting relays. Every relay change
+// is also sent as STATE to all clients, whoever caused it.
+//
+// Network callbacks only push into a lock-free inbox. The actuator task
+// drains it around ActuatorController::process(), so acks leave within one
+// poll of the command being applied and nothing here needs a lock.
+//
+// The server pings a client that has been quiet for PING_INTERVAL_MS and
+// drops one that stays silent for CLIENT_TIMEOUT_MS. Commands held past
+// ACK_TIMEOUT_MS (e.g. a relay dwell) are answered with ACK_TIMEOUT.
+class ControlChannel {
+public:
+    typedef void     (*SendFn)(uint32_t client, const uint8_t* frame, size_t len);
+    typedef void     (*CloseFn)(uint32_t client);
+    typedef uint32_t (*ClockFn)();   // milliseconds
+
+    enum FrameType : uint8_t { FRAME_CMD = 1, FRAME_PING, FRAME_PONG, FRAME_ACK, FRAME_STATE };
+    static const uint8_t FROM_SERVER = 0x80;
+
+    enum AckStatus : uint8_t { ACK_OK, ACK_BUSY, ACK_BAD_FRAME, ACK_TIMEOUT };
+
+    static const size_t   FRAME_SIZE        = 6;
+    static const uint8_t  MAX_CLIENTS       = 8;
+    static const uint8_t  MAX_PENDING       = 32;
+    static const size_t   INBOX_DEPTH       = 32;
+    static const uint32_t PING_INTERVAL_MS  = 10000;
+    static const uint32_t CLIENT_TIMEOUT_MS = 30000;
+    static const uint32_t ACK_TIMEOUT_MS    = 3000;
+
+    struct Stats {
+        uint32_t commands;
+        uint32_t acks;
+        uint32_t timeouts;        // acks sent as ACK_TIMEOUT
+        uint32_t rejected;        // bad frames, full command queue or pending table
+        uint32_t inboxDropped;
+        uint32_t clientsDropped;  // closed for silence or because the table was full
+    };
+
+    ControlChannel(ActuatorController& actuators, SendFn send, CloseFn close, ClockFn clock);
+
+    // ---------- network callbacks (any task, never block) ----------
+    void connected(uint32_t client);
+    void disconnected(uint32_t client);
+    // One binary message; false if it was malformed or the inbox was full.
+    bool received(uint32_t client, const uint8_t* data, size_t len);
+
+    // ---------- actuator task ----------
+    // Before ActuatorController::process(): takes in frames, submits commands.
+    void poll();
+    // After process(): acks what was applied, broadcasts relay changes.
+    void complete();
+    // About once a second: pings quiet clients, drops dead ones, expires acks.
+    void checkClients();
+
+    uint8_t      clients() const { return clientCount_; }
+    const Stats& stats() const   { return stats_; }
+
+    static void encode(uint8_t* out, uint8_t type, uint16_t id, uint8_t a0, uint8_t a1, uint8_t a2);
+
+private:
+    enum InboxKind : uint8_t { IN_CONNECT, IN_DISCONNECT, IN_FRAME };
+
+    struct Inbound {
+        uint32_t client;
+        uint8_t  kind;
+        uint8_t  frame[FRAME_SIZE];
+    };
+
+    struct Client {
+        uint32_t id;
+        uint32_t lastSeenMs;
+        uint32_t pingedMs;
+        bool     used;
+    };
+
+    struct Pending {
+        uint32_t client;
+        uint32_t seq;
+        uint32_t sentMs;
+        uint16_t id;
+        bool     used;
+    };
+
+    Client* findClient(uint32_t id);
+    void    dropClient(Client& c);
+    void    handleFrame(Client& c, const uint8_t* f);
+    void    reply(uint32_t client, uint8_t type, uint16_t id, uint8_t a0, uint8_t a1, uint8_t a2);
+    void    ack(Pending& p, AckStatus status);
+    uint8_t relayBits() const;
+    uint8_t autoBits() const;
+
+    ActuatorController& actuators_;
+    SendFn              send_;
+    CloseFn             close_;
+    ClockFn             clock_;
+
+    MpscQueue<Inbound, INBOX_DEPTH> inbox_;
+    Client   clients_[MAX_CLIENTS];
+    Pending  pending_[MAX_PENDING];
+    uint8_t  clientCount_;
+    uint8_t  pendingCount_;
+    uint8_t  lastRelays_, lastAuto_;
+    uint16_t nextPingId_;
+    Stats    stats_;
+};
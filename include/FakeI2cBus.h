@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include "I2cEngine.h"
+
+// =====================================
+//  FAKE I2C BUS (host builds)
+// =====================================
+// Register-file slaves for exercising the engine and the driver state
+// machines off-target. The first byte of a write selects the register, the
+// rest are stored from there, and a read returns bytes from the current
+// register. A write hook lets a device react to a command; a BMP180 fake,
+// for example, fills 0xF6.. when 0xF4 is written. Each transfer can advance
+// a fake clock by its wire time, so loop-latency figures come out realistic.
+class FakeI2cBus : public I2cBus {
+public:
+    static const uint8_t MAX_DEVICES = 4;
+
+    struct Device {
+        uint8_t addr;
+        uint8_t regs[256];
+        uint8_t ptr;
+        void  (*onWrite)(Device& dev, const uint8_t* tx, uint8_t len);
+    };
+
+    typedef void (*AdvanceFn)(uint32_t us);
+
+    uint32_t transfers  = 0;
+    uint32_t bytes      = 0;
+    uint32_t recoveries = 0;
+
+    Device* attach(uint8_t addr) {
+        if (count_ >= MAX_DEVICES) return nullptr;
+        Device& d = devices_[count_++];
+        memset(&d, 0, sizeof(d));
+        d.addr = addr;
+        return &d;
+    }
+
+    // The n transfers after the next `after` fail as a lost arbitration would.
+    void failNext(uint8_t n, uint8_t after = 0) { failNext_ = n; passFirst_ = after; }
+    // Simulated wire time: ~90 us per byte at 100 kHz, ~23 us at 400 kHz.
+    void setByteTime(uint32_t us, AdvanceFn advance) { byteUs_ = us; advance_ = advance; }
+
+    int transfer(uint8_t addr, const uint8_t* tx, uint8_t txLen, uint8_t* rx, uint8_t rxLen) override {
+        transfers++;
+        bytes += 1 + txLen + rxLen;
+        if (advance_) advance_((1 + txLen + rxLen) * byteUs_);
+        if (passFirst_)     passFirst_--;
+        else if (failNext_) { failNext_--; return 4; }
+
+        Device* d = find(addr);
+        if (!d) return 2;   // address NACK, as Wire reports it
+        if (txLen) {
+            d->ptr = tx[0];
+            for (uint8_t i = 1; i < txLen; i++) d->regs[(uint8_t)(tx[0] + i - 1)] = tx[i];
+            if (d->onWrite) d->onWrite(*d, tx, txLen);
+        }
+        for (uint8_t i = 0; i < rxLen; i++) rx[i] = d->regs[(uint8_t)(d->ptr + i)];
+        return 0;
+    }
+
+    void recover() override { recoveries++; }
+
+private:
+    Device* find(uint8_t addr) {
+        for (uint8_t i = 0; i < count_; i++)
+            if (devices_[i].addr == addr) return &devices_[i];
+        return nullptr;
+    }
+
+    Device    devices_[MAX_DEVICES];
+    uint8_t   count_    = 0;
+    uint8_t   failNext_ = 0;
+    uint8_t   passFirst_ = 0;
+    uint32_t  byteUs_   = 0;
+    AdvanceFn advance_  = nullptr;
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// =====================================
+//  FIXED-POINT QUANTITIES
+// =====================================
+// A reading is an int32 count of 1/Scale units, with the unit and scale part
+// of the type: DeciCelsius{215} is 21.5 C. Readings travel in this form from
+// the driver to the snapshot, the history and flash log, the alert stage and
+// the telemetry frame, so the hot path does integer arithmetic and compares
+// exactly. Mixing quantities or scales is a compile error; to<>() converts
+// the scale explicitly, with rounding.
+//
+// Floats appear only at the edges: fromFloat() for sources that deliver one
+// (the DHT library, the pH calibration), toFloat() for statistics. Both are
+// single precision, which the ESP32 FPU does in hardware.
+
+template <typename Unit, int32_t Scale>
+struct Fixed {
+    static_assert(Scale > 0, "scale must be positive");
+    static const int32_t SCALE    = Scale;
+    static const uint8_t DECIMALS = Scale >= 1000 ? 3 : Scale >= 100 ? 2 : Scale >= 10 ? 1 : 0;
+
+    int32_t raw;
+
+    static constexpr Fixed fromRaw(int32_t r) { return Fixed{ r }; }
+    // Rounds half away from zero. The caller screens out NAN.
+    static Fixed fromFloat(float v) {
+        float s = v * (float)Scale;
+        return Fixed{ (int32_t)(s < 0 ? s - 0.5f : s + 0.5f) };
+    }
+    float toFloat() const { return raw * (1.0f / Scale); }
+
+    template <int32_t To>
+    Fixed<Unit, To> to() const {
+        int64_t n = (int64_t)raw * To;
+        int64_t h = Scale / 2;
+        return Fixed<Unit, To>::fromRaw((int32_t)(n >= 0 ? (n + h) / Scale : (n - h) / Scale));
+    }
+
+    Fixed clamp(Fixed lo, Fixed hi) const { return raw < lo.raw ? lo : raw > hi.raw ? hi : *this; }
+
+    // "21.5", "-0.25", "1234": integer formatting, no float conversion.
+    size_t format(char* buf, size_t cap) const {
+        int n;
+        if (DECIMALS == 0) {
+            n = snprintf(buf, cap, "%ld", (long)raw);
+        } else {
+            uint32_t mag = raw < 0 ? -(uint32_t)raw : (uint32_t)raw;
+            n = snprintf(buf, cap, "%s%lu.%0*lu", raw < 0 ? "-" : "", (unsigned long)(mag / Scale),
+                         (int)DECIMALS, (unsigned long)(mag % Scale));
+        }
+        return n < 0 ? 0 : (size_t)n < cap ? (size_t)n : cap - 1;
+    }
+
+    friend bool  operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+    friend bool  operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+    friend bool  operator< (Fixed a, Fixed b) { return a.raw <  b.raw; }
+    friend bool  operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+    friend bool  operator> (Fixed a, Fixed b) { return a.raw >  b.raw; }
+    friend bool  operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+    friend Fixed operator+ (Fixed a, Fixed b) { return Fixed{ a.raw + b.raw }; }
+    friend Fixed operator- (Fixed a, Fixed b) { return Fixed{ a.raw - b.raw }; }
+};
+
+// ---------- QUANTITIES ----------
+struct Celsius {};
+struct RelHumidity {};
+struct Illuminance {};
+struct Acidity {};
+struct Pressure {};
+
+typedef Fixed<Celsius, 10>      DeciCelsius;    // air temperature, BMP180 resolution
+typedef Fixed<Celsius, 100>     CentiCelsius;   // water temperature
+typedef Fixed<RelHumidity, 10>  DeciPercent;
+typedef Fixed<Illuminance, 1>   Lux;
+typedef Fixed<Acidity, 100>     CentiPh;
+typedef Fixed<Pressure, 10>     DeciHpa;
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Seqlock.h"
+
+// =====================================
+//  FLIGHT RECORDER
+// =====================================
+// A ring of the last RING compact events (task runs, relay changes, I2C
+// errors, heap low-water marks, SSE client counts) kept in memory that a
+// software reset leaves alone: RTC slow memory on the ESP32. After a panic
+// or watchdog reset, begin() copies the previous boot's last KEEP events,
+// the task that was running and the reset cause aside for /debug/trace,
+// then recording carries on in the same ring.
+//
+// record() is an atomic increment, a cycle-counter read and an 8-byte
+// store, so it stays on in production. Stamps are raw cycle counts: times
+// are only ever shown relative to the newest event, by adding up the gaps
+// between neighbours. All events come from the loop task except the stall
+// check, which runs on the other core; ESP32 cores count cycles separately,
+// so its time is approximate.
+//
+// Each scheduler task has a run-time budget. A run that ends over it, or
+// that watch() sees still going past it, records a stall and freezes the
+// last STALL_KEEP events next to the ring, where it also survives a reset.
+// Tasks marked quiet run too often to be worth a start and end record each;
+// only their stalls are recorded, and the running task is tracked for all.
+
+enum TraceKind : uint8_t {
+    TRACE_BOOT,          // arg: ResetCause
+    TRACE_TASK_START,    // arg: task
+    TRACE_TASK_END,      // arg: task, value: run time in us (saturating)
+    TRACE_RELAY,         // arg: actuator, value: 1 on, 0 off
+    TRACE_I2C_ERROR,     // value: failed transactions since the last record
+    TRACE_HEAP_LOW,      // value: heap low-water mark in 16-byte units
+    TRACE_SSE_CLIENTS,   // value: subscribers
+    TRACE_STALL,         // arg: task, value: run time so far in ms (saturating)
+    TRACE_KIND_COUNT
+};
+
+enum ResetCause : uint8_t {
+    RESET_UNKNOWN,
+    RESET_POWER_ON,
+    RESET_EXTERNAL,
+    RESET_SOFTWARE,
+    RESET_PANIC,
+    RESET_TASK_WDT,
+    RESET_INT_WDT,
+    RESET_OTHER_WDT,
+    RESET_BROWNOUT,
+    RESET_DEEP_SLEEP,
+    RESET_CAUSE_COUNT
+};
+
+struct TraceRecord {
+    uint32_t stamp;    // cycle counter
+    uint8_t  kind;
+    uint8_t  arg;
+    uint16_t value;
+};
+
+struct StallTrace {
+    uint8_t     task;      // NO_TASK when there is none
+    uint8_t     count;
+    uint16_t    ms;        // how long the task had run
+    uint32_t    stampsPerUs;
+    TraceRecord events[32];
+};
+
+// The part that lives through a reset. Plain data with no constructor, so
+// startup code leaves it as the last boot wrote it.
+struct TraceMemory {
+    uint32_t          magic;
+    uint32_t          stampsPerUs;
+    uint32_t          head;        // events ever written
+    volatile uint8_t  task;        // running task, NO_TASK between runs
+    volatile uint32_t taskStamp;   // when it started
+    StallTrace        stall;       // this boot's latest
+    TraceRecord       ring[256];
+};
+
+class FlightRecorder {
+public:
+    typedef uint32_t    (*StampFn)();
+    typedef const char* (*TaskNameFn)(uint8_t task);
+
+    static const uint16_t RING       = sizeof(TraceMemory::ring) / sizeof(TraceRecord);
+    static const uint8_t  STALL_KEEP = sizeof(StallTrace::events) / sizeof(TraceRecord);
+    static const uint8_t  KEEP       = 64;      // previous-boot events shown
+    static const uint8_t  MAX_TASKS  = 16;      // Scheduler::MAX_TASKS
+    static const uint8_t  NO_TASK    = 0xFF;
+    static const uint32_t DEFAULT_BUDGET_US = 50000;
+    static const uint32_t MAGIC      = 0x54524331;   // "TRC1"
+
+    static_assert((RING & (RING - 1)) == 0, "RING must be a power of two");
+
+    // What was left from before the last reset.
+    struct PreviousBoot {
+        ResetCause  cause;
+        bool        valid;       // false after power-on or when the memory was not ours
+        uint8_t     task;        // running when it went down
+        uint8_t     count;
+        uint32_t    stampsPerUs;
+        TraceRecord events[KEEP];
+        StallTrace  stall;       // task is NO_TASK if that boot had none
+    };
+
+    FlightRecorder(TraceMemory& mem, StampFn stamp);
+
+    // Once at boot, before anything records.
+    void begin(ResetCause cause, uint32_t stampsPerUs);
+
+    void record(TraceKind kind, uint8_t arg = 0, uint16_t value = 0) {
+        uint32_t     i = head_.fetch_add(1, std::memory_order_relaxed);
+        TraceRecord& r = mem_.ring[i & (RING - 1)];
+        r.stamp = stamp_();
+        r.kind  = kind;
+        r.arg   = arg;
+        r.value = value;
+        mem_.head = i + 1;   // two cores racing can leave this one short
+    }
+
+    void setBudget(uint8_t task, uint32_t budgetUs, bool quiet = false);
+
+    // ---------- scheduler hooks (loop task) ----------
+    void taskStarted(uint8_t task);
+    void taskEnded(uint8_t task, uint32_t runUs);
+    // ---------- other core ----------
+    // Catches a task that is still running past its budget.
+    void watch();
+
+    // ---------- any task ----------
+    const PreviousBoot& previous() const { return previous_; }
+    // This boot's latest stall; task is NO_TASK if there has been none.
+    StallTrace          stall() const    { return stall_.read(); }
+    uint32_t            stalls() const   { return stalls_; }
+
+    static const char* kindName(TraceKind k);
+    static const char* causeName(ResetCause c);
+
+    // GET /debug/trace body. Task ids are named with this boot's table,
+    // which is the same as the last one's: tasks are added in a fixed order.
+    static size_t traceJson(const PreviousBoot& prev, const StallTrace& current, TaskNameFn taskName,
+                            char* buf, size_t cap);
+
+private:
+    void freeze(uint8_t task, uint32_t runUs);
+    static size_t eventsJson(const TraceRecord* ev, uint8_t count, uint32_t stampsPerUs, TaskNameFn taskName,
+                             char* buf, size_t cap);
+
+    TraceMemory&          mem_;
+    StampFn               stamp_;
+    std::atomic<uint32_t> head_;
+    std::atomic<bool>     freezing_;
+    std::atomic<bool>     stalled_;   // this run already recorded
+    uint32_t              budgetUs_[MAX_TASKS];
+    uint16_t              quiet_;     // bit per task
+    uint32_t              stampsPerUs_;
+    volatile uint32_t     stalls_;
+    PreviousBoot          previous_;
+    Seqlock<StallTrace>   stall_;
+};
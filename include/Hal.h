@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FixedPoint.h"
+#include "I2cEngine.h"
+#include "SensorLog.h"
+#include "ConfigStore.h"
+#include "FlightRecorder.h"
+
+// =====================================
+//  HARDWARE ABSTRACTION LAYER
+// =====================================
+// Everything the application core (App.cpp) needs from a board. Each
+// platform links exactly one implementation: src/main.cpp on the ESP32,
+// src/native/main.cpp for the Linux simulator. Plain functions rather than
+// an interface class, because there is only ever one platform per binary
+// and the calls sit on hot paths.
+namespace hal {
+
+// ---------- CLOCK ----------
+uint32_t millis();
+uint32_t micros();
+uint64_t monotonicUs();   // never wraps; drives the scheduler
+uint32_t cycles();        // free-running cycle counter for short intervals
+uint32_t cyclesPerUs();
+// Local seconds since midnight; false until the wall clock has been set.
+bool     timeOfDay(uint32_t& sec);
+// UTC seconds since 1970, for the flash log; false until the clock is set.
+bool     unixTime(uint32_t& sec);
+
+// ---------- GPIO ----------
+void pinOutput(uint8_t pin, bool level);   // configure as output, driven to level
+void pinInputPullup(uint8_t pin);
+void pinWrite(uint8_t pin, bool level);
+bool pinRead(uint8_t pin);
+
+// ---------- I2C ----------
+// The bus behind the transaction engine. Only the I2C owner (sensorStep())
+// calls into it.
+I2cBus& i2cBus();
+
+// ---------- ADC / PROBES ----------
+// Filtered pH probe voltage in millivolts, NAN until the filter has settled.
+float phMillivolts();
+// Channels that have no bus driver yet. Return false when no reading is available.
+bool  readHumidity(DeciPercent& rh);
+bool  readWaterTemp(CentiCelsius& t);
+
+// ---------- DISPLAY ----------
+// Panel initialisation before the engine owns the bus. Runtime output goes
+// through an I2cLcdSink on i2cBus().
+void displayBegin();
+
+// ---------- NETWORK ----------
+// /events sockets (see SseBroadcast.h). sseWrite takes what fits in the
+// client's send window and returns how much that was.
+size_t   sseWrite(uint32_t client, const char* data, size_t len);
+void     sseClose(uint32_t client);
+// Control WebSocket (see ControlChannel.h). client 0 sends to everyone.
+void     wsSend(uint32_t client, const uint8_t* frame, size_t len);
+void     wsClose(uint32_t client);
+
+// ---------- STORAGE ----------
+// Segment files behind the sensor log. Only the "log" task writes; web
+// exports read concurrently and rely on the block CRCs.
+LogStorage& logStorage();
+// The persistent configuration blob, read once at boot and rewritten by
+// the "config" task.
+ConfigStorage& configStorage();
+
+// ---------- MEMORY ----------
+uint32_t heapFree();      // bytes; 0 where the platform cannot tell
+uint32_t heapMinFree();   // low-water mark since boot
+
+// ---------- DIAGNOSTICS ----------
+// Flight recorder memory that survives a software reset (RTC slow memory on
+// the ESP32), and why the board last reset.
+TraceMemory& traceMemory();
+ResetCause   resetCause();
+
+// ---------- LOG ----------
+void log(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+}  // namespace hal
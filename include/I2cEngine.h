@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "MpscQueue.h"
+#include "Seqlock.h"
+
+// =====================================
+//  I2C BUS BACKEND
+// =====================================
+// Blocking primitives for one short transfer. The engine keeps every call
+// down to a handful of bytes, so a call never holds the bus for long. Returns
+// 0 on success, non-zero on NACK, timeout or arbitration loss.
+class I2cBus {
+public:
+    virtual ~I2cBus() {}
+    virtual int  transfer(uint8_t addr, const uint8_t* tx, uint8_t txLen, uint8_t* rx, uint8_t rxLen) = 0;
+    virtual void recover() = 0;   // clock a stuck slave free and reinitialise
+};
+
+// =====================================
+//  TRANSACTION
+// =====================================
+// Owned by the caller (drivers keep theirs statically) and handed to the
+// engine by pointer. The caller polls status() for the outcome.
+struct I2cTransaction {
+    enum Status : uint8_t { IDLE, QUEUED, DONE, FAILED, TIMED_OUT };
+
+    static const uint8_t MAX_TX = 30;
+    static const uint8_t MAX_RX = 22;
+
+    uint8_t  addr;
+    uint8_t  txLen;
+    uint8_t  rxLen;
+    uint8_t  tx[MAX_TX];
+    uint8_t  rx[MAX_RX];
+    uint32_t queuedAtUs;
+    uint32_t timeoutUs;   // give up if it cannot start within this long
+    std::atomic<uint8_t> state;
+
+    I2cTransaction() : addr(0), txLen(0), rxLen(0), queuedAtUs(0), timeoutUs(0), state(IDLE) {}
+
+    Status status() const { return (Status)state.load(std::memory_order_acquire); }
+    bool   busy() const   { return status() == QUEUED; }
+};
+
+// =====================================
+//  TRANSACTION ENGINE
+// =====================================
+// Sensor drivers and the LCD submit transactions into separate lanes from
+// any task; one owner task runs them, alternating lanes so a full LCD
+// redraw cannot starve a conversion read and vice versa. Consecutive
+// failures trigger a bus recovery. The owner task keeps the counters and
+// publishes a copy after every transaction for readers on the other core.
+class I2cEngine {
+public:
+    enum Lane : uint8_t { LANE_SENSOR, LANE_DISPLAY, LANE_COUNT };
+
+    typedef uint32_t (*ClockFn)();   // microseconds
+    typedef void     (*WakeFn)();    // called after submit, e.g. to notify the owner task
+
+    static const size_t  LANE_DEPTH         = 32;
+    static const uint8_t ERRORS_BEFORE_RESET = 3;
+
+    struct Stats {
+        uint32_t completed;
+        uint32_t failed;
+        uint32_t timedOut;
+        uint32_t recoveries;
+        uint32_t maxTransferUs;
+    };
+
+    I2cEngine(I2cBus& bus, ClockFn clock);
+
+    void setWake(WakeFn fn) { wake_ = fn; }
+
+    // Any task. False when the lane is full (the transaction is left IDLE).
+    bool submit(Lane lane, I2cTransaction* t);
+
+    // Owner task. Runs at most one transaction; returns false when idle.
+    bool poll();
+    bool pending() const;
+
+    // Any task.
+    Stats stats() const { return published_.read(); }
+
+private:
+    I2cBus&  bus_;
+    ClockFn  clock_;
+    WakeFn   wake_;
+    MpscQueue<I2cTransaction*, LANE_DEPTH> lanes_[LANE_COUNT];
+    std::atomic<uint32_t> queued_[LANE_COUNT];
+    uint8_t  nextLane_;
+    uint8_t  consecutiveErrors_;
+    Stats    stats_;      // owner task's copy
+    Seqlock<Stats> published_;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "I2cEngine.h"
+#include "LcdFramebuffer.h"
+
+// =====================================
+//  HD44780 OVER PCF8574, VIA THE ENGINE
+// =====================================
+// Encodes framebuffer output into the PCF8574 byte stream that
+// LiquidCrystal_I2C would bit-bang, but packs it into a few multi-byte
+// transactions on the display lane. The caller only fills buffers and never
+// waits for the bus. Panel initialisation still goes through
+// LiquidCrystal_I2C at boot, before the engine owns the bus.
+class I2cLcdSink : public LcdSink {
+public:
+    static const uint8_t POOL = 24;   // > one full 20x4 redraw
+
+    I2cLcdSink(I2cEngine& engine, uint8_t addr);
+
+    void setCursor(uint8_t col, uint8_t row) override;
+    void write(const char* data, uint8_t len) override;
+
+    void commit();       // submit the partly filled transaction; call after a flush
+    // Display and backlight off or back on; the panel keeps its contents.
+    void setPower(bool on);
+    // True once if any output was lost (pool exhausted or bus error) since the
+    // last call, meaning the panel no longer matches the framebuffer.
+    bool takeError();
+
+private:
+    void sendByte(uint8_t value, bool data);
+    I2cTransaction* current();
+
+    I2cEngine&      engine_;
+    uint8_t         addr_;
+    I2cTransaction  pool_[POOL];
+    uint8_t         next_;
+    I2cTransaction* open_;
+    bool            backlight_;
+    bool            error_;
+};
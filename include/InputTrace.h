@@ -0,0 +1,213 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Actuators.h"
+#include "MpscQueue.h"
+#include "RotaryInput.h"
+#include "SensorHistory.h"
+
+// =====================================
+//  INPUT TRACE
+// =====================================
+// Records everything from outside that the control and telemetry code
+// reacts to: each sensor cycle's readings, decoded encoder events, relay
+// commands from the web and the control WebSocket, and the wall clock. It
+// also records each relay decision, so a replay can be checked against
+// what the board did. The native simulator's --replay feeds a trace back
+// through the same App code (README, "Replaying a trace").
+//
+// Records go into a RAM ring of BLOCKS blocks that decode on their own:
+//
+//   0  magic 'IT', version, flags (bit 0: wall clock known)
+//   4  block sequence number
+//   8  start time (hal::millis())
+//  12  wall clock at the start (unix seconds, 0 when not set)
+//  16  local time minus UTC, minutes (int16)
+//  18  relay states as of the first record, auto modes as of the
+//      block opening (bit per actuator)
+//  20  records until an IN_END byte or the end of the block
+//
+// A record is its kind, the ms since the previous record (or the block
+// start) as a varint, then:
+//
+//   IN_SAMPLE    CHANNEL_COUNT zigzag varints, each the change from the
+//                block's previous sample (from 0 for its first)
+//   IN_ENCODER   type << 1 | clockwise
+//   IN_COMMAND   actuator, op << 1 | value
+//   IN_RELAY     actuator << 1 | on
+//   IN_CLOCK     unix seconds (4 bytes), local offset in minutes (2 bytes)
+//
+// A steady sensor cycle costs 8-10 bytes, so the 16 KB ring holds about
+// an hour at one cycle every 2 s.
+//
+// Producers on any task only push into a lock-free inbox; the owner task
+// drains it into the open block every second. GET /trace streams the file
+// header and then the ring oldest block first, without stopping the
+// writer: each block is copied out and checked afterwards, and one that was
+// reused during the copy is left out.
+enum InputKind : uint8_t {
+    IN_END,        // rest of the block is empty
+    IN_SAMPLE,
+    IN_ENCODER,
+    IN_COMMAND,
+    IN_RELAY,
+    IN_CLOCK,
+    INPUT_KIND_COUNT
+};
+
+struct InputRecord {
+    uint32_t ms;       // hal::millis() when it happened
+    uint8_t  kind;
+    uint8_t  a, b, c;  // encoder: type, dir; command: actuator, op, value; relay: actuator, on
+    int32_t  v[SensorHistory::CHANNEL_COUNT];   // sample: raw counts; clock: unix seconds, offset minutes
+};
+
+// What each block starts from.
+struct InputBlockInfo {
+    uint32_t seq;
+    uint32_t startMs;
+    uint32_t unixSec;     // 0 when the wall clock was not set
+    int16_t  offsetMin;   // local time minus UTC
+    uint8_t  relays;
+    uint8_t  autos;
+};
+
+class InputTrace {
+public:
+    typedef uint32_t (*ClockFn)();   // milliseconds
+    // The wall clock and the local offset; false while it is not set.
+    typedef bool     (*WallFn)(uint32_t& unixSec, int16_t& offsetMin);
+    // Relay states in the low byte, auto modes in the high byte.
+    typedef uint16_t (*StateFn)();
+    // Every block as it closes (the simulator's --record).
+    typedef void     (*BlockFn)(const uint8_t* block, size_t len);
+
+    static const size_t   BLOCK_SIZE  = 256;
+    static const size_t   HEADER_SIZE = 20;
+    static const uint16_t BLOCKS      = 64;
+    static const size_t   INBOX_DEPTH = 128;   // a fast spin between drains
+    static const size_t   FILE_HEADER = 8;     // 'HYTR', version, channels, actuators, reserved
+    static const uint8_t  VERSION     = 1;
+
+    struct Stats {
+        uint32_t records;     // encoded
+        uint32_t dropped;     // lost to a full inbox
+        uint32_t blocks;      // closed
+    };
+
+    InputTrace(ClockFn clock, WallFn wall, StateFn state);
+
+    void setBlockSink(BlockFn fn) { sink_ = fn; }
+
+    // ---------- producers (any task, never block) ----------
+    void sample(const int32_t v[SensorHistory::CHANNEL_COUNT]);
+    void encoder(const InputEvent& e);
+    void command(const ActuatorCommand& c);
+    void relay(Actuator a, bool on);
+    void clock(uint32_t unixSec, int16_t offsetMin);
+
+    // ---------- owner task ----------
+    // Opens the first block; call once the relays are restored.
+    void begin();
+    // Encodes what the producers queued.
+    void drain();
+    // Drains, then hands the open block to the sink as if it had closed.
+    void finish();
+
+    // ---------- any task ----------
+    const Stats& stats() const { return stats_; }
+    uint32_t     dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    // Sequence number of the open block; blocks head - BLOCKS + 1 .. head
+    // are in the ring.
+    uint32_t     head() const { return head_.load(std::memory_order_acquire); }
+    // A consistent copy of block seq, the open one up to what is written so
+    // far; false once the ring has reused it.
+    bool         copyBlock(uint32_t seq, uint8_t* out) const;
+
+    static void  fileHeader(uint8_t* out);
+    // Reads a block header; false if it is not one.
+    static bool  blockInfo(const uint8_t* block, InputBlockInfo& info);
+
+private:
+    void    push(InputRecord& r);
+    void    open(uint32_t seq, uint32_t ms);
+    void    close();
+    uint8_t build(const InputRecord& r, uint32_t ms, uint8_t* out) const;
+    void    encode(const InputRecord& r);
+
+    ClockFn clock_;
+    WallFn  wall_;
+    StateFn state_;
+    BlockFn sink_;
+
+    MpscQueue<InputRecord, INBOX_DEPTH> inbox_;
+    std::atomic<uint32_t> dropped_;
+
+    uint8_t               ring_[BLOCKS][BLOCK_SIZE];
+    std::atomic<uint32_t> head_;
+    std::atomic<uint16_t> fill_;      // bytes written to the open block
+    bool                  started_;
+    uint32_t              lastMs_;
+    int32_t               last_[SensorHistory::CHANNEL_COUNT];
+    bool                  haveSample_;
+    uint8_t               relays_;    // as of the last record encoded
+    Stats                 stats_;
+};
+
+// =====================================
+//  STREAMING TRACE READER
+// =====================================
+// GET /trace: the file header, then every block in the ring oldest first,
+// the open one as far as it is written. The body is whole blocks, so a
+// reader can decode it block by block; blocks the writer overtook during
+// the download are missing, which shows as a sequence gap.
+class InputTraceReader {
+public:
+    explicit InputTraceReader(const InputTrace& trace);
+
+    // Fills up to maxLen bytes; returns 0 once the document is complete.
+    size_t read(uint8_t* buf, size_t maxLen);
+
+private:
+    bool load();
+
+    const InputTrace& trace_;
+    uint32_t next_, last_;
+    uint8_t  block_[InputTrace::BLOCK_SIZE];
+    uint16_t pos_, len_;
+};
+
+// =====================================
+//  TRACE PARSER
+// =====================================
+// Walks a whole trace held in memory (the simulator's replay): checks the
+// file header, then returns the records in order with their block's header
+// at hand. Samples come back absolute.
+class InputTraceParser {
+public:
+    InputTraceParser(const uint8_t* data, size_t len);
+
+    // False if the file header does not match this build's registry.
+    bool valid() const { return valid_; }
+    // The next record, or false at the end.
+    bool next(InputRecord& r);
+    // The block the last record came from.
+    const InputBlockInfo& block() const { return info_; }
+    // Blocks missing between the ones read so far.
+    uint32_t gaps() const { return gaps_; }
+
+private:
+    bool nextBlock();
+
+    const uint8_t* data_;
+    size_t         len_, offset_;
+    bool           valid_, inBlock_, first_;
+    uint16_t       pos_;
+    uint32_t       ms_;
+    int32_t        last_[SensorHistory::CHANNEL_COUNT];
+    InputBlockInfo info_;
+    uint32_t       gaps_;
+};
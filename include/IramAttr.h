@@ -0,0 +1,20 @@
+#pragma once
+
+// =====================================
+//  INTERRUPT-SAFE PLACEMENT
+// =====================================
+// The encoder interrupt is registered as an IRAM interrupt, so it also runs
+// while a LittleFS or NVS write has the flash cache switched off. Everything
+// it reaches in the core must then be in IRAM (IRAM_ATTR) and every constant
+// it reads in DRAM (DRAM_ATTR); a flash access in that window faults the
+// chip. On other platforms both are no-ops.
+#if defined(ESP_PLATFORM)
+#include <esp_attr.h>
+#endif
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+#ifndef DRAM_ATTR
+#define DRAM_ATTR
+#endif
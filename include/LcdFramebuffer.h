@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "FixedPoint.h"
+
+// =====================================
+//  LCD BACKEND
+// =====================================
+// The minimal set of HD44780 operations the framebuffer needs. The board
+// feeds I2cLcdSink; CountingLcdSink lets the simulator's --bench-lcd measure
+// traffic.
+class LcdSink {
+public:
+    virtual ~LcdSink() {}
+    virtual void setCursor(uint8_t col, uint8_t row) = 0;
+    virtual void write(const char* data, uint8_t len) = 0;
+};
+
+// Counts what a frame would cost on the wire. LiquidCrystal_I2C sends every
+// command or data byte as two nibbles, each nibble being three PCF8574
+// writes (data, EN high, EN low).
+class CountingLcdSink : public LcdSink {
+public:
+    static const uint8_t I2C_WRITES_PER_BYTE = 6;
+
+    uint32_t cursorMoves = 0;
+    uint32_t dataBytes   = 0;
+
+    void setCursor(uint8_t, uint8_t) override { cursorMoves++; }
+    void write(const char*, uint8_t len) override { dataBytes += len; }
+
+    uint32_t lcdBytes() const        { return cursorMoves + dataBytes; }
+    uint32_t i2cTransactions() const { return lcdBytes() * I2C_WRITES_PER_BYTE; }
+    void     reset()                 { cursorMoves = dataBytes = 0; }
+};
+
+// =====================================
+//  SHADOW FRAMEBUFFER
+// =====================================
+// Menu code draws into a back buffer with the same setCursor/print calls it
+// used on the LCD. flush() diffs it against what the panel already shows and
+// sends only the changed runs, skipping setCursor when the panel's cursor has
+// already auto-advanced to the right cell.
+class LcdFramebuffer {
+public:
+    static const uint8_t COLS = 20;
+    static const uint8_t ROWS = 4;
+
+    explicit LcdFramebuffer(LcdSink& sink);
+
+    void beginFrame();                 // blank the back buffer (replaces lcd.clear())
+    void setCursor(uint8_t col, uint8_t row);
+    void print(const char* s);
+    void print(char c);
+    void print(float value, int digits);
+    void print(long value);
+    void print(int value) { print((long)value); }
+    // A reading at its own resolution, formatted without float math.
+    template <typename Unit, int32_t Scale>
+    void print(Fixed<Unit, Scale> value) {
+        char buf[16];
+        value.format(buf, sizeof(buf));
+        print(buf);
+    }
+
+    void flush();                      // push the differences to the panel
+    void invalidate() { valid_ = false; }   // force a full redraw on next flush
+
+    const char* row(uint8_t r) const { return front_[r]; }
+
+private:
+    void emit(uint8_t row, uint8_t from, uint8_t to);
+
+    LcdSink& sink_;
+    char     back_[ROWS][COLS];
+    char     front_[ROWS][COLS + 1];   // NUL-terminated for row()
+    uint8_t  col_, row_;
+    uint8_t  panelCol_, panelRow_;     // where the LCD's own cursor sits
+    bool     valid_;
+};
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// =====================================
+//  HOT-PATH METRICS
+// =====================================
+// Cycle-count latency histograms, event counters and gauges, exposed as
+// Prometheus text by MetricsReader. Build with -DHYDRO_METRICS=0 to compile
+// all of it out: the METRIC_* macros expand to nothing and no storage is
+// reserved.
+#ifndef HYDRO_METRICS
+#define HYDRO_METRICS 1
+#endif
+
+#if HYDRO_METRICS
+
+// Fixed power-of-two buckets over raw cycle counts, so record() is a
+// count-leading-zeros and an increment. Bucket k holds durations up to
+// 2^(FIRST_BIT + k) cycles (~1 us to ~70 ms at 240 MHz); the last is +Inf.
+// One writer per histogram. A scrape may see a sample half-recorded, which
+// the next scrape corrects.
+class LatencyHistogram {
+public:
+    static const uint8_t FIRST_BIT = 8;
+    static const uint8_t BUCKETS   = 18;
+
+    LatencyHistogram() : counts_(), sumCycles_(0) {}
+
+    void record(uint32_t cycles) {
+        uint8_t bits = cycles ? 32 - __builtin_clz(cycles) : 0;
+        uint8_t b    = bits <= FIRST_BIT ? 0 : bits - FIRST_BIT;
+        if (b >= BUCKETS) b = BUCKETS - 1;
+        counts_[b]++;
+        sumCycles_ += cycles;
+    }
+
+    uint32_t bucket(uint8_t b) const { return counts_[b]; }
+    uint64_t sumCycles() const       { return sumCycles_; }
+
+private:
+    volatile uint32_t counts_[BUCKETS];
+    volatile uint64_t sumCycles_;
+};
+
+class Counter {
+public:
+    Counter() : v_(0) {}
+    void     inc(uint32_t n = 1) { v_.fetch_add(n, std::memory_order_relaxed); }
+    uint32_t value() const       { return v_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint32_t> v_;
+};
+
+// Times the enclosing scope into a histogram.
+template <uint32_t (*Cycles)()>
+class ScopedCycleTimer {
+public:
+    explicit ScopedCycleTimer(LatencyHistogram& h) : h_(h), start_(Cycles()) {}
+    ~ScopedCycleTimer() { h_.record(Cycles() - start_); }
+
+private:
+    LatencyHistogram& h_;
+    uint32_t          start_;
+};
+
+// =====================================
+//  REGISTRY
+// =====================================
+// A fixed table of what /metrics reports. Names and help strings must
+// outlive the registry (string literals).
+class MetricsRegistry {
+public:
+    static const uint8_t MAX_METRICS = 48;
+
+    typedef uint32_t (*ValueFn)();
+
+    enum Kind : uint8_t { KIND_COUNTER, KIND_COUNTER_FN, KIND_GAUGE_FN, KIND_HISTOGRAM };
+
+    struct Metric {
+        const char* name;
+        const char* help;
+        Kind        kind;
+        const void* source;   // Counter or LatencyHistogram
+        ValueFn     fn;
+    };
+
+    MetricsRegistry() : count_(0) {}
+
+    bool addCounter(const char* name, const char* help, const Counter& c);
+    // A monotonic count kept elsewhere, e.g. a driver's error tally.
+    bool addCounter(const char* name, const char* help, ValueFn fn);
+    bool addGauge(const char* name, const char* help, ValueFn fn);
+    bool addHistogram(const char* name, const char* help, const LatencyHistogram& h);
+
+    uint8_t       count() const          { return count_; }
+    const Metric& metric(uint8_t i) const { return metrics_[i]; }
+
+private:
+    bool add(const char* name, const char* help, Kind kind, const void* source, ValueFn fn);
+
+    Metric  metrics_[MAX_METRICS];
+    uint8_t count_;
+};
+
+// =====================================
+//  STREAMING READER
+// =====================================
+// Formats the registry in the Prometheus text exposition format a line at a
+// time, like HistoryReader, so the response never exists as one buffer.
+// Histogram bounds are converted from cycles to seconds with cyclesPerUs.
+class MetricsReader {
+public:
+    MetricsReader(const MetricsRegistry& registry, uint32_t cyclesPerUs);
+
+    // Fills up to maxLen bytes; returns 0 once the document is complete.
+    size_t read(char* buf, size_t maxLen);
+
+private:
+    bool nextLine();
+
+    const MetricsRegistry& reg_;
+    double   secondsPerCycle_;
+    uint8_t  metric_;
+    uint8_t  line_;         // 0 HELP, 1 TYPE, then samples
+    uint32_t cumulative_;
+    char     pending_[128];
+    uint8_t  pendingLen_, pendingPos_;
+};
+
+#define METRIC_CONCAT_(a, b) a##b
+#define METRIC_CONCAT(a, b)  METRIC_CONCAT_(a, b)
+#define METRIC_TIME(hist)    ScopedCycleTimer<hal::cycles> METRIC_CONCAT(metricTimer_, __LINE__)(hist)
+#define METRIC_INC(counter)  (counter).inc()
+
+#else
+
+#define METRIC_TIME(hist)    do {} while (0)
+#define METRIC_INC(counter)  do {} while (0)
+
+#endif
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "IramAttr.h"
+
+// =====================================
+//  BOUNDED LOCK-FREE MPSC QUEUE
+// =====================================
+// Any number of producers (web handler, encoder, timers) push without locks
+// or blocking; exactly one consumer pops. Each cell carries a sequence
+// number (Vyukov's bounded queue), so a producer claims a slot with a single
+// CAS and publishes it with a release store. push() returns the slot's
+// position + 1, which is strictly increasing in queue order and makes a
+// natural command sequence number. push() is in IRAM because the encoder
+// interrupt calls it.
+
+template <typename T, size_t N>
+class MpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "MpscQueue depth must be a power of two");
+
+public:
+    MpscQueue() : head_(0), tail_(0) {
+        for (size_t i = 0; i < N; i++) cells_[i].seq.store((uint32_t)i, std::memory_order_relaxed);
+    }
+
+    // Any task. Returns the sequence number, or 0 when the queue is full.
+    uint32_t IRAM_ATTR push(const T& value) {
+        uint32_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell&    c    = cells_[pos & (N - 1)];
+            uint32_t seq  = c.seq.load(std::memory_order_acquire);
+            int32_t  diff = (int32_t)(seq - pos);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    c.value = value;
+                    c.seq.store(pos + 1, std::memory_order_release);
+                    return pos + 1;
+                }
+            } else if (diff < 0) {
+                return 0;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer only. seqOut receives the number push() returned for it.
+    bool pop(T& out, uint32_t* seqOut = nullptr) {
+        Cell&    c   = cells_[tail_ & (N - 1)];
+        uint32_t seq = c.seq.load(std::memory_order_acquire);
+        if ((int32_t)(seq - (tail_ + 1)) < 0) return false;
+        out = c.value;
+        if (seqOut) *seqOut = tail_ + 1;
+        c.seq.store(tail_ + N, std::memory_order_release);
+        tail_++;
+        return true;
+    }
+
+    static size_t capacity() { return N; }
+
+private:
+    struct Cell {
+        std::atomic<uint32_t> seq;
+        T                     value;
+    };
+
+    Cell                  cells_[N];
+    std::atomic<uint32_t> head_;
+    uint32_t              tail_;
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =====================================
+//  pH SIGNAL CHAIN
+// =====================================
+// Raw 12-bit ADC samples arrive in DMA blocks at tens of kHz. They pass
+// through three cheap decimating stages before any float math happens:
+//
+//   raw ──median-of-5──▶ ÷5 ──mean-of-32──▶ ÷32 ──EMA──▶ filtered counts
+//
+// The median removes single-sample spikes (relay switching, WiFi bursts),
+// the block mean removes broadband noise, and the EMA smooths the result
+// into a stable reading. At 20 kHz input the EMA runs at 125 Hz. Everything
+// here is plain C++, so recorded traces can be replayed on a host.
+
+class MedianDecimator {
+public:
+    static const uint8_t N = 5;
+
+    MedianDecimator() : fill_(0) {}
+
+    // Returns true and sets out every N samples.
+    bool push(uint16_t sample, uint16_t& out);
+
+private:
+    uint16_t window_[N];
+    uint8_t  fill_;
+};
+
+class MeanDecimator {
+public:
+    explicit MeanDecimator(uint8_t n) : n_(n), count_(0), sum_(0) {}
+
+    bool push(uint16_t sample, uint16_t& out) {
+        sum_ += sample;
+        if (++count_ < n_) return false;
+        out    = (uint16_t)((sum_ + n_ / 2) / n_);
+        sum_   = 0;
+        count_ = 0;
+        return true;
+    }
+
+private:
+    uint8_t  n_;
+    uint8_t  count_;
+    uint32_t sum_;
+};
+
+// Q16 fixed-point EMA so the per-sample path stays integer-only.
+class EmaFilter {
+public:
+    explicit EmaFilter(uint16_t alphaQ16) : alpha_(alphaQ16), state_(0), primed_(false) {}
+
+    void push(uint16_t sample) {
+        int32_t x = (int32_t)sample << 16;
+        if (!primed_) { state_ = x; primed_ = true; return; }
+        state_ += (int32_t)(((int64_t)(x - state_) * alpha_) >> 16);
+    }
+
+    bool  primed() const { return primed_; }
+    float value() const  { return state_ / 65536.0f; }
+
+private:
+    uint16_t alpha_;
+    int32_t  state_;
+    bool     primed_;
+};
+
+class PhFilterChain {
+public:
+    static const uint8_t  MEAN_N    = 32;
+    static const uint16_t EMA_ALPHA = 1311;   // ~0.02 -> ~0.4 s time constant at 125 Hz
+
+    PhFilterChain() : mean_(MEAN_N), ema_(EMA_ALPHA), outputs_(0) {}
+
+    void feed(const uint16_t* samples, size_t n);
+
+    bool     ready() const   { return ema_.primed(); }
+    float    counts() const  { return ema_.value(); }   // filtered 12-bit ADC counts
+    uint32_t outputs() const { return outputs_; }
+
+private:
+    MedianDecimator median_;
+    MeanDecimator   mean_;
+    EmaFilter       ema_;
+    uint32_t        outputs_;
+};
+
+// =====================================
+//  CALIBRATION
+// =====================================
+// Two or three buffer-solution points (probe millivolts -> pH), kept sorted
+// by millivolts and applied piecewise-linearly; outside the calibrated range
+// the nearest segment is extrapolated. The struct is stored in NVS as-is,
+// so VERSION must change if its layout does.
+struct PhCalibration {
+    static const uint8_t VERSION    = 1;
+    static const uint8_t MAX_POINTS = 3;
+
+    uint8_t version;
+    uint8_t count;
+    float   mv[MAX_POINTS];
+    float   ph[MAX_POINTS];
+
+    // PH-4502C style module behind a 2:1 divider (the ESP32 ADC tops out near
+    // 2.5 V): about 1.25 V at pH 7 and -88 mV per pH. Calibrate for real use.
+    static PhCalibration defaults();
+
+    bool  valid() const;
+    float toPh(float mv) const;
+    // Adds a point, replacing one within 0.5 pH of it, or the closest one when full.
+    void  addPoint(float mv, float ph);
+};
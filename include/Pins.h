@@ -0,0 +1,19 @@
+#pragma once
+
+// ---------- PIN DEFINITIONS ----------
+#define DHT_PIN      2
+#define PH_PIN       34
+#define ENC_CLK      33
+#define ENC_DT       25
+#define ENC_SW       26
+#define RELAY_MOTOR  23
+#define RELAY_LIGHT  18
+#define RELAY_FAN    19
+#define I2C_SDA      21
+#define I2C_SCL      22
+
+#define I2C_FREQ_HZ     100000   // the PCF8574 LCD backpack is a 100 kHz part
+#define I2C_TIMEOUT_MS  5
+#define LCD_ADDR        0x27
+
+// Relay polarity is declared per actuator in Registry.h.
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "IramAttr.h"
+#include "Seqlock.h"
+
+// =====================================
+//  POWER MANAGER
+// =====================================
+// Lets the control loop sleep from one deadline to the next instead of
+// waking every few milliseconds to look for work. The tasks that only react
+// to something (the encoder, the actuator owner, the SSE pump) park
+// themselves while there is nothing for them, and whatever gives them work
+// calls wake(): the encoder interrupt, a relay command from any task, an
+// /events or /ws client coming, going or sending. appLoop() turns the wake
+// into a trigger of the task concerned. Between deadlines the loop waits at
+// most MAX_WAIT_US, which keeps the loop watchdog fed. On the ESP32 the
+// sensor task already blocks until its next conversion, so once both cores
+// wait, the tickless idle takes the chip into light sleep and the radio
+// into modem sleep (src/main.cpp).
+//
+// Residency is measured on the control loop: running tasks (active),
+// waiting too briefly for light sleep to pay off (idle), and waiting at
+// least SLEEP_MIN_US with light sleep enabled (sleep). The chip only sleeps
+// while the other core and the radio are idle as well, so sleep is what
+// the control loop allowed, an upper bound on what light sleep saved.
+//
+// The LCD goes dark after the display timeout without encoder input. The
+// next encoder event only lights it again and is not acted on, so a turn in
+// the dark cannot toggle a relay.
+
+enum WakeSource : uint8_t {
+    WAKE_INPUT,      // encoder rotation or button
+    WAKE_COMMAND,    // relay command, or /ws traffic for the control channel
+    WAKE_NETWORK,    // /events client connected or gone
+    WAKE_SOURCE_COUNT
+};
+
+class PowerManager {
+public:
+    // Wakes the control loop; called from any task or an interrupt, so the
+    // platform's hook must be IRAM_ATTR like wake() itself.
+    typedef void (*WakeFn)();
+
+    static const uint64_t MAX_WAIT_US  = 1000000;
+    static const uint32_t SLEEP_MIN_US = 5000;   // shorter waits cost more to enter and leave light sleep
+
+    struct Stats {
+        uint64_t activeUs;
+        uint64_t idleUs;
+        uint64_t sleepUs;
+        uint32_t waits;
+        uint32_t sleeps;        // waits long enough to sleep
+        uint32_t displayOffs;
+        uint32_t wakes[WAKE_SOURCE_COUNT];
+        bool     displayOn;
+        bool     sleepEnabled;
+    };
+
+    PowerManager();
+
+    // ---------- setup ----------
+    void setWake(WakeFn fn)          { wakeFn_ = fn; }
+    // Whether the platform has light sleep; without it every wait is idle.
+    void setSleepEnabled(bool on)    { sleepEnabled_.store(on, std::memory_order_relaxed); }
+    // 0 keeps the display on; the countdown starts at nowMs.
+    void setDisplayTimeout(uint32_t ms, uint32_t nowMs);
+
+    // ---------- any task or interrupt ----------
+    // In IRAM and on word-sized atomics only: the encoder interrupt calls it
+    // while flash writes have the cache off (IramAttr.h).
+    void IRAM_ATTR wake(WakeSource s) {
+        pending_.fetch_or(1u << s, std::memory_order_release);
+        wakes_[s].fetch_add(1, std::memory_order_relaxed);
+        if (wakeFn_) wakeFn_();
+    }
+
+    // ---------- control loop ----------
+    // Wake sources since the last call, a bit per WakeSource.
+    uint8_t  takeWakes()         { return (uint8_t)pending_.exchange(0, std::memory_order_acquire); }
+    bool     wakePending() const { return pending_.load(std::memory_order_relaxed) != 0; }
+    // How long to wait when appLoop() has nothing due for idleUs.
+    uint64_t waitFor(uint64_t idleUs) const;
+    void     ran(uint64_t us);
+    // A wait that was planned to last plannedUs and lasted us.
+    void     waited(uint64_t plannedUs, uint64_t us);
+
+    // Encoder input at nowMs; false if it only woke the display.
+    bool     input(uint32_t nowMs);
+    // True once when the display should go dark.
+    bool     displayTimedOut(uint32_t nowMs);
+
+    // ---------- any task ----------
+    bool     displayOn() const    { return displayOn_.load(std::memory_order_relaxed); }
+    bool     sleepEnabled() const { return sleepEnabled_.load(std::memory_order_relaxed); }
+    Stats    stats() const        { return published_.read(); }
+
+    static const char* wakeName(WakeSource s);
+    // GET /power body.
+    static size_t statsJson(const Stats& s, char* buf, size_t cap);
+
+private:
+    void publish();
+
+    WakeFn                wakeFn_;
+    std::atomic<uint32_t> pending_;      // a bit per WakeSource
+    std::atomic<uint32_t> wakes_[WAKE_SOURCE_COUNT];
+    std::atomic<bool>     sleepEnabled_;
+    std::atomic<bool>     displayOn_;
+    uint32_t              displayTimeoutMs_;
+    uint32_t              lastInputMs_;
+    Stats                 stats_;        // control loop's copy
+    Seqlock<Stats>        published_;
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FixedPoint.h"
+#include "Pins.h"
+
+// =====================================
+//  SENSOR / ACTUATOR REGISTRY
+// =====================================
+// Every sensor and relay on the controller is declared once, in the two
+// lists below. Everything that used to repeat them is expanded from here at
+// compile time:
+//
+//   sensors    SensorSnapshot members, SensorHistory channels, telemetry
+//              fields and deadbands, LCD menu and screens, dashboard cards
+//   actuators  Actuator ids, relay pins and polarity, web device names,
+//              telemetry state/auto fields, LCD control menu, dashboard cards
+//
+// Each consumer defines X to pick the columns it needs and expands the
+// list: into an enum, a const table (flash on the ESP32), or a switch with
+// one case per entry. There are no virtual calls and no registry object in
+// RAM. tools/build_web.py reads the same rows to generate the dashboard.
+//
+// A second zone's pumps are one row each. ACT_COUNT is limited to 8 by the
+// relay bit masks (ActuatorController, ControlChannel frames, the config
+// blob). Adding or removing a sensor changes the flash log block and the
+// config limits layout: bump SensorLog::VERSION and the config schema.
+
+// ---------- SENSORS ----------
+// X(id, key, field, type, shift, deadband, label, unit, part)
+//   id        SensorHistory channel and TF_<id> telemetry field
+//   key       name on the wire: SSE field, /history and alert "sensor"
+//   field     SensorSnapshot member, of fixed-point type `type`
+//   shift     low bits dropped so history and log samples fit int16
+//   deadband  changes up to this many raw counts are left out of telemetry deltas
+//   label     LCD menu line and screen title, dashboard card (<= 19 chars)
+//   unit      appended to the value on the LCD
+//   part      where it comes from, shown on the dashboard card
+#define HYDRO_SENSORS(X)                                                                                  \
+    X(AIR_TEMP,   "bmpTemp",     bmpTemp,     DeciCelsius,  0, 0, "Air Temperature", " C",   "BMP180")  \
+    X(HUMIDITY,   "dhtHumidity", dhtHumidity, DeciPercent,  0, 0, "Humidity",        " %",   "DHT11")   \
+    X(WATER_TEMP, "ds18b20",     ds18b20Temp, CentiCelsius, 0, 4, "Water Temp",      " C",   "DS18B20") \
+    X(LUX,        "lux",         lux,         Lux,          1, 5, "Light Intensity", " lux", "BH1750")  \
+    X(PH,         "ph",          phValue,     CentiPh,      0, 2, "pH",              " pH",  "Analog")  \
+    X(PRESSURE,   "pressure",    pressure,    DeciHpa,      0, 1, "Pressure",        " hPa", "BMP180")
+
+// ---------- ACTUATORS ----------
+// X(id, key, pin, activeLow, label)
+//   id         ACT_<id>, TF_<id> and TF_<id>_AUTO
+//   key        web device name; key "Auto" switches its auto mode
+//   pin        relay output (Pins.h)
+//   activeLow  the relay board switches on with a LOW input
+//   label      LCD control menu and screen title, dashboard card
+#define HYDRO_ACTUATORS(X)                                   \
+    X(MOTOR, "motor", RELAY_MOTOR, true, "Water Pump")      \
+    X(LIGHT, "light", RELAY_LIGHT, true, "Grow Light")      \
+    X(FAN,   "fan",   RELAY_FAN,   true, "Ventilation Fan")
+
+// ---------- COUNTS ----------
+#define HYDRO_COUNT_ONE(...) +1
+static const uint8_t SENSOR_COUNT   = 0 HYDRO_SENSORS(HYDRO_COUNT_ONE);
+static const uint8_t ACTUATOR_COUNT = 0 HYDRO_ACTUATORS(HYDRO_COUNT_ONE);
+#undef HYDRO_COUNT_ONE
+
+static_assert(ACTUATOR_COUNT <= 8, "relay states travel as 8-bit masks");
+
+// ---------- RELAY OUTPUTS ----------
+struct RelayOutput {
+    uint8_t pin;
+    bool    activeLow;
+
+    // Pin level that switches the relay on or off.
+    constexpr bool level(bool on) const { return on != activeLow; }
+};
+
+#define HYDRO_RELAY_OUTPUT(id, key, pin, activeLow, label) { pin, activeLow },
+static constexpr RelayOutput RELAY_OUTPUTS[ACTUATOR_COUNT] = { HYDRO_ACTUATORS(HYDRO_RELAY_OUTPUT) };
+#undef HYDRO_RELAY_OUTPUT
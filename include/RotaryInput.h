@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+#include "IramAttr.h"
+#include "MpscQueue.h"
+
+// =====================================
+//  ROTARY ENCODER INPUT
+// =====================================
+// The platform's pin-change interrupt on both encoder pins reads CLK and DT
+// together and calls pinEdge(). A periodic task samples the push button
+// with sampleButton() while it is pressed or settling; a change on the
+// button pin starts it again. Both turn what they see into events on a lock-free
+// queue, and the menu drains it with next(). Nothing on the way is allowed
+// to block or lose a detent it could have counted. The interrupt's path,
+// pinEdge() through the decoder to the queue, is in IRAM (IramAttr.h).
+
+enum InputEventType : uint8_t {
+    EV_STEP,         // one detent; dir +1 clockwise, -1 counter-clockwise
+    EV_CLICK,        // released before LONG_PRESS_MS
+    EV_LONG_PRESS    // held for LONG_PRESS_MS; the release that follows is silent
+};
+
+struct InputEvent {
+    uint8_t type;
+    int8_t  dir;
+};
+
+// ---------- QUADRATURE ----------
+// Table-driven Gray-code decoder. Indexed by (previous AB << 2) | current
+// AB, with A = CLK in bit 1 and B = DT in bit 0. Each valid transition is a
+// quarter step. Contact bounce walks back and forth and nets out. A state
+// where both pins changed means an edge came and went before the interrupt
+// read the pins, so it is replayed as two quarter steps instead of being
+// dropped: in the direction the current detent is heading, or that of the
+// previous detent when it has only just left rest. A detent is reported when the
+// encoder comes to rest (both pins high) at least half a cycle away from
+// where it left, which also forgives one lost edge per detent.
+class QuadratureDecoder {
+public:
+    static const uint8_t REST = 0x3;
+
+    QuadratureDecoder() : state_(REST), quarters_(0), lastDetent_(0), skipped_(0) {}
+
+    // Current pin levels; returns +1/-1 when a detent completes, else 0.
+    int8_t IRAM_ATTR update(uint8_t ab) {
+        static const int8_t DRAM_ATTR TABLE[16] = {
+            0, -1,  1,  2,
+            1,  0,  2, -1,
+           -1,  2,  0,  1,
+            2,  1, -1,  0,
+        };
+        // Clockwise order of the states, and each state's place in it.
+        static const uint8_t DRAM_ATTR CYCLE[4] = { 0x3, 0x1, 0x0, 0x2 };
+        static const uint8_t DRAM_ATTR PLACE[4] = { 2, 1, 3, 0 };
+
+        ab &= 0x3;
+        int8_t t = TABLE[(state_ << 2) | ab];
+        if (t != 2) return t ? move(ab, t) : 0;
+
+        skipped_++;
+        int8_t dir = quarters_ > 0 ? 1 : quarters_ < 0 ? -1 : lastDetent_;
+        if (!dir) { state_ = ab; return 0; }
+        uint8_t mid = CYCLE[(PLACE[state_] + dir) & 0x3];
+        return move(mid, dir) + move(ab, dir);
+    }
+
+    uint32_t skipped() const { return skipped_; }   // double transitions inferred
+
+private:
+    int8_t IRAM_ATTR move(uint8_t ab, int8_t dir) {
+        state_     = ab;
+        quarters_ += dir;
+        if (ab != REST) return 0;
+        int8_t step = quarters_ >= 2 ? 1 : quarters_ <= -2 ? -1 : 0;
+        quarters_ = 0;
+        if (step) lastDetent_ = step;
+        return step;
+    }
+
+    uint8_t  state_;
+    int8_t   quarters_;     // since the last rest
+    int8_t   lastDetent_;
+    uint32_t skipped_;
+};
+
+// ---------- PUSH BUTTON ----------
+// Sampled on a fixed period, never from an interrupt. A level counts once
+// it has held for DEBOUNCE_MS; long presses fire while the button is still
+// down, so the menu reacts without waiting for the release.
+class DebouncedButton {
+public:
+    static const uint32_t DEBOUNCE_MS   = 20;
+    static const uint32_t LONG_PRESS_MS = 800;
+    static const uint8_t  NONE          = 0xFF;
+
+    DebouncedButton() : raw_(false), stable_(false), longSent_(false), changedMs_(0), pressedMs_(0) {}
+
+    // Returns EV_CLICK, EV_LONG_PRESS or NONE.
+    uint8_t update(bool pressed, uint32_t nowMs);
+
+    bool pressed() const { return stable_; }
+    // Released and settled: nothing can happen until the pin changes.
+    bool idle() const    { return !raw_ && !stable_; }
+
+private:
+    bool     raw_, stable_, longSent_;
+    uint32_t changedMs_, pressedMs_;
+};
+
+// ---------- EVENT SOURCE ----------
+class RotaryInput {
+public:
+    static const size_t QUEUE_DEPTH = 32;
+
+    RotaryInput() : dropped_(0) {}
+
+    // Pin-change interrupt: the CLK and DT levels read in one go.
+    void IRAM_ATTR pinEdge(uint8_t ab) {
+        int8_t step = decoder_.update(ab);
+        if (step) push(EV_STEP, step);
+    }
+
+    // Periodic task: the debounced button, pressed = true.
+    void sampleButton(bool pressed, uint32_t nowMs) {
+        uint8_t ev = button_.update(pressed, nowMs);
+        if (ev != DebouncedButton::NONE) push(ev, 0);
+    }
+
+    // An event decoded elsewhere: the simulator replaying a trace.
+    void inject(const InputEvent& e) { push(e.type, e.dir); }
+
+    // Consumer (the menu).
+    bool next(InputEvent& e) { return events_.pop(e); }
+
+    uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint32_t skipped() const { return decoder_.skipped(); }
+    // The button task may stop sampling until the next pin change.
+    bool     buttonIdle() const { return button_.idle(); }
+
+private:
+    void IRAM_ATTR push(uint8_t type, int8_t dir) {
+        InputEvent e = { type, dir };
+        if (!events_.push(e)) dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    QuadratureDecoder                   decoder_;
+    DebouncedButton                     button_;
+    MpscQueue<InputEvent, QUEUE_DEPTH>  events_;
+    std::atomic<uint32_t>               dropped_;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+
+// =====================================
+//  COOPERATIVE DEADLINE SCHEDULER
+// =====================================
+// Tasks are kept in a binary min-heap ordered by their next deadline, so
+// finding the next task to run is O(1) and rescheduling is O(log n).
+// Time comes from an injected microsecond clock, which lets the same code
+// run against esp_timer on the board and a fake clock on a host build.
+
+class Scheduler {
+public:
+    typedef uint64_t (*ClockFn)();
+    typedef void (*TaskFn)();
+    // Called just before and just after each run; runUs is 0 before.
+    typedef void (*ObserverFn)(uint8_t id, bool done, uint32_t runUs);
+
+    static const uint8_t MAX_TASKS  = 16;
+    static const uint8_t NO_TASK    = 0xFF;
+    static const uint64_t NEVER     = UINT64_MAX;
+
+    struct TaskStats {
+        uint32_t runs;
+        uint32_t lastRunUs;
+        uint32_t maxRunUs;
+        uint64_t totalRunUs;
+        uint32_t lastLateUs;    // how far past its deadline the task started
+        uint32_t maxLateUs;
+    };
+
+    explicit Scheduler(ClockFn clock);
+
+    // Runs every periodUs, first run after firstDelayUs.
+    uint8_t addPeriodic(const char* name, TaskFn fn, uint64_t periodUs, uint64_t firstDelayUs = 0);
+    // Runs once, delayUs from now. The slot is released after it fires.
+    uint8_t addOneShot(const char* name, TaskFn fn, uint64_t delayUs);
+
+    void trigger(uint8_t id);                     // run as soon as possible
+    void rescheduleAt(uint8_t id, uint64_t atUs); // move the next deadline
+    void cancel(uint8_t id);
+
+    // Runs every task whose deadline has passed and returns the number of
+    // microseconds until the next deadline (NEVER when nothing is queued).
+    uint64_t runDue();
+    uint64_t timeUntilNext() const;
+    uint64_t now() const { return clock_(); }
+    void       setObserver(ObserverFn fn) { observer_ = fn; }
+    ObserverFn observer() const           { return observer_; }
+
+    uint8_t          taskCount() const { return MAX_TASKS; }
+    bool             isActive(uint8_t id) const { return id < MAX_TASKS && tasks_[id].fn != nullptr; }
+    const char*      taskName(uint8_t id) const { return tasks_[id].name; }
+    const TaskStats& stats(uint8_t id) const { return tasks_[id].stats; }
+    // The next deadline; to an observer before a run, the one being served.
+    uint64_t         deadline(uint8_t id) const { return tasks_[id].deadline; }
+    void             resetStats();
+
+private:
+    struct Task {
+        const char* name;
+        TaskFn      fn;
+        uint64_t    periodUs;   // 0 = one-shot
+        uint64_t    deadline;
+        uint8_t     heapPos;    // NO_TASK while not queued
+        TaskStats   stats;
+    };
+
+    uint8_t allocate(const char* name, TaskFn fn, uint64_t periodUs, uint64_t deadline);
+    void    push(uint8_t id);
+    void    remove(uint8_t id);
+    void    siftUp(uint8_t pos);
+    void    siftDown(uint8_t pos);
+    void    swap(uint8_t a, uint8_t b);
+    bool    earlier(uint8_t a, uint8_t b) const { return tasks_[heap_[a]].deadline < tasks_[heap_[b]].deadline; }
+
+    ClockFn    clock_;
+    ObserverFn observer_;
+    Task       tasks_[MAX_TASKS];
+    uint8_t    heap_[MAX_TASKS];
+    uint8_t    heapSize_;
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "SensorHistory.h"
+#include "Seqlock.h"
+
+// =====================================
+//  SENSOR ANALYTICS AND ALERTS
+// =====================================
+// Runs on every acquisition, right behind updateSensors(), in constant
+// memory and a few floating-point operations per channel:
+//
+//   Welford   running mean and variance since boot
+//   EWMA      smoothed value that the band limits are checked against,
+//             so one noisy sample does not raise an alert
+//   rate      EWMA of the per-minute slope
+//   stuck     how long the fixed-point sample has not moved by one count
+//
+// Each channel has up to four alerts. LOW and HIGH are raised when the
+// smoothed value leaves [low, high] and cleared once it is back inside by
+// the hysteresis. RATE is raised when the slope passes maxRatePerMin and
+// cleared below half of it. STUCK is raised after stuckSec without change
+// and cleared by the next change. Every raise and clear is an event.
+//
+// The I2C owner calls update() and is the only writer. Everything it
+// produces goes out through one seqlock: the stats, the active alerts and
+// the last RECENT_EVENTS events. The web handlers and the telemetry task
+// read copies, and the telemetry task forwards events it has not seen yet.
+// Limits come in through a second seqlock from the config task.
+
+enum AlertKind : uint8_t { ALERT_LOW, ALERT_HIGH, ALERT_RATE, ALERT_STUCK, ALERT_KIND_COUNT };
+
+struct ChannelLimits {
+    float    low, high;       // band on the smoothed value; NAN = no limit
+    float    hysteresis;      // how far back inside the band before clearing
+    float    maxRatePerMin;   // 0 = no rate alert
+    uint16_t stuckSec;        // 0 = no stuck alert
+};
+
+struct AlertLimits {
+    ChannelLimits ch[SensorHistory::CHANNEL_COUNT];
+};
+
+struct AlertEvent {
+    uint32_t seq;      // 1, 2, 3, ... since boot
+    uint32_t tSec;     // seconds since boot
+    float    value;    // smoothed value, or the slope for RATE
+    uint8_t  channel;
+    uint8_t  kind;
+    bool     raised;
+};
+
+struct ChannelStats {
+    uint32_t n;
+    float    mean, stddev;   // Welford, since boot
+    float    ewma;
+    float    ratePerMin;
+    uint32_t unchangedSec;
+};
+
+class SensorAnalytics {
+public:
+    static const uint8_t CHANNELS      = SensorHistory::CHANNEL_COUNT;
+    static const uint8_t RECENT_EVENTS = 16;
+    static constexpr float EWMA_ALPHA  = 0.2f;    // ~5 samples, 10 s at the 2 s cycle
+    static constexpr float RATE_ALPHA  = 0.1f;
+
+    struct State {
+        ChannelStats stats[CHANNELS];
+        uint8_t      active[CHANNELS];     // bit per AlertKind
+        AlertEvent   recent[RECENT_EVENTS];
+        uint32_t     events;               // total; recent[] holds the last few
+        uint32_t     raised;
+    };
+
+    SensorAnalytics();
+
+    // Config task.
+    void setLimits(const AlertLimits& limits) { limits_.write(limits); }
+    AlertLimits limits() const                { return limits_.read(); }
+
+    // I2C owner, once per acquisition, with the raw snapshot samples in
+    // SensorHistory channel order; tMs is the hal::millis() they were taken at.
+    void update(uint32_t tMs, const int32_t samples[CHANNELS]);
+
+    // Any task.
+    State state() const { return published_.read(); }
+
+    static const char* kindName(AlertKind k);
+    static size_t eventJson(const AlertEvent& e, char* buf, size_t cap);
+    // GET /alerts body: active alerts, recent events and per-channel stats.
+    static size_t stateJson(const State& s, char* buf, size_t cap);
+
+private:
+    struct Track {
+        uint32_t n;
+        float    mean, m2;
+        float    ewma, rate;
+        float    prevEwma;
+        uint32_t prevMs;
+        int32_t  lastSample;
+        uint32_t unchangedMs;
+    };
+
+    void check(uint8_t ch, const ChannelLimits& lim, uint32_t tSec);
+    void set(uint8_t ch, AlertKind k, bool on, float value, uint32_t tSec);
+
+    Track                track_[CHANNELS];
+    State                state_;
+    Seqlock<AlertLimits> limits_;
+    Seqlock<State>       published_;
+};
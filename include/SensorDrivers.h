@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "FixedPoint.h"
+#include "I2cEngine.h"
+
+// =====================================
+//  SPLIT-PHASE SENSOR DRIVERS
+// =====================================
+// Each driver is a state machine advanced by poll(). A step either hands a
+// transaction to the engine or waits for a conversion deadline, and never
+// sleeps. startCycle() kicks off one measurement; idle() turns true when
+// it has finished, and valid() tells whether it succeeded.
+
+class Bmp180Driver {
+public:
+    static const uint8_t ADDRESS = 0x77;
+
+    explicit Bmp180Driver(I2cEngine& engine, uint8_t oversampling = 3);
+
+    void startCycle();
+    void poll(uint32_t nowUs);
+
+    bool        idle() const        { return state_ == S_IDLE; }
+    bool        valid() const       { return valid_; }
+    DeciCelsius temperature() const { return DeciCelsius::fromRaw(tempDeci_); }
+    DeciHpa     pressure() const    { return DeciHpa::fromRaw((pressurePa_ + 5) / 10); }
+    // When the driver next needs poll() (0 = as soon as the engine finishes).
+    uint32_t wakeAtUs() const { return waitUntilUs_; }
+
+private:
+    enum State : uint8_t {
+        S_IDLE, S_CALIB,
+        S_T_START, S_T_CONVERT, S_T_READ,
+        S_P_START, S_P_CONVERT, S_P_READ
+    };
+
+    void    finish(bool ok);
+    int32_t computeB5(int32_t ut) const;
+    int32_t computePressure(int32_t up, int32_t b5) const;
+
+    I2cEngine&     engine_;
+    I2cTransaction txn_;
+    uint8_t        oss_;
+    State          state_;
+    bool           calibrated_;
+    bool           valid_;
+    uint32_t       waitUntilUs_;
+    int32_t        b5_;
+    int32_t        tempDeci_;
+    int32_t        pressurePa_;
+
+    int16_t  ac1_, ac2_, ac3_, b1_, b2_, mb_, mc_, md_;
+    uint16_t ac4_, ac5_, ac6_;
+};
+
+class Bh1750Driver {
+public:
+    static const uint8_t ADDRESS = 0x23;
+
+    explicit Bh1750Driver(I2cEngine& engine);
+
+    void startCycle();
+    void poll(uint32_t nowUs);
+
+    bool idle() const  { return state_ == S_IDLE; }
+    bool valid() const { return valid_; }
+    Lux  lux() const   { return Lux::fromRaw(lux_); }
+
+private:
+    enum State : uint8_t { S_IDLE, S_CONFIGURE, S_READ };
+
+    I2cEngine&     engine_;
+    I2cTransaction txn_;
+    State          state_;
+    bool           configured_;
+    bool           valid_;
+    int32_t        lux_;
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "Registry.h"
+
+// =====================================
+//  MULTI-RESOLUTION SENSOR HISTORY
+// =====================================
+// Three fixed rings per channel, all statically sized:
+//
+//   tier    period  slots  span   bytes (6 channels)
+//   RAW       2 s    450   15 min   450 * (4 + 6*2)  =  7.2 KB
+//   MINUTE   60 s    720   12 h     720 * (4 + 6*6)  = 28.8 KB
+//   HOUR   3600 s    168    7 d     168 * (4 + 6*6)  =  6.7 KB
+//
+// ~43 KB in .bss and nothing on the heap. Samples come in as the raw counts
+// of the SensorSnapshot fixed-point types and are stored as int16 in
+// per-channel units: the same scale, except lux in 2 lx steps. A sample updates the open minute and hour
+// accumulators in O(1); when a bucket closes its min/max/avg moves into the
+// ring and the oldest entry is overwritten.
+//
+// One writer (the sensor task) and any number of readers on other tasks.
+// Each tier's count is published with release after the slot is filled.
+// Readers check after copying that the slot has not been handed to a newer
+// entry, as a seqlock reader checks its sequence.
+
+class SensorHistory {
+public:
+    // One per HYDRO_SENSORS row, in its order.
+    enum Channel : uint8_t {
+#define HYDRO_CHANNEL_ID(id, ...) id,
+        HYDRO_SENSORS(HYDRO_CHANNEL_ID)
+#undef HYDRO_CHANNEL_ID
+        CHANNEL_COUNT
+    };
+    enum Tier    : uint8_t { RAW, MINUTE, HOUR, TIER_COUNT };
+
+    static const uint16_t RAW_SLOTS    = 450;
+    static const uint16_t MINUTE_SLOTS = 720;
+    static const uint16_t HOUR_SLOTS   = 168;
+
+    struct Point {
+        uint32_t t;            // seconds since boot (bucket start for rollups); never wraps
+        float    min, max, avg;
+    };
+
+    SensorHistory();
+
+    // Called once per acquisition with one raw sample per channel. tSec is
+    // uptime from the 64-bit monotonic clock: readers rely on it only ever
+    // growing, which seconds from the 32-bit millis() stop doing after 49.7 days.
+    void add(uint32_t tSec, const int32_t samples[CHANNEL_COUNT]);
+
+    // Entries are addressed by a sequence number that only ever grows.
+    // firstSeq() leaves out the oldest slot of a full ring, since add()
+    // overwrites it next. get() returns false when the entry was not yet
+    // written, or when the ring overtook it, even during the copy.
+    uint32_t firstSeq(Tier tier) const;
+    uint32_t endSeq(Tier tier) const { return written_[tier].load(std::memory_order_acquire); }
+    bool     get(Tier tier, Channel ch, uint32_t seq, Point& out) const;
+
+    static const char* channelName(Channel ch);
+    static bool        channelFromName(const char* name, Channel& out);
+    static const char* tierName(Tier tier);
+    static bool        tierFromName(const char* name, Tier& out);
+    static uint32_t    tierPeriod(Tier tier);
+    static uint8_t     channelDecimals(Channel ch);
+    static int32_t     sampleScale(Channel ch);   // raw sample counts per unit
+
+    // Per-channel storage units, shared with the flash log (SensorLog).
+    // encode() takes a raw snapshot sample, decode() gives the reading.
+    static int16_t encode(Channel ch, int32_t sample);
+    static float   decode(Channel ch, int16_t v);
+
+private:
+    struct Rollup { int16_t min, max, avg; };
+    struct Accum  { int32_t sum; int16_t min, max; uint16_t n; };
+
+    static uint16_t capacity(Tier tier);
+
+    void accumulate(Accum* acc, Channel ch, int16_t min, int16_t max, int32_t sum, uint16_t n);
+    void closeMinute();
+    void closeHour();
+
+    int16_t  raw_[RAW_SLOTS][CHANNEL_COUNT];
+    uint32_t rawT_[RAW_SLOTS];
+    Rollup   minute_[MINUTE_SLOTS][CHANNEL_COUNT];
+    uint32_t minuteT_[MINUTE_SLOTS];
+    Rollup   hour_[HOUR_SLOTS][CHANNEL_COUNT];
+    uint32_t hourT_[HOUR_SLOTS];
+
+    Accum    minuteAcc_[CHANNEL_COUNT];
+    Accum    hourAcc_[CHANNEL_COUNT];
+    uint32_t minuteStart_, hourStart_;
+
+    std::atomic<uint32_t> written_[TIER_COUNT];   // sensor task stores, any task loads
+};
+
+// =====================================
+//  STREAMING READER
+// =====================================
+// Formats one channel/tier window as JSON a chunk at a time, so an HTTP
+// response can be produced without ever holding the whole document:
+//   {"sensor":"ph","res":"1m","period":60,"points":[[t,min,max,avg],...]}
+// The raw tier emits [t,value] pairs.
+class HistoryReader {
+public:
+    HistoryReader(const SensorHistory& h, SensorHistory::Channel ch, SensorHistory::Tier tier,
+                  uint32_t fromSec, uint32_t toSec);
+
+    // Fills up to maxLen bytes; returns 0 once the document is complete.
+    size_t read(char* buf, size_t maxLen);
+
+private:
+    bool nextLine();
+
+    const SensorHistory&   h_;
+    SensorHistory::Channel ch_;
+    SensorHistory::Tier    tier_;
+    uint32_t from_, to_;
+    uint32_t seq_;
+    uint8_t  stage_;       // 0 header, 1 points, 2 footer, 3 done
+    bool     first_;
+    char     pending_[96];
+    uint8_t  pendingLen_, pendingPos_;
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "SensorHistory.h"
+
+// =====================================
+//  LOG STORAGE BACKEND
+// =====================================
+// A fixed set of segment files. LittleFS on the board, plain files in the
+// native simulator. Offsets are always block-aligned and a write never
+// extends a segment by more than one block.
+class LogStorage {
+public:
+    virtual ~LogStorage() {}
+    virtual uint32_t size(uint8_t segment) = 0;
+    virtual bool     read(uint8_t segment, uint32_t offset, uint8_t* buf, size_t len) = 0;
+    virtual bool     write(uint8_t segment, uint32_t offset, const uint8_t* buf, size_t len) = 0;
+    virtual bool     erase(uint8_t segment) = 0;   // truncate to empty
+};
+
+// =====================================
+//  COMPRESSED SENSOR LOG
+// =====================================
+// Append-only, in 512-byte blocks that decode on their own:
+//
+//   0  magic 'HL', version, sample count
+//   4  block sequence number (grows forever, orders blocks across segments)
+//   8  first timestamp (unix seconds)
+//  12  payload length, reserved
+//  16  CRC-32 of the block with this field zeroed
+//  20  first sample, CHANNEL_COUNT int16 codes (SensorHistory fixed point)
+//  32  payload: per further sample, the timestamp delta-of-delta as a
+//      zigzag varint, then each code XORed with the previous one as a varint
+//
+// A steady 60 s sample costs 7 bytes when nothing changed and 7-10 bytes
+// typically, so a block holds about an hour and 1 MB of flash holds two to
+// three months.
+//
+// Samples collect in a RAM block. flush() writes the open block in place, so
+// a power cut loses at most one flush interval. When the block is full the
+// writer moves on to the next one. Segments are filled round-robin and the
+// oldest is truncated before reuse, which spreads erases across the whole
+// log. begin() finds the newest valid block and resumes after it. Blocks
+// with a bad CRC, such as a torn final write, are skipped by readers and
+// overwritten by the writer.
+class SensorLog {
+public:
+    static const size_t   BLOCK_SIZE   = 512;
+    static const size_t   HEADER_SIZE  = 32;
+    static const uint8_t  MAX_SEGMENTS = 32;
+    static const uint8_t  CHANNELS     = SensorHistory::CHANNEL_COUNT;
+
+    struct Stats {
+        uint32_t samples;
+        uint32_t blocksWritten;
+        uint32_t writeErrors;
+        uint32_t tornBlocks;      // invalid blocks found by begin()
+    };
+
+    SensorLog(LogStorage& storage, uint8_t segments, uint16_t blocksPerSegment);
+
+    // Finds where to continue writing. Call once before append().
+    void begin();
+    // Adds one sample (raw snapshot counts, see SensorHistory::encode); may
+    // write a full block.
+    bool append(uint32_t unixSec, const int32_t samples[CHANNELS]);
+    // Writes the open block even if it is only partly full.
+    bool flush();
+
+    uint8_t      segments() const         { return segments_; }
+    uint16_t     blocksPerSegment() const { return blocksPerSegment_; }
+    LogStorage&  storage() const          { return storage_; }
+    const Stats& stats() const            { return stats_; }
+
+    // Validates a block read from storage and returns its sequence number.
+    static bool  checkBlock(const uint8_t* block, uint32_t& seq);
+
+private:
+    void     startBlock(uint32_t unixSec, const int16_t codes[CHANNELS]);
+    bool     writeBlock();
+    void     nextBlock();
+
+    LogStorage& storage_;
+    uint8_t     segments_;
+    uint16_t    blocksPerSegment_;
+    uint8_t     segment_;       // where the open block goes
+    uint16_t    blockIndex_;
+    uint32_t    seq_;
+    bool        dirty_;         // open block has samples not yet written
+
+    uint8_t     block_[BLOCK_SIZE];
+    uint16_t    payloadLen_;
+    uint8_t     count_;
+    uint32_t    lastT_;
+    int32_t     lastDt_;
+    int16_t     last_[CHANNELS];
+
+    Stats       stats_;
+};
+
+// =====================================
+//  STREAMING CSV EXPORT
+// =====================================
+// Walks the segments oldest first and decodes one block at a time, so the
+// RAM cost is one block plus a line whatever the range:
+//   time,bmpTemp,dhtHumidity,ds18b20,lux,ph,pressure
+//   2026-10-17T06:00:00Z,24.3,61.0,21.25,6400,5.87,1013.2
+// Covers what has been written to storage, i.e. up to one flush interval
+// behind the live sensors.
+class LogExporter {
+public:
+    LogExporter(const SensorLog& log, uint32_t fromSec, uint32_t toSec);
+
+    // Fills up to maxLen bytes; returns 0 once the document is complete.
+    size_t read(char* buf, size_t maxLen);
+
+private:
+    bool nextLine();
+    bool nextSample(uint32_t& t, int16_t codes[SensorLog::CHANNELS]);
+    bool loadBlock();
+
+    const SensorLog& log_;
+    uint32_t from_, to_;
+    uint8_t  order_[SensorLog::MAX_SEGMENTS];   // segments by first sequence number
+    uint8_t  orderCount_, orderPos_;
+    uint16_t blockIndex_;
+    uint32_t lastSeq_;
+    uint8_t  stage_;        // 0 header, 1 rows, 2 done
+
+    uint8_t  block_[SensorLog::BLOCK_SIZE];
+    uint16_t pos_, end_;
+    uint8_t  left_;         // samples still to decode in block_
+    bool     first_;
+    uint32_t t_;
+    int32_t  dt_;
+    int16_t  codes_[SensorLog::CHANNELS];
+
+    char     pending_[128];
+    uint8_t  pendingLen_, pendingPos_;
+};
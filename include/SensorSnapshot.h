@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "Registry.h"
+
+// One complete acquisition cycle, published as a unit by the sensor task.
+// Consumers always see all readings from the same cycle. Each reading is
+// fixed point in the unit and resolution the telemetry sends; the members
+// and their order come from HYDRO_SENSORS.
+struct SensorSnapshot {
+#define HYDRO_SNAPSHOT_FIELD(id, key, field, type, ...) type field;
+    HYDRO_SENSORS(HYDRO_SNAPSHOT_FIELD)
+#undef HYDRO_SNAPSHOT_FIELD
+    uint32_t takenAtMs;   // millis() when the cycle finished
+    uint32_t takenAtSec;  // ...as seconds since boot that never wrap; history time base
+};
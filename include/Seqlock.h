@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+// =====================================
+//  SINGLE-WRITER SEQLOCK
+// =====================================
+// One producer publishes a trivially copyable value; any number of readers
+// on other cores take consistent copies without locks and without ever
+// blocking the producer. The sequence is odd while a write is in progress;
+// a reader that sees it change retries.
+//
+// The payload is held as relaxed atomic words, so a read overlapping the
+// write is not a data race under the C++ memory model, and a host build can
+// hammer it from std::threads.
+
+template <typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock payload must be trivially copyable");
+    static const size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+public:
+    Seqlock() : seq_(0) {
+        for (size_t i = 0; i < WORDS; i++) words_[i].store(0, std::memory_order_relaxed);
+    }
+
+    // Producer only.
+    void write(const T& value) {
+        uint32_t buf[WORDS] = {};
+        memcpy(buf, &value, sizeof(T));
+
+        uint32_t s = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++) words_[i].store(buf[i], std::memory_order_relaxed);
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+    // Returns false if a write raced the copy; out is then unspecified.
+    bool tryRead(T& out) const {
+        uint32_t buf[WORDS];
+        uint32_t s1 = seq_.load(std::memory_order_acquire);
+        if (s1 & 1) return false;
+        for (size_t i = 0; i < WORDS; i++) buf[i] = words_[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) != s1) return false;
+        memcpy(&out, buf, sizeof(T));
+        return true;
+    }
+
+    T read() const {
+        T out;
+        while (!tryRead(out)) {}
+        return out;
+    }
+
+    // Number of completed writes; readers can use it to skip unchanged data.
+    uint32_t version() const { return seq_.load(std::memory_order_acquire) >> 1; }
+
+private:
+    std::atomic<uint32_t> seq_;
+    std::atomic<uint32_t> words_[WORDS];
+};
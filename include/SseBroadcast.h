@@ -0,0 +1,170 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "MpscQueue.h"
+#include "Seqlock.h"
+
+// =====================================
+//  SSE BROADCAST
+// =====================================
+// Fans /events out to many dashboards from fixed memory. Each event is
+// serialized once, as the bytes that go on the wire, into a ring of the
+// last RING frames that all clients share. A client is only a cursor into
+// that ring plus how far into the frame its socket has got, so ten or fifty
+// subscribers cost the same buffers as one.
+//
+// A client may fall at most CLIENT_QUEUE frames behind. Past that its
+// backlog is coalesced: the frames it has not started are dropped and it
+// gets one snapshot of the current state (from the KeyframeFn) instead, then
+// carries on from the newest frame. Snapshots are built into one of
+// KEYFRAMES buffers, reference-counted by the clients sending them, and
+// reused by every client that coalesces at the same point. If both are busy
+// the oldest frames are simply dropped (drop-oldest); the dashboard notices
+// the broken delta chain and resyncs on its own.
+//
+// A client that accepts no bytes for STALL_MS while it has something to
+// send, or that is still inside a frame when the ring wraps onto it, is
+// closed. New clients beyond MAX_CLIENTS are refused.
+//
+// Network callbacks only push into a lock-free inbox or bump an atomic.
+// publish() and pump() run on the control task, which owns everything else.
+// Once a second pump() publishes each client's lag through a seqlock for
+// /events/clients and /metrics.
+class SseBroadcaster {
+public:
+    // Hands bytes to the client's socket; returns how many it took (0 when
+    // its send buffer is full).
+    typedef size_t   (*WriteFn)(uint32_t client, const char* data, size_t len);
+    typedef void     (*CloseFn)(uint32_t client);
+    typedef uint32_t (*ClockFn)();   // milliseconds
+    // The current full state and its event id; 0 while there is none yet.
+    typedef uint32_t (*KeyframeFn)(const char*& data);
+
+    static const uint8_t  MAX_CLIENTS  = 64;
+    static const uint8_t  RING         = 32;    // power of two
+    static const uint8_t  CLIENT_QUEUE = 8;
+    static const uint8_t  KEYFRAMES    = 2;
+    static const size_t   FRAME_MAX    = 320;   // a telemetry snapshot plus the SSE fields
+    static const size_t   INBOX_DEPTH  = 128;   // every client leaving and rejoining between pumps
+    static const uint32_t STALL_MS     = 30000;
+    static const uint32_t TABLE_MS     = 1000;
+
+    static_assert((RING & (RING - 1)) == 0, "RING must be a power of two");
+    static_assert(CLIENT_QUEUE < RING, "a client's queue must fit in the ring");
+
+    struct Stats {
+        uint32_t frames;       // published
+        uint32_t bytes;        // handed to sockets
+        uint32_t oversized;    // events too big for FRAME_MAX, not sent
+        uint32_t coalesced;    // frames skipped for a snapshot
+        uint32_t dropped;      // frames skipped without one
+        uint32_t evicted;      // clients closed for stalling
+        uint32_t rejected;     // connections refused at MAX_CLIENTS
+        uint8_t  peakClients;
+    };
+
+    // Per connected client, for /events/clients.
+    struct ClientInfo {
+        uint32_t id;
+        uint32_t lagFrames;    // published but not fully sent
+        uint32_t lagMs;        // age of the oldest of them
+        uint32_t bytes;
+        uint32_t coalesced;
+    };
+
+    struct ClientTable {
+        uint8_t    count;
+        uint32_t   maxLagMs;
+        ClientInfo client[MAX_CLIENTS];
+    };
+
+    SseBroadcaster(WriteFn write, CloseFn close, ClockFn clock, KeyframeFn keyframe);
+
+    // ---------- network callbacks (any task, never block) ----------
+    // False at MAX_CLIENTS; the platform refuses the connection.
+    bool connected(uint32_t client, uint32_t lastEventId);
+    void disconnected(uint32_t client);
+    bool full() const { return admitted_.load(std::memory_order_relaxed) >= MAX_CLIENTS; }
+
+    // ---------- control task ----------
+    void publish(const char* event, const char* data, uint32_t id);
+    // Takes in connects and disconnects and writes what each socket accepts.
+    void pump();
+    // Some client still has frames to take, so pump() must run again.
+    bool backlog() const;
+
+    // ---------- any task ----------
+    uint8_t      clients() const     { return admitted_.load(std::memory_order_relaxed); }
+    const Stats& stats() const       { return stats_; }
+    ClientTable  clientTable() const { return table_.read(); }
+    uint32_t     maxLagMs() const    { return maxLagMs_; }
+
+    // GET /events/clients body.
+    static size_t clientsJson(const ClientTable& t, const Stats& s, char* buf, size_t cap);
+    // One SSE frame as it goes on the wire; 0 if it does not fit.
+    static size_t format(char* buf, size_t cap, const char* event, const char* data, uint32_t id);
+
+private:
+    enum InboxKind : uint8_t { IN_CONNECT, IN_DISCONNECT };
+
+    struct Inbound {
+        uint32_t client;
+        uint32_t lastId;
+        uint8_t  kind;
+    };
+
+    struct Frame {
+        char     text[FRAME_MAX];
+        uint16_t len;
+        uint32_t atMs;
+    };
+
+    struct Keyframe {
+        char     text[FRAME_MAX];
+        uint16_t len;
+        uint32_t head;     // built when this was the next sequence number
+        uint32_t id;       // of the state it holds
+        uint8_t  refs;     // clients part-way through it
+    };
+
+    struct Client {
+        uint32_t id;
+        uint32_t cursor;      // next frame to send
+        uint32_t lastId;      // from the connect; resolved on the first pump
+        uint32_t progressMs;  // last time the socket took bytes, or had nothing to take
+        uint32_t bytes;
+        uint32_t coalesced;
+        uint16_t offset;      // into the frame being sent
+        int8_t   key;         // keyframe being sent, -1 for none
+        bool     fresh;       // connected, not yet placed in the stream
+        bool     used;
+    };
+
+    Client* findClient(uint32_t id);
+    void    addClient(uint32_t id, uint32_t lastId);
+    void    dropClient(Client& c, bool close);
+    int8_t  acquireKeyframe();
+    void    resync(Client& c);
+    void    drain(Client& c, uint32_t now);
+    void    publishTable(uint32_t now);
+
+    WriteFn    write_;
+    CloseFn    close_;
+    ClockFn    clock_;
+    KeyframeFn keyframe_;
+
+    MpscQueue<Inbound, INBOX_DEPTH> inbox_;
+    std::atomic<uint8_t>            admitted_;
+    Frame    ring_[RING];
+    Keyframe keys_[KEYFRAMES];
+    Client   clients_[MAX_CLIENTS];
+    uint32_t head_;   // sequence number the next published frame gets
+    Stats    stats_;
+
+    Seqlock<ClientTable> table_;
+    uint32_t             tableMs_;
+    volatile uint32_t    maxLagMs_;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "Registry.h"
+
+// =====================================
+//  DELTA-ENCODED TELEMETRY (protocol 2)
+// =====================================
+// Every frame carries a monotonically increasing version which is also used
+// as the SSE event id, so a reconnecting browser reports the last version it
+// applied in Last-Event-ID.
+//
+//   event: snapshot   {"p":2,"v":41,"bmpTemp":243,...all fields}
+//   event: delta      {"v":42,"b":41,"ph":587}
+//
+// A delta only lists fields that moved beyond their deadband since the value
+// last sent, and applies on top of version "b". A client whose version does
+// not match "b" reconnects and receives a fresh snapshot.
+
+// Every sensor reading, then every relay state, then every auto mode, in
+// registry order.
+enum TelemetryField : uint8_t {
+#define HYDRO_TF_ID(id, ...) TF_##id,
+#define HYDRO_TF_AUTO(id, ...) TF_##id##_AUTO,
+    HYDRO_SENSORS(HYDRO_TF_ID)
+    HYDRO_ACTUATORS(HYDRO_TF_ID)
+    HYDRO_ACTUATORS(HYDRO_TF_AUTO)
+#undef HYDRO_TF_ID
+#undef HYDRO_TF_AUTO
+    TF_COUNT
+};
+
+// Longest frame: a delta header with two 10-digit versions, every field
+// with an int32 sensor value or a one-digit relay value, "}" and the NUL.
+// sizeof(key) counts the key and its NUL.
+#define HYDRO_TF_SENSOR_TEXT(id, key, ...) + sizeof(key) + 14   // ,"key":-2147483648
+#define HYDRO_TF_RELAY_TEXT(id, key, ...)  + sizeof(key) + 4 + sizeof(key "Auto") + 4
+static const size_t TELEMETRY_TEXT_MAX =
+    32 HYDRO_SENSORS(HYDRO_TF_SENSOR_TEXT) HYDRO_ACTUATORS(HYDRO_TF_RELAY_TEXT);
+#undef HYDRO_TF_SENSOR_TEXT
+#undef HYDRO_TF_RELAY_TEXT
+
+// Values are in wire units (deci-degrees, centi-pH, ...), as the dashboard expects.
+struct TelemetryFrame {
+    int32_t v[TF_COUNT];
+};
+
+class TelemetryEncoder {
+public:
+    static const uint8_t PROTOCOL     = 2;
+    static const size_t  MAX_FRAME    = TELEMETRY_TEXT_MAX;
+
+    TelemetryEncoder();
+
+    void setDeadband(TelemetryField f, int32_t units) { deadband_[f] = units; }
+    // Send a full snapshot every n updates so lost deltas heal; 0 disables.
+    void setKeyframeInterval(uint16_t n) { keyframeEvery_ = n; }
+
+    // Encodes the new frame into buf (at least MAX_FRAME bytes). Returns the
+    // length, 0 when nothing moved beyond its deadband, and whether it is a
+    // snapshot rather than a delta.
+    size_t update(const TelemetryFrame& frame, char* buf, size_t cap, bool& isSnapshot);
+
+    // Latest snapshot text, safe to read from another task: it is rebuilt into
+    // the inactive half of a double buffer and then published.
+    const char* snapshot() const { return snap_[active_]; }
+    uint32_t    version() const  { return version_; }
+
+    static const char* fieldName(TelemetryField f);
+    static size_t      encodeFull(const TelemetryFrame& frame, uint32_t version, char* buf, size_t cap);
+
+private:
+    TelemetryFrame    sent_;
+    int32_t           deadband_[TF_COUNT];
+    uint16_t          keyframeEvery_;
+    uint16_t          sinceKeyframe_;
+    bool              primed_;
+    volatile uint32_t version_;
+    char              snap_[2][MAX_FRAME];
+    volatile uint8_t  active_;
+};
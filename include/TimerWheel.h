@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+
+// =====================================
+//  HIERARCHICAL TIMER WHEEL
+// =====================================
+// Fixed-capacity one-shot timers on a whole-tick clock (seconds, for the
+// actuator schedules). Six levels of 64 slots cover the full 32-bit range.
+// A timer sits at the level of the highest 6-bit digit in which its deadline
+// differs from the current tick, so schedule() and cancel() are O(1) list
+// operations. When the clock crosses a slot boundary on an upper level, that
+// slot's timers cascade down a level.
+//
+// advance() jumps straight between ticks that have work, found from
+// per-level occupancy masks, so idle time costs nothing however far the
+// clock moves. nextDeadline() is that same tick: when the owner next has to
+// call advance(). It is the earliest deadline or, if sooner, the next
+// cascade.
+class TimerWheel {
+public:
+    typedef void (*Callback)(void* ctx, uint32_t arg);
+
+    static const uint16_t MAX_TIMERS = 256;
+    static const uint16_t NO_TIMER   = 0xFFFF;
+    static const uint32_t NEVER      = UINT32_MAX;
+
+    explicit TimerWheel(uint32_t now = 0);
+
+    // Fires fn(ctx, arg) once the clock reaches atTick. A deadline at or
+    // before now() fires on the next tick. NO_TIMER when the pool is full.
+    uint16_t schedule(uint32_t atTick, Callback fn, void* ctx, uint32_t arg);
+    // False if the timer already fired or was cancelled. Ids are reused once
+    // a timer is done, so only cancel ids you know are still pending.
+    bool     cancel(uint16_t id);
+    void     clear();
+
+    // Runs every timer due up to nowTick, in deadline order. Callbacks may
+    // schedule and cancel. Returns how many fired.
+    uint16_t advance(uint32_t nowTick);
+    uint32_t nextDeadline() const;
+
+    uint32_t now() const     { return now_; }
+    uint16_t pending() const { return pending_; }
+
+private:
+    static const uint8_t LEVELS    = 6;
+    static const uint8_t SLOT_BITS = 6;
+    static const uint8_t SLOTS     = 1 << SLOT_BITS;
+
+    struct Timer {
+        uint32_t at;
+        Callback fn;        // nullptr while free
+        void*    ctx;
+        uint32_t arg;
+        uint16_t prev, next;
+        uint8_t  level, slot;
+    };
+
+    void     link(uint16_t id);
+    void     unlink(uint16_t id);
+    void     release(uint16_t id);
+    uint16_t runTick(uint32_t tick);
+
+    Timer    timers_[MAX_TIMERS];
+    uint16_t heads_[LEVELS][SLOTS];
+    uint64_t occupied_[LEVELS];
+    uint16_t freeHead_;
+    uint16_t pending_;
+    uint32_t now_;
+};
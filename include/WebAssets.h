@@ -0,0 +1,314 @@
+// Generated by tools/build_web.py from web/ - do not edit.
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+struct WebAsset {
+    const char*    path;
+    const char*    contentType;
+    const char*    cacheControl;
+    const char*    etag;         // quoted, strong
+    const uint8_t* gzip;
+    size_t         gzipLen;
+};
+
+// app.css: 5261 bytes minified, 1718 bytes gzipped
+static const uint8_t WEB_APP_CSS_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xb5, 0x58, 0x6d, 0x6f, 0xdb, 0x36,
+    0x10, 0xfe, 0x2b, 0x02, 0x82, 0xc2, 0x56, 0x21, 0x09, 0x92, 0x22, 0x3b, 0xb2, 0xf4, 0xa5, 0xdd,
+    0x86, 0x61, 0xfd, 0xb0, 0x7e, 0x68, 0xd7, 0x01, 0xfb, 0x48, 0x4b, 0x94, 0xcd, 0x56, 0x22, 0x0d,
+    0x8a, 0x4a, 0x9c, 0x1a, 0xfe, 0xef, 0xbb, 0xa3, 0xa8, 0x37, 0xbf, 0x25, 0x6b, 0x31, 0x24, 0x31,
+    0x4c, 0x8a, 0x3a, 0x3e, 0x77, 0x7c, 0xee, 0xb9, 0x63, 0xde, 0x3a, 0x6f, 0x93, 0x64, 0x4d, 0x0b,
+    0x21, 0x29, 0x7e, 0x23, 0x85, 0xa2, 0xf2, 0xb0, 0x16, 0x7b, 0xb7, 0x66, 0xdf, 0x19, 0xdf, 0x24,
+    0x6b, 0x21, 0x73, 0x2a, 0x5d, 0x98, 0x49, 0x2b, 0x22, 0x37, 0x8c, 0x27, 0x7e, 0xba, 0x23, 0x79,
+    0x8e, 0xcf, 0xfc, 0x63, 0x22, 0x85, 0x50, 0x07, 0xd7, 0x5d, 0x6f, 0x92, 0x3b, 0x9f, 0xf8, 0x34,
+    0x88, 0x52, 0xd7, 0xcd, 0x88, 0xcc, 0x93, 0xbb, 0x20, 0x0a, 0x8a, 0x90, 0xc2, 0xb0, 0xb5, 0x00,
+    0x13, 0xf4, 0xde, 0x8f, 0x62, 0x98, 0x20, 0x59, 0x46, 0xb9, 0x82, 0x17, 0xfc, 0x2c, 0x5e, 0x2d,
+    0xfb, 0x89, 0x10, 0x4d, 0x14, 0xfe, 0xda, 0x87, 0x99, 0x27, 0x22, 0x79, 0x72, 0x57, 0xf8, 0x64,
+    0xe1, 0xe3, 0x30, 0x27, 0x7c, 0x83, 0x26, 0x68, 0x1c, 0x2d, 0xa2, 0x05, 0x4c, 0x28, 0xba, 0x07,
+    0x03, 0x59, 0x9c, 0x17, 0x05, 0x3e, 0xaf, 0x1a, 0x45, 0x61, 0xcb, 0x88, 0x2c, 0x97, 0x31, 0x8e,
+    0x0b, 0xc1, 0x95, 0xbb, 0xa5, 0x24, 0x4f, 0x66, 0x9f, 0xc8, 0xd7, 0x7c, 0x4b, 0x38, 0x9b, 0x39,
+    0xb3, 0x5f, 0xc8, 0x96, 0xd7, 0xd9, 0x56, 0xb2, 0x42, 0xc1, 0xe8, 0xb7, 0x0f, 0x1f, 0xad, 0xf7,
+    0x25, 0x78, 0xcb, 0x89, 0xa2, 0x30, 0xfe, 0x4c, 0x37, 0x82, 0x5a, 0x5f, 0x3e, 0xcc, 0x9c, 0x4f,
+    0x62, 0x2d, 0x94, 0x70, 0x66, 0x7f, 0xd0, 0xf2, 0x91, 0x2a, 0x96, 0x11, 0xeb, 0x23, 0x6d, 0x60,
+    0xc9, 0x7b, 0xc9, 0x48, 0xe9, 0xd4, 0x84, 0xd7, 0x6e, 0x4d, 0xc1, 0x4a, 0xb7, 0x51, 0x25, 0xb8,
+    0x48, 0x66, 0x9f, 0xb7, 0x44, 0x52, 0xeb, 0x2f, 0x9a, 0x6d, 0xad, 0x3f, 0x61, 0x62, 0xe6, 0x34,
+    0x4c, 0x3f, 0xa9, 0x77, 0x24, 0xa3, 0x60, 0xfe, 0x77, 0x33, 0xfd, 0x27, 0xe5, 0xa5, 0x70, 0x7e,
+    0x15, 0xbc, 0x16, 0x25, 0xa9, 0x01, 0x07, 0xfd, 0x4a, 0xfe, 0x6e, 0xac, 0xcf, 0x60, 0xd6, 0xac,
+    0xe8, 0xdf, 0x3a, 0xae, 0x45, 0xfe, 0x7c, 0x58, 0x93, 0xec, 0xdb, 0x46, 0x8a, 0x86, 0xe7, 0xc9,
+    0x23, 0x91, 0x73, 0x0c, 0xb6, 0x9d, 0x66, 0xa2, 0x14, 0xd2, 0x8c, 0x31, 0x18, 0x76, 0xaa, 0xa1,
+    0x14, 0xa4, 0x62, 0xe5, 0xb3, 0x99, 0xef, 0xa3, 0x60, 0xa7, 0x15, 0xe3, 0xf0, 0x8d, 0x6d, 0xb6,
+    0x2a, 0x09, 0x7c, 0xff, 0x71, 0x9b, 0x8a, 0x47, 0x2a, 0x8b, 0x52, 0x3c, 0xb9, 0xfb, 0x64, 0xcb,
+    0xf2, 0x9c, 0x72, 0xbd, 0x57, 0xc7, 0x84, 0x43, 0x06, 0xaf, 0xe2, 0x19, 0xcd, 0x66, 0xe9, 0x4e,
+    0xd4, 0x4c, 0x31, 0xc1, 0x93, 0x82, 0xed, 0x69, 0x9e, 0x32, 0x5e, 0x53, 0x05, 0x1c, 0x18, 0x50,
+    0xb9, 0xac, 0x22, 0x1b, 0x9a, 0x94, 0x8c, 0x53, 0x22, 0xdd, 0x8d, 0x24, 0x39, 0x83, 0x57, 0xe7,
+    0x72, 0xb3, 0x26, 0x73, 0xdf, 0x09, 0x7d, 0xdf, 0x09, 0x16, 0xbe, 0xe3, 0xf9, 0xf7, 0xb6, 0x15,
+    0xec, 0xf6, 0x8e, 0x92, 0xe0, 0xe9, 0x0e, 0x62, 0xc5, 0x15, 0x8e, 0x6d, 0xe7, 0xf4, 0xc5, 0x95,
+    0x9f, 0xd3, 0x8d, 0xf3, 0xda, 0xd7, 0xc7, 0x40, 0x80, 0xb2, 0x34, 0x89, 0xfc, 0xdd, 0xde, 0xc2,
+    0x0f, 0x40, 0xce, 0xc0, 0x0b, 0xe9, 0xd2, 0x47, 0x58, 0x5c, 0x27, 0x5c, 0x70, 0x9a, 0x7e, 0x77,
+    0x19, 0xcf, 0xe9, 0x1e, 0xa8, 0xdb, 0xfa, 0xdb, 0xf2, 0xfd, 0xbf, 0xb8, 0x9b, 0x48, 0xba, 0xa3,
+    0x44, 0x01, 0xff, 0xdd, 0x53, 0xe4, 0x96, 0x46, 0x3e, 0x42, 0x38, 0x41, 0x1b, 0x02, 0x7a, 0xe3,
+    0x15, 0xfe, 0x78, 0x7e, 0x64, 0x5f, 0x9c, 0x8b, 0x00, 0xbf, 0x7d, 0x13, 0xfc, 0x6a, 0xb5, 0x3a,
+    0xe2, 0xb9, 0x02, 0xf2, 0x1e, 0x6e, 0x0d, 0x44, 0xfd, 0xf6, 0x9c, 0x2a, 0xb1, 0x03, 0xb4, 0xdd,
+    0x42, 0x38, 0xeb, 0x09, 0x72, 0xdc, 0x29, 0x80, 0x80, 0x46, 0x10, 0x57, 0xc7, 0x5b, 0x85, 0x6d,
+    0xf4, 0x72, 0x29, 0x76, 0x6e, 0xc1, 0x30, 0x17, 0x92, 0x75, 0xd9, 0xc8, 0x79, 0x10, 0xea, 0xc0,
+    0x76, 0x99, 0xaf, 0x94, 0xa8, 0x12, 0x88, 0xb5, 0x05, 0x8c, 0x65, 0xb9, 0x65, 0x48, 0xa8, 0x9f,
+    0xda, 0x83, 0x16, 0x58, 0x21, 0x00, 0x4f, 0x73, 0x56, 0xef, 0x4a, 0xf2, 0x9c, 0x14, 0x25, 0xdd,
+    0xa7, 0xa4, 0x64, 0x1b, 0xee, 0x32, 0x45, 0xab, 0x3a, 0xc1, 0x0c, 0xa7, 0x32, 0xfd, 0xda, 0x00,
+    0xd0, 0xe2, 0xd9, 0xed, 0x22, 0xae, 0x79, 0xee, 0xae, 0xa9, 0x7a, 0xa2, 0x94, 0xa7, 0x86, 0xa2,
+    0x4b, 0xd8, 0xff, 0xe8, 0x95, 0x62, 0x23, 0x0e, 0x9a, 0xc3, 0xfa, 0x5c, 0x03, 0xef, 0x7e, 0x21,
+    0x69, 0xd5, 0xf2, 0xfc, 0xa9, 0x5d, 0xf8, 0x00, 0xfe, 0x95, 0x54, 0x61, 0x9c, 0xd0, 0x10, 0xe2,
+    0xf0, 0x82, 0x10, 0x16, 0x61, 0x4a, 0xb8, 0x3a, 0xf8, 0x40, 0xe7, 0x2a, 0x69, 0x76, 0x3b, 0x2a,
+    0x33, 0x52, 0xd3, 0x49, 0xde, 0xb4, 0xb2, 0x63, 0xb7, 0x3b, 0x59, 0x60, 0x80, 0x1f, 0xae, 0xa4,
+    0x95, 0xd9, 0x0e, 0xc4, 0xe8, 0xe8, 0xb5, 0x81, 0x77, 0x25, 0xce, 0x1c, 0x5e, 0x72, 0x77, 0x43,
+    0x76, 0x49, 0x0c, 0x61, 0x19, 0xdc, 0xf0, 0x62, 0xed, 0xc5, 0x78, 0x23, 0xad, 0x5e, 0x57, 0x13,
+    0x18, 0xd5, 0x00, 0x30, 0xd6, 0x8a, 0xa8, 0xa6, 0x76, 0x73, 0x90, 0xdb, 0x27, 0x96, 0xab, 0x2d,
+    0x9c, 0x2d, 0xd8, 0xed, 0x73, 0x1a, 0xbe, 0x9b, 0xf3, 0x42, 0x32, 0x36, 0x35, 0x60, 0x7d, 0x93,
+    0x9e, 0x29, 0x87, 0xf1, 0x38, 0xd5, 0xfa, 0xbe, 0x25, 0xb9, 0x78, 0x82, 0x73, 0xf3, 0x2d, 0x40,
+    0x68, 0x4d, 0x17, 0x80, 0x60, 0x56, 0x44, 0xf3, 0x6a, 0xd7, 0x94, 0x35, 0xb5, 0xc2, 0xda, 0x62,
+    0xbc, 0x60, 0x1c, 0x9c, 0xeb, 0x8f, 0x98, 0x71, 0xe4, 0xbf, 0xbb, 0x2e, 0x45, 0xf6, 0xcd, 0xd4,
+    0x86, 0x36, 0x2a, 0xe8, 0xf1, 0x18, 0xb0, 0x27, 0x8a, 0xe2, 0x5c, 0xc5, 0x5a, 0x4d, 0xbf, 0x81,
+    0xa5, 0x5b, 0x30, 0x60, 0xc1, 0x24, 0x38, 0xbe, 0xfb, 0x46, 0x9f, 0x0b, 0x49, 0x2a, 0x5a, 0x5b,
+    0x1a, 0xdb, 0xc1, 0x7f, 0xe3, 0x00, 0xcf, 0xdf, 0x1c, 0x04, 0x32, 0x40, 0x3d, 0x27, 0xc1, 0x71,
+    0x31, 0x1a, 0x79, 0xd1, 0xf1, 0x58, 0x11, 0xc6, 0x87, 0x4c, 0x91, 0xb4, 0x04, 0x73, 0x8f, 0x43,
+    0x3a, 0x05, 0x80, 0x7e, 0xef, 0x9a, 0xa8, 0x86, 0x31, 0xc6, 0xb2, 0x2b, 0x75, 0x16, 0x69, 0x94,
+    0xe8, 0x39, 0x7e, 0x0f, 0xbc, 0xb4, 0x42, 0xd4, 0x97, 0xa5, 0xaf, 0x5d, 0xa4, 0x19, 0x5a, 0x74,
+    0x15, 0x53, 0x25, 0x1d, 0x51, 0xd5, 0x7b, 0xc0, 0x23, 0x3e, 0x25, 0xe6, 0xab, 0x79, 0x69, 0xf8,
+    0x60, 0x42, 0xda, 0xe5, 0xdf, 0x72, 0x38, 0xe2, 0x92, 0x16, 0x2a, 0x09, 0x4f, 0x12, 0xb2, 0x3b,
+    0x3a, 0x03, 0xb6, 0x5d, 0x14, 0x18, 0x9c, 0x50, 0x6c, 0x50, 0xa7, 0x58, 0xde, 0x33, 0x16, 0x07,
+    0x29, 0x7e, 0x00, 0xcf, 0x2b, 0x98, 0x51, 0x14, 0x72, 0xb2, 0x6c, 0x2a, 0x5e, 0x1b, 0x81, 0x9b,
+    0xa3, 0xeb, 0x28, 0x0b, 0xa5, 0x03, 0xd5, 0x03, 0x22, 0x34, 0x07, 0x2d, 0x06, 0xb9, 0x0a, 0x0a,
+    0x69, 0xdb, 0x9a, 0xd8, 0x1a, 0xd2, 0x14, 0x65, 0xa4, 0xf7, 0xc3, 0x06, 0xe0, 0xfc, 0xc0, 0x71,
+    0xb6, 0x53, 0x95, 0xab, 0x72, 0x32, 0x25, 0xb1, 0xe6, 0x75, 0x17, 0xfd, 0xb0, 0x8b, 0x7e, 0x7a,
+    0x7e, 0x94, 0x5d, 0x39, 0x33, 0xc5, 0x2c, 0xd5, 0x21, 0x6e, 0xd7, 0x18, 0x8b, 0x3a, 0xc0, 0x96,
+    0x17, 0x2e, 0x6a, 0xa7, 0x8f, 0x3f, 0x0c, 0xeb, 0x16, 0xed, 0xcd, 0xc2, 0x47, 0xd6, 0x80, 0x14,
+    0xce, 0xc4, 0x88, 0xab, 0x0e, 0xac, 0x9f, 0xb6, 0x54, 0xf7, 0xbb, 0x14, 0x0c, 0xf1, 0x78, 0x06,
+    0x97, 0x2f, 0x17, 0xb5, 0x71, 0x69, 0x98, 0x9c, 0xda, 0xf8, 0x89, 0x9d, 0x76, 0xdc, 0xf5, 0xc7,
+    0x7e, 0x98, 0x49, 0xcb, 0xbb, 0xef, 0x30, 0x6f, 0xd1, 0xeb, 0xc3, 0xd8, 0xbf, 0x93, 0x34, 0x1f,
+    0x88, 0xa6, 0xbf, 0xe1, 0x21, 0xff, 0x33, 0x77, 0x51, 0xdc, 0xc7, 0x16, 0x7a, 0xdf, 0x87, 0x04,
+    0xd2, 0x4f, 0xdd, 0x92, 0xac, 0x69, 0xf9, 0x22, 0xad, 0x83, 0xe5, 0xcf, 0xf1, 0x3a, 0xea, 0x18,
+    0xe3, 0x3e, 0x92, 0xb2, 0x31, 0x69, 0x74, 0x45, 0x06, 0x47, 0x3a, 0x1a, 0x7a, 0xe1, 0xa5, 0x6a,
+    0x70, 0x1e, 0x06, 0x28, 0x72, 0x5a, 0xa7, 0x3a, 0xa9, 0x1c, 0xc7, 0xd4, 0x90, 0x22, 0x32, 0x11,
+    0xf5, 0x48, 0x49, 0xa5, 0xba, 0x14, 0x51, 0xa3, 0x45, 0xe3, 0x65, 0xd6, 0x18, 0xf4, 0xd5, 0xb5,
+    0x6e, 0x03, 0x9a, 0xf9, 0x5a, 0x9f, 0xbc, 0xf8, 0x4a, 0x69, 0x30, 0x21, 0x43, 0xfe, 0x2d, 0xfb,
+    0x70, 0x31, 0xe0, 0xea, 0xe1, 0x32, 0x49, 0x03, 0xac, 0x39, 0x2d, 0x41, 0x83, 0x69, 0xf9, 0x09,
+    0xbc, 0x08, 0xf7, 0xe8, 0xd5, 0x31, 0x88, 0x8f, 0x1e, 0x66, 0xd1, 0xf3, 0xcf, 0xab, 0x43, 0x3c,
+    0x55, 0x87, 0x50, 0x4b, 0x41, 0x6b, 0xfb, 0x7f, 0x12, 0x04, 0x6c, 0x38, 0x6e, 0x65, 0xfa, 0x78,
+    0x7b, 0x8f, 0x64, 0xa8, 0x14, 0xd3, 0xc3, 0x3d, 0x6d, 0x32, 0xa3, 0x85, 0xdd, 0xbd, 0x63, 0xfa,
+    0xab, 0x9f, 0xeb, 0x67, 0x4e, 0xa8, 0x1e, 0x0f, 0x11, 0xe1, 0x50, 0xc0, 0x26, 0xcd, 0x4d, 0xf0,
+    0x9a, 0xde, 0xc6, 0xbf, 0x95, 0x6b, 0x9d, 0xe9, 0x35, 0xc9, 0x37, 0xaf, 0x4e, 0x23, 0x6f, 0xa9,
+    0x39, 0xd7, 0x57, 0x38, 0x38, 0x85, 0x0b, 0xcd, 0x84, 0x56, 0xdd, 0x31, 0xb8, 0xe5, 0x25, 0x70,
+    0x0b, 0x5a, 0x4d, 0x30, 0x78, 0xc0, 0xcf, 0xd3, 0xee, 0x73, 0x14, 0xec, 0x20, 0xb4, 0x2f, 0xb5,
+    0x63, 0xe7, 0x84, 0x38, 0x7d, 0xf1, 0xde, 0x3e, 0xd9, 0x66, 0xda, 0x5e, 0xe8, 0xe5, 0xe1, 0x7d,
+    0xe8, 0x2c, 0x57, 0xf8, 0xeb, 0x05, 0xfe, 0x74, 0x9f, 0xa1, 0xf1, 0xb8, 0xb4, 0xcf, 0xe8, 0xc5,
+    0x61, 0x1f, 0x3c, 0x5d, 0x29, 0xca, 0x7a, 0x4a, 0x07, 0x5d, 0x03, 0x75, 0x64, 0x60, 0xe4, 0x3e,
+    0x49, 0x18, 0xe2, 0xc7, 0xd1, 0x5b, 0x2b, 0x7e, 0xc0, 0x39, 0xec, 0x2c, 0xe0, 0xf8, 0xdb, 0xce,
+    0x22, 0x1e, 0x53, 0x37, 0xc0, 0x5d, 0x75, 0x6a, 0x1a, 0x14, 0xba, 0xbf, 0x9f, 0x06, 0xfd, 0xa1,
+    0x8b, 0xf9, 0xb5, 0x4b, 0xdd, 0x58, 0x38, 0xe2, 0x53, 0xfa, 0x5c, 0x3c, 0xa1, 0xf8, 0xa6, 0x54,
+    0x37, 0x12, 0xba, 0x84, 0xc4, 0x5c, 0x3c, 0x26, 0x89, 0xd5, 0x07, 0x17, 0x2b, 0xe6, 0xb8, 0x7e,
+    0x06, 0x50, 0x4e, 0x87, 0x06, 0xae, 0xad, 0xa7, 0xe0, 0x7d, 0x62, 0x92, 0x6d, 0xd8, 0xa6, 0xce,
+    0x40, 0x34, 0xe7, 0xde, 0xea, 0xc1, 0xd6, 0x0b, 0xdc, 0x17, 0xa8, 0xb1, 0xf8, 0x41, 0x6a, 0x44,
+    0xbd, 0xf9, 0xae, 0x3a, 0x5e, 0xdf, 0x24, 0x8c, 0xcf, 0x9a, 0x4f, 0x2c, 0x46, 0x67, 0x36, 0xc3,
+    0xce, 0xe6, 0x0b, 0x34, 0x0b, 0x7f, 0x94, 0x66, 0x8b, 0x61, 0x83, 0x2b, 0xa8, 0x47, 0xab, 0xc3,
+    0xe8, 0x06, 0xea, 0x31, 0x9c, 0xd8, 0x58, 0x45, 0xa1, 0x3e, 0x37, 0x18, 0x81, 0x73, 0xcb, 0x85,
+    0x73, 0x21, 0x0d, 0xf1, 0x5f, 0x2f, 0x57, 0x51, 0x0f, 0xaf, 0x01, 0xea, 0xb4, 0xbb, 0x88, 0xc0,
+    0x55, 0x43, 0xd3, 0xbd, 0xc1, 0xcb, 0xf2, 0xb8, 0x58, 0x69, 0xc1, 0xeb, 0x40, 0x5c, 0xf3, 0x6d,
+    0xb0, 0x19, 0x46, 0x23, 0xcc, 0x46, 0xb0, 0x5f, 0xc4, 0x1f, 0x86, 0xe7, 0x01, 0xf1, 0xfb, 0x80,
+    0x8c, 0xd6, 0x81, 0x6d, 0x5d, 0xb4, 0xce, 0xdb, 0x9a, 0xf0, 0xe5, 0xb2, 0x8b, 0x57, 0xe2, 0x9b,
+    0x37, 0xb4, 0x36, 0xaf, 0x74, 0x85, 0x30, 0xb5, 0xe1, 0x78, 0x57, 0x92, 0x5a, 0x7d, 0xd9, 0xe5,
+    0x50, 0x3d, 0xf3, 0x57, 0xeb, 0xf1, 0x55, 0x30, 0x23, 0xfb, 0xba, 0xb2, 0x8f, 0xd1, 0xe1, 0xc5,
+    0xe4, 0xf8, 0xae, 0xa2, 0x39, 0x23, 0xd6, 0x7c, 0xb8, 0xcc, 0x2c, 0xb1, 0x61, 0xb7, 0x0f, 0xdd,
+    0xbf, 0x0a, 0xfa, 0x9b, 0x3a, 0x36, 0xee, 0xe6, 0x52, 0xd4, 0x95, 0x52, 0x8c, 0x98, 0xe6, 0xd1,
+    0xc2, 0xbf, 0xd4, 0x8f, 0x99, 0x22, 0x85, 0x2a, 0x33, 0xbd, 0x4e, 0x5c, 0xee, 0x11, 0xa0, 0x0b,
+    0xb0, 0xe0, 0xaf, 0x55, 0xc8, 0x70, 0xa8, 0x7a, 0xb7, 0x5f, 0x39, 0x1e, 0xff, 0x05, 0xd0, 0xd3,
+    0x5c, 0x01, 0x8d, 0x14, 0x00, 0x00,
+};
+
+// app.js: 4520 bytes minified, 1799 bytes gzipped
+static const uint8_t WEB_APP_JS_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x95, 0x57, 0x6d, 0x53, 0xdb, 0x38,
+    0x10, 0xfe, 0xce, 0xaf, 0x10, 0x7c, 0xa8, 0xed, 0xa9, 0x6b, 0x02, 0xd7, 0xde, 0x30, 0x50, 0xe8,
+    0xa4, 0x21, 0xdc, 0x71, 0x07, 0x84, 0x21, 0x69, 0xfb, 0x21, 0x93, 0xb9, 0x51, 0x2c, 0x39, 0x71,
+    0x91, 0x2d, 0x9f, 0x25, 0x13, 0x32, 0x34, 0xf7, 0xdb, 0x6f, 0x57, 0xb2, 0x1d, 0x3b, 0xbc, 0x94,
+    0x4e, 0x3b, 0x83, 0xbc, 0xda, 0x5d, 0xed, 0x3e, 0xfb, 0x9a, 0x50, 0xa6, 0x4a, 0x93, 0x61, 0xff,
+    0x6a, 0x38, 0xb8, 0x19, 0x92, 0x63, 0x32, 0x7e, 0xd8, 0xb9, 0xe5, 0xcb, 0x9d, 0x43, 0xb2, 0x33,
+    0x4d, 0xb2, 0x11, 0x4f, 0xb2, 0x1d, 0x9f, 0xec, 0xa8, 0x90, 0x0a, 0x0e, 0xb4, 0xbd, 0x0e, 0x7c,
+    0x30, 0x1e, 0xc6, 0x09, 0x15, 0x0a, 0xbf, 0x57, 0x3e, 0xa9, 0xf9, 0xd9, 0x5c, 0xff, 0x59, 0x24,
+    0x31, 0x8b, 0xf5, 0xf2, 0xf5, 0x32, 0x6a, 0xef, 0x60, 0xba, 0xdf, 0x69, 0xf3, 0x6f, 0x08, 0xec,
+    0x37, 0x05, 0x44, 0x71, 0xdf, 0x62, 0x6e, 0xb3, 0x76, 0x9a, 0xac, 0xd9, 0xfc, 0xf5, 0x6a, 0xb3,
+    0x9c, 0x2b, 0x55, 0xe4, 0xfc, 0x65, 0xc3, 0x27, 0x47, 0x5b, 0xa1, 0x81, 0xeb, 0xb4, 0xff, 0xf5,
+    0xbc, 0xd7, 0x37, 0x70, 0xed, 0x24, 0x52, 0xcb, 0x1c, 0xe5, 0x44, 0x3c, 0x9b, 0x6b, 0x3c, 0x44,
+    0x34, 0xdd, 0xa9, 0x59, 0x99, 0xd4, 0x84, 0x00, 0x23, 0x93, 0x61, 0x91, 0xf0, 0x54, 0x07, 0x33,
+    0xae, 0xfb, 0x82, 0xe3, 0xf1, 0xf3, 0xf2, 0x9c, 0xb9, 0x0e, 0xb0, 0xa5, 0xa7, 0x52, 0x3b, 0x5e,
+    0x25, 0x21, 0xe8, 0x94, 0x8b, 0x9f, 0x49, 0x5c, 0x20, 0x13, 0xca, 0x08, 0xae, 0x09, 0xbf, 0xd3,
+    0x43, 0x59, 0xe4, 0x21, 0x07, 0xa9, 0xb4, 0x10, 0xc2, 0x52, 0x95, 0xa6, 0x9a, 0x13, 0x62, 0x5e,
+    0xb7, 0xd4, 0xa8, 0x48, 0x43, 0x1d, 0xcb, 0x94, 0xa0, 0x06, 0x1e, 0x6a, 0xd7, 0x23, 0x0f, 0x5b,
+    0x2d, 0x61, 0xbe, 0x20, 0xfd, 0x3b, 0x78, 0xc8, 0x52, 0x5c, 0x67, 0x97, 0xe3, 0x97, 0xc2, 0x87,
+    0x6a, 0xbe, 0x40, 0xa6, 0x32, 0xe3, 0x29, 0xb0, 0x83, 0xfc, 0xf1, 0x09, 0xa8, 0x00, 0x1f, 0x83,
+    0x50, 0x50, 0xa5, 0x2e, 0x62, 0xa5, 0x83, 0x9c, 0x27, 0xf2, 0x0e, 0x64, 0x65, 0x14, 0x19, 0x03,
+    0xd1, 0xd2, 0x40, 0xf3, 0x7b, 0xdd, 0x93, 0xa9, 0x06, 0x6d, 0x20, 0xe8, 0xf4, 0xac, 0x01, 0x9c,
+    0x39, 0x47, 0x5b, 0xab, 0xb6, 0x6e, 0x9e, 0xe7, 0x32, 0x7f, 0x56, 0x39, 0x65, 0xec, 0x65, 0xcd,
+    0xa7, 0xb1, 0x0a, 0x9f, 0x53, 0x0e, 0xc2, 0xc6, 0x3b, 0xd4, 0xc4, 0xe1, 0x21, 0xd7, 0x51, 0x29,
+    0xcd, 0xd4, 0x1c, 0xd0, 0xf7, 0x09, 0xb7, 0xcf, 0x95, 0x51, 0x03, 0x55, 0x7f, 0x0d, 0x07, 0x57,
+    0x41, 0x46, 0x73, 0xc5, 0x5d, 0x1e, 0x30, 0xaa, 0x29, 0x3c, 0x19, 0x47, 0xc4, 0x65, 0x41, 0x46,
+    0xb6, 0x8f, 0x8f, 0xc9, 0xbe, 0x47, 0x72, 0xae, 0x8b, 0x3c, 0xb5, 0x64, 0x0b, 0xf7, 0x9b, 0x37,
+    0x84, 0x05, 0x77, 0xe6, 0xde, 0x10, 0xe0, 0xfc, 0x96, 0xec, 0x79, 0x44, 0x48, 0xca, 0xba, 0x82,
+    0xe7, 0x5a, 0xb9, 0xa0, 0xc6, 0xf2, 0x42, 0x88, 0x8f, 0xb6, 0x72, 0x9e, 0x32, 0xb0, 0xc4, 0x50,
+    0xe0, 0x66, 0xe5, 0xbd, 0x6c, 0x30, 0xe3, 0x42, 0xd3, 0x5f, 0xb1, 0x76, 0xdb, 0xbe, 0xf5, 0xe3,
+    0x07, 0xd8, 0x35, 0x6d, 0xda, 0x05, 0xb1, 0x07, 0xfb, 0xd5, 0x32, 0x0d, 0xc1, 0xa2, 0xca, 0x13,
+    0xb2, 0xda, 0x1a, 0x4c, 0xbf, 0x03, 0x78, 0x01, 0x00, 0x1e, 0xcf, 0x52, 0x6b, 0x97, 0x4f, 0x98,
+    0xf7, 0xcb, 0x96, 0x52, 0xf4, 0x76, 0xd3, 0x52, 0xfa, 0x8c, 0xa5, 0xf6, 0x16, 0x8a, 0x11, 0xee,
+    0x69, 0xa0, 0x78, 0xaa, 0x20, 0x07, 0xde, 0x12, 0x07, 0xfe, 0xbd, 0x05, 0xc2, 0x6d, 0x9c, 0x32,
+    0xeb, 0x0e, 0x5c, 0x5a, 0xec, 0xc0, 0x11, 0x27, 0xa7, 0xb1, 0x82, 0x28, 0x7b, 0xc4, 0xbc, 0xa5,
+    0x4c, 0x72, 0x80, 0x0e, 0x70, 0x87, 0x0b, 0xc5, 0x2b, 0x2a, 0x40, 0xc6, 0x35, 0xb7, 0x17, 0xa5,
+    0x13, 0xeb, 0x48, 0xa0, 0x17, 0xed, 0xd8, 0xac, 0x2a, 0x53, 0x0d, 0xa5, 0x2c, 0x8a, 0x21, 0xd7,
+    0x78, 0x57, 0x17, 0x50, 0x53, 0x04, 0x9c, 0x8b, 0xb8, 0x0e, 0xe7, 0x50, 0x2d, 0x56, 0xc6, 0xf1,
+    0x02, 0x3d, 0xe7, 0xa9, 0x9b, 0xa3, 0xe7, 0x79, 0xf0, 0x5d, 0xc9, 0xd4, 0xf5, 0x4a, 0x1a, 0xb3,
+    0x68, 0x94, 0xa6, 0x85, 0x82, 0xd3, 0x1c, 0x15, 0xb3, 0x80, 0x82, 0xe2, 0x3b, 0x1e, 0x44, 0x32,
+    0xef, 0x53, 0xd0, 0x45, 0x91, 0xaf, 0xe1, 0xd6, 0x33, 0xa0, 0x78, 0x4f, 0xba, 0x14, 0x84, 0x14,
+    0xed, 0x29, 0x2b, 0x68, 0x65, 0x9c, 0xaa, 0x4d, 0x6f, 0xb3, 0x9b, 0x02, 0x2b, 0xfb, 0xcc, 0xbf,
+    0x05, 0xcf, 0x97, 0x43, 0x40, 0x2b, 0x84, 0x8e, 0xd6, 0x15, 0xc2, 0x75, 0x40, 0x51, 0xce, 0xde,
+    0xdd, 0x51, 0x51, 0x70, 0x70, 0xaa, 0xb2, 0x0d, 0xbb, 0xd3, 0x3a, 0xa4, 0x68, 0x06, 0xc2, 0x34,
+    0x0e, 0x82, 0xc0, 0x1a, 0x3c, 0x09, 0xa2, 0x58, 0x68, 0xc8, 0x81, 0x5b, 0xe4, 0xbb, 0xc5, 0x88,
+    0x01, 0xf5, 0x5b, 0xac, 0x51, 0x34, 0x88, 0x99, 0xf5, 0x01, 0x10, 0x49, 0x68, 0x56, 0xf3, 0x64,
+    0x22, 0xd6, 0x2e, 0x92, 0xc7, 0x7b, 0x13, 0xcc, 0x2c, 0x81, 0x29, 0x02, 0x56, 0x95, 0x9d, 0xaf,
+    0xd1, 0x02, 0xb4, 0x9c, 0xcd, 0x04, 0x5f, 0x27, 0x98, 0x31, 0x20, 0x10, 0x3c, 0x9d, 0xe9, 0x39,
+    0x39, 0x21, 0x9d, 0xa7, 0xa4, 0x75, 0xac, 0x05, 0x16, 0x5c, 0x8b, 0xf7, 0x13, 0x71, 0x0c, 0x0c,
+    0x87, 0x06, 0x50, 0x7b, 0xf5, 0x5d, 0xc6, 0xa9, 0x0b, 0x4a, 0x21, 0xa9, 0x80, 0xec, 0xd8, 0x04,
+    0x69, 0xa1, 0x67, 0x2b, 0x06, 0xdc, 0xaf, 0x8a, 0xd8, 0xf6, 0xd6, 0x75, 0x29, 0x84, 0x42, 0x42,
+    0x6a, 0xdb, 0xa4, 0xb6, 0x5d, 0xb6, 0x4c, 0xaa, 0xea, 0x63, 0x23, 0x14, 0x2e, 0x43, 0x6d, 0xe5,
+    0x04, 0xae, 0x41, 0x56, 0x88, 0x8b, 0x82, 0xb4, 0x53, 0x01, 0x64, 0xae, 0x0f, 0x6d, 0x67, 0x6c,
+    0x4e, 0x13, 0xb2, 0x4b, 0x54, 0x60, 0x66, 0x14, 0xa4, 0x94, 0x3c, 0x8b, 0xef, 0x39, 0x73, 0x31,
+    0xc9, 0xed, 0x9c, 0xf2, 0x30, 0x23, 0xca, 0xf1, 0x54, 0xeb, 0x4a, 0x69, 0xc2, 0x4b, 0x75, 0x37,
+    0x5c, 0xd0, 0xa5, 0x21, 0x40, 0x51, 0x8f, 0xf1, 0xef, 0xa4, 0x3a, 0x60, 0x58, 0xba, 0x85, 0x96,
+    0xce, 0x04, 0x75, 0x3c, 0x3b, 0x7d, 0x20, 0x0e, 0xfa, 0x4b, 0x06, 0x75, 0x8b, 0x95, 0xd7, 0xee,
+    0xbe, 0x5b, 0xce, 0x05, 0x5c, 0x92, 0xc2, 0xde, 0x5a, 0x58, 0xb1, 0x7a, 0x4e, 0xe1, 0xd3, 0x45,
+    0x6b, 0x2f, 0x24, 0xda, 0x3d, 0x8a, 0x13, 0x3e, 0xd4, 0x79, 0x9c, 0xce, 0xdc, 0x36, 0xb8, 0xe8,
+    0x6e, 0xcc, 0x7c, 0x02, 0x09, 0xe7, 0xd5, 0xf9, 0xf5, 0xe2, 0x2c, 0x8c, 0x59, 0xd9, 0xe6, 0x38,
+    0x48, 0x3c, 0x1a, 0x06, 0xa0, 0x67, 0x53, 0x7f, 0xd3, 0xff, 0xb2, 0xb7, 0x51, 0xf0, 0x79, 0xfd,
+    0xdc, 0x94, 0xb2, 0x59, 0x35, 0x35, 0x9f, 0x7b, 0xb5, 0x42, 0xeb, 0x33, 0xf2, 0xae, 0x07, 0x37,
+    0x16, 0x0b, 0x79, 0xa5, 0x68, 0x0f, 0x78, 0xd7, 0x92, 0x68, 0xc2, 0x67, 0x9d, 0xbe, 0x4a, 0xb2,
+    0x6b, 0x79, 0xdb, 0xc2, 0x17, 0x3f, 0xd9, 0x19, 0x9a, 0xc2, 0xf5, 0xea, 0x80, 0xb8, 0x19, 0x77,
+    0x71, 0x14, 0x98, 0xc3, 0x06, 0x7e, 0x36, 0xc3, 0xa1, 0x4c, 0x06, 0x57, 0x0e, 0x96, 0xc3, 0xe0,
+    0xec, 0xcc, 0x39, 0x2a, 0x39, 0x4d, 0x3d, 0x5e, 0x99, 0xc4, 0x82, 0x46, 0x8c, 0xa8, 0xbe, 0xb3,
+    0xd0, 0x61, 0xd0, 0xdd, 0x5a, 0x52, 0xa6, 0x46, 0xd2, 0x4e, 0x6c, 0x98, 0x2e, 0xf8, 0x26, 0xe2,
+    0xe4, 0x11, 0x78, 0x13, 0x0f, 0x4f, 0x15, 0xb6, 0x69, 0x85, 0x50, 0x84, 0xdb, 0xdb, 0xe5, 0xb0,
+    0x29, 0x05, 0xd1, 0x53, 0x33, 0xc2, 0xb0, 0xe4, 0x70, 0xd4, 0x96, 0xb8, 0x61, 0xf4, 0xca, 0xe3,
+    0xb3, 0xea, 0xde, 0x21, 0x83, 0xd1, 0x69, 0xe2, 0x7d, 0x54, 0x2b, 0x34, 0x70, 0x78, 0x6b, 0x14,
+    0x37, 0x30, 0x30, 0x6f, 0x82, 0x23, 0xc3, 0x70, 0xce, 0x59, 0x01, 0x4d, 0xa4, 0xb4, 0x0e, 0xbd,
+    0xba, 0xa4, 0x69, 0x41, 0x05, 0x49, 0x24, 0xab, 0xc9, 0x98, 0x6f, 0xd5, 0x04, 0x39, 0xbb, 0xe9,
+    0x5e, 0xf6, 0x49, 0x95, 0x11, 0x0f, 0xa4, 0x77, 0x79, 0x6a, 0x36, 0xd6, 0xeb, 0xf3, 0xab, 0x3f,
+    0x60, 0xff, 0x84, 0xc3, 0x00, 0x0f, 0xbf, 0xf9, 0xa4, 0xdb, 0xfb, 0xfb, 0x90, 0xbc, 0xf7, 0xc9,
+    0x70, 0xd4, 0x1d, 0xf5, 0x0f, 0xc9, 0x07, 0xb2, 0x3a, 0xaa, 0x75, 0x0c, 0x2e, 0xff, 0x19, 0xf6,
+    0x6f, 0xbe, 0xf6, 0x6f, 0x40, 0x47, 0xe7, 0xfe, 0xa0, 0x53, 0xdd, 0x0c, 0xae, 0x81, 0x3e, 0x42,
+    0xa2, 0x8f, 0xe7, 0xee, 0x97, 0xd1, 0x00, 0x3e, 0xf6, 0xed, 0xee, 0xb7, 0x50, 0xcd, 0xbd, 0x0f,
+    0x29, 0x61, 0xc2, 0xce, 0x71, 0x4f, 0xe8, 0x34, 0xfa, 0x4f, 0x94, 0x43, 0xfc, 0x5c, 0xbd, 0xcc,
+    0xa0, 0x0a, 0xb0, 0xee, 0xa8, 0x4f, 0xa6, 0x3e, 0x09, 0x11, 0x4e, 0xbb, 0x0f, 0x98, 0xea, 0xfd,
+    0x12, 0xa7, 0xfa, 0xa0, 0x9b, 0xe7, 0x50, 0x37, 0xe3, 0x8a, 0x97, 0xbc, 0x01, 0x5b, 0xa2, 0xc8,
+    0x1c, 0x4f, 0x4e, 0xc8, 0x41, 0x2d, 0x3b, 0x69, 0x57, 0xf4, 0x42, 0xf5, 0x1a, 0xab, 0xe6, 0xa2,
+    0x1a, 0xa7, 0xdf, 0xf8, 0x74, 0x28, 0xc3, 0x5b, 0x28, 0x77, 0x57, 0x40, 0x4b, 0x40, 0xd6, 0x20,
+    0xcb, 0x61, 0x91, 0x0e, 0xa5, 0xb0, 0xa3, 0x7d, 0xae, 0x75, 0xa6, 0x0e, 0x1d, 0x44, 0x7e, 0xa1,
+    0xd4, 0xe1, 0xee, 0xae, 0x01, 0x7c, 0x61, 0x4e, 0x1e, 0x64, 0x58, 0x2d, 0x36, 0x97, 0x80, 0x05,
+    0x64, 0xf6, 0xee, 0xc2, 0x6c, 0xa9, 0x0b, 0x15, 0x4c, 0xe3, 0x94, 0xe6, 0xcb, 0x11, 0x58, 0x8a,
+    0xa9, 0x49, 0xd1, 0xf0, 0x69, 0x11, 0x45, 0x3c, 0x77, 0xcc, 0xb5, 0x4c, 0x13, 0xd8, 0xf5, 0xe9,
+    0x0c, 0x6f, 0x5b, 0xbb, 0x49, 0x54, 0x1a, 0xd7, 0xf0, 0xb7, 0xb5, 0x49, 0x45, 0xd5, 0xdc, 0xc0,
+    0x0c, 0xfc, 0x7d, 0xbd, 0xfc, 0x59, 0x69, 0x6d, 0xdf, 0x8b, 0xc6, 0x9d, 0x09, 0x80, 0xf3, 0x5f,
+    0x23, 0x6e, 0x56, 0xda, 0xde, 0x83, 0xa4, 0xc9, 0x8a, 0x00, 0x73, 0xc0, 0x03, 0x78, 0x70, 0xac,
+    0x33, 0xd7, 0x06, 0xa2, 0xbc, 0x81, 0xa4, 0xf0, 0x41, 0xcf, 0xde, 0x84, 0xfc, 0x80, 0x3f, 0xfb,
+    0x13, 0xf2, 0xf1, 0x23, 0x02, 0xdc, 0xb1, 0xff, 0x3d, 0x33, 0xde, 0x60, 0xbb, 0x79, 0x42, 0x29,
+    0xa4, 0x11, 0x2e, 0x7a, 0x1b, 0x54, 0x93, 0x54, 0x90, 0xe0, 0x59, 0x26, 0x96, 0xa6, 0xfd, 0x29,
+    0x37, 0x1a, 0xbf, 0x9f, 0xe0, 0x1b, 0x1f, 0x4c, 0xb8, 0x4a, 0x58, 0xcc, 0xdc, 0x5a, 0x2f, 0xde,
+    0xc4, 0x46, 0x0b, 0x13, 0x08, 0x1b, 0x27, 0x36, 0x6d, 0x59, 0x68, 0xb7, 0x8e, 0xa8, 0x4f, 0xf6,
+    0x3b, 0x9d, 0x0e, 0xd6, 0x26, 0x46, 0xbc, 0x11, 0xe8, 0x46, 0x82, 0x35, 0xdf, 0x34, 0x3d, 0x42,
+    0xd9, 0x76, 0xab, 0x30, 0x1b, 0x36, 0xa7, 0x54, 0xd9, 0x95, 0x63, 0xaf, 0x19, 0x14, 0x89, 0xbf,
+    0x33, 0xac, 0x28, 0x26, 0x5a, 0x0c, 0xd8, 0xee, 0x59, 0x1d, 0x65, 0x6d, 0xae, 0xc9, 0x8d, 0x35,
+    0x1c, 0x1b, 0x9a, 0x39, 0xd8, 0x09, 0x07, 0xac, 0x12, 0x76, 0xdb, 0x35, 0x65, 0x3d, 0xea, 0x4a,
+    0x2d, 0xd8, 0x61, 0x36, 0xa6, 0x83, 0x4c, 0xcb, 0xd1, 0xf0, 0x68, 0x07, 0xc0, 0x90, 0xf5, 0x12,
+    0xe6, 0x32, 0x7e, 0x17, 0x87, 0xc8, 0x99, 0x99, 0x91, 0x55, 0xc0, 0x11, 0x7c, 0x49, 0x4e, 0x0d,
+    0x19, 0x3d, 0x44, 0x7b, 0x00, 0x45, 0x68, 0x54, 0x00, 0x70, 0xce, 0x29, 0x5b, 0x0e, 0xeb, 0xe5,
+    0xb5, 0x2e, 0x81, 0x60, 0x70, 0xdd, 0xbf, 0x32, 0xf3, 0xa7, 0xac, 0x50, 0xd7, 0x1e, 0xcc, 0xcf,
+    0x06, 0x5b, 0x66, 0x51, 0x64, 0x42, 0xf4, 0x28, 0x55, 0xa0, 0xa1, 0xf8, 0xb6, 0xb0, 0xfd, 0xea,
+    0x27, 0x69, 0x00, 0x5b, 0x0c, 0xbf, 0x1f, 0x44, 0xa5, 0x71, 0x5e, 0xc3, 0x3a, 0xbb, 0x2b, 0xda,
+    0x9c, 0xad, 0x5a, 0x54, 0xc4, 0xca, 0xa4, 0x3f, 0x43, 0xc3, 0x21, 0xd7, 0x4d, 0xf8, 0x60, 0x1b,
+    0xcd, 0x32, 0x7c, 0xcc, 0xb1, 0x5a, 0x9c, 0x96, 0x63, 0x2d, 0x06, 0x83, 0xa9, 0x53, 0xbd, 0x70,
+    0x54, 0x6f, 0xc2, 0x26, 0x64, 0x40, 0x7f, 0x20, 0x09, 0xd7, 0x73, 0x89, 0xcb, 0xc0, 0xf5, 0x60,
+    0x38, 0x02, 0xca, 0x54, 0xb2, 0xe5, 0x21, 0x3e, 0xfc, 0x68, 0xb3, 0x02, 0x89, 0x26, 0xac, 0x55,
+    0x24, 0xb7, 0x36, 0xf1, 0xb6, 0x9d, 0xcf, 0x27, 0x57, 0x45, 0x32, 0xad, 0x7f, 0x90, 0xc0, 0x16,
+    0x53, 0x99, 0xd7, 0x50, 0x6a, 0x67, 0x00, 0x86, 0xba, 0x02, 0x64, 0x3d, 0xe8, 0xcd, 0xbc, 0x7d,
+    0x61, 0x66, 0x5a, 0x81, 0x27, 0x47, 0x6e, 0xac, 0xba, 0x36, 0x03, 0x51, 0x09, 0x84, 0x77, 0xda,
+    0x1a, 0x3c, 0xc0, 0xa3, 0x69, 0x9c, 0xaa, 0xf6, 0xe8, 0xc1, 0x9f, 0x7d, 0x8f, 0x1d, 0xc1, 0xb6,
+    0xed, 0x57, 0xfa, 0x3e, 0x91, 0x0e, 0x31, 0x13, 0xa2, 0xfd, 0x34, 0x8a, 0xae, 0xfe, 0x07, 0xf5,
+    0x32, 0x9e, 0x2a, 0xa8, 0x11, 0x00, 0x00,
+};
+
+// index.html: 3459 bytes minified, 896 bytes gzipped
+static const uint8_t WEB_INDEX_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xbd, 0x57, 0x5d, 0x6f, 0xdb, 0x36,
+    0x14, 0x7d, 0xef, 0xaf, 0xe0, 0x08, 0x74, 0xd9, 0x80, 0xca, 0x8a, 0x9c, 0x66, 0x49, 0x51, 0xc9,
+    0x43, 0x3e, 0x96, 0x79, 0x40, 0x82, 0x18, 0xad, 0xbb, 0xa2, 0x8f, 0xb4, 0x74, 0x65, 0x71, 0xa5,
+    0x48, 0x81, 0xa4, 0x9c, 0xf9, 0xdf, 0xef, 0x92, 0xa2, 0x1d, 0x67, 0xf5, 0x57, 0xdc, 0xa0, 0x0f,
+    0x86, 0x4c, 0xf2, 0xf2, 0x9c, 0x73, 0xaf, 0x0e, 0xaf, 0xa4, 0xf4, 0xa7, 0xeb, 0xfb, 0xab, 0xf1,
+    0x97, 0xd1, 0x1f, 0xa4, 0xb2, 0xb5, 0x18, 0xbc, 0x4a, 0xdd, 0x85, 0x08, 0x26, 0xa7, 0x19, 0x05,
+    0x49, 0xdd, 0x04, 0xb0, 0x02, 0x2f, 0x35, 0x58, 0x46, 0xf2, 0x8a, 0x69, 0x03, 0x36, 0xa3, 0x9f,
+    0xc6, 0x37, 0xd1, 0x39, 0x5d, 0x4c, 0x4b, 0x56, 0x43, 0x46, 0x67, 0x1c, 0x1e, 0x1a, 0xa5, 0x2d,
+    0x25, 0xb9, 0x92, 0x16, 0x24, 0x86, 0x3d, 0xf0, 0xc2, 0x56, 0x59, 0x01, 0x33, 0x9e, 0x43, 0xe4,
+    0x07, 0x6f, 0x08, 0x97, 0xdc, 0x72, 0x26, 0x22, 0x93, 0x33, 0x01, 0x59, 0xd2, 0x3b, 0x76, 0x30,
+    0x96, 0x5b, 0x01, 0x83, 0xe1, 0xbc, 0xd0, 0xaa, 0x51, 0x92, 0xe7, 0xe4, 0x0a, 0x21, 0xb4, 0x12,
+    0x64, 0xc4, 0x24, 0x88, 0x34, 0xee, 0xd6, 0x5f, 0xa5, 0x82, 0xcb, 0xaf, 0x44, 0x83, 0xc8, 0xa8,
+    0xb1, 0x73, 0x01, 0xa6, 0x02, 0x40, 0xbe, 0x4a, 0x43, 0x99, 0xd1, 0x98, 0x35, 0x4d, 0x2f, 0x37,
+    0xe6, 0xf7, 0x59, 0xf6, 0x36, 0x7f, 0x77, 0xf2, 0xf6, 0xb4, 0xdf, 0xef, 0x27, 0x90, 0xf4, 0x93,
+    0xb2, 0xef, 0x28, 0xe2, 0x90, 0xc8, 0x44, 0x15, 0xf3, 0x90, 0x16, 0x68, 0xfc, 0x53, 0xf0, 0x19,
+    0xc9, 0x05, 0x33, 0x26, 0xa3, 0x42, 0x4d, 0x15, 0xed, 0x54, 0xa4, 0xa6, 0x61, 0x72, 0x10, 0x54,
+    0xa4, 0xb1, 0x1f, 0xa5, 0x31, 0xc6, 0x3e, 0xdd, 0xd1, 0xa1, 0x44, 0x9a, 0x4f, 0x2b, 0xeb, 0x48,
+    0x5c, 0xdc, 0x62, 0xcd, 0x58, 0x66, 0x5b, 0x13, 0x15, 0x0a, 0x15, 0xf2, 0x22, 0xa3, 0x58, 0x15,
+    0x79, 0x8d, 0x83, 0x41, 0x80, 0x0b, 0xd1, 0x8b, 0xa5, 0x5b, 0x36, 0x01, 0x41, 0x1d, 0xa5, 0x84,
+    0xdc, 0x72, 0x39, 0xed, 0xf5, 0x7a, 0xcb, 0xc8, 0xc0, 0x1c, 0x2f, 0x55, 0xd7, 0x8c, 0xbb, 0xf9,
+    0x66, 0x49, 0xe6, 0xf6, 0x28, 0x19, 0xf9, 0x42, 0xd1, 0xc1, 0x2d, 0x9f, 0x01, 0xf9, 0x08, 0xd2,
+    0x28, 0x4d, 0x3e, 0xe0, 0x1e, 0x84, 0x33, 0x69, 0xdc, 0x3c, 0x15, 0x6f, 0xfc, 0x7a, 0x34, 0xd5,
+    0xbc, 0xa0, 0x4f, 0x57, 0x72, 0xa6, 0xd7, 0x4d, 0x45, 0xa2, 0xd3, 0x78, 0xc1, 0x35, 0x19, 0x43,
+    0xdd, 0x80, 0xc6, 0x0c, 0x35, 0xac, 0xa9, 0x8b, 0x8f, 0x9e, 0x31, 0xd1, 0x42, 0x97, 0xfb, 0xa4,
+    0x6e, 0xdc, 0x06, 0x3a, 0x88, 0xa2, 0x4d, 0xd1, 0x2d, 0xfa, 0x02, 0xd3, 0x27, 0x3f, 0xd7, 0xbc,
+    0xc0, 0x9a, 0xbd, 0x27, 0x97, 0x77, 0xa3, 0xe4, 0xfc, 0x78, 0x53, 0x38, 0xc7, 0x9a, 0xa1, 0x92,
+    0x65, 0x65, 0xd6, 0x46, 0x6d, 0xc9, 0x61, 0xd8, 0x22, 0x0f, 0xb7, 0xf3, 0x3d, 0xc4, 0x17, 0x95,
+    0x5d, 0x44, 0xef, 0x4e, 0xe0, 0xf5, 0x63, 0x02, 0xd7, 0xc3, 0x71, 0x92, 0x6c, 0xd7, 0x3f, 0x3c,
+    0x58, 0xff, 0x67, 0x66, 0xa1, 0xbb, 0x0b, 0xfb, 0x64, 0x60, 0x92, 0xf3, 0x49, 0xff, 0xf8, 0x59,
+    0xe5, 0xbf, 0xfe, 0x98, 0x9c, 0x5f, 0xf6, 0x77, 0xd4, 0xff, 0xf3, 0xc1, 0xfa, 0x6f, 0xdd, 0x91,
+    0x21, 0x7f, 0xb9, 0x46, 0x61, 0xf6, 0xbb, 0x0d, 0xa2, 0xfd, 0x77, 0x77, 0x02, 0x18, 0xb4, 0xe2,
+    0xa0, 0x61, 0x72, 0x76, 0xba, 0x23, 0x83, 0xdb, 0x83, 0x33, 0x68, 0x86, 0x7b, 0x88, 0x6e, 0xaa,
+    0xdd, 0x9a, 0x9b, 0xe1, 0xa3, 0xe4, 0x0b, 0xc9, 0xb0, 0x0b, 0x6d, 0x97, 0x3c, 0x3a, 0x58, 0xf2,
+    0x48, 0x83, 0x31, 0xfb, 0x9d, 0xd8, 0x26, 0x84, 0xee, 0x96, 0x5f, 0x8d, 0xd8, 0xf3, 0x0e, 0xed,
+    0xff, 0xf5, 0x87, 0xcb, 0xa6, 0x5e, 0xf6, 0x01, 0x04, 0x9b, 0x2f, 0x1e, 0x08, 0xdf, 0x76, 0x31,
+    0xed, 0x96, 0xd7, 0x35, 0xb1, 0x6e, 0xc1, 0x57, 0xc4, 0x67, 0x54, 0x2b, 0xab, 0xf4, 0xd5, 0xb7,
+    0x05, 0xea, 0xe2, 0xba, 0xce, 0xba, 0x76, 0xc9, 0x3d, 0xde, 0x16, 0x07, 0x6e, 0xd4, 0xae, 0x3d,
+    0x70, 0x5d, 0xe0, 0x84, 0x15, 0x53, 0x20, 0xaa, 0x2c, 0x57, 0x08, 0x2f, 0xdd, 0x1c, 0x1d, 0xdc,
+    0xdf, 0xdc, 0x6c, 0xbe, 0x6b, 0x41, 0x69, 0xc8, 0xd0, 0x69, 0x98, 0xb4, 0xd6, 0xaa, 0xe5, 0x93,
+    0x64, 0x62, 0x25, 0xc1, 0x5f, 0x84, 0xc5, 0x23, 0x44, 0xc9, 0x5c, 0xf0, 0xfc, 0x6b, 0xd8, 0x75,
+    0x55, 0x17, 0xbf, 0x1c, 0x79, 0xa2, 0xa3, 0x37, 0x47, 0xc9, 0xd1, 0xaf, 0x74, 0x30, 0x6e, 0xb5,
+    0x24, 0xf7, 0x32, 0x8d, 0x3b, 0x8c, 0xcd, 0x60, 0x4e, 0xe6, 0x16, 0xb0, 0xe3, 0x47, 0xb0, 0xb2,
+    0x5c, 0x41, 0x0b, 0xf2, 0xd7, 0x83, 0xb2, 0xd6, 0xaa, 0x95, 0xe4, 0x2f, 0x70, 0x78, 0x69, 0xe5,
+    0x0a, 0x8f, 0x55, 0xd3, 0xa9, 0x00, 0x37, 0xbf, 0x60, 0x42, 0x16, 0x37, 0x24, 0x77, 0xaa, 0x80,
+    0x15, 0x9a, 0x95, 0xf2, 0x38, 0xd0, 0xe0, 0xe0, 0xa7, 0xd0, 0xe1, 0x91, 0x79, 0xc7, 0x64, 0xcb,
+    0x04, 0xa9, 0x11, 0x80, 0x30, 0xb4, 0xce, 0x0c, 0x76, 0x96, 0x7a, 0x69, 0x0a, 0xe1, 0xda, 0xd0,
+    0xe1, 0xa6, 0xf8, 0x53, 0xab, 0x07, 0xe2, 0x5b, 0xd9, 0xbe, 0xa6, 0xf0, 0x84, 0x3f, 0xc2, 0x14,
+    0x9e, 0xe8, 0xa5, 0x4c, 0xb1, 0x00, 0xfb, 0x4e, 0x53, 0x78, 0x98, 0xed, 0xa6, 0xe8, 0x98, 0x9e,
+    0x6f, 0x8a, 0x25, 0xf4, 0x0b, 0x98, 0xa2, 0x64, 0xf2, 0x70, 0x4b, 0xfc, 0x8d, 0x6f, 0xbe, 0x5c,
+    0x30, 0xd7, 0xc1, 0xc8, 0x0d, 0x93, 0xfb, 0xfa, 0x02, 0x39, 0x7f, 0x84, 0x2b, 0x90, 0xe6, 0xa5,
+    0x3c, 0xd1, 0x41, 0x7d, 0xa7, 0x23, 0x10, 0x64, 0xbb, 0x1f, 0x1c, 0xcb, 0xf3, 0xdd, 0x10, 0x60,
+    0xf7, 0xf5, 0xc2, 0x4a, 0x9d, 0xbd, 0x97, 0x98, 0xb1, 0x9f, 0x9a, 0x02, 0x1b, 0x3e, 0x7a, 0xe0,
+    0xe2, 0x81, 0x71, 0xf7, 0x3a, 0x4e, 0x70, 0xcc, 0xfc, 0x3b, 0x79, 0xd8, 0x13, 0x5e, 0xc1, 0x4d,
+    0xae, 0x79, 0x63, 0x89, 0xd1, 0x79, 0xf8, 0x04, 0xf9, 0xc7, 0x7d, 0x81, 0x9c, 0xc1, 0xc9, 0x6f,
+    0xa7, 0x27, 0xc9, 0x24, 0x29, 0xcf, 0xce, 0x4e, 0x4b, 0x38, 0xf1, 0x6f, 0xfd, 0x3e, 0xd2, 0x6d,
+    0x0d, 0xdf, 0x20, 0xb1, 0xff, 0xe6, 0xfa, 0x0f, 0x28, 0xd1, 0x85, 0x65, 0x83, 0x0d, 0x00, 0x00,
+};
+
+static const WebAsset WEB_ASSETS[] = {
+    { "/app.css", "text/css", "public, max-age=31536000, immutable", "\"4c93452221e121f2\"", WEB_APP_CSS_GZ, sizeof(WEB_APP_CSS_GZ) },
+    { "/app.js", "application/javascript", "public, max-age=31536000, immutable", "\"7e36531b1f775fe3\"", WEB_APP_JS_GZ, sizeof(WEB_APP_JS_GZ) },
+    { "/", "text/html; charset=utf-8", "no-cache", "\"3a43d3bf04b3efc1\"", WEB_INDEX_HTML_GZ, sizeof(WEB_INDEX_HTML_GZ) },
+};
+static const size_t WEB_ASSET_COUNT = sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]);
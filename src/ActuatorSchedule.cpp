@@ -0,0 +1,149 @@
+#include "ActuatorSchedule.h"
+
+ActuatorSchedule::ActuatorSchedule(ActuatorController& actuators)
+    : actuators_(actuators), todOffset_(0), started_(false) {
+    for (uint8_t a = 0; a < ACT_COUNT; a++) {
+        onCount_[a]  = 0;
+        released_[a] = false;
+    }
+    drop();
+}
+
+// Empties the table. Actuators that were wanted on are marked for the off
+// the next sync() sends, unless they have entries again by then.
+void ActuatorSchedule::drop() {
+    wheel_.clear();
+    for (uint16_t i = 0; i < MAX_ENTRIES; i++) {
+        slots_[i].used  = false;
+        slots_[i].on    = false;
+        slots_[i].timer = TimerWheel::NO_TIMER;
+    }
+    for (uint8_t a = 0; a < ACT_COUNT; a++) {
+        if (onCount_[a]) released_[a] = true;
+        onCount_[a]    = 0;
+        entryCount_[a] = 0;
+    }
+    used_ = 0;
+}
+
+void ActuatorSchedule::clear() {
+    drop();
+    sync();
+}
+
+void ActuatorSchedule::replace(const ScheduleEntry* entries, uint16_t count) {
+    drop();
+    for (uint16_t i = 0; i < count; i++) add(entries[i]);
+    sync();
+}
+
+int ActuatorSchedule::add(const ScheduleEntry& e) {
+    if (e.actuator >= ACT_COUNT || e.startSec >= DAY_SEC || e.endSec >= DAY_SEC) return -1;
+    for (uint16_t i = 0; i < MAX_ENTRIES; i++) {
+        Slot& s = slots_[i];
+        if (s.used) continue;
+        s.entry = e;
+        s.used  = true;
+        s.on    = false;
+        s.timer = TimerWheel::NO_TIMER;
+        used_++;
+        entryCount_[e.actuator]++;
+        if (started_) arm(i);
+        return i;
+    }
+    return -1;
+}
+
+bool ActuatorSchedule::remove(uint16_t index) {
+    if (index >= MAX_ENTRIES || !slots_[index].used) return false;
+    Slot& s = slots_[index];
+    if (s.timer != TimerWheel::NO_TIMER) wheel_.cancel(s.timer);
+    Actuator a = s.entry.actuator;
+    if (entryCount_[a] == 1 && onCount_[a]) released_[a] = true;
+    setPhase(s, false);
+    s.used  = false;
+    s.timer = TimerWheel::NO_TIMER;
+    used_--;
+    entryCount_[a]--;
+    sync();
+    return true;
+}
+
+void ActuatorSchedule::setPhase(Slot& s, bool on) {
+    if (s.on == on) return;
+    s.on = on;
+    if (on) onCount_[s.entry.actuator]++;
+    else    onCount_[s.entry.actuator]--;
+}
+
+// =====================================
+//  EDGES
+// =====================================
+// Works out where the entry is right now (wheel time) and arms its next
+// edge: the end of the current on/off phase, clipped to the window end, or
+// the next window start. Cycles count from the window start.
+void ActuatorSchedule::arm(uint16_t index) {
+    Slot&                s   = slots_[index];
+    const ScheduleEntry& e   = s.entry;
+    uint32_t             now = wheel_.now();
+    uint32_t             len  = e.endSec == e.startSec ? DAY_SEC : (e.endSec + DAY_SEC - e.startSec) % DAY_SEC;
+    uint32_t             into = (timeOfDay(now) + DAY_SEC - e.startSec) % DAY_SEC;
+    bool                 on;
+    uint32_t             wait;
+
+    if (into >= len) {
+        on   = false;
+        wait = DAY_SEC - into;
+    } else if (!e.onSec || !e.offSec) {
+        on   = true;
+        wait = len - into;
+    } else {
+        uint32_t period = e.onSec + e.offSec;
+        uint32_t pos    = into % period;
+        on   = pos < e.onSec;
+        wait = on ? e.onSec - pos : period - pos;
+        if (wait > len - into) wait = len - into;
+    }
+
+    setPhase(s, on);
+    s.timer = wheel_.schedule(now + wait, onEdge, this, index);
+}
+
+void ActuatorSchedule::onEdge(void* ctx, uint32_t index) {
+    ActuatorSchedule* self = (ActuatorSchedule*)ctx;
+    self->slots_[index].timer = TimerWheel::NO_TIMER;
+    self->arm(index);
+}
+
+// =====================================
+//  DRIVING
+// =====================================
+void ActuatorSchedule::start(uint32_t nowSec, uint32_t timeOfDaySec) {
+    for (uint16_t i = 0; i < MAX_ENTRIES; i++) {
+        if (slots_[i].timer == TimerWheel::NO_TIMER) continue;
+        wheel_.cancel(slots_[i].timer);
+        slots_[i].timer = TimerWheel::NO_TIMER;
+    }
+    wheel_.advance(nowSec);
+    todOffset_ = (timeOfDaySec % DAY_SEC + DAY_SEC - nowSec % DAY_SEC) % DAY_SEC;
+    started_   = true;
+    for (uint16_t i = 0; i < MAX_ENTRIES; i++)
+        if (slots_[i].used) arm(i);
+    sync();
+}
+
+uint32_t ActuatorSchedule::advance(uint32_t nowSec) {
+    if (wheel_.advance(nowSec)) sync();
+    return wheel_.nextDeadline();
+}
+
+void ActuatorSchedule::sync() {
+    for (uint8_t i = 0; i < ACT_COUNT; i++) {
+        Actuator a        = (Actuator)i;
+        bool     released = released_[a];
+        released_[a]      = false;
+        if ((!entryCount_[a] && !released) || !actuators_.autoMode(a)) continue;
+        bool want = onCount_[a] > 0;
+        if (actuators_.state(a) != want) actuators_.submit(a, OP_SET, want, SRC_AUTO);
+    }
+}
@@ -0,0 +1,118 @@
+#include "Actuators.h"
+
+#include <string.h>
+
+#define ACTUATOR_NAME(id, key, ...) key,
+static const char* ACTUATOR_NAMES[ACT_COUNT] = { HYDRO_ACTUATORS(ACTUATOR_NAME) };
+#undef ACTUATOR_NAME
+
+ActuatorController::ActuatorController(OutputFn output, ClockFn clock)
+    : output_(output), clock_(clock), audit_(nullptr), tap_(nullptr), lastSeq_(0),
+      stateBits_(0), autoBits_(0), acked_(0), dropped_(0) {
+    memset(pending_, 0, sizeof(pending_));
+    memset(minDwellMs_, 0, sizeof(minDwellMs_));
+    memset(lastChangeMs_, 0, sizeof(lastChangeMs_));
+    memset(changed_, 0, sizeof(changed_));
+}
+
+const char* ActuatorController::name(Actuator a) { return ACTUATOR_NAMES[a]; }
+
+bool ActuatorController::fromName(const char* name, Actuator& out) {
+    for (uint8_t a = 0; a < ACT_COUNT; a++)
+        if (strcmp(name, ACTUATOR_NAMES[a]) == 0) { out = (Actuator)a; return true; }
+    return false;
+}
+
+// FNV-1a. constexpr so the registry names become case labels: the lookup is
+// one pass over the request string and a jump, with a strcmp to reject
+// collisions. Two names that hash alike fail to compile as duplicate cases.
+static constexpr uint32_t nameHash(const char* s, uint32_t h = 2166136261u) {
+    return *s ? nameHash(s + 1, (h ^ (uint8_t)*s) * 16777619u) : h;
+}
+
+bool ActuatorController::commandFromName(const char* name, Actuator& a, CommandOp& op) {
+    const char* expect;
+    switch (nameHash(name)) {
+#define COMMAND_CASES(id, key, ...)                                                         \
+    case nameHash(key):        a = ACT_##id; op = OP_SET;  expect = key;        break; \
+    case nameHash(key "Auto"): a = ACT_##id; op = OP_AUTO; expect = key "Auto"; break;
+    HYDRO_ACTUATORS(COMMAND_CASES)
+#undef COMMAND_CASES
+    default:                    return false;
+    }
+    return strcmp(name, expect) == 0;
+}
+
+void ActuatorController::setBit(std::atomic<uint8_t>& bits, Actuator a, bool on) {
+    uint8_t v = bits.load(std::memory_order_relaxed);
+    bits.store(on ? (uint8_t)(v | (1u << a)) : (uint8_t)(v & ~(1u << a)), std::memory_order_release);
+}
+
+void ActuatorController::restore(Actuator a, bool on, bool autoMode) {
+    setBit(stateBits_, a, on);
+    setBit(autoBits_, a, autoMode);
+    output_(a, on);
+}
+
+uint32_t ActuatorController::submit(Actuator a, CommandOp op, bool value, CommandSource src) {
+    ActuatorCommand c = { (uint8_t)a, (uint8_t)op, (uint8_t)value, (uint8_t)src };
+    uint32_t seq = queue_.push(c);
+    if (!seq) dropped_.fetch_add(1, std::memory_order_relaxed);
+    else if (tap_) tap_(c);
+    return seq;
+}
+
+void ActuatorController::apply(Actuator a, bool on, CommandSource src, uint32_t seq) {
+    setBit(stateBits_, a, on);
+    output_(a, on);
+    lastChangeMs_[a] = clock_();
+    changed_[a]      = true;
+    if (audit_) audit_(a, on, src, seq);
+}
+
+// =====================================
+//  BATCH PROCESSING
+// =====================================
+void ActuatorController::process() {
+    ActuatorCommand c;
+    uint32_t seq;
+    while (queue_.pop(c, &seq)) {
+        lastSeq_ = seq;
+        if (c.actuator >= ACT_COUNT) continue;
+        Actuator a = (Actuator)c.actuator;
+
+        if (c.op == OP_AUTO) { setBit(autoBits_, a, c.value); continue; }
+        // A cycle command queued before the user took manual control is stale.
+        if (c.source == SRC_AUTO && !autoMode(a)) continue;
+        if (c.source == SRC_WEB || c.source == SRC_ENCODER) setBit(autoBits_, a, false);
+
+        Pending& p    = pending_[a];
+        bool     base = p.active ? p.target : state(a);
+        if (!p.active) { p.active = true; p.firstSeq = seq; }
+        p.target  = c.op == OP_TOGGLE ? !base : (bool)c.value;
+        p.lastSeq = seq;
+        p.source  = (CommandSource)c.source;
+    }
+
+    uint32_t now = clock_();
+    uint32_t ack = lastSeq_;
+    for (uint8_t i = 0; i < ACT_COUNT; i++) {
+        Actuator a = (Actuator)i;
+        Pending& p = pending_[a];
+        if (!p.active) continue;
+        if (p.target == state(a)) { p.active = false; continue; }   // folded into a no-op
+        if (changed_[a] && now - lastChangeMs_[a] < minDwellMs_[a]) {
+            if (p.firstSeq - 1 < ack) ack = p.firstSeq - 1;
+            continue;
+        }
+        apply(a, p.target, p.source, p.lastSeq);
+        p.active = false;
+    }
+    acked_.store(ack, std::memory_order_release);
+}
+
+bool ActuatorController::pending() const {
+    for (uint8_t i = 0; i < ACT_COUNT; i++)
+        if (pending_[i].active) return true;
+    return false;
+}
@@ -0,0 +1,919 @@
+#include "App.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "Hal.h"
+#include "Pins.h"
+#include "LcdFramebuffer.h"
+#include "I2cLcdSink.h"
+#include "SensorDrivers.h"
+#include "ActuatorSchedule.h"
+
+// ---------- I2C ----------
+uint32_t i2cClock() { return hal::micros(); }
+
+I2cEngine    i2c(hal::i2cBus(), i2cClock);
+Bmp180Driver bmpDriver(i2c);
+Bh1750Driver luxDriver(i2c);
+
+// ---------- DISPLAY ----------
+I2cLcdSink     lcdSink(i2c, LCD_ADDR);
+LcdFramebuffer frame(lcdSink);
+
+// ---------- pH CALIBRATION ----------
+Seqlock<PhCalibration> phCalibration;
+
+// ---------- MENU STATE ----------
+// The main menu lists every registry sensor, then "Controls"; the controls
+// menu every actuator, then "Back". A sensor or actuator screen shows the
+// entry its menu index points at.
+enum MenuState { WELCOME, MAIN_MENU, SENSOR_DISPLAY, RELAY_MENU, ACTUATOR_CONTROL };
+
+const int MAIN_ITEMS  = SensorHistory::CHANNEL_COUNT + 1;
+const int RELAY_ITEMS = ACT_COUNT + 1;
+
+MenuState currentState  = WELCOME;
+MenuState previousState = WELCOME;
+
+int menuIndex      = 0;
+int relayMenuIndex = 0;
+
+// ---------- RELAY STATE ----------
+const uint32_t MIN_RELAY_DWELL_MS = 1000;   // shortest time a relay holds a state
+
+void driveRelay(Actuator a, bool on);
+uint32_t actuatorClock() { return hal::millis(); }
+// Only the "actuators" task changes relays; everything else submits commands.
+ActuatorController actuators(driveRelay, actuatorClock);
+// Dashboard commands over WebSocket, acked from the same task.
+ControlChannel     control(actuators, hal::wsSend, hal::wsClose, actuatorClock);
+
+// ---------- AUTO SCHEDULES ----------
+// What each actuator does while in auto mode, by local time of day.
+#define HM(h, m) ((h) * 3600UL + (m) * 60UL)
+const ScheduleEntry DEFAULT_SCHEDULE[] = {
+    { ACT_LIGHT, HM(6, 0),  HM(20, 0), 0,          0           },   // 14 h photoperiod
+    { ACT_MOTOR, HM(6, 0),  HM(20, 0), HM(0, 15),  HM(0, 45)   },   // day: 15 min every hour
+    { ACT_MOTOR, HM(20, 0), HM(6, 0),  HM(0, 10),  HM(1, 50)   },   // night: 10 min every 2 h
+    { ACT_FAN,   HM(10, 0), HM(18, 0), HM(0, 10),  HM(0, 20)   },   // warmest hours: 1/3 duty
+};
+#undef HM
+
+ActuatorSchedule schedule(actuators);
+
+// ---------- ALERT LIMITS ----------
+// Per sensor channel, in SensorHistory order. Lux follows the grow light
+// and sits at 0 all night, so it has no checks by default.
+const ChannelLimits DEFAULT_LIMITS[] = {
+    //  low     high    hyst   rate/min  stuck s
+    {  15.0f,  32.0f,  0.5f,   1.0f,    1800 },   // air temperature, C
+    {  40.0f,  85.0f,  2.0f,   5.0f,    1800 },   // humidity, %
+    {  18.0f,  26.0f,  0.3f,   0.5f,    1800 },   // water temperature, C
+    {  NAN,    NAN,    0.0f,   0.0f,    0    },   // light, lux
+    {  5.5f,   6.2f,   0.05f,  0.2f,    900  },   // pH
+    {  NAN,    NAN,    0.0f,   1.0f,    0    },   // pressure, hPa
+};
+static_assert(sizeof(DEFAULT_LIMITS) / sizeof(DEFAULT_LIMITS[0]) == SensorHistory::CHANNEL_COUNT,
+              "one row of limits per registry sensor");
+
+// ---------- PERSISTENT CONFIG ----------
+// Auto modes, manual relay states, the schedule table, the alert limits and
+// the schedules' time of day, restored in appSetup() before the first
+// control pass. DEFAULT_SCHEDULE and all actuators in auto mode are the
+// factory settings.
+HydroConfig defaultConfig() {
+    HydroConfig c = {};
+    c.autoBits = (1u << ACT_COUNT) - 1;
+    c.clockTod = HydroConfig::TOD_UNKNOWN;
+    for (size_t i = 0; i < sizeof(DEFAULT_SCHEDULE) / sizeof(DEFAULT_SCHEDULE[0]); i++)
+        c.schedule[c.scheduleCount++] = DEFAULT_SCHEDULE[i];
+    for (uint8_t ch = 0; ch < SensorHistory::CHANNEL_COUNT; ch++) c.limits.ch[ch] = DEFAULT_LIMITS[ch];
+    return c;
+}
+
+ConfigStore configStore(hal::configStorage(), actuatorClock, defaultConfig());
+const uint32_t   CLOCK_CHECK_S  = 60;
+const uint32_t   REANCHOR_S     = 86400;   // re-read the wall clock daily to absorb drift
+uint32_t         anchoredAt     = 0;
+bool             clockAnchored  = false;
+// Without a wall clock a power blip would restart the schedules' day at
+// midnight. Their time of day is checkpointed to the config this often, and
+// boot resumes from the last checkpoint until the wall clock is known.
+const uint32_t   TOD_SAVE_S     = 900;
+uint32_t         todSavedAt     = 0;
+bool             todSaveDue     = false;
+
+// ---------- TASK PERIODS ----------
+// "encoder" and "actuators" only poll while the button is down or a relay
+// waits out its dwell; otherwise they sleep until power wakes them.
+const unsigned long ENCODER_POLL_MS         = 5;
+const unsigned long SENSOR_INTERVAL         = 2000;
+const unsigned long displayUpdateInterval   = 1000;
+const unsigned long ACTUATOR_POLL_MS        = 10;
+const unsigned long WS_CHECK_MS             = 1000;
+const unsigned long CONFIG_SYNC_MS          = 500;
+const unsigned long ALERT_POLL_MS           = 1000;
+const unsigned long WELCOME_MS              = 2000;
+
+// ---------- SENSOR VALUES ----------
+// Written only by sensorStep(); everyone else reads a consistent copy with
+// sensorFeed.read().
+Seqlock<SensorSnapshot> sensorFeed;
+
+// ---------- SENSOR HISTORY ----------
+SensorHistory history;   // fixed ~43 KB in .bss, see SensorHistory.h
+
+// ---------- ANALYTICS ----------
+// Fed by the I2C owner with every acquisition; alerts go out from the
+// "alerts" task.
+SensorAnalytics analytics;
+uint32_t        alertsSent = 0;
+
+// ---------- FLASH LOG ----------
+// 8 x 256 blocks = 1 MB of flash, about ten weeks at one sample a minute.
+const uint8_t  LOG_SEGMENTS       = 8;
+const uint16_t LOG_SEGMENT_BLOCKS = 256;
+const uint32_t LOG_INTERVAL_S     = 60;
+const uint32_t LOG_FLUSH_S        = 300;   // most a power cut can lose
+SensorLog      sensorLog(hal::logStorage(), LOG_SEGMENTS, LOG_SEGMENT_BLOCKS);
+uint32_t       lastLogFlush = 0;
+
+// ---------- ENCODER ----------
+// Rotation arrives from the platform's pin-change interrupt; the button is
+// sampled by the "encoder" task, which also drains the events.
+RotaryInput encoderInput;
+
+// ---------- SSE TIMING ----------
+const unsigned long SSE_INTERVAL = 2000;
+const uint16_t SSE_KEYFRAME_EVERY = 15;   // full snapshot every 30 s
+
+// Changes at or below these (wire units) are not worth a delta: the sensor
+// rows' deadbands; relay fields always go out.
+#define SSE_DEADBAND_OF(id, key, field, type, shift, deadband, ...) deadband,
+const int32_t SSE_DEADBAND[SensorHistory::CHANNEL_COUNT] = { HYDRO_SENSORS(SSE_DEADBAND_OF) };
+#undef SSE_DEADBAND_OF
+TelemetryEncoder telemetry;
+
+// ---------- SSE FAN-OUT ----------
+const unsigned long SSE_PUMP_MS = 50;   // how often sockets with a backlog are topped up
+
+// What a new or lagging dashboard is sent before it joins the stream.
+uint32_t telemetryKeyframe(const char*& data) {
+    data = telemetry.snapshot();
+    return telemetry.version();
+}
+SseBroadcaster sse(hal::sseWrite, hal::sseClose, hal::millis, telemetryKeyframe);
+// "id: <10 digits>\nevent: snapshot\ndata: " and the blank line around it.
+static_assert(SseBroadcaster::FRAME_MAX >= TelemetryEncoder::MAX_FRAME + 40,
+              "a telemetry snapshot must fit one SSE frame");
+
+// ---------- BOOT TIMELINE ----------
+BootTimeline bootTimeline;
+
+void markBoot(BootPhase p) {
+    if (bootTimeline.mark(p, hal::monotonicUs()))
+        hal::log("boot: %s at %u us\n", BootTimeline::name(p), (unsigned)bootTimeline.atUs(p));
+}
+
+// ---------- SCHEDULER ----------
+uint64_t schedulerClock() { return hal::monotonicUs(); }
+// Whole seconds since boot from the 64-bit clock; unlike millis() / 1000 it
+// does not wrap after 49.7 days.
+uint32_t uptimeSec() { return (uint32_t)(hal::monotonicUs() / 1000000ULL); }
+Scheduler scheduler(schedulerClock);
+uint8_t displayTask  = Scheduler::NO_TASK;
+uint8_t timersTask   = Scheduler::NO_TASK;
+uint8_t encoderTask  = Scheduler::NO_TASK;
+uint8_t actuatorTask = Scheduler::NO_TASK;
+uint8_t ssePumpTask  = Scheduler::NO_TASK;
+
+void requestDisplayUpdate() { scheduler.trigger(displayTask); }
+
+// A periodic task with nothing to do sleeps until something triggers it.
+void park(uint8_t id) { scheduler.rescheduleAt(id, Scheduler::NEVER); }
+
+// ---------- POWER ----------
+const uint32_t DISPLAY_TIMEOUT_MS = 300000;   // LCD dark after 5 min without encoder input
+PowerManager   power;
+
+// ---------- FLIGHT RECORDER ----------
+// Every task run is traced except the ones that run several times a
+// second, which would push everything else out of the ring; those only
+// record a stall. Flash writes get a longer budget than the rest.
+const unsigned long TRACE_POLL_MS        = 1000;
+const uint32_t      TRACE_FLASH_BUDGET_US = 250000;
+const uint32_t      TRACE_HEAP_STEP      = 256;    // bytes the low-water mark must drop by to be recorded
+FlightRecorder flight(hal::traceMemory(), hal::cycles);
+uint32_t       tracedHeapMin    = UINT32_MAX;
+uint32_t       tracedI2cErrors  = 0;
+uint8_t        tracedSseClients = 0;
+
+void traceTask(uint8_t id, bool done, uint32_t runUs) {
+    if (done) flight.taskEnded(id, runUs);
+    else      flight.taskStarted(id);
+}
+
+const char* traceTaskName(uint8_t id) {
+    return id < Scheduler::MAX_TASKS ? scheduler.taskName(id) : nullptr;   // kept after a one-shot fires
+}
+
+uint16_t traceValue(uint32_t v) { return v > UINT16_MAX ? UINT16_MAX : v; }
+
+// Samples what has no event of its own, and encodes the input trace.
+void pollTrace() {
+    inputTrace.drain();
+    uint32_t heapMin = hal::heapMinFree();
+    if (heapMin && heapMin + TRACE_HEAP_STEP <= tracedHeapMin) {
+        flight.record(TRACE_HEAP_LOW, 0, traceValue(heapMin / 16));
+        tracedHeapMin = heapMin;
+    }
+    const I2cEngine::Stats is = i2c.stats();
+    uint32_t errors = is.failed + is.timedOut;
+    if (errors != tracedI2cErrors) {
+        flight.record(TRACE_I2C_ERROR, 0, traceValue(errors - tracedI2cErrors));
+        tracedI2cErrors = errors;
+    }
+    uint8_t clients = sse.clients();
+    if (clients != tracedSseClients) {
+        flight.record(TRACE_SSE_CLIENTS, 0, clients);
+        tracedSseClients = clients;
+    }
+}
+
+// ---------- INPUT TRACE ----------
+// Sensor samples, encoder events, web commands, relay changes and the wall
+// clock, for GET /trace and the simulator's replay. Encoded by the "trace"
+// task.
+bool traceWallClock(uint32_t& unixSec, int16_t& offsetMin) {
+    uint32_t tod;
+    if (!hal::unixTime(unixSec) || !hal::timeOfDay(tod)) return false;
+    int32_t off = (int32_t)tod - (int32_t)(unixSec % 86400);
+    if (off > 43200)       off -= 86400;
+    else if (off < -43200) off += 86400;
+    offsetMin = (off + (off < 0 ? -30 : 30)) / 60;   // the two reads may straddle a second
+    return true;
+}
+
+uint16_t traceRelayState() {
+    uint16_t bits = 0;
+    for (uint8_t a = 0; a < ACT_COUNT; a++) {
+        if (actuators.state((Actuator)a))    bits |= 1u << a;
+        if (actuators.autoMode((Actuator)a)) bits |= 0x100u << a;
+    }
+    return bits;
+}
+
+InputTrace inputTrace(actuatorClock, traceWallClock, traceRelayState);
+
+// Every accepted command wakes the actuator task. Only web commands are
+// traced: encoder and schedule ones follow from inputs the trace already has.
+void commandSubmitted(const ActuatorCommand& c) {
+    if (c.source == SRC_WEB) inputTrace.command(c);
+    power.wake(WAKE_COMMAND);
+}
+
+// ---------- METRICS ----------
+#if HYDRO_METRICS
+MetricsRegistry  metrics;
+LatencyHistogram encoderLatency;
+LatencyHistogram sensorLatency;
+LatencyHistogram displayLatency;
+LatencyHistogram sseLatency;
+LatencyHistogram analyticsLatency;
+Counter          loopIterations;
+Counter          sseSends;
+Counter          relayToggles;
+
+uint32_t i2cErrors()     { const I2cEngine::Stats s = i2c.stats(); return s.failed + s.timedOut; }
+uint32_t i2cRecoveries() { return i2c.stats().recoveries; }
+uint32_t inputDropped()  { return encoderInput.dropped(); }
+uint32_t logBlocks()     { return sensorLog.stats().blocksWritten; }
+uint32_t wsCommands()    { return control.stats().commands; }
+uint32_t wsClients()     { return control.clients(); }
+uint32_t logErrors()     { return sensorLog.stats().writeErrors; }
+uint32_t alertsRaised()  { return analytics.state().raised; }
+uint32_t alertsActive() {
+    const SensorAnalytics::State st = analytics.state();
+    uint32_t n = 0;
+    for (uint8_t ch = 0; ch < SensorAnalytics::CHANNELS; ch++)
+        for (uint8_t k = 0; k < ALERT_KIND_COUNT; k++) n += (st.active[ch] >> k) & 1;
+    return n;
+}
+uint32_t configSaves()   { return configStore.stats().saves; }
+uint32_t sseClients()    { return sse.clients(); }
+uint32_t sseCoalesced()  { return sse.stats().coalesced; }
+uint32_t sseDropped()    { return sse.stats().dropped; }
+uint32_t sseEvicted()    { return sse.stats().evicted; }
+uint32_t sseRejected()   { return sse.stats().rejected; }
+uint32_t sseMaxLagMs()   { return sse.maxLagMs(); }
+uint32_t traceStalls()   { return flight.stalls(); }
+uint32_t inputTraceDropped() { return inputTrace.dropped(); }
+uint32_t powerActiveMs() { return (uint32_t)(power.stats().activeUs / 1000); }
+uint32_t powerIdleMs()   { return (uint32_t)(power.stats().idleUs / 1000); }
+uint32_t powerSleepMs()  { return (uint32_t)(power.stats().sleepUs / 1000); }
+uint32_t powerWakes() {
+    const PowerManager::Stats s = power.stats();
+    uint32_t n = 0;
+    for (uint8_t w = 0; w < WAKE_SOURCE_COUNT; w++) n += s.wakes[w];
+    return n;
+}
+uint32_t displayLit()    { return power.displayOn(); }
+uint32_t bootAppReady()  { return bootTimeline.atUs(BOOT_APP_READY); }
+uint32_t bootControl()   { return bootTimeline.atUs(BOOT_FIRST_CONTROL); }
+uint32_t bootSensors()   { return bootTimeline.atUs(BOOT_FIRST_SENSORS); }
+uint32_t bootNetwork()   { return bootTimeline.atUs(BOOT_NETWORK_UP); }
+uint32_t bootSse()       { return bootTimeline.atUs(BOOT_FIRST_SSE); }
+#endif
+
+// =====================================
+//  RELAY HELPERS
+// =====================================
+// Pin and polarity come from the registry's RELAY_OUTPUTS table.
+void driveRelay(Actuator a, bool on) {
+    METRIC_INC(relayToggles);
+    flight.record(TRACE_RELAY, a, on);
+    inputTrace.relay(a, on);
+    hal::pinWrite(RELAY_OUTPUTS[a].pin, RELAY_OUTPUTS[a].level(on));
+}
+
+void auditRelay(Actuator a, bool on, CommandSource src, uint32_t seq) {
+    static const char* SOURCES[] = { "web", "encoder", "auto", "boot" };
+    hal::log("relay %s -> %s (%s, seq %u)\n", ActuatorController::name(a), on ? "ON" : "OFF",
+             SOURCES[src], (unsigned)seq);
+}
+
+// =====================================
+//  LCD MENU
+// =====================================
+// Queues the changed cells on the display lane; never waits for the bus.
+void flushFrame() {
+    frame.flush();
+    lcdSink.commit();
+    if (lcdSink.takeError()) frame.invalidate();   // panel lost output: redraw everything next time
+}
+
+// Dark after DISPLAY_TIMEOUT_MS without input; the "display" task sleeps
+// until the next encoder event lights the panel again.
+void wakeDisplay() {
+    lcdSink.setPower(true);
+    requestDisplayUpdate();
+}
+
+void finishWelcome() {
+    if (currentState == WELCOME) currentState = MAIN_MENU;
+    requestDisplayUpdate();
+}
+
+// Shows the splash screen. The "welcome" one-shot hands over to the main
+// menu instead of blocking, so control keeps running underneath it.
+void displayWelcome() {
+    currentState = WELCOME;
+    frame.beginFrame();
+    frame.setCursor(3, 1); frame.print("WELCOME TO");
+    frame.setCursor(3, 2); frame.print("HYDROPONIC");
+    flushFrame();
+}
+
+void handleUpButton() {
+    if (currentState == MAIN_MENU)       { if (--menuIndex < 0)      menuIndex = MAIN_ITEMS - 1; }
+    else if (currentState == RELAY_MENU) { if (--relayMenuIndex < 0) relayMenuIndex = RELAY_ITEMS - 1; }
+    else if (currentState == ACTUATOR_CONTROL)
+        actuators.submit((Actuator)relayMenuIndex, OP_TOGGLE, true, SRC_ENCODER);
+}
+void handleDownButton() {
+    if (currentState == MAIN_MENU)       { if (++menuIndex >= MAIN_ITEMS)      menuIndex = 0; }
+    else if (currentState == RELAY_MENU) { if (++relayMenuIndex >= RELAY_ITEMS) relayMenuIndex = 0; }
+    else if (currentState == ACTUATOR_CONTROL)
+        actuators.submit((Actuator)relayMenuIndex, OP_TOGGLE, true, SRC_ENCODER);
+}
+void handleOkButton() {
+    if (currentState == MAIN_MENU) {
+        currentState = menuIndex < SensorHistory::CHANNEL_COUNT ? SENSOR_DISPLAY : RELAY_MENU;
+    } else if (currentState == RELAY_MENU) {
+        currentState = relayMenuIndex < ACT_COUNT ? ACTUATOR_CONTROL : MAIN_MENU;
+    } else if (currentState == ACTUATOR_CONTROL) {
+        currentState = RELAY_MENU;
+    } else {
+        currentState = MAIN_MENU;
+    }
+}
+void handleBackButton() {
+    if (currentState == ACTUATOR_CONTROL)
+        currentState = RELAY_MENU;
+    else if (currentState != MAIN_MENU)
+        currentState = MAIN_MENU;
+}
+
+// Rotation arrives from the pin interrupt and a button change wakes this
+// task; it keeps sampling the button until it is released and settled.
+void handleEncoder() {
+    METRIC_TIME(encoderLatency);
+    uint32_t now = hal::millis();
+    encoderInput.sampleButton(!hal::pinRead(ENC_SW), now);
+
+    InputEvent e;
+    bool       changed = false;
+    while (encoderInput.next(e)) {
+        inputTrace.encoder(e);
+        changed = true;
+        if (!power.input(now)) { wakeDisplay(); continue; }   // only lit the panel
+        if      (e.type == EV_STEP)       { if (e.dir > 0) handleDownButton(); else handleUpButton(); }
+        else if (e.type == EV_CLICK)      handleOkButton();
+        else if (e.type == EV_LONG_PRESS) handleBackButton();
+    }
+    if (changed) requestDisplayUpdate();
+    if (encoderInput.buttonIdle()) park(encoderTask);
+}
+
+// =====================================
+//  SENSORS
+// =====================================
+SampleSourceFn sampleSource = nullptr;
+
+void setSampleSource(SampleSourceFn fn) { sampleSource = fn; }
+
+// Folds the finished driver cycle into the snapshot. A failed read keeps the
+// previous value.
+void updateSensors(SensorSnapshot& s) {
+    METRIC_TIME(sensorLatency);
+    if (sampleSource) {
+        sampleSource(s);
+    } else {
+        if (bmpDriver.valid()) {
+            s.bmpTemp  = bmpDriver.temperature();   // BMP180 temperature used everywhere
+            s.pressure = bmpDriver.pressure();
+        }
+        if (luxDriver.valid()) s.lux = luxDriver.lux();
+
+        hal::readHumidity(s.dhtHumidity);
+        hal::readWaterTemp(s.ds18b20Temp);
+
+        float mv = hal::phMillivolts();
+        if (!isnan(mv)) s.phValue = CentiPh::fromFloat(phCalibration.read().toPh(mv));
+    }
+    s.takenAtMs    = hal::millis();
+    s.takenAtSec   = uptimeSec();
+}
+
+// The snapshot's readings as raw counts in SensorHistory channel order, the
+// form the history, the flash log and the alert stage take.
+void toSample(const SensorSnapshot& s, int32_t out[SensorHistory::CHANNEL_COUNT]) {
+#define SAMPLE_OF(id, key, field, ...) out[SensorHistory::id] = s.field.raw;
+    HYDRO_SENSORS(SAMPLE_OF)
+#undef SAMPLE_OF
+}
+
+void analyzeSample(uint32_t takenAtMs, const int32_t sample[SensorHistory::CHANNEL_COUNT]) {
+    METRIC_TIME(analyticsLatency);
+    analytics.update(takenAtMs, sample);
+}
+
+// Mid-range until the first readings.
+SensorSnapshot acquired  = { DeciCelsius::fromRaw(0), DeciPercent::fromRaw(500), CentiCelsius::fromRaw(2000),
+                             Lux::fromRaw(0), CentiPh::fromRaw(585), DeciHpa::fromRaw(0), 0, 0 };
+uint32_t       nextCycle = 0;
+bool           cycleOpen = false;
+
+// Runs LCD and sensor transactions from the engine and steps the split-phase
+// drivers. Between steps the caller may sleep until the returned deadline or
+// until the engine's wake hook fires, so control code never waits on I2C.
+uint32_t sensorStep() {
+    flight.watch();
+    uint32_t now = hal::micros();
+    if (!cycleOpen && (int32_t)(now - nextCycle) >= 0) {
+        bmpDriver.startCycle();
+        luxDriver.startCycle();
+        nextCycle += SENSOR_INTERVAL * 1000UL;
+        cycleOpen  = true;
+    }
+
+    bmpDriver.poll(now);
+    luxDriver.poll(now);
+    while (i2c.poll()) {}
+
+    if (cycleOpen && bmpDriver.idle() && luxDriver.idle()) {
+        cycleOpen = false;
+        updateSensors(acquired);
+        sensorFeed.write(acquired);
+
+        int32_t sample[SensorHistory::CHANNEL_COUNT];
+        toSample(acquired, sample);
+        inputTrace.sample(sample);
+        history.add(acquired.takenAtSec, sample);
+        analyzeSample(acquired.takenAtMs, sample);
+        markBoot(BOOT_FIRST_SENSORS);
+    }
+
+    // Next thing to do: a conversion finishing (0 = results ready now) or the next cycle.
+    return cycleOpen ? bmpDriver.wakeAtUs() : nextCycle;
+}
+
+// =====================================
+//  LCD DISPLAY
+// =====================================
+#define SENSOR_LABEL(id, key, field, type, shift, deadband, label, ...) label,
+#define ACTUATOR_LABEL(id, key, pin, activeLow, label) label,
+const char* const SENSOR_LABELS[SensorHistory::CHANNEL_COUNT] = { HYDRO_SENSORS(SENSOR_LABEL) };
+const char* const ACTUATOR_LABELS[ACT_COUNT]                  = { HYDRO_ACTUATORS(ACTUATOR_LABEL) };
+#undef SENSOR_LABEL
+#undef ACTUATOR_LABEL
+
+// Centred on the top row.
+void printTitle(LcdFramebuffer& fb, const char* title) {
+    size_t len = strlen(title);
+    fb.setCursor(len < LcdFramebuffer::COLS ? (LcdFramebuffer::COLS - len) / 2 : 0, 0);
+    fb.print(title);
+}
+
+// One menu screen from readings s, into fb's back buffer; the caller flushes.
+void drawMenu(LcdFramebuffer& fb, MenuState state, int mainIndex, int relayIndex, const SensorSnapshot& s) {
+    fb.beginFrame();
+
+    if (state == MAIN_MENU) {
+        fb.setCursor(0,0); fb.print("     MAIN MENU     ");
+        for (int i = 0; i < 3; i++) {
+            int idx = (mainIndex + i - 1 + MAIN_ITEMS) % MAIN_ITEMS;
+            fb.setCursor(0, i+1);
+            fb.print(i == 1 ? ">" : " ");
+            fb.print(idx < SensorHistory::CHANNEL_COUNT ? SENSOR_LABELS[idx] : "Controls");
+        }
+    }
+    else if (state == SENSOR_DISPLAY) {
+        printTitle(fb, SENSOR_LABELS[mainIndex]);
+        switch (mainIndex) {
+#define SENSOR_SCREEN(id, key, field, type, shift, deadband, label, unit, part) \
+        case SensorHistory::id:                                                  \
+            fb.setCursor(0,1); fb.print(part);                                   \
+            fb.setCursor(0,2); fb.print(s.field); fb.print(unit);                \
+            break;
+        HYDRO_SENSORS(SENSOR_SCREEN)
+#undef SENSOR_SCREEN
+        }
+    }
+    else if (state == RELAY_MENU) {
+        fb.setCursor(0,0); fb.print(" Controls");
+        for (int i = 0; i < 3; i++) {
+            int idx = (relayIndex + i - 1 + RELAY_ITEMS) % RELAY_ITEMS;
+            fb.setCursor(0, i+1);
+            fb.print(i == 1 ? ">" : " ");
+            fb.print(idx < ACT_COUNT ? ACTUATOR_LABELS[idx] : "Back");
+        }
+    }
+    else if (state == ACTUATOR_CONTROL) {
+        Actuator a = (Actuator)relayIndex;
+        printTitle(fb, ACTUATOR_LABELS[a]);
+        fb.setCursor(0,1); fb.print("State: ");
+        fb.print(actuators.state(a) ? "ON " : "OFF");
+        fb.setCursor(0,2); fb.print("Mode: ");
+        fb.print(actuators.autoMode(a) ? "AUTO  " : "MANUAL");
+    }
+}
+
+void updateDisplay() {
+    if (currentState == WELCOME) return;   // splash stays until finishWelcome()
+    if (power.displayTimedOut(hal::millis())) lcdSink.setPower(false);
+    if (!power.displayOn()) { park(displayTask); return; }
+    METRIC_TIME(displayLatency);
+
+    const SensorSnapshot s = sensorFeed.read();
+    previousState = currentState;
+    drawMenu(frame, currentState, menuIndex, relayMenuIndex, s);
+    flushFrame();
+}
+
+// The screens in the order scrolling through the menus shows them: each
+// main menu position, then the sensor screens, each controls menu position
+// and the relay screens.
+uint8_t menuScreenCount() { return MAIN_ITEMS + SensorHistory::CHANNEL_COUNT + RELAY_ITEMS + ACT_COUNT; }
+
+const char* drawMenuScreen(uint8_t screen, const SensorSnapshot& s, LcdFramebuffer& fb) {
+    int i = screen;
+    if (i < MAIN_ITEMS) { drawMenu(fb, MAIN_MENU, i, 0, s); return "main menu"; }
+    i -= MAIN_ITEMS;
+    if (i < SensorHistory::CHANNEL_COUNT) { drawMenu(fb, SENSOR_DISPLAY, i, 0, s); return SENSOR_LABELS[i]; }
+    i -= SensorHistory::CHANNEL_COUNT;
+    if (i < RELAY_ITEMS) { drawMenu(fb, RELAY_MENU, 0, i, s); return "controls menu"; }
+    i -= RELAY_ITEMS;
+    drawMenu(fb, ACTUATOR_CONTROL, 0, i, s);
+    return ACTUATOR_LABELS[i];
+}
+
+// =====================================
+//  SSE - push sensor data to browser
+// =====================================
+void sendSSEData() {
+    METRIC_TIME(sseLatency);
+    const SensorSnapshot s = sensorFeed.read();
+    TelemetryFrame f;
+    // The snapshot already holds the telemetry's units.
+#define SENSOR_FIELD(id, key, field, ...) f.v[TF_##id] = s.field.raw;
+#define RELAY_FIELDS(id, ...)                                     \
+    f.v[TF_##id]         = actuators.state(ACT_##id)    ? 1 : 0; \
+    f.v[TF_##id##_AUTO]  = actuators.autoMode(ACT_##id) ? 1 : 0;
+    HYDRO_SENSORS(SENSOR_FIELD)
+    HYDRO_ACTUATORS(RELAY_FIELDS)
+#undef SENSOR_FIELD
+#undef RELAY_FIELDS
+
+    // Encode even with no listeners so the snapshot handed to new clients is current.
+    char   out[TelemetryEncoder::MAX_FRAME];
+    bool   isSnapshot;
+    size_t len = telemetry.update(f, out, sizeof(out), isSnapshot);
+    if (!len || !sse.clients()) return;
+    sse.publish(isSnapshot ? "snapshot" : "delta", out, telemetry.version());
+    scheduler.trigger(ssePumpTask);
+    METRIC_INC(sseSends);
+    markBoot(BOOT_FIRST_SSE);
+}
+
+// Runs while a socket has frames left to take, then sleeps until the next
+// publish or a client coming or going.
+void pumpSSE() {
+    sse.pump();
+    if (!sse.backlog()) park(ssePumpTask);
+}
+
+// =====================================
+//  ALERTS
+// =====================================
+// Forwards alert events the analytics stage has produced since the last
+// pass: to the log, and as "alert" SSE events. They carry no event id, so
+// a dashboard's Last-Event-ID keeps tracking the telemetry version.
+void publishAlerts() {
+    const SensorAnalytics::State st = analytics.state();
+    if (st.events == alertsSent) return;
+    uint32_t from = st.events - alertsSent > SensorAnalytics::RECENT_EVENTS
+                  ? st.events - SensorAnalytics::RECENT_EVENTS : alertsSent;
+    bool listeners = sse.clients() > 0;
+    for (uint32_t seq = from; seq < st.events; seq++) {
+        const AlertEvent& e = st.recent[seq % SensorAnalytics::RECENT_EVENTS];
+        char json[160];
+        SensorAnalytics::eventJson(e, json, sizeof(json));
+        hal::log("alert %s\n", json);
+        if (listeners) sse.publish("alert", json, 0);
+    }
+    alertsSent = st.events;
+    if (listeners) scheduler.trigger(ssePumpTask);
+}
+
+// =====================================
+//  AUTO SCHEDULES
+// =====================================
+// Fires due schedule edges, then sleeps until the wheel's next deadline.
+void runSchedules() {
+    uint32_t next = schedule.advance(uptimeSec());
+    scheduler.rescheduleAt(timersTask, next == ActuatorSchedule::NEVER ? Scheduler::NEVER : next * 1000000ULL);
+}
+
+// Until the wall clock is known, boot resumes from the stored checkpoint
+// (midnight if there is none). Once it is, the schedules are re-anchored to
+// it, and again daily.
+void checkClock() {
+    uint32_t tod;
+    uint32_t now = uptimeSec();
+    if (!hal::timeOfDay(tod)) return;
+    if (clockAnchored && now - anchoredAt < REANCHOR_S) return;
+    schedule.start(now, tod);
+    clockAnchored = true;
+    anchoredAt    = now;
+    todSaveDue    = true;
+    scheduler.trigger(timersTask);
+
+    uint32_t unixSec;
+    int16_t  offsetMin;
+    if (traceWallClock(unixSec, offsetMin)) inputTrace.clock(unixSec, offsetMin);
+}
+
+// =====================================
+//  FLASH LOG
+// =====================================
+// Appends the latest snapshot once a minute. Samples collect in RAM and
+// only reach flash when a block fills or every LOG_FLUSH_S, so the control
+// loop pays for a flash write a few times an hour. Nothing is logged until
+// the wall clock is set, since the log is indexed by real time.
+void logSensors() {
+    uint32_t t;
+    if (!hal::unixTime(t)) return;
+
+    int32_t sample[SensorHistory::CHANNEL_COUNT];
+    toSample(sensorFeed.read(), sample);
+    sensorLog.append(t, sample);
+
+    uint32_t now = uptimeSec();
+    if (now - lastLogFlush >= LOG_FLUSH_S) {
+        sensorLog.flush();
+        lastLogFlush = now;
+    }
+}
+
+// Owner of every relay: applies queued commands, acks WebSocket commands
+// and refreshes the LCD when something actually switched. Woken by every
+// command and /ws message; polls only while a relay waits out its dwell.
+void processActuators() {
+    uint32_t acked = actuators.ackedSeq();
+    control.poll();
+    actuators.process();
+    control.complete();
+    markBoot(BOOT_FIRST_CONTROL);
+    if (!actuators.pending()) park(actuatorTask);
+    if (actuators.ackedSeq() == acked) return;
+    schedule.sync();   // e.g. auto mode just switched back on
+    requestDisplayUpdate();
+}
+
+void checkControlClients() { control.checkClients(); }
+
+// =====================================
+//  CONFIG
+// =====================================
+void loadSchedule(const HydroConfig& c) {
+    schedule.replace(c.schedule, c.scheduleCount);
+    scheduler.trigger(timersTask);
+}
+
+// Returns true when the schedule table changed.
+bool applyEdit(HydroConfig& c, const ConfigEdit& e) {
+    if (e.op == ConfigEdit::SET_ENTRY) {
+        if (e.index > c.scheduleCount || e.index >= HydroConfig::MAX_SCHEDULE) return false;
+        if (e.index == c.scheduleCount) c.scheduleCount++;
+        c.schedule[e.index] = e.entry;
+    } else if (e.op == ConfigEdit::REMOVE_ENTRY) {
+        if (e.index >= c.scheduleCount) return false;
+        for (uint8_t i = e.index; i + 1 < c.scheduleCount; i++) c.schedule[i] = c.schedule[i + 1];
+        c.scheduleCount--;
+    } else if (e.op == ConfigEdit::SET_LIMITS) {
+        if (e.index >= SensorAnalytics::CHANNELS) return false;
+        c.limits.ch[e.index] = e.limits;
+        analytics.setLimits(c.limits);
+        return false;   // the schedule is untouched
+    } else if (e.op == ConfigEdit::RESET_SCHEDULE) {
+        const HydroConfig& d = configStore.defaults();
+        c.scheduleCount = d.scheduleCount;
+        for (uint8_t i = 0; i < d.scheduleCount; i++) c.schedule[i] = d.schedule[i];
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Applies queued /config edits, folds in the current auto modes and manual
+// relay states, and lets the store decide whether it is time to write.
+void syncConfig() {
+    HydroConfig c = configStore.current();
+    ConfigEdit  e;
+    bool        rescheduled = false;
+    while (configStore.nextEdit(e)) rescheduled |= applyEdit(c, e);
+    if (rescheduled) loadSchedule(c);
+
+    c.autoBits  = 0;
+    c.relayBits = 0;
+    for (uint8_t a = 0; a < ACT_COUNT; a++) {
+        if (actuators.autoMode((Actuator)a))   c.autoBits  |= 1u << a;
+        else if (actuators.state((Actuator)a)) c.relayBits |= 1u << a;
+    }
+    uint32_t now = uptimeSec();
+    if (todSaveDue || now - todSavedAt >= TOD_SAVE_S) {
+        c.clockTod = schedule.timeOfDay(now);
+        todSavedAt = now;
+        todSaveDue = false;
+    }
+    configStore.update(c);
+    configStore.commit();
+}
+
+// =====================================
+//  SETUP / LOOP
+// =====================================
+// "encoder", "sse-pump" and "actuators" are woken by appLoop(), "timers" by
+// the schedule's next edge and "display" by requestDisplayUpdate() once dark.
+const AppTask APP_TASKS[] = {
+    { "encoder",   handleEncoder,       &encoderTask,  ENCODER_POLL_MS,        0,                      true,
+      FlightRecorder::DEFAULT_BUDGET_US, true },
+    { "sse",       sendSSEData,         nullptr,       SSE_INTERVAL,           SSE_INTERVAL,           false, 0, false },
+    { "sse-pump",  pumpSSE,             &ssePumpTask,  SSE_PUMP_MS,            0,                      true,
+      FlightRecorder::DEFAULT_BUDGET_US, true },
+    { "timers",    runSchedules,        &timersTask,   1000,                   0,                      true,  0, false },
+    { "clock",     checkClock,          nullptr,       CLOCK_CHECK_S * 1000,   0,                      false, 0, false },
+    { "log",       logSensors,          nullptr,       LOG_INTERVAL_S * 1000,  LOG_INTERVAL_S * 1000,  false,
+      TRACE_FLASH_BUDGET_US, false },
+    { "actuators", processActuators,    &actuatorTask, ACTUATOR_POLL_MS,       0,                      true,
+      FlightRecorder::DEFAULT_BUDGET_US, true },
+    { "ws",        checkControlClients, nullptr,       WS_CHECK_MS,            0,                      false, 0, false },
+    { "config",    syncConfig,          nullptr,       CONFIG_SYNC_MS,         CONFIG_SYNC_MS,         false,
+      TRACE_FLASH_BUDGET_US, false },
+    { "alerts",    publishAlerts,       nullptr,       ALERT_POLL_MS,          0,                      false, 0, false },
+    { "display",   updateDisplay,       &displayTask,  displayUpdateInterval,  0,                      true,  0, false },
+    { "trace",     pollTrace,           nullptr,       TRACE_POLL_MS,          0,                      false,
+      FlightRecorder::DEFAULT_BUDGET_US, true },
+    { "welcome",   finishWelcome,       nullptr,       0,                      WELCOME_MS,             false, 0, false },
+};
+const uint8_t APP_TASK_COUNT = sizeof(APP_TASKS) / sizeof(APP_TASKS[0]);
+
+const AppTask* appTask(const char* name) {
+    for (uint8_t i = 0; i < APP_TASK_COUNT; i++)
+        if (!strcmp(APP_TASKS[i].name, name)) return &APP_TASKS[i];
+    return nullptr;
+}
+
+void appSetup() {
+    hal::pinInputPullup(ENC_CLK);
+    hal::pinInputPullup(ENC_DT);
+    hal::pinInputPullup(ENC_SW);
+    for (uint8_t a = 0; a < ACT_COUNT; a++) hal::pinOutput(RELAY_OUTPUTS[a].pin, RELAY_OUTPUTS[a].level(false));
+
+    flight.begin(hal::resetCause(), hal::cyclesPerUs());
+    scheduler.setObserver(traceTask);
+    if (flight.previous().valid)
+        hal::log("trace: reset by %s%s%s, %u events kept\n", FlightRecorder::causeName(flight.previous().cause),
+                 traceTaskName(flight.previous().task) ? " in " : "",
+                 traceTaskName(flight.previous().task) ? traceTaskName(flight.previous().task) : "",
+                 (unsigned)flight.previous().count);
+
+    // One read brings back the modes, relays and schedules from before the
+    // power cut, so the first control pass already runs with them.
+    if (!configStore.begin()) hal::log("config: none stored, using defaults\n");
+    const HydroConfig& cfg = configStore.current();
+    for (uint8_t a = 0; a < ACT_COUNT; a++)
+        actuators.restore((Actuator)a, cfg.relayBits & (1u << a), cfg.autoBits & (1u << a));
+    analytics.setLimits(cfg.limits);
+    for (uint8_t a = 0; a < ACT_COUNT; a++) actuators.setMinDwell((Actuator)a, MIN_RELAY_DWELL_MS);
+    actuators.setAudit(auditRelay);
+    actuators.setTap(commandSubmitted);
+    inputTrace.begin();
+
+    for (uint8_t ch = 0; ch < SensorHistory::CHANNEL_COUNT; ch++)   // sensor fields lead, in channel order
+        telemetry.setDeadband((TelemetryField)ch, SSE_DEADBAND[ch]);
+    telemetry.setKeyframeInterval(SSE_KEYFRAME_EVERY);
+
+    nextCycle = hal::micros();
+
+    power.setDisplayTimeout(DISPLAY_TIMEOUT_MS, hal::millis());
+    for (uint8_t i = 0; i < cfg.scheduleCount; i++) schedule.add(cfg.schedule[i]);
+    schedule.start(uptimeSec(), cfg.clockTod == HydroConfig::TOD_UNKNOWN ? 0 : cfg.clockTod);
+    sensorLog.begin();
+    lastLogFlush = uptimeSec();
+    for (uint8_t i = 0; i < APP_TASK_COUNT; i++) {
+        const AppTask& t  = APP_TASKS[i];
+        uint8_t        id = t.periodMs ? scheduler.addPeriodic(t.name, t.fn, t.periodMs * 1000ULL, t.firstMs * 1000ULL)
+                                       : scheduler.addOneShot(t.name, t.fn, t.firstMs * 1000ULL);
+        if (t.id) *t.id = id;
+        if (t.budgetUs) flight.setBudget(id, t.budgetUs, t.quiet);
+    }
+
+#if HYDRO_METRICS
+    metrics.addHistogram("hydro_encoder_seconds", "handleEncoder() run time", encoderLatency);
+    metrics.addHistogram("hydro_sensor_update_seconds", "updateSensors() run time", sensorLatency);
+    metrics.addHistogram("hydro_display_update_seconds", "updateDisplay() run time", displayLatency);
+    metrics.addHistogram("hydro_sse_send_seconds", "sendSSEData() run time", sseLatency);
+    metrics.addHistogram("hydro_analytics_seconds", "Per-sample statistics and alert checks", analyticsLatency);
+    metrics.addCounter("hydro_loop_iterations_total", "Control loop passes", loopIterations);
+    metrics.addCounter("hydro_sse_sends_total", "Telemetry events published", sseSends);
+    metrics.addCounter("hydro_relay_toggles_total", "Relay output changes", relayToggles);
+    metrics.addCounter("hydro_i2c_errors_total", "I2C transactions failed or timed out", i2cErrors);
+    metrics.addCounter("hydro_i2c_recoveries_total", "I2C bus recoveries", i2cRecoveries);
+    metrics.addCounter("hydro_input_events_dropped_total", "Encoder events lost to a full queue", inputDropped);
+    metrics.addCounter("hydro_ws_commands_total", "Relay commands received over the control WebSocket", wsCommands);
+    metrics.addGauge("hydro_ws_clients", "Connected control WebSocket clients", wsClients);
+    metrics.addCounter("hydro_log_block_writes_total", "Sensor log blocks written to flash", logBlocks);
+    metrics.addCounter("hydro_log_write_errors_total", "Sensor log block writes that failed", logErrors);
+    metrics.addCounter("hydro_alerts_raised_total", "Sensor alerts raised", alertsRaised);
+    metrics.addGauge("hydro_alerts_active", "Sensor alerts currently active", alertsActive);
+    metrics.addCounter("hydro_config_saves_total", "Configuration writes to flash", configSaves);
+    metrics.addGauge("hydro_sse_clients", "Connected /events clients", sseClients);
+    metrics.addCounter("hydro_sse_coalesced_total", "Frames replaced by a snapshot for lagging clients", sseCoalesced);
+    metrics.addCounter("hydro_sse_dropped_total", "Frames skipped for lagging clients without a snapshot", sseDropped);
+    metrics.addCounter("hydro_sse_evicted_total", "/events clients closed for stalling", sseEvicted);
+    metrics.addCounter("hydro_sse_rejected_total", "/events connections refused at the client cap", sseRejected);
+    metrics.addGauge("hydro_sse_max_lag_ms", "Age of the oldest frame any client has not received", sseMaxLagMs);
+    metrics.addCounter("hydro_trace_stalls_total", "Task runs over their budget", traceStalls);
+    metrics.addCounter("hydro_input_trace_dropped_total", "Input trace records lost to a full inbox",
+                       inputTraceDropped);
+    metrics.addCounter("hydro_power_active_ms_total", "Control loop time spent running tasks", powerActiveMs);
+    metrics.addCounter("hydro_power_idle_ms_total", "Control loop time waiting, too briefly to sleep", powerIdleMs);
+    metrics.addCounter("hydro_power_sleep_ms_total", "Control loop time waiting long enough for light sleep",
+                       powerSleepMs);
+    metrics.addCounter("hydro_power_wakes_total", "Control loop wakes by input, commands and sockets", powerWakes);
+    metrics.addGauge("hydro_display_on", "1 while the LCD is lit", displayLit);
+    metrics.addGauge("hydro_heap_free_bytes", "Free heap", hal::heapFree);
+    metrics.addGauge("hydro_heap_min_free_bytes", "Lowest free heap since boot", hal::heapMinFree);
+    metrics.addGauge("hydro_boot_app_ready_us", "Power-up to appSetup() done, 0 until reached", bootAppReady);
+    metrics.addGauge("hydro_boot_first_control_us", "Power-up to first actuator pass", bootControl);
+    metrics.addGauge("hydro_boot_first_sensors_us", "Power-up to first sensor cycle", bootSensors);
+    metrics.addGauge("hydro_boot_network_up_us", "Power-up to first WiFi join", bootNetwork);
+    metrics.addGauge("hydro_boot_first_sse_us", "Power-up to first telemetry event sent", bootSse);
+#endif
+
+    displayWelcome();
+    markBoot(BOOT_APP_READY);
+}
+
+uint64_t appLoop() {
+    METRIC_INC(loopIterations);
+    uint8_t wakes = power.takeWakes();
+    if (wakes & (1u << WAKE_INPUT))   scheduler.trigger(encoderTask);
+    if (wakes & (1u << WAKE_COMMAND)) scheduler.trigger(actuatorTask);
+    if (wakes & (1u << WAKE_NETWORK)) scheduler.trigger(ssePumpTask);
+    uint64_t idleUs = scheduler.runDue();
+    return power.wakePending() ? 0 : idleUs;
+}
@@ -0,0 +1,213 @@
+#include "ConfigStore.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ByteCodec.h"
+
+static const uint8_t MAGIC0 = 'H';
+static const uint8_t MAGIC1 = 'C';
+
+// =====================================
+//  ENCODING HELPERS
+// =====================================
+static uint32_t floatBits(float f)    { uint32_t v; memcpy(&v, &f, 4); return v; }
+static float    bitsFloat(uint32_t v) { float f; memcpy(&f, &v, 4); return f; }
+
+// Field by field: the structs have padding, so memcmp could see a change
+// that is not there. Floats compare by bits, so an unset (NAN) limit equals
+// itself.
+static bool sameConfig(const HydroConfig& a, const HydroConfig& b) {
+    if (a.autoBits != b.autoBits || a.relayBits != b.relayBits || a.scheduleCount != b.scheduleCount ||
+        a.clockTod != b.clockTod)
+        return false;
+    for (uint8_t i = 0; i < a.scheduleCount; i++) {
+        const ScheduleEntry& x = a.schedule[i];
+        const ScheduleEntry& y = b.schedule[i];
+        if (x.actuator != y.actuator || x.startSec != y.startSec || x.endSec != y.endSec ||
+            x.onSec != y.onSec || x.offSec != y.offSec)
+            return false;
+    }
+    for (uint8_t ch = 0; ch < SensorAnalytics::CHANNELS; ch++) {
+        const ChannelLimits& x = a.limits.ch[ch];
+        const ChannelLimits& y = b.limits.ch[ch];
+        if (floatBits(x.low) != floatBits(y.low) || floatBits(x.high) != floatBits(y.high) ||
+            floatBits(x.hysteresis) != floatBits(y.hysteresis) ||
+            floatBits(x.maxRatePerMin) != floatBits(y.maxRatePerMin) || x.stuckSec != y.stuckSec)
+            return false;
+    }
+    return true;
+}
+
+// =====================================
+//  BLOB FORMAT
+// =====================================
+size_t ConfigStore::encode(const HydroConfig& c, uint8_t* blob) {
+    uint8_t* p = blob + HEADER_SIZE;
+    *p++ = c.autoBits;
+    *p++ = c.relayBits;
+    *p++ = c.scheduleCount;
+    for (uint8_t i = 0; i < c.scheduleCount; i++) {
+        const ScheduleEntry& e = c.schedule[i];
+        *p++ = e.actuator;
+        put32(p, e.startSec); p += 4;
+        put32(p, e.endSec);   p += 4;
+        put32(p, e.onSec);    p += 4;
+        put32(p, e.offSec);   p += 4;
+    }
+    for (uint8_t ch = 0; ch < SensorAnalytics::CHANNELS; ch++) {
+        const ChannelLimits& l = c.limits.ch[ch];
+        put32(p, floatBits(l.low));           p += 4;
+        put32(p, floatBits(l.high));          p += 4;
+        put32(p, floatBits(l.hysteresis));    p += 4;
+        put32(p, floatBits(l.maxRatePerMin)); p += 4;
+        put16(p, l.stuckSec);                 p += 2;
+    }
+    put32(p, c.clockTod); p += 4;
+    uint16_t payload = (uint16_t)(p - blob - HEADER_SIZE);
+
+    blob[0] = MAGIC0;
+    blob[1] = MAGIC1;
+    put16(blob + 2, SCHEMA_VERSION);
+    put16(blob + 4, payload);
+    put16(blob + 6, 0);
+    put32(blob + 8, crc32(blob + HEADER_SIZE, payload));
+    return HEADER_SIZE + payload;
+}
+
+// Each schema version reads its own fields and leaves the rest at the
+// defaults; a new version adds a block guarded by version >= N.
+bool ConfigStore::decode(const uint8_t* blob, size_t len, const HydroConfig& defaults,
+                         HydroConfig& out, uint16_t& version) {
+    if (len < HEADER_SIZE || blob[0] != MAGIC0 || blob[1] != MAGIC1) return false;
+    version          = get16(blob + 2);
+    uint16_t payload = get16(blob + 4);
+    if (version == 0 || HEADER_SIZE + payload > len) return false;
+    const uint8_t* p   = blob + HEADER_SIZE;
+    const uint8_t* end = p + payload;
+    if (get32(blob + 8) != crc32(p, payload)) return false;
+
+    HydroConfig c = defaults;
+    if (version >= 1) {
+        if (end - p < 3) return false;
+        c.autoBits      = *p++;
+        c.relayBits     = *p++;
+        c.scheduleCount = *p++;
+        if (c.scheduleCount > HydroConfig::MAX_SCHEDULE ||
+            (size_t)(end - p) < c.scheduleCount * ENTRY_SIZE)
+            return false;
+        for (uint8_t i = 0; i < c.scheduleCount; i++) {
+            ScheduleEntry& e = c.schedule[i];
+            if (*p >= ACT_COUNT) return false;
+            e.actuator = (Actuator)*p++;
+            e.startSec = get32(p); p += 4;
+            e.endSec   = get32(p); p += 4;
+            e.onSec    = get32(p); p += 4;
+            e.offSec   = get32(p); p += 4;
+        }
+    }
+    if (version >= 2) {
+        if ((size_t)(end - p) < SensorAnalytics::CHANNELS * LIMITS_SIZE) return false;
+        for (uint8_t ch = 0; ch < SensorAnalytics::CHANNELS; ch++) {
+            ChannelLimits& l = c.limits.ch[ch];
+            l.low           = bitsFloat(get32(p)); p += 4;
+            l.high          = bitsFloat(get32(p)); p += 4;
+            l.hysteresis    = bitsFloat(get32(p)); p += 4;
+            l.maxRatePerMin = bitsFloat(get32(p)); p += 4;
+            l.stuckSec      = get16(p);            p += 2;
+        }
+    }
+    if (version >= 3) {
+        if (end - p < 4) return false;
+        c.clockTod = get32(p); p += 4;
+        if (c.clockTod >= ActuatorSchedule::DAY_SEC) c.clockTod = HydroConfig::TOD_UNKNOWN;
+    }
+    out = c;
+    return true;
+}
+
+// =====================================
+//  STORE
+// =====================================
+ConfigStore::ConfigStore(ConfigStorage& storage, ClockFn clock, const HydroConfig& defaults)
+    : storage_(storage), clock_(clock), defaults_(defaults), working_(defaults), dirty_(false),
+      firstDirtyMs_(0), lastDirtyMs_(0) {
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+bool ConfigStore::begin() {
+    uint8_t  blob[MAX_BLOB];
+    size_t   len     = storage_.load(blob, sizeof(blob));
+    uint16_t version = 0;
+    bool     ok      = len && len <= sizeof(blob) && decode(blob, len, defaults_, working_, version);
+    if (!ok) working_ = defaults_;
+    stats_.loadedVersion = ok ? version : 0;
+    published_.write(working_);
+    // An older schema is rewritten in the current one with the next change.
+    return ok;
+}
+
+void ConfigStore::update(const HydroConfig& c) {
+    if (sameConfig(c, working_)) return;
+    working_ = c;
+    published_.write(working_);
+    uint32_t now = clock_();
+    if (!dirty_) firstDirtyMs_ = now;
+    lastDirtyMs_ = now;
+    dirty_       = true;
+    stats_.updates++;
+}
+
+bool ConfigStore::commit(bool force) {
+    if (!dirty_) return false;
+    uint32_t now = clock_();
+    if (!force && now - lastDirtyMs_ < SAVE_QUIET_MS && now - firstDirtyMs_ < SAVE_MAX_MS) return false;
+
+    uint8_t blob[MAX_BLOB];
+    size_t  len = encode(working_, blob);
+    if (!storage_.save(blob, len)) {
+        stats_.saveErrors++;
+        firstDirtyMs_ = lastDirtyMs_ = now;   // try again after another quiet period
+        return false;
+    }
+    dirty_ = false;
+    stats_.saves++;
+    return true;
+}
+
+// =====================================
+//  JSON
+// =====================================
+size_t ConfigStore::toJson(const HydroConfig& c, char* buf, size_t cap) {
+    int len = snprintf(buf, cap, "{\"version\":%u,\"auto\":{", (unsigned)SCHEMA_VERSION);
+    for (uint8_t a = 0; a < ACT_COUNT && len < (int)cap; a++)
+        len += snprintf(buf + len, cap - len, "%s\"%s\":%s", a ? "," : "", ActuatorController::name((Actuator)a),
+                        c.autoBits & (1u << a) ? "true" : "false");
+    if (len < (int)cap) len += snprintf(buf + len, cap - len, "},\"relay\":{");
+    for (uint8_t a = 0; a < ACT_COUNT && len < (int)cap; a++)
+        len += snprintf(buf + len, cap - len, "%s\"%s\":%s", a ? "," : "", ActuatorController::name((Actuator)a),
+                        c.relayBits & (1u << a) ? "true" : "false");
+    if (len < (int)cap) len += snprintf(buf + len, cap - len, "},\"schedule\":[");
+    for (uint8_t i = 0; i < c.scheduleCount && len < (int)cap; i++) {
+        const ScheduleEntry& e = c.schedule[i];
+        len += snprintf(buf + len, cap - len,
+                        "%s{\"device\":\"%s\",\"start\":\"%02u:%02u\",\"end\":\"%02u:%02u\",\"on\":%u,\"off\":%u}",
+                        i ? "," : "", ActuatorController::name(e.actuator),
+                        (unsigned)(e.startSec / 3600), (unsigned)(e.startSec / 60 % 60),
+                        (unsigned)(e.endSec / 3600), (unsigned)(e.endSec / 60 % 60),
+                        (unsigned)(e.onSec / 60), (unsigned)(e.offSec / 60));
+    }
+    if (len < (int)cap) len += snprintf(buf + len, cap - len, "],\"limits\":{");
+    for (uint8_t ch = 0; ch < SensorAnalytics::CHANNELS && len < (int)cap; ch++) {
+        const ChannelLimits& l = c.limits.ch[ch];
+        char low[16], high[16];
+        if (isnan(l.low))  strcpy(low, "null");  else snprintf(low, sizeof(low), "%g", l.low);
+        if (isnan(l.high)) strcpy(high, "null"); else snprintf(high, sizeof(high), "%g", l.high);
+        len += snprintf(buf + len, cap - len, "%s\"%s\":{\"low\":%s,\"high\":%s,\"hysteresis\":%g,\"rate\":%g,\"stuck\":%u}",
+                        ch ? "," : "", SensorHistory::channelName((SensorHistory::Channel)ch), low, high,
+                        l.hysteresis, l.maxRatePerMin, (unsigned)l.stuckSec);
+    }
+    if (len < (int)cap) len += snprintf(buf + len, cap - len, "}}");
+    return len < (int)cap ? len : cap - 1;
+}
@@ -0,0 +1,90 @@
+#include "ConnectionManager.h"
+
+#include <string.h>
+
+ConnectionManager::ConnectionManager(WifiRadio& radio, ClockFn clock, LinkFn onLink)
+    : radio_(radio), clock_(clock), onLink_(onLink), state_(CM_IDLE), usingHint_(false),
+      hintStale_(false), apActive_(false), since_(0), downSince_(0), backoffMs_(BACKOFF_MIN_MS),
+      waitMs_(0), apAfterMs_(0) {
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+const char* ConnectionManager::stateName(State s) {
+    static const char* NAMES[] = { "idle", "joining", "connected", "backoff" };
+    return s <= CM_BACKOFF ? NAMES[s] : "?";
+}
+
+void ConnectionManager::start() {
+    if (state_ != CM_IDLE) return;
+    uint32_t now = clock_();
+    downSince_ = now;
+    backoffMs_ = BACKOFF_MIN_MS;
+    join(now);
+}
+
+// The cached access point is tried whenever there is one, except straight
+// after it has just missed.
+void ConnectionManager::join(uint32_t now) {
+    usingHint_ = radio_.hasHint() && !hintStale_;
+    hintStale_ = false;
+    stats_.attempts++;
+    state_ = CM_JOINING;
+    since_ = now;
+    radio_.begin(usingHint_);
+}
+
+void ConnectionManager::failed(uint32_t now) {
+    state_ = CM_BACKOFF;
+    since_ = now;
+    waitMs_ = backoffMs_;
+    backoffMs_ = backoffMs_ >= BACKOFF_MAX_MS / 2 ? BACKOFF_MAX_MS : backoffMs_ * 2;
+}
+
+void ConnectionManager::poll() {
+    uint32_t now = clock_();
+
+    switch (state_) {
+    case CM_IDLE:
+        return;
+
+    case CM_JOINING:
+        if (radio_.connected()) {
+            state_     = CM_CONNECTED;
+            backoffMs_ = BACKOFF_MIN_MS;
+            stats_.lastJoinMs = now - downSince_;
+            if (usingHint_) stats_.hintJoins++; else stats_.scanJoins++;
+            radio_.joined();
+            if (apActive_) { radio_.stopAp(); apActive_ = false; }
+            if (onLink_) onLink_(true);
+            return;
+        }
+        if (now - since_ < (usingHint_ ? HINT_TIMEOUT_MS : JOIN_TIMEOUT_MS)) break;
+        radio_.disconnect();
+        if (usingHint_) {
+            stats_.hintMisses++;
+            hintStale_ = true;
+            join(now);
+        } else {
+            failed(now);
+        }
+        break;
+
+    case CM_CONNECTED:
+        if (radio_.connected()) return;
+        stats_.drops++;
+        downSince_ = now;
+        backoffMs_ = BACKOFF_MIN_MS;
+        if (onLink_) onLink_(false);
+        join(now);
+        break;
+
+    case CM_BACKOFF:
+        if (now - since_ >= waitMs_) join(now);
+        break;
+    }
+
+    if (apAfterMs_ && !apActive_ && now - downSince_ >= apAfterMs_) {
+        radio_.startAp();
+        apActive_ = true;
+    }
+}
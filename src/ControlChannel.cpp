@@ -0,0 +1,187 @@
+#include "ControlChannel.h"
+
+#include <string.h>
+
+ControlChannel::ControlChannel(ActuatorController& actuators, SendFn send, CloseFn close, ClockFn clock)
+    : actuators_(actuators), send_(send), close_(close), clock_(clock), clientCount_(0),
+      pendingCount_(0), lastRelays_(0), lastAuto_(0), nextPingId_(0) {
+    memset(clients_, 0, sizeof(clients_));
+    memset(pending_, 0, sizeof(pending_));
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+void ControlChannel::encode(uint8_t* out, uint8_t type, uint16_t id, uint8_t a0, uint8_t a1, uint8_t a2) {
+    out[0] = type;
+    out[1] = id;
+    out[2] = id >> 8;
+    out[3] = a0;
+    out[4] = a1;
+    out[5] = a2;
+}
+
+// =====================================
+//  NETWORK CALLBACKS
+// =====================================
+void ControlChannel::connected(uint32_t client) {
+    Inbound in = { client, IN_CONNECT, {} };
+    if (!inbox_.push(in)) { stats_.inboxDropped++; close_(client); }
+}
+
+// Must not be lost, or the client's slot leaks until it times out.
+void ControlChannel::disconnected(uint32_t client) {
+    Inbound in = { client, IN_DISCONNECT, {} };
+    if (!inbox_.push(in)) stats_.inboxDropped++;
+}
+
+bool ControlChannel::received(uint32_t client, const uint8_t* data, size_t len) {
+    if (len != FRAME_SIZE) return false;
+    Inbound in = { client, IN_FRAME, {} };
+    memcpy(in.frame, data, FRAME_SIZE);
+    if (inbox_.push(in)) return true;
+    stats_.inboxDropped++;
+    return false;
+}
+
+// =====================================
+//  ACTUATOR TASK
+// =====================================
+ControlChannel::Client* ControlChannel::findClient(uint32_t id) {
+    for (uint8_t i = 0; i < MAX_CLIENTS; i++)
+        if (clients_[i].used && clients_[i].id == id) return &clients_[i];
+    return nullptr;
+}
+
+uint8_t ControlChannel::relayBits() const {
+    uint8_t bits = 0;
+    for (uint8_t a = 0; a < ACT_COUNT; a++) bits |= actuators_.state((Actuator)a) << a;
+    return bits;
+}
+
+uint8_t ControlChannel::autoBits() const {
+    uint8_t bits = 0;
+    for (uint8_t a = 0; a < ACT_COUNT; a++) bits |= actuators_.autoMode((Actuator)a) << a;
+    return bits;
+}
+
+// Forgets the client and any acks still owed to it.
+void ControlChannel::dropClient(Client& c) {
+    c.used = false;
+    clientCount_--;
+    for (uint8_t i = 0; i < MAX_PENDING; i++)
+        if (pending_[i].used && pending_[i].client == c.id) { pending_[i].used = false; pendingCount_--; }
+}
+
+void ControlChannel::reply(uint32_t client, uint8_t type, uint16_t id, uint8_t a0, uint8_t a1, uint8_t a2) {
+    uint8_t f[FRAME_SIZE];
+    encode(f, type | FROM_SERVER, id, a0, a1, a2);
+    send_(client, f, FRAME_SIZE);
+}
+
+void ControlChannel::ack(Pending& p, AckStatus status) {
+    reply(p.client, FRAME_ACK, p.id, status, relayBits(), autoBits());
+    stats_.acks++;
+    if (status == ACK_TIMEOUT) stats_.timeouts++;
+    p.used = false;
+    pendingCount_--;
+}
+
+void ControlChannel::handleFrame(Client& c, const uint8_t* f) {
+    uint16_t id = f[1] | f[2] << 8;
+    c.lastSeenMs = clock_();
+
+    switch (f[0]) {
+    case FRAME_PING:
+        reply(c.id, FRAME_PONG, id, 0, 0, 0);
+        return;
+    case FRAME_PONG:
+        return;   // only here to refresh lastSeenMs
+    case FRAME_CMD:
+        break;
+    default:
+        stats_.rejected++;
+        reply(c.id, FRAME_ACK, id, ACK_BAD_FRAME, relayBits(), autoBits());
+        return;
+    }
+
+    stats_.commands++;
+    if (f[3] >= ACT_COUNT || f[4] > OP_AUTO) {
+        stats_.rejected++;
+        reply(c.id, FRAME_ACK, id, ACK_BAD_FRAME, relayBits(), autoBits());
+        return;
+    }
+
+    Pending* slot = nullptr;
+    for (uint8_t i = 0; i < MAX_PENDING && !slot; i++)
+        if (!pending_[i].used) slot = &pending_[i];
+    uint32_t seq = slot ? actuators_.submit((Actuator)f[3], (CommandOp)f[4], f[5], SRC_WEB) : 0;
+    if (!seq) {
+        stats_.rejected++;
+        reply(c.id, FRAME_ACK, id, ACK_BUSY, relayBits(), autoBits());
+        return;
+    }
+    slot->client = c.id;
+    slot->seq    = seq;
+    slot->sentMs = clock_();
+    slot->id     = id;
+    slot->used   = true;
+    pendingCount_++;
+}
+
+void ControlChannel::poll() {
+    Inbound in;
+    while (inbox_.pop(in)) {
+        Client* c = findClient(in.client);
+        if (in.kind == IN_CONNECT) {
+            if (c) continue;
+            for (uint8_t i = 0; i < MAX_CLIENTS && !c; i++)
+                if (!clients_[i].used) c = &clients_[i];
+            if (!c) { stats_.clientsDropped++; close_(in.client); continue; }
+            c->id         = in.client;
+            c->lastSeenMs = clock_();
+            c->pingedMs   = c->lastSeenMs;
+            c->used       = true;
+            clientCount_++;
+            reply(in.client, FRAME_STATE, 0, 0, relayBits(), autoBits());
+        } else if (in.kind == IN_DISCONNECT) {
+            if (c) dropClient(*c);
+        } else if (c) {
+            handleFrame(*c, in.frame);
+        }
+    }
+}
+
+void ControlChannel::complete() {
+    if (pendingCount_) {
+        uint32_t acked = actuators_.ackedSeq();
+        for (uint8_t i = 0; i < MAX_PENDING; i++)
+            if (pending_[i].used && (int32_t)(pending_[i].seq - acked) <= 0) ack(pending_[i], ACK_OK);
+    }
+
+    uint8_t relays = relayBits();
+    uint8_t autos  = autoBits();
+    if (relays == lastRelays_ && autos == lastAuto_) return;
+    lastRelays_ = relays;
+    lastAuto_   = autos;
+    if (clientCount_) reply(0, FRAME_STATE, 0, 0, relays, autos);
+}
+
+void ControlChannel::checkClients() {
+    uint32_t now = clock_();
+    for (uint8_t i = 0; i < MAX_PENDING; i++)
+        if (pending_[i].used && now - pending_[i].sentMs >= ACK_TIMEOUT_MS) ack(pending_[i], ACK_TIMEOUT);
+
+    for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+        Client& c = clients_[i];
+        if (!c.used) continue;
+        uint32_t quiet = now - c.lastSeenMs;
+        if (quiet >= CLIENT_TIMEOUT_MS) {
+            // The disconnect event that follows finds no slot and is ignored.
+            stats_.clientsDropped++;
+            dropClient(c);
+            close_(c.id);
+        } else if (quiet >= PING_INTERVAL_MS && now - c.pingedMs >= PING_INTERVAL_MS) {
+            c.pingedMs = now;
+            reply(c.id, FRAME_PING, ++nextPingId_, 0, 0, 0);
+        }
+    }
+}
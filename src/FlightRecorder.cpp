@@ -0,0 +1,220 @@
+#include "FlightRecorder.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+
+const char* const KIND_NAMES[TRACE_KIND_COUNT] = {
+    "boot", "task_start", "task_end", "relay", "i2c_error", "heap_low", "sse_clients", "stall",
+};
+
+const char* const CAUSE_NAMES[RESET_CAUSE_COUNT] = {
+    "unknown", "power-on", "external", "software", "panic", "task watchdog", "interrupt watchdog",
+    "watchdog", "brownout", "deep sleep",
+};
+
+StallTrace noStall() {
+    StallTrace s;
+    memset(&s, 0, sizeof(s));
+    s.task = FlightRecorder::NO_TASK;
+    return s;
+}
+
+}  // namespace
+
+FlightRecorder::FlightRecorder(TraceMemory& mem, StampFn stamp)
+    : mem_(mem), stamp_(stamp), head_(0), freezing_(false), stalled_(false), quiet_(0), stampsPerUs_(1),
+      stalls_(0) {
+    for (uint8_t t = 0; t < MAX_TASKS; t++) budgetUs_[t] = DEFAULT_BUDGET_US;
+    memset(&previous_, 0, sizeof(previous_));
+    previous_.task       = NO_TASK;
+    previous_.stall.task = NO_TASK;
+}
+
+// =====================================
+//  BOOT
+// =====================================
+void FlightRecorder::begin(ResetCause cause, uint32_t stampsPerUs) {
+    stampsPerUs_ = stampsPerUs ? stampsPerUs : 1;
+    memset(&previous_, 0, sizeof(previous_));
+    previous_.cause      = cause;
+    previous_.task       = NO_TASK;
+    previous_.stall.task = NO_TASK;
+
+    // After power-on the memory holds noise; the magic only guards against
+    // a layout from other firmware.
+    if (cause != RESET_POWER_ON && mem_.magic == MAGIC && mem_.stampsPerUs) {
+        previous_.valid       = true;
+        previous_.task        = mem_.task < MAX_TASKS ? mem_.task : NO_TASK;
+        previous_.stampsPerUs = mem_.stampsPerUs;
+        uint32_t end = mem_.head;
+        uint32_t n   = end < KEEP ? end : KEEP;
+        for (uint32_t i = 0; i < n; i++) {
+            const TraceRecord& r = mem_.ring[(end - n + i) & (RING - 1)];
+            if (r.kind < TRACE_KIND_COUNT) previous_.events[previous_.count++] = r;
+        }
+        if (mem_.stall.task < MAX_TASKS && mem_.stall.count <= STALL_KEEP && mem_.stall.stampsPerUs)
+            previous_.stall = mem_.stall;
+    } else {
+        memset((void*)&mem_, 0, sizeof(mem_));
+        mem_.magic = MAGIC;
+    }
+
+    mem_.stampsPerUs = stampsPerUs_;
+    mem_.task        = NO_TASK;
+    mem_.stall       = noStall();
+    stall_.write(mem_.stall);
+    head_.store(mem_.head, std::memory_order_relaxed);
+    record(TRACE_BOOT, cause);
+}
+
+void FlightRecorder::setBudget(uint8_t task, uint32_t budgetUs, bool quiet) {
+    if (task >= MAX_TASKS) return;
+    budgetUs_[task] = budgetUs;
+    if (quiet) quiet_ |= 1u << task;
+    else       quiet_ &= ~(1u << task);
+}
+
+// =====================================
+//  STALLS
+// =====================================
+void FlightRecorder::taskStarted(uint8_t task) {
+    stalled_.store(false, std::memory_order_relaxed);
+    mem_.taskStamp = stamp_();
+    mem_.task      = task;
+    if (!(quiet_ >> task & 1)) record(TRACE_TASK_START, task);
+}
+
+void FlightRecorder::taskEnded(uint8_t task, uint32_t runUs) {
+    mem_.task = NO_TASK;
+    if (!(quiet_ >> task & 1)) record(TRACE_TASK_END, task, runUs > UINT16_MAX ? UINT16_MAX : runUs);
+    if (task < MAX_TASKS && runUs > budgetUs_[task]) freeze(task, runUs);
+}
+
+void FlightRecorder::watch() {
+    uint8_t task = mem_.task;
+    if (task >= MAX_TASKS || stalled_.load(std::memory_order_relaxed)) return;
+    uint32_t runUs = (stamp_() - mem_.taskStamp) / stampsPerUs_;
+    if (runUs > budgetUs_[task] && mem_.task == task) freeze(task, runUs);
+}
+
+// Either core can get here; the first one for a run takes the snapshot.
+void FlightRecorder::freeze(uint8_t task, uint32_t runUs) {
+    bool idle = false;
+    if (!freezing_.compare_exchange_strong(idle, true, std::memory_order_acquire)) return;
+    if (stalled_.exchange(true, std::memory_order_relaxed)) {
+        freezing_.store(false, std::memory_order_release);
+        return;
+    }
+
+    uint32_t ms = runUs / 1000;
+    record(TRACE_STALL, task, ms > UINT16_MAX ? UINT16_MAX : ms);
+
+    StallTrace s;
+    s.task        = task;
+    s.ms          = ms > UINT16_MAX ? UINT16_MAX : ms;
+    s.stampsPerUs = stampsPerUs_;
+    uint32_t end = head_.load(std::memory_order_relaxed);
+    uint32_t n   = end < STALL_KEEP ? end : STALL_KEEP;
+    for (uint32_t i = 0; i < n; i++) s.events[i] = mem_.ring[(end - n + i) & (RING - 1)];
+    s.count = n;
+
+    stall_.write(s);
+    mem_.stall = s;
+    stalls_    = stalls_ + 1;
+    freezing_.store(false, std::memory_order_release);
+}
+
+// =====================================
+//  NAMES / JSON
+// =====================================
+const char* FlightRecorder::kindName(TraceKind k) { return k < TRACE_KIND_COUNT ? KIND_NAMES[k] : "?"; }
+
+const char* FlightRecorder::causeName(ResetCause c) { return c < RESET_CAUSE_COUNT ? CAUSE_NAMES[c] : "?"; }
+
+// Oldest first, each with its time in ms before the newest one. A gap that
+// looks negative came from the other core's counter and counts as 0.
+size_t FlightRecorder::eventsJson(const TraceRecord* ev, uint8_t count, uint32_t stampsPerUs,
+                                  TaskNameFn taskName, char* buf, size_t cap) {
+    uint64_t age = 0;
+    for (uint8_t i = 1; i < count; i++) {
+        uint32_t gap = ev[i].stamp - ev[i - 1].stamp;
+        if (gap < 0x80000000u) age += gap;
+    }
+
+    int len = snprintf(buf, cap, "[");
+    for (uint8_t i = 0; i < count && len < (int)cap; i++) {
+        const TraceRecord& r = ev[i];
+        if (i) {
+            uint32_t gap = r.stamp - ev[i - 1].stamp;
+            if (gap < 0x80000000u) age -= gap;
+        }
+        len += snprintf(buf + len, cap - len, "%s{\"ms\":%.3f,\"kind\":\"%s\"", i ? "," : "",
+                        -(double)age / stampsPerUs / 1000.0, kindName((TraceKind)r.kind));
+        if (len >= (int)cap) break;
+
+        const char* task = taskName(r.arg);
+        switch (r.kind) {
+        case TRACE_BOOT:
+            len += snprintf(buf + len, cap - len, ",\"reset\":\"%s\"}", causeName((ResetCause)r.arg));
+            break;
+        case TRACE_TASK_START:
+            len += snprintf(buf + len, cap - len, ",\"task\":\"%s\"}", task ? task : "?");
+            break;
+        case TRACE_TASK_END:
+            len += snprintf(buf + len, cap - len, ",\"task\":\"%s\",\"us\":%u}", task ? task : "?", (unsigned)r.value);
+            break;
+        case TRACE_RELAY:
+            len += snprintf(buf + len, cap - len, ",\"relay\":%u,\"on\":%s}", (unsigned)r.arg, r.value ? "true" : "false");
+            break;
+        case TRACE_I2C_ERROR:
+            len += snprintf(buf + len, cap - len, ",\"errors\":%u}", (unsigned)r.value);
+            break;
+        case TRACE_HEAP_LOW:
+            len += snprintf(buf + len, cap - len, ",\"heapMin\":%lu}", (unsigned long)r.value * 16);
+            break;
+        case TRACE_SSE_CLIENTS:
+            len += snprintf(buf + len, cap - len, ",\"clients\":%u}", (unsigned)r.value);
+            break;
+        case TRACE_STALL:
+            len += snprintf(buf + len, cap - len, ",\"task\":\"%s\",\"ms\":%u}", task ? task : "?", (unsigned)r.value);
+            break;
+        default:
+            len += snprintf(buf + len, cap - len, "}");
+            break;
+        }
+    }
+    if (len < (int)cap) len += snprintf(buf + len, cap - len, "]");
+    return len < (int)cap ? len : cap - 1;
+}
+
+size_t FlightRecorder::traceJson(const PreviousBoot& prev, const StallTrace& current, TaskNameFn taskName,
+                                 char* buf, size_t cap) {
+    const char* running = prev.task < MAX_TASKS ? taskName(prev.task) : nullptr;
+    int len = snprintf(buf, cap, "{\"reset\":\"%s\",\"recovered\":%s,", causeName(prev.cause),
+                       prev.valid ? "true" : "false");
+    if (len < (int)cap) len += running ? snprintf(buf + len, cap - len, "\"running\":\"%s\",", running)
+                                       : snprintf(buf + len, cap - len, "\"running\":null,");
+    if (len < (int)cap) len += snprintf(buf + len, cap - len, "\"events\":");
+    if (len < (int)cap) len += eventsJson(prev.events, prev.count, prev.stampsPerUs ? prev.stampsPerUs : 1, taskName,
+                                          buf + len, cap - len);
+
+    // This boot's stall, and the one the last boot froze before going down.
+    const StallTrace* stalls[] = { &current, &prev.stall };
+    const char*       keys[]   = { "stall", "previousStall" };
+    for (uint8_t k = 0; k < 2 && len < (int)cap; k++) {
+        const StallTrace& s = *stalls[k];
+        if (s.task >= MAX_TASKS) {
+            len += snprintf(buf + len, cap - len, ",\"%s\":null", keys[k]);
+            continue;
+        }
+        const char* task = taskName(s.task);
+        len += snprintf(buf + len, cap - len, ",\"%s\":{\"task\":\"%s\",\"ms\":%u,\"events\":", keys[k],
+                        task ? task : "?", (unsigned)s.ms);
+        if (len < (int)cap) len += eventsJson(s.events, s.count, s.stampsPerUs, taskName, buf + len, cap - len);
+        if (len < (int)cap) len += snprintf(buf + len, cap - len, "}");
+    }
+    if (len < (int)cap) len += snprintf(buf + len, cap - len, "}");
+    return len < (int)cap ? len : cap - 1;
+}
@@ -0,0 +1,72 @@
+#include "I2cEngine.h"
+
+#include <string.h>
+
+I2cEngine::I2cEngine(I2cBus& bus, ClockFn clock)
+    : bus_(bus), clock_(clock), wake_(nullptr), nextLane_(0), consecutiveErrors_(0) {
+    memset(&stats_, 0, sizeof(stats_));
+    published_.write(stats_);
+    for (uint8_t l = 0; l < LANE_COUNT; l++) queued_[l].store(0, std::memory_order_relaxed);
+}
+
+bool I2cEngine::submit(Lane lane, I2cTransaction* t) {
+    t->queuedAtUs = clock_();
+    t->state.store(I2cTransaction::QUEUED, std::memory_order_release);
+    if (!lanes_[lane].push(t)) {
+        t->state.store(I2cTransaction::IDLE, std::memory_order_release);
+        return false;
+    }
+    queued_[lane].fetch_add(1, std::memory_order_release);
+    if (wake_) wake_();
+    return true;
+}
+
+bool I2cEngine::pending() const {
+    for (uint8_t l = 0; l < LANE_COUNT; l++)
+        if (queued_[l].load(std::memory_order_acquire)) return true;
+    return false;
+}
+
+bool I2cEngine::poll() {
+    I2cTransaction* t = nullptr;
+    for (uint8_t i = 0; i < LANE_COUNT && !t; i++) {
+        uint8_t lane = (nextLane_ + i) % LANE_COUNT;
+        if (lanes_[lane].pop(t)) {
+            queued_[lane].fetch_sub(1, std::memory_order_release);
+            nextLane_ = (lane + 1) % LANE_COUNT;   // round-robin between lanes
+        }
+    }
+    if (!t) return false;
+
+    uint32_t start = clock_();
+    if (t->timeoutUs && start - t->queuedAtUs > t->timeoutUs) {
+        stats_.timedOut++;
+        published_.write(stats_);
+        t->state.store(I2cTransaction::TIMED_OUT, std::memory_order_release);
+        return true;
+    }
+
+    int err = bus_.transfer(t->addr, t->tx, t->txLen, t->rx, t->rxLen);
+    uint32_t took = clock_() - start;
+    if (took > stats_.maxTransferUs) stats_.maxTransferUs = took;
+
+    // Published before the state so a caller that sees its transaction
+    // finish also sees it counted.
+    if (err) {
+        stats_.failed++;
+        bool reset = ++consecutiveErrors_ >= ERRORS_BEFORE_RESET;
+        if (reset) stats_.recoveries++;
+        published_.write(stats_);
+        t->state.store(I2cTransaction::FAILED, std::memory_order_release);
+        if (reset) {
+            bus_.recover();
+            consecutiveErrors_ = 0;
+        }
+    } else {
+        stats_.completed++;
+        consecutiveErrors_ = 0;
+        published_.write(stats_);
+        t->state.store(I2cTransaction::DONE, std::memory_order_release);
+    }
+    return true;
+}
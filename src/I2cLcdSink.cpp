@@ -0,0 +1,83 @@
+#include "I2cLcdSink.h"
+
+// PCF8574 pin mapping used by LiquidCrystal_I2C backpacks.
+static const uint8_t LCD_RS        = 0x01;
+static const uint8_t LCD_EN        = 0x04;
+static const uint8_t LCD_BACKLIGHT = 0x08;
+static const uint8_t LCD_SET_DDRAM = 0x80;
+static const uint8_t LCD_DISPLAY_ON  = 0x0C;   // display control: on, no cursor, no blink
+static const uint8_t LCD_DISPLAY_OFF = 0x08;
+static const uint8_t ROW_OFFSETS[] = { 0x00, 0x40, 0x14, 0x54 };
+
+// Each nibble is three expander writes: settle RS/data, raise EN, drop EN
+// (the HD44780 latches on the falling edge).
+static const uint8_t BYTES_PER_NIBBLE = 3;
+static const uint8_t BYTES_PER_CHAR   = 2 * BYTES_PER_NIBBLE;
+
+I2cLcdSink::I2cLcdSink(I2cEngine& engine, uint8_t addr)
+    : engine_(engine), addr_(addr), next_(0), open_(nullptr), backlight_(true), error_(false) {}
+
+I2cTransaction* I2cLcdSink::current() {
+    if (open_ && open_->txLen + BYTES_PER_CHAR <= I2cTransaction::MAX_TX) return open_;
+    commit();
+
+    I2cTransaction* t = &pool_[next_];
+    if (t->busy()) { error_ = true; return nullptr; }   // bus is behind by a whole pool
+    if (t->status() == I2cTransaction::FAILED || t->status() == I2cTransaction::TIMED_OUT) error_ = true;
+    next_ = (next_ + 1) % POOL;
+
+    t->addr      = addr_;
+    t->txLen     = 0;
+    t->rxLen     = 0;
+    t->timeoutUs = 0;   // late LCD output is still correct output
+    t->state.store(I2cTransaction::IDLE, std::memory_order_relaxed);
+    open_ = t;
+    return t;
+}
+
+void I2cLcdSink::sendByte(uint8_t value, bool data) {
+    I2cTransaction* t = current();
+    if (!t) return;
+    uint8_t flags = (backlight_ ? LCD_BACKLIGHT : 0) | (data ? LCD_RS : 0);
+    const uint8_t nibbles[2] = { (uint8_t)(value & 0xF0), (uint8_t)((value << 4) & 0xF0) };
+    for (uint8_t n = 0; n < 2; n++) {
+        t->tx[t->txLen++] = nibbles[n] | flags;
+        t->tx[t->txLen++] = nibbles[n] | flags | LCD_EN;
+        t->tx[t->txLen++] = nibbles[n] | flags;
+    }
+}
+
+void I2cLcdSink::setCursor(uint8_t col, uint8_t row) {
+    if (row > 3) row = 3;
+    sendByte(LCD_SET_DDRAM | (col + ROW_OFFSETS[row]), false);
+}
+
+void I2cLcdSink::write(const char* data, uint8_t len) {
+    for (uint8_t i = 0; i < len; i++) sendByte((uint8_t)data[i], true);
+}
+
+// The backlight is an expander pin, so it follows the command's bytes.
+void I2cLcdSink::setPower(bool on) {
+    backlight_ = on;
+    sendByte(on ? LCD_DISPLAY_ON : LCD_DISPLAY_OFF, false);
+    commit();
+}
+
+void I2cLcdSink::commit() {
+    if (!open_) return;
+    if (open_->txLen && !engine_.submit(I2cEngine::LANE_DISPLAY, open_)) error_ = true;
+    open_ = nullptr;
+}
+
+bool I2cLcdSink::takeError() {
+    for (uint8_t i = 0; i < POOL; i++) {
+        I2cTransaction::Status s = pool_[i].status();
+        if (s == I2cTransaction::FAILED || s == I2cTransaction::TIMED_OUT) {
+            pool_[i].state.store(I2cTransaction::IDLE, std::memory_order_relaxed);
+            error_ = true;
+        }
+    }
+    bool e = error_;
+    error_ = false;
+    return e;
+}
@@ -0,0 +1,349 @@
+#include "InputTrace.h"
+
+#include <string.h>
+
+#include "ByteCodec.h"
+
+static const uint8_t MAGIC0     = 'I';
+static const uint8_t MAGIC1     = 'T';
+static const uint8_t FLAG_WALL  = 0x01;
+static const uint8_t CHANNELS   = SensorHistory::CHANNEL_COUNT;
+static const uint8_t MAX_RECORD = 1 + 5 + CHANNELS * 5;   // worst-case encoded sample
+
+static_assert((InputTrace::BLOCKS & (InputTrace::BLOCKS - 1)) == 0, "BLOCKS must be a power of two");
+static_assert(InputTrace::HEADER_SIZE + MAX_RECORD <= InputTrace::BLOCK_SIZE, "a record must fit an empty block");
+
+void InputTrace::fileHeader(uint8_t* out) {
+    out[0] = 'H'; out[1] = 'Y'; out[2] = 'T'; out[3] = 'R';
+    out[4] = VERSION;
+    out[5] = CHANNELS;
+    out[6] = ACT_COUNT;
+    out[7] = 0;
+}
+
+bool InputTrace::blockInfo(const uint8_t* block, InputBlockInfo& info) {
+    if (block[0] != MAGIC0 || block[1] != MAGIC1 || block[2] != VERSION) return false;
+    info.seq       = get32(block + 4);
+    info.startMs   = get32(block + 8);
+    info.unixSec   = block[3] & FLAG_WALL ? get32(block + 12) : 0;
+    info.offsetMin = (int16_t)get16(block + 16);
+    info.relays    = block[18];
+    info.autos     = block[19];
+    return true;
+}
+
+// =====================================
+//  PRODUCERS
+// =====================================
+InputTrace::InputTrace(ClockFn clock, WallFn wall, StateFn state)
+    : clock_(clock), wall_(wall), state_(state), sink_(nullptr), dropped_(0), head_(0), fill_(0),
+      started_(false), lastMs_(0), haveSample_(false), relays_(0) {
+    memset(ring_, 0, sizeof(ring_));
+    memset(last_, 0, sizeof(last_));
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+void InputTrace::push(InputRecord& r) {
+    r.ms = clock_();
+    if (!inbox_.push(r)) dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void InputTrace::sample(const int32_t v[SensorHistory::CHANNEL_COUNT]) {
+    InputRecord r = {};
+    r.kind = IN_SAMPLE;
+    memcpy(r.v, v, sizeof(r.v));
+    push(r);
+}
+
+void InputTrace::encoder(const InputEvent& e) {
+    InputRecord r = {};
+    r.kind = IN_ENCODER;
+    r.a    = e.type;
+    r.b    = (uint8_t)e.dir;
+    push(r);
+}
+
+void InputTrace::command(const ActuatorCommand& c) {
+    InputRecord r = {};
+    r.kind = IN_COMMAND;
+    r.a    = c.actuator;
+    r.b    = c.op;
+    r.c    = c.value;
+    push(r);
+}
+
+void InputTrace::relay(Actuator a, bool on) {
+    InputRecord r = {};
+    r.kind = IN_RELAY;
+    r.a    = a;
+    r.b    = on;
+    push(r);
+}
+
+void InputTrace::clock(uint32_t unixSec, int16_t offsetMin) {
+    InputRecord r = {};
+    r.kind = IN_CLOCK;
+    r.v[0] = (int32_t)unixSec;
+    r.v[1] = offsetMin;
+    push(r);
+}
+
+// =====================================
+//  WRITER (owner task)
+// =====================================
+void InputTrace::begin() {
+    if (started_) return;
+    started_ = true;
+    relays_  = (uint8_t)state_();
+    open(0, clock_());
+}
+
+// The slot is announced as reused before it is touched, so a reader that
+// was copying the block it held sees the head move and drops its copy.
+void InputTrace::open(uint32_t seq, uint32_t ms) {
+    head_.store(seq, std::memory_order_relaxed);
+    fill_.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    uint8_t* b = ring_[seq & (BLOCKS - 1)];
+    memset(b, 0, BLOCK_SIZE);
+    b[0] = MAGIC0;
+    b[1] = MAGIC1;
+    b[2] = VERSION;
+    put32(b + 4, seq);
+    put32(b + 8, ms);
+
+    uint32_t unixSec;
+    int16_t  offsetMin;
+    if (wall_(unixSec, offsetMin)) {
+        b[3] |= FLAG_WALL;
+        put32(b + 12, unixSec - (clock_() - ms) / 1000);   // back to the block start
+        put16(b + 16, (uint16_t)offsetMin);
+    }
+    b[18] = relays_;
+    b[19] = (uint8_t)(state_() >> 8);
+
+    lastMs_     = ms;
+    haveSample_ = false;
+    fill_.store(HEADER_SIZE, std::memory_order_release);
+}
+
+void InputTrace::close() {
+    uint32_t seq = head_.load(std::memory_order_relaxed);
+    stats_.blocks++;
+    if (sink_) sink_(ring_[seq & (BLOCKS - 1)], BLOCK_SIZE);
+}
+
+// Relative to the open block: deltas from its last sample and time.
+uint8_t InputTrace::build(const InputRecord& r, uint32_t ms, uint8_t* out) const {
+    uint8_t n = 0;
+    out[n++] = r.kind;
+    n += putVarint(out + n, ms - lastMs_);
+    switch (r.kind) {
+    case IN_SAMPLE:
+        for (uint8_t ch = 0; ch < CHANNELS; ch++)
+            n += putVarint(out + n, zigzag(r.v[ch] - (haveSample_ ? last_[ch] : 0)));
+        break;
+    case IN_ENCODER:
+        out[n++] = r.a << 1 | ((int8_t)r.b > 0);
+        break;
+    case IN_COMMAND:
+        out[n++] = r.a;
+        out[n++] = r.b << 1 | (r.c & 1);
+        break;
+    case IN_RELAY:
+        out[n++] = r.a << 1 | (r.b & 1);
+        break;
+    case IN_CLOCK:
+        put32(out + n, (uint32_t)r.v[0]);
+        put16(out + n + 4, (uint16_t)r.v[1]);
+        n += 6;
+        break;
+    }
+    return n;
+}
+
+void InputTrace::encode(const InputRecord& r) {
+    // Producers on other tasks can stamp a little before ones already drained.
+    uint32_t ms = (int32_t)(r.ms - lastMs_) < 0 ? lastMs_ : r.ms;
+
+    uint8_t  rec[MAX_RECORD];
+    uint8_t  n    = build(r, ms, rec);
+    uint16_t fill = fill_.load(std::memory_order_relaxed);
+    if (fill + n > BLOCK_SIZE) {
+        close();
+        open(head_.load(std::memory_order_relaxed) + 1, ms);
+        n    = build(r, ms, rec);
+        fill = HEADER_SIZE;
+    }
+
+    memcpy(ring_[head_.load(std::memory_order_relaxed) & (BLOCKS - 1)] + fill, rec, n);
+    fill_.store(fill + n, std::memory_order_release);
+
+    lastMs_ = ms;
+    if (r.kind == IN_SAMPLE) {
+        memcpy(last_, r.v, sizeof(last_));
+        haveSample_ = true;
+    } else if (r.kind == IN_RELAY) {
+        if (r.b) relays_ |= 1u << r.a;
+        else     relays_ &= ~(1u << r.a);
+    }
+    stats_.records++;
+}
+
+void InputTrace::drain() {
+    if (!started_) return;
+    InputRecord r;
+    while (inbox_.pop(r)) encode(r);
+    stats_.dropped = dropped_.load(std::memory_order_relaxed);
+}
+
+void InputTrace::finish() {
+    drain();
+    if (started_) close();
+}
+
+// =====================================
+//  READERS (any task)
+// =====================================
+bool InputTrace::copyBlock(uint32_t seq, uint8_t* out) const {
+    for (;;) {
+        uint32_t h1 = head_.load(std::memory_order_acquire);
+        if ((int32_t)(h1 - seq) < 0 || h1 - seq >= BLOCKS) return false;
+        uint16_t len = seq == h1 ? fill_.load(std::memory_order_acquire) : BLOCK_SIZE;
+        if (len < HEADER_SIZE) return false;   // being opened right now
+
+        memcpy(out, ring_[seq & (BLOCKS - 1)], len);
+        memset(out + len, 0, BLOCK_SIZE - len);
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        uint32_t h2 = head_.load(std::memory_order_relaxed);
+        if (h2 - seq >= BLOCKS) return false;   // reused under the copy
+        if (seq != h1 || h2 == h1) return true;
+        // It closed while we read its fill; copy it again whole.
+    }
+}
+
+InputTraceReader::InputTraceReader(const InputTrace& trace) : trace_(trace), pos_(0), len_(0) {
+    last_ = trace.head();
+    next_ = last_ >= InputTrace::BLOCKS - 1 ? last_ - (InputTrace::BLOCKS - 1) : 0;
+    InputTrace::fileHeader(block_);
+    len_ = InputTrace::FILE_HEADER;
+}
+
+bool InputTraceReader::load() {
+    while ((int32_t)(last_ - next_) >= 0) {
+        uint32_t seq = next_++;
+        if (trace_.copyBlock(seq, block_)) {
+            pos_ = 0;
+            len_ = InputTrace::BLOCK_SIZE;
+            return true;
+        }
+        // Overtaken by the writer: skip ahead to what is still in the ring.
+        uint32_t head   = trace_.head();
+        uint32_t oldest = head >= InputTrace::BLOCKS - 1 ? head - (InputTrace::BLOCKS - 1) : 0;
+        if ((int32_t)(oldest - next_) > 0) next_ = oldest;
+    }
+    return false;
+}
+
+size_t InputTraceReader::read(uint8_t* buf, size_t maxLen) {
+    size_t n = 0;
+    while (n < maxLen) {
+        if (pos_ >= len_ && !load()) break;
+        size_t take = len_ - pos_;
+        if (take > maxLen - n) take = maxLen - n;
+        memcpy(buf + n, block_ + pos_, take);
+        pos_ += take;
+        n    += take;
+    }
+    return n;
+}
+
+// =====================================
+//  PARSER
+// =====================================
+InputTraceParser::InputTraceParser(const uint8_t* data, size_t len)
+    : data_(data), len_(len), offset_(InputTrace::FILE_HEADER), valid_(false), inBlock_(false), first_(true),
+      pos_(0), ms_(0), gaps_(0) {
+    memset(last_, 0, sizeof(last_));
+    memset(&info_, 0, sizeof(info_));
+    uint8_t expect[InputTrace::FILE_HEADER];
+    InputTrace::fileHeader(expect);
+    valid_ = len >= InputTrace::FILE_HEADER && memcmp(data, expect, InputTrace::FILE_HEADER) == 0;
+}
+
+bool InputTraceParser::nextBlock() {
+    while (offset_ + InputTrace::BLOCK_SIZE <= len_) {
+        InputBlockInfo info;
+        if (!InputTrace::blockInfo(data_ + offset_, info)) {
+            offset_ += InputTrace::BLOCK_SIZE;
+            continue;
+        }
+        if (!first_ && (int32_t)(info.seq - info_.seq) > 1) gaps_ += info.seq - info_.seq - 1;
+        first_   = false;
+        info_    = info;
+        inBlock_ = true;
+        pos_     = InputTrace::HEADER_SIZE;
+        ms_      = info.startMs;
+        memset(last_, 0, sizeof(last_));
+        return true;
+    }
+    return false;
+}
+
+bool InputTraceParser::next(InputRecord& r) {
+    if (!valid_) return false;
+    for (;;) {
+        if (!inBlock_ && !nextBlock()) return false;
+        const uint8_t* b   = data_ + offset_;
+        const uint16_t end = InputTrace::BLOCK_SIZE;
+        if (pos_ >= end || b[pos_] == IN_END || b[pos_] >= INPUT_KIND_COUNT) {
+            offset_ += InputTrace::BLOCK_SIZE;
+            inBlock_ = false;
+            continue;
+        }
+
+        memset(&r, 0, sizeof(r));
+        r.kind = b[pos_++];
+        uint32_t dt;
+        bool     ok = getVarint(b, pos_, end, dt);
+        switch (r.kind) {
+        case IN_SAMPLE:
+            for (uint8_t ch = 0; ch < CHANNELS && ok; ch++) {
+                uint32_t z;
+                ok = getVarint(b, pos_, end, z);
+                last_[ch] += unzigzag(z);
+                r.v[ch] = last_[ch];
+            }
+            break;
+        case IN_ENCODER:
+            ok = ok && pos_ + 1 <= end;
+            if (ok) {
+                r.a = b[pos_] >> 1;
+                r.b = r.a == EV_STEP ? (uint8_t)(b[pos_] & 1 ? 1 : -1) : 0;
+                pos_ += 1;
+            }
+            break;
+        case IN_COMMAND:
+            ok = ok && pos_ + 2 <= end;
+            if (ok) { r.a = b[pos_]; r.b = b[pos_ + 1] >> 1; r.c = b[pos_ + 1] & 1; pos_ += 2; }
+            break;
+        case IN_RELAY:
+            ok = ok && pos_ + 1 <= end;
+            if (ok) { r.a = b[pos_] >> 1; r.b = b[pos_] & 1; pos_ += 1; }
+            break;
+        case IN_CLOCK:
+            ok = ok && pos_ + 6 <= end;
+            if (ok) { r.v[0] = (int32_t)get32(b + pos_); r.v[1] = (int16_t)get16(b + pos_ + 4); pos_ += 6; }
+            break;
+        }
+        if (!ok) {   // truncated record: the rest of the block is unusable
+            pos_ = end;
+            continue;
+        }
+        ms_ += dt;
+        r.ms = ms_;
+        return true;
+    }
+}
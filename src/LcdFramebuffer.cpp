@@ -0,0 +1,80 @@
+#include "LcdFramebuffer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// Unchanged cells shorter than this between two changed runs are rewritten
+// rather than paying for another setCursor command byte.
+static const uint8_t MERGE_GAP = 1;
+
+LcdFramebuffer::LcdFramebuffer(LcdSink& sink)
+    : sink_(sink), col_(0), row_(0), panelCol_(0xFF), panelRow_(0xFF), valid_(false) {
+    memset(back_, ' ', sizeof(back_));
+    memset(front_, ' ', sizeof(front_));
+    for (uint8_t r = 0; r < ROWS; r++) front_[r][COLS] = '\0';
+}
+
+// =====================================
+//  DRAWING
+// =====================================
+void LcdFramebuffer::beginFrame() {
+    memset(back_, ' ', sizeof(back_));
+    col_ = row_ = 0;
+}
+
+void LcdFramebuffer::setCursor(uint8_t col, uint8_t row) {
+    col_ = col;
+    row_ = row;
+}
+
+void LcdFramebuffer::print(char c) {
+    if (row_ < ROWS && col_ < COLS) back_[row_][col_] = c;
+    col_++;   // like the panel, text past the edge is simply lost
+}
+
+void LcdFramebuffer::print(const char* s) {
+    while (*s) print(*s++);
+}
+
+void LcdFramebuffer::print(float value, int digits) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%.*f", digits, (double)value);
+    print(buf);
+}
+
+void LcdFramebuffer::print(long value) {
+    char buf[12];
+    snprintf(buf, sizeof(buf), "%ld", value);
+    print(buf);
+}
+
+// =====================================
+//  DIFF + FLUSH
+// =====================================
+void LcdFramebuffer::emit(uint8_t row, uint8_t from, uint8_t to) {
+    if (panelRow_ != row || panelCol_ != from) sink_.setCursor(from, row);
+    sink_.write(&back_[row][from], to - from);
+    memcpy(&front_[row][from], &back_[row][from], to - from);
+    panelRow_ = row;
+    panelCol_ = to;   // HD44780 row wrap is non-linear, so never rely on it past COLS
+    if (panelCol_ >= COLS) panelCol_ = 0xFF;
+}
+
+void LcdFramebuffer::flush() {
+    for (uint8_t r = 0; r < ROWS; r++) {
+        uint8_t c = 0;
+        while (c < COLS) {
+            if (valid_ && back_[r][c] == front_[r][c]) { c++; continue; }
+
+            // Extend the run, swallowing short unchanged gaps.
+            uint8_t end = c + 1, gap = 0;
+            for (uint8_t i = end; i < COLS; i++) {
+                if (!valid_ || back_[r][i] != front_[r][i]) { end = i + 1; gap = 0; }
+                else if (++gap > MERGE_GAP) break;
+            }
+            emit(r, c, end);
+            c = end;
+        }
+    }
+    valid_ = true;
+}
@@ -0,0 +1,110 @@
+#include "Metrics.h"
+
+#if HYDRO_METRICS
+
+#include <stdio.h>
+#include <string.h>
+
+// =====================================
+//  REGISTRY
+// =====================================
+bool MetricsRegistry::add(const char* name, const char* help, Kind kind, const void* source, ValueFn fn) {
+    if (count_ >= MAX_METRICS) return false;
+    Metric& m = metrics_[count_++];
+    m.name   = name;
+    m.help   = help;
+    m.kind   = kind;
+    m.source = source;
+    m.fn     = fn;
+    return true;
+}
+
+bool MetricsRegistry::addCounter(const char* name, const char* help, const Counter& c) {
+    return add(name, help, KIND_COUNTER, &c, nullptr);
+}
+
+bool MetricsRegistry::addCounter(const char* name, const char* help, ValueFn fn) {
+    return add(name, help, KIND_COUNTER_FN, nullptr, fn);
+}
+
+bool MetricsRegistry::addGauge(const char* name, const char* help, ValueFn fn) {
+    return add(name, help, KIND_GAUGE_FN, nullptr, fn);
+}
+
+bool MetricsRegistry::addHistogram(const char* name, const char* help, const LatencyHistogram& h) {
+    return add(name, help, KIND_HISTOGRAM, &h, nullptr);
+}
+
+// =====================================
+//  STREAMING READER
+// =====================================
+MetricsReader::MetricsReader(const MetricsRegistry& registry, uint32_t cyclesPerUs)
+    : reg_(registry), secondsPerCycle_(1e-6 / (cyclesPerUs ? cyclesPerUs : 1)),
+      metric_(0), line_(0), cumulative_(0), pendingLen_(0), pendingPos_(0) {}
+
+bool MetricsReader::nextLine() {
+    pendingPos_ = 0;
+    pendingLen_ = 0;
+    if (metric_ >= reg_.count()) return false;
+
+    const MetricsRegistry::Metric& m = reg_.metric(metric_);
+    int  n    = 0;
+    bool last = false;
+
+    if (line_ == 0) {
+        n = snprintf(pending_, sizeof(pending_), "# HELP %s %s\n", m.name, m.help);
+    } else if (line_ == 1) {
+        const char* type = m.kind == MetricsRegistry::KIND_HISTOGRAM ? "histogram"
+                         : m.kind == MetricsRegistry::KIND_GAUGE_FN  ? "gauge" : "counter";
+        n = snprintf(pending_, sizeof(pending_), "# TYPE %s %s\n", m.name, type);
+    } else if (m.kind == MetricsRegistry::KIND_COUNTER) {
+        n = snprintf(pending_, sizeof(pending_), "%s %lu\n", m.name,
+                     (unsigned long)((const Counter*)m.source)->value());
+        last = true;
+    } else if (m.kind != MetricsRegistry::KIND_HISTOGRAM) {
+        n = snprintf(pending_, sizeof(pending_), "%s %lu\n", m.name, (unsigned long)m.fn());
+        last = true;
+    } else {
+        // Cumulative buckets, then _sum and _count.
+        const LatencyHistogram& h = *(const LatencyHistogram*)m.source;
+        uint8_t b = line_ - 2;
+        if (b < LatencyHistogram::BUCKETS) {
+            cumulative_ += h.bucket(b);
+            if (b + 1 < LatencyHistogram::BUCKETS)
+                n = snprintf(pending_, sizeof(pending_), "%s_bucket{le=\"%.3g\"} %lu\n", m.name,
+                             (double)(1UL << (LatencyHistogram::FIRST_BIT + b)) * secondsPerCycle_,
+                             (unsigned long)cumulative_);
+            else
+                n = snprintf(pending_, sizeof(pending_), "%s_bucket{le=\"+Inf\"} %lu\n", m.name,
+                             (unsigned long)cumulative_);
+        } else if (b == LatencyHistogram::BUCKETS) {
+            n = snprintf(pending_, sizeof(pending_), "%s_sum %.6f\n", m.name,
+                         (double)h.sumCycles() * secondsPerCycle_);
+        } else {
+            n = snprintf(pending_, sizeof(pending_), "%s_count %lu\n", m.name, (unsigned long)cumulative_);
+            last = true;
+        }
+    }
+
+    if (last) { metric_++; line_ = 0; cumulative_ = 0; }
+    else      { line_++; }
+
+    if (n < 0) n = 0;
+    pendingLen_ = n < (int)sizeof(pending_) ? n : sizeof(pending_) - 1;
+    return true;
+}
+
+size_t MetricsReader::read(char* buf, size_t maxLen) {
+    size_t len = 0;
+    while (len < maxLen) {
+        if (pendingPos_ == pendingLen_ && !nextLine()) break;
+        size_t chunk = pendingLen_ - pendingPos_;
+        if (chunk > maxLen - len) chunk = maxLen - len;
+        memcpy(buf + len, pending_ + pendingPos_, chunk);
+        pendingPos_ += chunk;
+        len         += chunk;
+    }
+    return len;
+}
+
+#endif
@@ -0,0 +1,82 @@
+#include "PhPipeline.h"
+
+#include <math.h>
+
+// =====================================
+//  FILTER STAGES
+// =====================================
+bool MedianDecimator::push(uint16_t sample, uint16_t& out) {
+    window_[fill_++] = sample;
+    if (fill_ < N) return false;
+    fill_ = 0;
+
+    // Insertion sort of five values beats anything clever at this size.
+    uint16_t v[N];
+    for (uint8_t i = 0; i < N; i++) {
+        uint16_t x = window_[i];
+        int8_t   j = i - 1;
+        while (j >= 0 && v[j] > x) { v[j + 1] = v[j]; j--; }
+        v[j + 1] = x;
+    }
+    out = v[N / 2];
+    return true;
+}
+
+void PhFilterChain::feed(const uint16_t* samples, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        uint16_t m, avg;
+        if (!median_.push(samples[i], m)) continue;
+        if (!mean_.push(m, avg)) continue;
+        ema_.push(avg);
+        outputs_++;
+    }
+}
+
+// =====================================
+//  CALIBRATION
+// =====================================
+PhCalibration PhCalibration::defaults() {
+    PhCalibration c = {};
+    c.version = VERSION;
+    c.count   = 2;
+    c.mv[0] = 1250.0f; c.ph[0] = 7.00f;
+    c.mv[1] = 1515.0f; c.ph[1] = 4.00f;
+    return c;
+}
+
+bool PhCalibration::valid() const {
+    if (version != VERSION || count < 2 || count > MAX_POINTS) return false;
+    for (uint8_t i = 0; i < count; i++) {
+        if (isnan(mv[i]) || isnan(ph[i])) return false;
+        if (i && mv[i] - mv[i - 1] < 1.0f) return false;   // sorted, distinct
+    }
+    return true;
+}
+
+float PhCalibration::toPh(float v) const {
+    uint8_t seg = 0;
+    while (seg + 2 < count && v > mv[seg + 1]) seg++;
+    float slope = (ph[seg + 1] - ph[seg]) / (mv[seg + 1] - mv[seg]);
+    return ph[seg] + (v - mv[seg]) * slope;
+}
+
+void PhCalibration::addPoint(float v, float p) {
+    int8_t slot = -1;
+    for (uint8_t i = 0; i < count; i++)
+        if (fabsf(ph[i] - p) < 0.5f) slot = i;
+    if (slot < 0 && count < MAX_POINTS) slot = count++;
+    if (slot < 0) {
+        slot = 0;
+        for (uint8_t i = 1; i < count; i++)
+            if (fabsf(ph[i] - p) < fabsf(ph[slot] - p)) slot = i;
+    }
+    mv[slot] = v;
+    ph[slot] = p;
+
+    for (uint8_t i = 1; i < count; i++)
+        for (uint8_t j = i; j > 0 && mv[j - 1] > mv[j]; j--) {
+            float t = mv[j]; mv[j] = mv[j - 1]; mv[j - 1] = t;
+            t = ph[j]; ph[j] = ph[j - 1]; ph[j - 1] = t;
+        }
+    version = VERSION;
+}
@@ -0,0 +1,92 @@
+#include "PowerManager.h"
+
+#include <stdio.h>
+#include <string.h>
+
+PowerManager::PowerManager()
+    : wakeFn_(nullptr), pending_(0), sleepEnabled_(false), displayOn_(true), displayTimeoutMs_(0),
+      lastInputMs_(0) {
+    for (uint8_t s = 0; s < WAKE_SOURCE_COUNT; s++) wakes_[s].store(0, std::memory_order_relaxed);
+    memset(&stats_, 0, sizeof(stats_));
+    stats_.displayOn = true;
+}
+
+void PowerManager::setDisplayTimeout(uint32_t ms, uint32_t nowMs) {
+    displayTimeoutMs_ = ms;
+    lastInputMs_      = nowMs;
+}
+
+// =====================================
+//  RESIDENCY
+// =====================================
+uint64_t PowerManager::waitFor(uint64_t idleUs) const {
+    if (wakePending()) return 0;
+    return idleUs < MAX_WAIT_US ? idleUs : MAX_WAIT_US;
+}
+
+void PowerManager::ran(uint64_t us) {
+    stats_.activeUs += us;
+}
+
+// Light sleep is entered or not when the wait starts, so a wait cut short
+// by a wake still counts by what was planned.
+void PowerManager::waited(uint64_t plannedUs, uint64_t us) {
+    stats_.waits++;
+    if (sleepEnabled() && plannedUs >= SLEEP_MIN_US) {
+        stats_.sleepUs += us;
+        stats_.sleeps++;
+    } else {
+        stats_.idleUs += us;
+    }
+    publish();
+}
+
+void PowerManager::publish() {
+    for (uint8_t s = 0; s < WAKE_SOURCE_COUNT; s++) stats_.wakes[s] = wakes_[s].load(std::memory_order_relaxed);
+    stats_.displayOn    = displayOn();
+    stats_.sleepEnabled = sleepEnabled();
+    published_.write(stats_);
+}
+
+// =====================================
+//  DISPLAY
+// =====================================
+bool PowerManager::input(uint32_t nowMs) {
+    lastInputMs_ = nowMs;
+    if (displayOn()) return true;
+    displayOn_.store(true, std::memory_order_relaxed);
+    return false;
+}
+
+bool PowerManager::displayTimedOut(uint32_t nowMs) {
+    if (!displayTimeoutMs_ || !displayOn() || nowMs - lastInputMs_ < displayTimeoutMs_) return false;
+    displayOn_.store(false, std::memory_order_relaxed);
+    stats_.displayOffs++;
+    return true;
+}
+
+// =====================================
+//  JSON
+// =====================================
+const char* PowerManager::wakeName(WakeSource s) {
+    static const char* NAMES[WAKE_SOURCE_COUNT] = { "input", "command", "network" };
+    return s < WAKE_SOURCE_COUNT ? NAMES[s] : "?";
+}
+
+size_t PowerManager::statsJson(const Stats& s, char* buf, size_t cap) {
+    uint64_t total = s.activeUs + s.idleUs + s.sleepUs;
+    double   scale = total ? 100.0 / total : 0.0;
+    int len = snprintf(buf, cap,
+                       "{\"sleepEnabled\":%s,\"displayOn\":%s,\"activeMs\":%llu,\"idleMs\":%llu,\"sleepMs\":%llu,"
+                       "\"activePct\":%.2f,\"idlePct\":%.2f,\"sleepPct\":%.2f,\"waits\":%u,\"sleeps\":%u,"
+                       "\"displayOffs\":%u,\"wakes\":{",
+                       s.sleepEnabled ? "true" : "false", s.displayOn ? "true" : "false",
+                       (unsigned long long)(s.activeUs / 1000), (unsigned long long)(s.idleUs / 1000),
+                       (unsigned long long)(s.sleepUs / 1000), s.activeUs * scale, s.idleUs * scale,
+                       s.sleepUs * scale, (unsigned)s.waits, (unsigned)s.sleeps, (unsigned)s.displayOffs);
+    for (uint8_t w = 0; w < WAKE_SOURCE_COUNT && len < (int)cap; w++)
+        len += snprintf(buf + len, cap - len, "%s\"%s\":%u", w ? "," : "", wakeName((WakeSource)w),
+                        (unsigned)s.wakes[w]);
+    if (len < (int)cap) len += snprintf(buf + len, cap - len, "}}");
+    return len < (int)cap ? len : cap - 1;
+}
@@ -0,0 +1,24 @@
+#include "RotaryInput.h"
+
+uint8_t DebouncedButton::update(bool pressed, uint32_t nowMs) {
+    if (pressed != raw_) {
+        raw_       = pressed;
+        changedMs_ = nowMs;
+    }
+
+    if (raw_ != stable_ && nowMs - changedMs_ >= DEBOUNCE_MS) {
+        stable_ = raw_;
+        if (stable_) {
+            pressedMs_ = nowMs;
+            longSent_  = false;
+            return NONE;
+        }
+        return longSent_ ? NONE : (uint8_t)EV_CLICK;
+    }
+
+    if (stable_ && !longSent_ && nowMs - pressedMs_ >= LONG_PRESS_MS) {
+        longSent_ = true;
+        return EV_LONG_PRESS;
+    }
+    return NONE;
+}
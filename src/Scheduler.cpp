@@ -0,0 +1,150 @@
+#include "Scheduler.h"
+
+#include <string.h>
+
+Scheduler::Scheduler(ClockFn clock) : clock_(clock), observer_(nullptr), heapSize_(0) {
+    memset(tasks_, 0, sizeof(tasks_));
+    for (uint8_t i = 0; i < MAX_TASKS; i++) tasks_[i].heapPos = NO_TASK;
+}
+
+// =====================================
+//  TASK REGISTRATION
+// =====================================
+uint8_t Scheduler::allocate(const char* name, TaskFn fn, uint64_t periodUs, uint64_t deadline) {
+    for (uint8_t id = 0; id < MAX_TASKS; id++) {
+        Task& t = tasks_[id];
+        if (t.fn) continue;
+        t.name     = name;
+        t.fn       = fn;
+        t.periodUs = periodUs;
+        t.deadline = deadline;
+        memset(&t.stats, 0, sizeof(t.stats));
+        push(id);
+        return id;
+    }
+    return NO_TASK;
+}
+
+uint8_t Scheduler::addPeriodic(const char* name, TaskFn fn, uint64_t periodUs, uint64_t firstDelayUs) {
+    if (!fn || periodUs == 0) return NO_TASK;
+    return allocate(name, fn, periodUs, clock_() + firstDelayUs);
+}
+
+uint8_t Scheduler::addOneShot(const char* name, TaskFn fn, uint64_t delayUs) {
+    if (!fn) return NO_TASK;
+    return allocate(name, fn, 0, clock_() + delayUs);
+}
+
+void Scheduler::trigger(uint8_t id) {
+    rescheduleAt(id, clock_());
+}
+
+void Scheduler::rescheduleAt(uint8_t id, uint64_t atUs) {
+    if (!isActive(id)) return;
+    remove(id);
+    tasks_[id].deadline = atUs;
+    push(id);
+}
+
+void Scheduler::cancel(uint8_t id) {
+    if (!isActive(id)) return;
+    remove(id);
+    tasks_[id].fn = nullptr;
+}
+
+void Scheduler::resetStats() {
+    for (uint8_t id = 0; id < MAX_TASKS; id++) memset(&tasks_[id].stats, 0, sizeof(TaskStats));
+}
+
+// =====================================
+//  DISPATCH
+// =====================================
+uint64_t Scheduler::runDue() {
+    // Bounded so a task that keeps re-triggering itself cannot starve the caller.
+    for (uint8_t budget = MAX_TASKS * 2; budget && heapSize_; budget--) {
+        uint8_t  id    = heap_[0];
+        Task&    t     = tasks_[id];
+        uint64_t start = clock_();
+        if (t.deadline > start) break;
+
+        remove(id);
+        uint64_t late = start - t.deadline;
+        if (observer_) observer_(id, false, 0);
+        t.fn();
+        uint64_t end  = clock_();
+        uint64_t took = end - start;
+        if (observer_) observer_(id, true, took > UINT32_MAX ? UINT32_MAX : (uint32_t)took);
+
+        TaskStats& s = t.stats;
+        s.runs++;
+        s.lastRunUs   = (uint32_t)took;
+        s.totalRunUs += took;
+        s.lastLateUs  = late > UINT32_MAX ? UINT32_MAX : (uint32_t)late;
+        if (s.lastRunUs  > s.maxRunUs)  s.maxRunUs  = s.lastRunUs;
+        if (s.lastLateUs > s.maxLateUs) s.maxLateUs = s.lastLateUs;
+
+        // The task may have cancelled or rescheduled itself while running.
+        if (!t.fn || t.heapPos != NO_TASK) continue;
+        if (t.periodUs == 0) { t.fn = nullptr; continue; }
+
+        t.deadline += t.periodUs;
+        if (t.deadline <= end) t.deadline = end + t.periodUs;   // overran: skip missed periods
+        push(id);
+    }
+    return timeUntilNext();
+}
+
+uint64_t Scheduler::timeUntilNext() const {
+    if (!heapSize_) return NEVER;
+    uint64_t now  = clock_();
+    uint64_t next = tasks_[heap_[0]].deadline;
+    return next > now ? next - now : 0;
+}
+
+// =====================================
+//  MIN-HEAP
+// =====================================
+void Scheduler::push(uint8_t id) {
+    uint8_t pos = heapSize_++;
+    heap_[pos] = id;
+    tasks_[id].heapPos = pos;
+    siftUp(pos);
+}
+
+void Scheduler::remove(uint8_t id) {
+    uint8_t pos = tasks_[id].heapPos;
+    if (pos == NO_TASK) return;
+    uint8_t last = --heapSize_;
+    if (pos != last) {
+        swap(pos, last);
+        siftUp(pos);
+        siftDown(pos);
+    }
+    tasks_[id].heapPos = NO_TASK;
+}
+
+void Scheduler::siftUp(uint8_t pos) {
+    while (pos > 0) {
+        uint8_t parent = (pos - 1) / 2;
+        if (!earlier(pos, parent)) break;
+        swap(pos, parent);
+        pos = parent;
+    }
+}
+
+void Scheduler::siftDown(uint8_t pos) {
+    for (;;) {
+        uint8_t l = 2 * pos + 1, r = l + 1, best = pos;
+        if (l < heapSize_ && earlier(l, best)) best = l;
+        if (r < heapSize_ && earlier(r, best)) best = r;
+        if (best == pos) break;
+        swap(pos, best);
+        pos = best;
+    }
+}
+
+void Scheduler::swap(uint8_t a, uint8_t b) {
+    uint8_t ta = heap_[a], tb = heap_[b];
+    heap_[a] = tb; tasks_[tb].heapPos = a;
+    heap_[b] = ta; tasks_[ta].heapPos = b;
+}
@@ -0,0 +1,148 @@
+#include "SensorAnalytics.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+SensorAnalytics::SensorAnalytics() {
+    memset(track_, 0, sizeof(track_));
+    memset(&state_, 0, sizeof(state_));
+    AlertLimits none;
+    for (uint8_t ch = 0; ch < CHANNELS; ch++) none.ch[ch] = { NAN, NAN, 0, 0, 0 };
+    limits_.write(none);
+}
+
+const char* SensorAnalytics::kindName(AlertKind k) {
+    static const char* NAMES[ALERT_KIND_COUNT] = { "low", "high", "rate", "stuck" };
+    return k < ALERT_KIND_COUNT ? NAMES[k] : "?";
+}
+
+// =====================================
+//  PER SAMPLE
+// =====================================
+void SensorAnalytics::update(uint32_t tMs, const int32_t samples[CHANNELS]) {
+    const AlertLimits lim  = limits_.read();
+    uint32_t          tSec = tMs / 1000;
+
+    for (uint8_t ch = 0; ch < CHANNELS; ch++) {
+        Track& t = track_[ch];
+        float  x = samples[ch] / (float)SensorHistory::sampleScale((SensorHistory::Channel)ch);
+
+        t.n++;
+        float d = x - t.mean;
+        t.mean += d / t.n;
+        t.m2   += d * (x - t.mean);
+
+        if (t.n == 1) {
+            t.ewma       = x;
+            t.rate       = 0;
+            t.lastSample = samples[ch];
+        } else {
+            uint32_t dtMs = tMs - t.prevMs;
+            t.ewma += EWMA_ALPHA * (x - t.ewma);
+            if (dtMs) t.rate += RATE_ALPHA * ((t.ewma - t.prevEwma) * 60000.0f / dtMs - t.rate);
+            if (samples[ch] == t.lastSample) t.unchangedMs += dtMs;
+            else                             { t.lastSample = samples[ch]; t.unchangedMs = 0; }
+        }
+        t.prevEwma = t.ewma;
+        t.prevMs   = tMs;
+
+        ChannelStats& s = state_.stats[ch];
+        s.n            = t.n;
+        s.mean         = t.mean;
+        s.stddev       = t.n > 1 ? sqrtf(t.m2 / (t.n - 1)) : 0;
+        s.ewma         = t.ewma;
+        s.ratePerMin   = t.rate;
+        s.unchangedSec = t.unchangedMs / 1000;
+
+        check(ch, lim.ch[ch], tSec);
+    }
+    published_.write(state_);
+}
+
+// Raise when past the limit, clear only once back by the hysteresis. A
+// limit switched off clears its alert.
+void SensorAnalytics::check(uint8_t ch, const ChannelLimits& lim, uint32_t tSec) {
+    const Track& t      = track_[ch];
+    uint8_t      active = state_.active[ch];
+    float        v      = t.ewma;
+    float        rate   = fabsf(t.rate);
+
+    bool low = active & (1u << ALERT_LOW);
+    if (isnan(lim.low))                              { if (low) set(ch, ALERT_LOW, false, v, tSec); }
+    else if (!low && v < lim.low)                    set(ch, ALERT_LOW, true, v, tSec);
+    else if (low && v >= lim.low + lim.hysteresis)   set(ch, ALERT_LOW, false, v, tSec);
+
+    bool high = active & (1u << ALERT_HIGH);
+    if (isnan(lim.high))                             { if (high) set(ch, ALERT_HIGH, false, v, tSec); }
+    else if (!high && v > lim.high)                  set(ch, ALERT_HIGH, true, v, tSec);
+    else if (high && v <= lim.high - lim.hysteresis) set(ch, ALERT_HIGH, false, v, tSec);
+
+    bool fast = active & (1u << ALERT_RATE);
+    if (lim.maxRatePerMin <= 0)                      { if (fast) set(ch, ALERT_RATE, false, t.rate, tSec); }
+    else if (!fast && rate > lim.maxRatePerMin)      set(ch, ALERT_RATE, true, t.rate, tSec);
+    else if (fast && rate < lim.maxRatePerMin / 2)   set(ch, ALERT_RATE, false, t.rate, tSec);
+
+    bool stuck = active & (1u << ALERT_STUCK);
+    bool still = lim.stuckSec && t.unchangedMs >= lim.stuckSec * 1000UL;
+    if (still != stuck) set(ch, ALERT_STUCK, still, v, tSec);
+}
+
+void SensorAnalytics::set(uint8_t ch, AlertKind k, bool on, float value, uint32_t tSec) {
+    if (on) state_.active[ch] |= 1u << k;
+    else    state_.active[ch] &= ~(1u << k);
+
+    AlertEvent& e = state_.recent[state_.events % RECENT_EVENTS];
+    e.seq     = ++state_.events;
+    e.tSec    = tSec;
+    e.value   = value;
+    e.channel = ch;
+    e.kind    = k;
+    e.raised  = on;
+    if (on) state_.raised++;
+}
+
+// =====================================
+//  JSON
+// =====================================
+size_t SensorAnalytics::eventJson(const AlertEvent& e, char* buf, size_t cap) {
+    SensorHistory::Channel ch = (SensorHistory::Channel)e.channel;
+    int decimals = e.kind == ALERT_RATE ? 3 : SensorHistory::channelDecimals(ch);
+    int len = snprintf(buf, cap, "{\"seq\":%u,\"t\":%u,\"sensor\":\"%s\",\"kind\":\"%s\",\"state\":\"%s\",\"value\":%.*f}",
+                       (unsigned)e.seq, (unsigned)e.tSec, SensorHistory::channelName(ch),
+                       kindName((AlertKind)e.kind), e.raised ? "raised" : "cleared", decimals, e.value);
+    return len < (int)cap ? len : cap - 1;
+}
+
+size_t SensorAnalytics::stateJson(const State& s, char* buf, size_t cap) {
+    int  len   = snprintf(buf, cap, "{\"active\":[");
+    bool first = true;
+    for (uint8_t ch = 0; ch < CHANNELS; ch++) {
+        for (uint8_t k = 0; k < ALERT_KIND_COUNT && len < (int)cap; k++) {
+            if (!(s.active[ch] & (1u << k))) continue;
+            len += snprintf(buf + len, cap - len, "%s{\"sensor\":\"%s\",\"kind\":\"%s\"}", first ? "" : ",",
+                            SensorHistory::channelName((SensorHistory::Channel)ch), kindName((AlertKind)k));
+            first = false;
+        }
+    }
+
+    // Newest first.
+    if (len < (int)cap) len += snprintf(buf + len, cap - len, "],\"raised\":%u,\"events\":[", (unsigned)s.raised);
+    uint32_t kept = s.events < RECENT_EVENTS ? s.events : RECENT_EVENTS;
+    for (uint32_t i = 0; i < kept && len + 1 < (int)cap; i++) {
+        if (i) buf[len++] = ',';
+        len += eventJson(s.recent[(s.events - 1 - i) % RECENT_EVENTS], buf + len, cap - len);
+    }
+
+    if (len < (int)cap) len += snprintf(buf + len, cap - len, "],\"stats\":{");
+    for (uint8_t ch = 0; ch < CHANNELS && len < (int)cap; ch++) {
+        const ChannelStats& st = s.stats[ch];
+        int d = SensorHistory::channelDecimals((SensorHistory::Channel)ch) + 1;
+        len += snprintf(buf + len, cap - len,
+                        "%s\"%s\":{\"n\":%u,\"mean\":%.*f,\"stddev\":%.*f,\"ewma\":%.*f,\"rate\":%.4f,\"unchanged\":%u}",
+                        ch ? "," : "", SensorHistory::channelName((SensorHistory::Channel)ch), (unsigned)st.n,
+                        d, st.mean, d, st.stddev, d, st.ewma, st.ratePerMin, (unsigned)st.unchangedSec);
+    }
+    if (len < (int)cap) len += snprintf(buf + len, cap - len, "}}");
+    return len < (int)cap ? len : cap - 1;
+}
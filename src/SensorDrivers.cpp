@@ -0,0 +1,202 @@
+#include "SensorDrivers.h"
+
+#include <string.h>
+
+// Drives one request/response step on a driver-owned transaction: submits it
+// the first time, then reports 0 while in flight, 1 on success, -1 on failure.
+static int8_t exchange(I2cEngine& engine, I2cTransaction& t, uint8_t addr,
+                       const uint8_t* tx, uint8_t txLen, uint8_t rxLen, uint32_t timeoutUs) {
+    switch (t.status()) {
+    case I2cTransaction::IDLE:
+        t.addr      = addr;
+        t.txLen     = txLen;
+        t.rxLen     = rxLen;
+        t.timeoutUs = timeoutUs;
+        if (txLen) memcpy(t.tx, tx, txLen);
+        return engine.submit(I2cEngine::LANE_SENSOR, &t) ? 0 : -1;
+    case I2cTransaction::QUEUED:
+        return 0;
+    case I2cTransaction::DONE:
+        t.state.store(I2cTransaction::IDLE, std::memory_order_relaxed);
+        return 1;
+    default:
+        t.state.store(I2cTransaction::IDLE, std::memory_order_relaxed);
+        return -1;
+    }
+}
+
+static bool reached(uint32_t nowUs, uint32_t atUs) { return (int32_t)(nowUs - atUs) >= 0; }
+
+// A sensor read must get the bus within a couple of LCD chunks.
+static const uint32_t SENSOR_TXN_TIMEOUT_US = 20000;
+
+// =====================================
+//  BMP180
+// =====================================
+// Register map and compensation follow the Bosch BMP180 datasheet.
+static const uint8_t  BMP_REG_CALIB   = 0xAA;
+static const uint8_t  BMP_REG_CONTROL = 0xF4;
+static const uint8_t  BMP_REG_RESULT  = 0xF6;
+static const uint8_t  BMP_CMD_TEMP    = 0x2E;
+static const uint8_t  BMP_CMD_PRESS   = 0x34;
+static const uint32_t BMP_TEMP_WAIT_US     = 4500;
+static const uint32_t BMP_PRESS_WAIT_US[4] = { 4500, 7500, 13500, 25500 };
+
+Bmp180Driver::Bmp180Driver(I2cEngine& engine, uint8_t oversampling)
+    : engine_(engine), oss_(oversampling > 3 ? 3 : oversampling), state_(S_IDLE),
+      calibrated_(false), valid_(false), waitUntilUs_(0), b5_(0), tempDeci_(0), pressurePa_(0),
+      ac1_(0), ac2_(0), ac3_(0), b1_(0), b2_(0), mb_(0), mc_(0), md_(0), ac4_(0), ac5_(0), ac6_(0) {}
+
+void Bmp180Driver::startCycle() {
+    if (state_ != S_IDLE) return;   // previous cycle still running
+    valid_ = false;
+    state_ = calibrated_ ? S_T_START : S_CALIB;
+}
+
+void Bmp180Driver::finish(bool ok) {
+    valid_       = ok;
+    state_       = S_IDLE;
+    waitUntilUs_ = 0;
+}
+
+int32_t Bmp180Driver::computeB5(int32_t ut) const {
+    int32_t x1 = ((ut - (int32_t)ac6_) * (int32_t)ac5_) >> 15;
+    int32_t x2 = ((int32_t)mc_ << 11) / (x1 + (int32_t)md_);
+    return x1 + x2;
+}
+
+int32_t Bmp180Driver::computePressure(int32_t up, int32_t b5) const {
+    int32_t  b6 = b5 - 4000;
+    int32_t  x1 = ((int32_t)b2_ * ((b6 * b6) >> 12)) >> 11;
+    int32_t  x2 = ((int32_t)ac2_ * b6) >> 11;
+    int32_t  x3 = x1 + x2;
+    int32_t  b3 = ((((int32_t)ac1_ * 4 + x3) << oss_) + 2) / 4;
+    x1 = ((int32_t)ac3_ * b6) >> 13;
+    x2 = ((int32_t)b1_ * ((b6 * b6) >> 12)) >> 16;
+    x3 = ((x1 + x2) + 2) >> 2;
+    uint32_t b4 = ((uint32_t)ac4_ * (uint32_t)(x3 + 32768)) >> 15;
+    uint32_t b7 = ((uint32_t)up - b3) * (uint32_t)(50000UL >> oss_);
+    int32_t  p  = b7 < 0x80000000UL ? (int32_t)((b7 * 2) / b4) : (int32_t)((b7 / b4) * 2);
+    x1 = (p >> 8) * (p >> 8);
+    x1 = (x1 * 3038) >> 16;
+    x2 = (-7357 * p) >> 16;
+    return p + ((x1 + x2 + 3791) >> 4);
+}
+
+void Bmp180Driver::poll(uint32_t nowUs) {
+    const uint8_t* rx = txn_.rx;
+    int8_t r;
+
+    switch (state_) {
+    case S_IDLE:
+        return;
+
+    case S_CALIB: {
+        const uint8_t tx[] = { BMP_REG_CALIB };
+        if ((r = exchange(engine_, txn_, ADDRESS, tx, 1, 22, SENSOR_TXN_TIMEOUT_US)) == 0) return;
+        if (r < 0) { finish(false); return; }
+        ac1_ = (int16_t)(rx[0] << 8 | rx[1]);   ac2_ = (int16_t)(rx[2] << 8 | rx[3]);
+        ac3_ = (int16_t)(rx[4] << 8 | rx[5]);   ac4_ = (uint16_t)(rx[6] << 8 | rx[7]);
+        ac5_ = (uint16_t)(rx[8] << 8 | rx[9]);  ac6_ = (uint16_t)(rx[10] << 8 | rx[11]);
+        b1_  = (int16_t)(rx[12] << 8 | rx[13]); b2_  = (int16_t)(rx[14] << 8 | rx[15]);
+        mb_  = (int16_t)(rx[16] << 8 | rx[17]); mc_  = (int16_t)(rx[18] << 8 | rx[19]);
+        md_  = (int16_t)(rx[20] << 8 | rx[21]);
+        calibrated_ = md_ != 0;   // an all-zero block means the read was bogus
+        if (!calibrated_) { finish(false); return; }
+        state_ = S_T_START;
+        return;
+    }
+
+    case S_T_START: {
+        const uint8_t tx[] = { BMP_REG_CONTROL, BMP_CMD_TEMP };
+        if ((r = exchange(engine_, txn_, ADDRESS, tx, 2, 0, SENSOR_TXN_TIMEOUT_US)) == 0) return;
+        if (r < 0) { finish(false); return; }
+        waitUntilUs_ = nowUs + BMP_TEMP_WAIT_US;
+        state_       = S_T_CONVERT;
+        return;
+    }
+
+    case S_T_CONVERT:
+        if (!reached(nowUs, waitUntilUs_)) return;
+        waitUntilUs_ = 0;
+        state_       = S_T_READ;
+        // fall through
+    case S_T_READ: {
+        const uint8_t tx[] = { BMP_REG_RESULT };
+        if ((r = exchange(engine_, txn_, ADDRESS, tx, 1, 2, SENSOR_TXN_TIMEOUT_US)) == 0) return;
+        if (r < 0) { finish(false); return; }
+        b5_       = computeB5((int32_t)(rx[0] << 8 | rx[1]));
+        tempDeci_ = (b5_ + 8) >> 4;
+        state_    = S_P_START;
+        return;
+    }
+
+    case S_P_START: {
+        const uint8_t tx[] = { BMP_REG_CONTROL, (uint8_t)(BMP_CMD_PRESS + (oss_ << 6)) };
+        if ((r = exchange(engine_, txn_, ADDRESS, tx, 2, 0, SENSOR_TXN_TIMEOUT_US)) == 0) return;
+        if (r < 0) { finish(false); return; }
+        waitUntilUs_ = nowUs + BMP_PRESS_WAIT_US[oss_];
+        state_       = S_P_CONVERT;
+        return;
+    }
+
+    case S_P_CONVERT:
+        if (!reached(nowUs, waitUntilUs_)) return;
+        waitUntilUs_ = 0;
+        state_       = S_P_READ;
+        // fall through
+    case S_P_READ: {
+        const uint8_t tx[] = { BMP_REG_RESULT };
+        if ((r = exchange(engine_, txn_, ADDRESS, tx, 1, 3, SENSOR_TXN_TIMEOUT_US)) == 0) return;
+        if (r < 0) { finish(false); return; }
+        int32_t up  = ((int32_t)rx[0] << 16 | (int32_t)rx[1] << 8 | rx[2]) >> (8 - oss_);
+        pressurePa_ = computePressure(up, b5_);
+        finish(true);
+        return;
+    }
+    }
+}
+
+// =====================================
+//  BH1750
+// =====================================
+// Runs in continuous high-resolution mode, so a cycle is a single 2-byte read
+// of the latest conversion (1 count = 1/1.2 lx at the default MTreg).
+static const uint8_t BH1750_CONTINUOUS_HIGH_RES = 0x10;
+
+Bh1750Driver::Bh1750Driver(I2cEngine& engine)
+    : engine_(engine), state_(S_IDLE), configured_(false), valid_(false), lux_(0) {}
+
+void Bh1750Driver::startCycle() {
+    if (state_ != S_IDLE) return;
+    valid_ = false;
+    state_ = configured_ ? S_READ : S_CONFIGURE;
+}
+
+void Bh1750Driver::poll(uint32_t) {
+    int8_t r;
+    switch (state_) {
+    case S_IDLE:
+        return;
+
+    case S_CONFIGURE: {
+        // The first conversion takes ~180 ms, so this cycle reports no value.
+        const uint8_t tx[] = { BH1750_CONTINUOUS_HIGH_RES };
+        if ((r = exchange(engine_, txn_, ADDRESS, tx, 1, 0, SENSOR_TXN_TIMEOUT_US)) == 0) return;
+        configured_ = r > 0;
+        state_      = S_IDLE;
+        return;
+    }
+
+    case S_READ:
+        if ((r = exchange(engine_, txn_, ADDRESS, nullptr, 0, 2, SENSOR_TXN_TIMEOUT_US)) == 0) return;
+        if (r < 0) {
+            configured_ = false;   // it may have lost power; reconfigure next cycle
+        } else {
+            lux_   = ((txn_.rx[0] << 8 | txn_.rx[1]) * 5 + 3) / 6;   // counts / 1.2, rounded
+            valid_ = true;
+        }
+        state_ = S_IDLE;
+        return;
+    }
+}
@@ -0,0 +1,234 @@
+#include "SensorHistory.h"
+#include "SensorSnapshot.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+struct ChannelInfo { const char* name; int32_t sampleScale; uint8_t shift; uint8_t decimals; };
+
+// From the registry rows. Scales and decimals come from the snapshot's
+// types; shift drops low bits so every channel fits int16 (lux in 2 lx
+// steps covers the BH1750's 0..65535 lx).
+#define CHANNEL(id, key, field, T, shift, ...) { key, T::SCALE, shift, T::DECIMALS },
+static const ChannelInfo CHANNELS[SensorHistory::CHANNEL_COUNT] = { HYDRO_SENSORS(CHANNEL) };
+#undef CHANNEL
+
+static const char*    TIER_NAMES[SensorHistory::TIER_COUNT]   = { "raw", "1m", "1h" };
+static const uint32_t TIER_PERIODS[SensorHistory::TIER_COUNT] = { 2, 60, 3600 };
+
+SensorHistory::SensorHistory() : minuteStart_(0), hourStart_(0) {
+    memset(minuteAcc_, 0, sizeof(minuteAcc_));
+    memset(hourAcc_, 0, sizeof(hourAcc_));
+    for (uint8_t t = 0; t < TIER_COUNT; t++) written_[t].store(0, std::memory_order_relaxed);
+}
+
+// =====================================
+//  ENCODING
+// =====================================
+int16_t SensorHistory::encode(Channel ch, int32_t sample) {
+    uint8_t shift = CHANNELS[ch].shift;
+    int32_t v     = shift ? (sample + (1 << (shift - 1))) >> shift : sample;
+    if (v > 32767)  return 32767;
+    if (v < -32768) return -32768;
+    return (int16_t)v;
+}
+
+float SensorHistory::decode(Channel ch, int16_t v) {
+    return (int32_t)v * (1 << CHANNELS[ch].shift) / (float)CHANNELS[ch].sampleScale;
+}
+
+uint16_t SensorHistory::capacity(Tier tier) {
+    return tier == RAW ? RAW_SLOTS : tier == MINUTE ? MINUTE_SLOTS : HOUR_SLOTS;
+}
+
+const char* SensorHistory::channelName(Channel ch)    { return CHANNELS[ch].name; }
+uint8_t     SensorHistory::channelDecimals(Channel ch) { return CHANNELS[ch].decimals; }
+int32_t     SensorHistory::sampleScale(Channel ch)     { return CHANNELS[ch].sampleScale; }
+const char* SensorHistory::tierName(Tier tier)        { return TIER_NAMES[tier]; }
+uint32_t    SensorHistory::tierPeriod(Tier tier)      { return TIER_PERIODS[tier]; }
+
+bool SensorHistory::channelFromName(const char* name, Channel& out) {
+    for (uint8_t c = 0; c < CHANNEL_COUNT; c++)
+        if (strcmp(name, CHANNELS[c].name) == 0) { out = (Channel)c; return true; }
+    return false;
+}
+
+bool SensorHistory::tierFromName(const char* name, Tier& out) {
+    for (uint8_t t = 0; t < TIER_COUNT; t++)
+        if (strcmp(name, TIER_NAMES[t]) == 0) { out = (Tier)t; return true; }
+    return false;
+}
+
+// =====================================
+//  INGEST
+// =====================================
+void SensorHistory::accumulate(Accum* acc, Channel ch, int16_t min, int16_t max, int32_t sum, uint16_t n) {
+    Accum& a = acc[ch];
+    if (a.n == 0) { a.min = min; a.max = max; }
+    else {
+        if (min < a.min) a.min = min;
+        if (max > a.max) a.max = max;
+    }
+    a.sum += sum;
+    a.n   += n;
+}
+
+void SensorHistory::closeMinute() {
+    uint32_t seq  = written_[MINUTE].load(std::memory_order_relaxed);
+    uint16_t slot = seq % MINUTE_SLOTS;
+    Accum hourSample[CHANNEL_COUNT];
+    for (uint8_t c = 0; c < CHANNEL_COUNT; c++) {
+        Accum& a = minuteAcc_[c];
+        Rollup& r = minute_[slot][c];
+        r.min = a.min;
+        r.max = a.max;
+        r.avg = (int16_t)(a.sum / (int32_t)a.n);
+        hourSample[c] = a;
+        a.sum = 0; a.n = 0;
+    }
+    minuteT_[slot] = minuteStart_;
+    written_[MINUTE].store(seq + 1, std::memory_order_release);
+
+    for (uint8_t c = 0; c < CHANNEL_COUNT; c++) {
+        const Accum& m = hourSample[c];
+        accumulate(hourAcc_, (Channel)c, m.min, m.max, m.sum, m.n);
+    }
+}
+
+void SensorHistory::closeHour() {
+    uint32_t seq  = written_[HOUR].load(std::memory_order_relaxed);
+    uint16_t slot = seq % HOUR_SLOTS;
+    for (uint8_t c = 0; c < CHANNEL_COUNT; c++) {
+        Accum& a = hourAcc_[c];
+        Rollup& r = hour_[slot][c];
+        r.min = a.min;
+        r.max = a.max;
+        r.avg = (int16_t)(a.sum / (int32_t)a.n);
+        a.sum = 0; a.n = 0;
+    }
+    hourT_[slot] = hourStart_;
+    written_[HOUR].store(seq + 1, std::memory_order_release);
+}
+
+void SensorHistory::add(uint32_t tSec, const int32_t samples[CHANNEL_COUNT]) {
+    uint32_t minute = tSec - tSec % TIER_PERIODS[MINUTE];
+    uint32_t hour   = tSec - tSec % TIER_PERIODS[HOUR];
+
+    // Close buckets before the sample that falls outside them.
+    if (minuteAcc_[0].n && minute != minuteStart_) closeMinute();
+    if (hourAcc_[0].n   && hour   != hourStart_)   closeHour();
+    minuteStart_ = minute;
+    hourStart_   = hour;
+
+    uint32_t seq  = written_[RAW].load(std::memory_order_relaxed);
+    uint16_t slot = seq % RAW_SLOTS;
+    for (uint8_t c = 0; c < CHANNEL_COUNT; c++) {
+        int16_t v = encode((Channel)c, samples[c]);
+        raw_[slot][c] = v;
+        accumulate(minuteAcc_, (Channel)c, v, v, v, 1);
+    }
+    rawT_[slot] = tSec;
+    written_[RAW].store(seq + 1, std::memory_order_release);
+}
+
+// =====================================
+//  QUERY
+// =====================================
+// The slot of entry end - cap is the one add() fills next, so it is never
+// handed out.
+uint32_t SensorHistory::firstSeq(Tier tier) const {
+    uint32_t end = endSeq(tier);
+    uint16_t cap = capacity(tier);
+    return end >= cap ? end - cap + 1 : 0;
+}
+
+bool SensorHistory::get(Tier tier, Channel ch, uint32_t seq, Point& out) const {
+    if (seq < firstSeq(tier) || seq >= endSeq(tier)) return false;
+    uint16_t slot = seq % capacity(tier);
+    uint32_t t;
+    int16_t  min, max, avg;
+    if (tier == RAW) {
+        t   = rawT_[slot];
+        min = max = avg = raw_[slot][ch];
+    } else {
+        const Rollup& r = tier == MINUTE ? minute_[slot][ch] : hour_[slot][ch];
+        t   = tier == MINUTE ? minuteT_[slot] : hourT_[slot];
+        min = r.min;
+        max = r.max;
+        avg = r.avg;
+    }
+    // If add() moved past seq during the copy, the slot may hold parts of
+    // a newer entry.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (seq < firstSeq(tier)) return false;
+    out.t   = t;
+    out.min = decode(ch, min);
+    out.max = decode(ch, max);
+    out.avg = decode(ch, avg);
+    return true;
+}
+
+// =====================================
+//  STREAMING READER
+// =====================================
+HistoryReader::HistoryReader(const SensorHistory& h, SensorHistory::Channel ch, SensorHistory::Tier tier,
+                             uint32_t fromSec, uint32_t toSec)
+    : h_(h), ch_(ch), tier_(tier), from_(fromSec), to_(toSec),
+      seq_(h.firstSeq(tier)), stage_(0), first_(true), pendingLen_(0), pendingPos_(0) {}
+
+bool HistoryReader::nextLine() {
+    pendingPos_ = 0;
+    pendingLen_ = 0;
+    int n = 0;
+
+    if (stage_ == 0) {
+        n = snprintf(pending_, sizeof(pending_), "{\"sensor\":\"%s\",\"res\":\"%s\",\"period\":%lu,\"points\":[",
+                     SensorHistory::channelName(ch_), SensorHistory::tierName(tier_),
+                     (unsigned long)SensorHistory::tierPeriod(tier_));
+        stage_ = 1;
+    } else if (stage_ == 1) {
+        // Entries the ring overwrote while we were streaming are skipped.
+        uint32_t oldest = h_.firstSeq(tier_);
+        if (seq_ < oldest) seq_ = oldest;
+
+        SensorHistory::Point p;
+        while (seq_ < h_.endSeq(tier_)) {
+            if (!h_.get(tier_, ch_, seq_, p)) { seq_ = h_.firstSeq(tier_); continue; }   // overtaken
+            seq_++;
+            if (p.t < from_) continue;
+            if (p.t > to_) { seq_ = h_.endSeq(tier_); break; }
+
+            int d = SensorHistory::channelDecimals(ch_);
+            const char* sep = first_ ? "" : ",";
+            first_ = false;
+            if (tier_ == SensorHistory::RAW)
+                n = snprintf(pending_, sizeof(pending_), "%s[%lu,%.*f]", sep, (unsigned long)p.t, d, (double)p.avg);
+            else
+                n = snprintf(pending_, sizeof(pending_), "%s[%lu,%.*f,%.*f,%.*f]", sep, (unsigned long)p.t,
+                             d, (double)p.min, d, (double)p.max, d, (double)p.avg);
+            break;
+        }
+        if (n == 0) stage_ = 2;
+    }
+
+    if (stage_ == 2 && n == 0) {
+        n = snprintf(pending_, sizeof(pending_), "]}");
+        stage_ = 3;
+    }
+    pendingLen_ = n > 0 ? (uint8_t)n : 0;
+    return pendingLen_ > 0;
+}
+
+size_t HistoryReader::read(char* buf, size_t maxLen) {
+    size_t len = 0;
+    while (len < maxLen) {
+        if (pendingPos_ == pendingLen_ && (stage_ == 3 || !nextLine())) break;
+        size_t chunk = pendingLen_ - pendingPos_;
+        if (chunk > maxLen - len) chunk = maxLen - len;
+        memcpy(buf + len, pending_ + pendingPos_, chunk);
+        pendingPos_ += chunk;
+        len         += chunk;
+    }
+    return len;
+}
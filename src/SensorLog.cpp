@@ -0,0 +1,294 @@
+#include "SensorLog.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "ByteCodec.h"
+
+static const uint8_t  MAGIC0       = 'H';
+static const uint8_t  MAGIC1       = 'L';
+static const uint8_t  VERSION      = 1;
+static const size_t   CRC_OFFSET   = 16;
+static const size_t   MAX_SAMPLE   = 5 + SensorLog::CHANNELS * 3;   // worst-case encoded sample
+static const uint16_t PAYLOAD_MAX  = SensorLog::BLOCK_SIZE - SensorLog::HEADER_SIZE;
+
+// Covers the whole block with the CRC field read as zeros.
+static uint32_t blockCrc(const uint8_t* block) {
+    static const uint8_t ZERO[4] = { 0, 0, 0, 0 };
+    uint32_t crc = 0xFFFFFFFF;
+    crc = crc32Update(crc, block, CRC_OFFSET);
+    crc = crc32Update(crc, ZERO, sizeof(ZERO));
+    crc = crc32Update(crc, block + CRC_OFFSET + 4, SensorLog::BLOCK_SIZE - CRC_OFFSET - 4);
+    return ~crc;
+}
+
+bool SensorLog::checkBlock(const uint8_t* block, uint32_t& seq) {
+    if (block[0] != MAGIC0 || block[1] != MAGIC1 || block[2] != VERSION) return false;
+    if (block[3] == 0 || get16(block + 12) > PAYLOAD_MAX) return false;
+    if (get32(block + CRC_OFFSET) != blockCrc(block)) return false;
+    seq = get32(block + 4);
+    return true;
+}
+
+// =====================================
+//  WRITER
+// =====================================
+SensorLog::SensorLog(LogStorage& storage, uint8_t segments, uint16_t blocksPerSegment)
+    : storage_(storage), segments_(segments > MAX_SEGMENTS ? MAX_SEGMENTS : segments),
+      blocksPerSegment_(blocksPerSegment), segment_(0), blockIndex_(0), seq_(0), dirty_(false),
+      payloadLen_(0), count_(0), lastT_(0), lastDt_(0) {
+    memset(block_, 0, sizeof(block_));
+    memset(last_, 0, sizeof(last_));
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+void SensorLog::begin() {
+    // The segment whose first block is newest is the one being filled.
+    bool     found   = false;
+    uint32_t newest  = 0;
+    uint8_t  current = 0;
+    for (uint8_t s = 0; s < segments_; s++) {
+        uint32_t seq;
+        if (storage_.size(s) < BLOCK_SIZE || !storage_.read(s, 0, block_, BLOCK_SIZE)) continue;
+        if (!checkBlock(block_, seq)) continue;
+        if (!found || seq > newest) { found = true; newest = seq; current = s; }
+    }
+
+    segment_ = current;
+    count_   = 0;
+    dirty_   = false;
+    if (!found) {
+        blockIndex_ = 0;
+        seq_        = 0;
+        storage_.erase(segment_);
+        return;
+    }
+
+    // Resume after its last valid block; anything invalid is a torn write.
+    uint32_t blocks  = storage_.size(current) / BLOCK_SIZE;
+    uint32_t lastSeq = newest;
+    int32_t  last    = -1;
+    if (blocks > blocksPerSegment_) blocks = blocksPerSegment_;
+    for (uint32_t b = 0; b < blocks; b++) {
+        uint32_t seq;
+        if (storage_.read(current, b * BLOCK_SIZE, block_, BLOCK_SIZE) && checkBlock(block_, seq) &&
+            (last < 0 || seq > lastSeq)) {
+            last    = b;
+            lastSeq = seq;
+        } else {
+            stats_.tornBlocks++;
+        }
+    }
+    if (storage_.size(current) % BLOCK_SIZE) stats_.tornBlocks++;
+
+    seq_        = lastSeq;
+    blockIndex_ = (uint16_t)last;
+    nextBlock();
+}
+
+void SensorLog::nextBlock() {
+    seq_++;
+    count_ = 0;
+    dirty_ = false;
+    if (++blockIndex_ < blocksPerSegment_) return;
+    blockIndex_ = 0;
+    segment_    = (segment_ + 1) % segments_;
+    storage_.erase(segment_);   // the oldest data goes
+}
+
+void SensorLog::startBlock(uint32_t unixSec, const int16_t codes[CHANNELS]) {
+    memset(block_, 0, sizeof(block_));
+    put32(block_ + 8, unixSec);
+    for (uint8_t c = 0; c < CHANNELS; c++) put16(block_ + 20 + 2 * c, (uint16_t)codes[c]);
+    payloadLen_ = 0;
+    count_      = 1;
+    lastT_      = unixSec;
+    lastDt_     = 0;
+    memcpy(last_, codes, sizeof(last_));
+}
+
+bool SensorLog::writeBlock() {
+    block_[0] = MAGIC0;
+    block_[1] = MAGIC1;
+    block_[2] = VERSION;
+    block_[3] = count_;
+    put32(block_ + 4, seq_);
+    put16(block_ + 12, payloadLen_);
+    put32(block_ + CRC_OFFSET, blockCrc(block_));
+
+    dirty_ = false;
+    if (!storage_.write(segment_, (uint32_t)blockIndex_ * BLOCK_SIZE, block_, BLOCK_SIZE)) {
+        stats_.writeErrors++;
+        return false;
+    }
+    stats_.blocksWritten++;
+    return true;
+}
+
+bool SensorLog::append(uint32_t unixSec, const int32_t samples[CHANNELS]) {
+    int16_t codes[CHANNELS];
+    for (uint8_t c = 0; c < CHANNELS; c++) codes[c] = SensorHistory::encode((SensorHistory::Channel)c, samples[c]);
+    stats_.samples++;
+
+    if (count_ == 0) {
+        startBlock(unixSec, codes);
+        dirty_ = true;
+        return true;
+    }
+
+    uint8_t sample[MAX_SAMPLE];
+    int32_t dt = (int32_t)(unixSec - lastT_);
+    uint8_t n  = putVarint(sample, zigzag(dt - lastDt_));
+    for (uint8_t c = 0; c < CHANNELS; c++) n += putVarint(sample + n, (uint16_t)(codes[c] ^ last_[c]));
+
+    bool ok = true;
+    if (payloadLen_ + n > PAYLOAD_MAX || count_ == 0xFF) {
+        ok = writeBlock();
+        nextBlock();
+        startBlock(unixSec, codes);
+    } else {
+        memcpy(block_ + HEADER_SIZE + payloadLen_, sample, n);
+        payloadLen_ += n;
+        count_++;
+        lastT_  = unixSec;
+        lastDt_ = dt;
+        memcpy(last_, codes, sizeof(last_));
+    }
+    dirty_ = true;
+    return ok;
+}
+
+bool SensorLog::flush() {
+    return dirty_ ? writeBlock() : true;
+}
+
+// =====================================
+//  CSV EXPORT
+// =====================================
+LogExporter::LogExporter(const SensorLog& log, uint32_t fromSec, uint32_t toSec)
+    : log_(log), from_(fromSec), to_(toSec), orderCount_(0), orderPos_(0), blockIndex_(0),
+      lastSeq_(0), stage_(0), pos_(0), end_(0), left_(0), first_(false), t_(0), dt_(0),
+      pendingLen_(0), pendingPos_(0) {
+    // Order segments by their first block, remembering where each starts.
+    LogStorage& st = log.storage();
+    uint32_t    seqs[SensorLog::MAX_SEGMENTS];
+    uint32_t    starts[SensorLog::MAX_SEGMENTS];
+    for (uint8_t s = 0; s < log.segments(); s++) {
+        uint32_t seq;
+        if (st.size(s) < SensorLog::BLOCK_SIZE || !st.read(s, 0, block_, SensorLog::BLOCK_SIZE)) continue;
+        if (!SensorLog::checkBlock(block_, seq)) continue;
+        uint8_t i = orderCount_++;
+        while (i > 0 && seqs[i - 1] > seq) {
+            seqs[i] = seqs[i - 1]; starts[i] = starts[i - 1]; order_[i] = order_[i - 1];
+            i--;
+        }
+        seqs[i] = seq; starts[i] = get32(block_ + 8); order_[i] = s;
+    }
+    // Whole segments that end before the range are never read.
+    while (orderPos_ + 1 < orderCount_ && starts[orderPos_ + 1] <= from_) orderPos_++;
+    memset(codes_, 0, sizeof(codes_));
+}
+
+bool LogExporter::loadBlock() {
+    LogStorage& st = log_.storage();
+    while (orderPos_ < orderCount_) {
+        uint8_t  seg    = order_[orderPos_];
+        uint32_t offset = (uint32_t)blockIndex_ * SensorLog::BLOCK_SIZE;
+        if (blockIndex_ >= log_.blocksPerSegment() || offset + SensorLog::BLOCK_SIZE > st.size(seg)) {
+            orderPos_++;
+            blockIndex_ = 0;
+            continue;
+        }
+        blockIndex_++;
+
+        uint32_t seq;
+        if (!st.read(seg, offset, block_, SensorLog::BLOCK_SIZE)) continue;
+        if (!SensorLog::checkBlock(block_, seq) || (lastSeq_ && seq <= lastSeq_)) continue;
+        lastSeq_ = seq;
+
+        t_     = get32(block_ + 8);
+        dt_    = 0;
+        left_  = block_[3];
+        pos_   = SensorLog::HEADER_SIZE;
+        end_   = SensorLog::HEADER_SIZE + get16(block_ + 12);
+        first_ = true;
+        for (uint8_t c = 0; c < SensorLog::CHANNELS; c++) codes_[c] = (int16_t)get16(block_ + 20 + 2 * c);
+        return true;
+    }
+    return false;
+}
+
+bool LogExporter::nextSample(uint32_t& t, int16_t codes[SensorLog::CHANNELS]) {
+    for (;;) {
+        while (left_ == 0)
+            if (!loadBlock()) return false;
+        left_--;
+        if (first_) {
+            first_ = false;
+        } else {
+            uint32_t v;
+            bool     ok = getVarint(block_, pos_, end_, v);
+            dt_ += unzigzag(v);
+            t_  += dt_;
+            for (uint8_t c = 0; ok && c < SensorLog::CHANNELS; c++) {
+                ok = getVarint(block_, pos_, end_, v);
+                codes_[c] ^= (int16_t)v;
+            }
+            if (!ok) { left_ = 0; continue; }   // payload shorter than its count says
+        }
+        t = t_;
+        memcpy(codes, codes_, sizeof(codes_));
+        return true;
+    }
+}
+
+bool LogExporter::nextLine() {
+    pendingPos_ = 0;
+    pendingLen_ = 0;
+    int n = 0;
+
+    if (stage_ == 0) {
+        n = snprintf(pending_, sizeof(pending_), "time");
+        for (uint8_t c = 0; c < SensorLog::CHANNELS; c++)
+            n += snprintf(pending_ + n, sizeof(pending_) - n, ",%s",
+                          SensorHistory::channelName((SensorHistory::Channel)c));
+        n += snprintf(pending_ + n, sizeof(pending_) - n, "\n");
+        stage_ = 1;
+    } else if (stage_ == 1) {
+        uint32_t t;
+        int16_t  codes[SensorLog::CHANNELS];
+        do {
+            if (!nextSample(t, codes) || t > to_) { stage_ = 2; return false; }
+        } while (t < from_);
+
+        time_t    tt = t;
+        struct tm utc;
+        gmtime_r(&tt, &utc);
+        n = (int)strftime(pending_, sizeof(pending_), "%Y-%m-%dT%H:%M:%SZ", &utc);
+        for (uint8_t c = 0; c < SensorLog::CHANNELS; c++) {
+            SensorHistory::Channel ch = (SensorHistory::Channel)c;
+            n += snprintf(pending_ + n, sizeof(pending_) - n, ",%.*f", SensorHistory::channelDecimals(ch),
+                          (double)SensorHistory::decode(ch, codes[c]));
+        }
+        n += snprintf(pending_ + n, sizeof(pending_) - n, "\n");
+    } else {
+        return false;
+    }
+
+    pendingLen_ = n < (int)sizeof(pending_) ? n : sizeof(pending_) - 1;
+    return pendingLen_ > 0;
+}
+
+size_t LogExporter::read(char* buf, size_t maxLen) {
+    size_t len = 0;
+    while (len < maxLen) {
+        if (pendingPos_ == pendingLen_ && !nextLine()) break;
+        size_t chunk = pendingLen_ - pendingPos_;
+        if (chunk > maxLen - len) chunk = maxLen - len;
+        memcpy(buf + len, pending_ + pendingPos_, chunk);
+        pendingPos_ += chunk;
+        len         += chunk;
+    }
+    return len;
+}
@@ -0,0 +1,232 @@
+#include "SseBroadcast.h"
+
+#include <stdio.h>
+#include <string.h>
+
+SseBroadcaster::SseBroadcaster(WriteFn write, CloseFn close, ClockFn clock, KeyframeFn keyframe)
+    : write_(write), close_(close), clock_(clock), keyframe_(keyframe), admitted_(0), head_(0),
+      tableMs_(0), maxLagMs_(0) {
+    memset(ring_, 0, sizeof(ring_));
+    memset(keys_, 0, sizeof(keys_));
+    memset(clients_, 0, sizeof(clients_));
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+// "id: 41\nevent: delta\ndata: {...}\n\n"; no id line for id 0. Returns 0
+// when it does not fit.
+size_t SseBroadcaster::format(char* buf, size_t cap, const char* event, const char* data, uint32_t id) {
+    int n = id ? snprintf(buf, cap, "id: %u\nevent: %s\ndata: %s\n\n", (unsigned)id, event, data)
+               : snprintf(buf, cap, "event: %s\ndata: %s\n\n", event, data);
+    return n > 0 && (size_t)n < cap ? n : 0;
+}
+
+// =====================================
+//  NETWORK CALLBACKS
+// =====================================
+bool SseBroadcaster::connected(uint32_t client, uint32_t lastEventId) {
+    uint8_t n = admitted_.load(std::memory_order_relaxed);
+    do {
+        if (n >= MAX_CLIENTS) { stats_.rejected++; return false; }
+    } while (!admitted_.compare_exchange_weak(n, n + 1, std::memory_order_relaxed));
+
+    Inbound in = { client, lastEventId, IN_CONNECT };
+    if (inbox_.push(in)) return true;
+    admitted_.fetch_sub(1, std::memory_order_relaxed);
+    stats_.rejected++;
+    return false;
+}
+
+// Only for clients connected() accepted. If the inbox is full the slot
+// stays behind, its writes go nowhere, and it is evicted as stalled.
+void SseBroadcaster::disconnected(uint32_t client) {
+    admitted_.fetch_sub(1, std::memory_order_relaxed);
+    Inbound in = { client, 0, IN_DISCONNECT };
+    inbox_.push(in);
+}
+
+// =====================================
+//  CONTROL TASK
+// =====================================
+SseBroadcaster::Client* SseBroadcaster::findClient(uint32_t id) {
+    for (uint8_t i = 0; i < MAX_CLIENTS; i++)
+        if (clients_[i].used && clients_[i].id == id) return &clients_[i];
+    return nullptr;
+}
+
+void SseBroadcaster::addClient(uint32_t id, uint32_t lastId) {
+    uint8_t used = 0;
+    Client* slot = nullptr;
+    for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+        if (clients_[i].used) used++;
+        else if (!slot)       slot = &clients_[i];
+    }
+    if (!slot) { stats_.rejected++; close_(id); return; }   // only with leaked slots
+
+    memset(slot, 0, sizeof(*slot));
+    slot->id         = id;
+    slot->lastId     = lastId;
+    slot->cursor     = head_;
+    slot->progressMs = clock_();
+    slot->key        = -1;
+    slot->fresh      = true;
+    slot->used       = true;
+    if (used + 1 > stats_.peakClients) stats_.peakClients = used + 1;
+}
+
+void SseBroadcaster::dropClient(Client& c, bool close) {
+    if (c.key >= 0) keys_[c.key].refs--;
+    c.used = false;
+    if (close) close_(c.id);
+}
+
+void SseBroadcaster::publish(const char* event, const char* data, uint32_t id) {
+    // The slot about to be reused holds frame head_ - RING. A client still
+    // part-way through it has not moved for the whole ring.
+    for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+        Client& c = clients_[i];
+        if (c.used && c.key < 0 && c.offset && head_ - c.cursor >= RING) { stats_.evicted++; dropClient(c, true); }
+    }
+
+    Frame& f = ring_[head_ % RING];
+    size_t len = format(f.text, FRAME_MAX, event, data, id);
+    if (!len) { stats_.oversized++; return; }
+    f.len  = len;
+    f.atMs = clock_();
+    head_++;
+    stats_.frames++;
+}
+
+// The current state, built at most once per position in the stream. -1
+// when there is none yet or both buffers are being sent.
+int8_t SseBroadcaster::acquireKeyframe() {
+    const char* data;
+    uint32_t    id = keyframe_(data);
+    if (!id) return -1;
+    for (int8_t k = 0; k < KEYFRAMES; k++)
+        if (keys_[k].len && keys_[k].head == head_ && keys_[k].id == id) return k;
+    for (int8_t k = 0; k < KEYFRAMES; k++) {
+        if (keys_[k].refs) continue;
+        size_t len = format(keys_[k].text, FRAME_MAX, "snapshot", data, id);
+        if (!len) return -1;
+        keys_[k].len  = len;
+        keys_[k].head = head_;
+        keys_[k].id   = id;
+        return k;
+    }
+    return -1;
+}
+
+// Replaces whatever the client has not started with the current state.
+void SseBroadcaster::resync(Client& c) {
+    int8_t k = acquireKeyframe();
+    if (k < 0) return;
+    uint32_t skipped = head_ - c.cursor;
+    keys_[k].refs++;
+    c.key        = k;
+    c.cursor     = head_;
+    c.coalesced += skipped;
+    stats_.coalesced += skipped;
+}
+
+void SseBroadcaster::drain(Client& c, uint32_t now) {
+    if (c.fresh) {
+        // A browser reconnecting with the current id is already in sync.
+        const char* data;
+        uint32_t    id = keyframe_(data);
+        c.fresh = false;
+        if (id && c.lastId != id) resync(c);
+    }
+    if (c.key < 0 && c.offset == 0 && head_ - c.cursor > CLIENT_QUEUE) {
+        resync(c);
+        if (c.key < 0) {
+            stats_.dropped += head_ - CLIENT_QUEUE - c.cursor;
+            c.cursor = head_ - CLIENT_QUEUE;
+        }
+    }
+
+    for (;;) {
+        const char* text;
+        size_t      len;
+        if (c.key >= 0)            { text = keys_[c.key].text; len = keys_[c.key].len; }
+        else if (c.cursor != head_) { const Frame& f = ring_[c.cursor % RING]; text = f.text; len = f.len; }
+        else                        { c.progressMs = now; return; }   // caught up
+
+        size_t n = write_(c.id, text + c.offset, len - c.offset);
+        if (n) {
+            c.progressMs = now;
+            c.bytes     += n;
+            stats_.bytes += n;
+            c.offset    += n;
+        }
+        if (c.offset < len) break;   // socket buffer full
+        c.offset = 0;
+        if (c.key >= 0) { keys_[c.key].refs--; c.key = -1; }
+        else            c.cursor++;
+    }
+
+    if (now - c.progressMs >= STALL_MS) { stats_.evicted++; dropClient(c, true); }
+}
+
+void SseBroadcaster::pump() {
+    Inbound in;
+    while (inbox_.pop(in)) {
+        if (in.kind == IN_CONNECT)             addClient(in.client, in.lastId);
+        else if (Client* c = findClient(in.client)) dropClient(*c, false);
+    }
+
+    uint32_t now = clock_();
+    for (uint8_t i = 0; i < MAX_CLIENTS; i++)
+        if (clients_[i].used) drain(clients_[i], now);
+
+    if (now - tableMs_ >= TABLE_MS) {
+        publishTable(now);
+        tableMs_ = now;
+    }
+}
+
+bool SseBroadcaster::backlog() const {
+    for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+        const Client& c = clients_[i];
+        if (c.used && (c.fresh || c.key >= 0 || c.cursor != head_)) return true;
+    }
+    return false;
+}
+
+void SseBroadcaster::publishTable(uint32_t now) {
+    ClientTable t;
+    t.count    = 0;
+    t.maxLagMs = 0;
+    for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+        const Client& c = clients_[i];
+        if (!c.used) continue;
+        ClientInfo& ci = t.client[t.count++];
+        ci.id        = c.id;
+        ci.lagFrames = head_ - c.cursor + (c.key >= 0 ? 1 : 0);
+        ci.lagMs     = c.cursor != head_ ? now - ring_[c.cursor % RING].atMs : 0;
+        ci.bytes     = c.bytes;
+        ci.coalesced = c.coalesced;
+        if (ci.lagMs > t.maxLagMs) t.maxLagMs = ci.lagMs;
+    }
+    table_.write(t);
+    maxLagMs_ = t.maxLagMs;
+}
+
+// =====================================
+//  JSON
+// =====================================
+size_t SseBroadcaster::clientsJson(const ClientTable& t, const Stats& s, char* buf, size_t cap) {
+    int len = snprintf(buf, cap,
+                       "{\"max\":%u,\"peak\":%u,\"frames\":%u,\"coalesced\":%u,\"dropped\":%u,\"evicted\":%u,"
+                       "\"rejected\":%u,\"maxLagMs\":%u,\"clients\":[",
+                       (unsigned)MAX_CLIENTS, (unsigned)s.peakClients, (unsigned)s.frames, (unsigned)s.coalesced,
+                       (unsigned)s.dropped, (unsigned)s.evicted, (unsigned)s.rejected, (unsigned)t.maxLagMs);
+    for (uint8_t i = 0; i < t.count && len < (int)cap; i++) {
+        const ClientInfo& c = t.client[i];
+        len += snprintf(buf + len, cap - len,
+                        "%s{\"id\":%u,\"lag\":%u,\"lagMs\":%u,\"bytes\":%u,\"coalesced\":%u}", i ? "," : "",
+                        (unsigned)c.id, (unsigned)c.lagFrames, (unsigned)c.lagMs, (unsigned)c.bytes,
+                        (unsigned)c.coalesced);
+    }
+    if (len < (int)cap) len += snprintf(buf + len, cap - len, "]}");
+    return len < (int)cap ? len : cap - 1;
+}
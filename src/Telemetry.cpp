@@ -0,0 +1,77 @@
+#include "Telemetry.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define FIELD_NAME(id, key, ...) key,
+#define AUTO_NAME(id, key, ...)  key "Auto",
+static const char* FIELD_NAMES[TF_COUNT] = {
+    HYDRO_SENSORS(FIELD_NAME) HYDRO_ACTUATORS(FIELD_NAME) HYDRO_ACTUATORS(AUTO_NAME)
+};
+#undef FIELD_NAME
+#undef AUTO_NAME
+
+TelemetryEncoder::TelemetryEncoder()
+    : keyframeEvery_(15), sinceKeyframe_(0), primed_(false), version_(0), active_(0) {
+    memset(&sent_, 0, sizeof(sent_));
+    memset(deadband_, 0, sizeof(deadband_));
+    snap_[0][0] = snap_[1][0] = '\0';
+}
+
+const char* TelemetryEncoder::fieldName(TelemetryField f) { return FIELD_NAMES[f]; }
+
+// Appends printf output, tracking the length; stops writing once full.
+static void append(char* buf, size_t cap, size_t& len, const char* fmt, const char* name, long value) {
+    if (len >= cap) return;
+    int n = snprintf(buf + len, cap - len, fmt, name, value);
+    len = n < 0 ? cap : len + (size_t)n;
+}
+
+size_t TelemetryEncoder::encodeFull(const TelemetryFrame& frame, uint32_t version, char* buf, size_t cap) {
+    int n = snprintf(buf, cap, "{\"p\":%u,\"v\":%lu", (unsigned)PROTOCOL, (unsigned long)version);
+    size_t len = n < 0 ? cap : (size_t)n;
+    for (uint8_t f = 0; f < TF_COUNT; f++)
+        append(buf, cap, len, ",\"%s\":%ld", FIELD_NAMES[f], (long)frame.v[f]);
+    if (len + 2 > cap) return 0;   // truncated frames are never sent
+    buf[len++] = '}';
+    buf[len]   = '\0';
+    return len;
+}
+
+size_t TelemetryEncoder::update(const TelemetryFrame& frame, char* buf, size_t cap, bool& isSnapshot) {
+    isSnapshot = !primed_ || (keyframeEvery_ && ++sinceKeyframe_ >= keyframeEvery_);
+
+    if (isSnapshot) {
+        sent_          = frame;
+        primed_        = true;
+        sinceKeyframe_ = 0;
+        version_       = version_ + 1;
+        size_t len = encodeFull(sent_, version_, buf, cap);
+        uint8_t next = active_ ^ 1;
+        encodeFull(sent_, version_, snap_[next], MAX_FRAME);
+        active_ = next;
+        return len;
+    }
+
+    uint32_t base = version_;
+    int n = snprintf(buf, cap, "{\"v\":%lu,\"b\":%lu", (unsigned long)(base + 1), (unsigned long)base);
+    size_t len = n < 0 ? cap : (size_t)n;
+    uint8_t changed = 0;
+    for (uint8_t f = 0; f < TF_COUNT; f++) {
+        int32_t diff = frame.v[f] - sent_.v[f];
+        if (diff < 0) diff = -diff;
+        if (diff == 0 || diff <= deadband_[f]) continue;
+        sent_.v[f] = frame.v[f];
+        append(buf, cap, len, ",\"%s\":%ld", FIELD_NAMES[f], (long)frame.v[f]);
+        changed++;
+    }
+    if (!changed || len + 2 > cap) return 0;
+    buf[len++] = '}';
+    buf[len]   = '\0';
+
+    version_ = base + 1;
+    uint8_t next = active_ ^ 1;
+    encodeFull(sent_, version_, snap_[next], MAX_FRAME);
+    active_ = next;
+    return len;
+}
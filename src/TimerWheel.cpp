@@ -0,0 +1,135 @@
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel(uint32_t now) : now_(now) {
+    clear();
+}
+
+void TimerWheel::clear() {
+    for (uint16_t i = 0; i < MAX_TIMERS; i++) {
+        timers_[i].fn   = nullptr;
+        timers_[i].next = i + 1 < MAX_TIMERS ? i + 1 : NO_TIMER;
+    }
+    for (uint8_t l = 0; l < LEVELS; l++) {
+        for (uint8_t s = 0; s < SLOTS; s++) heads_[l][s] = NO_TIMER;
+        occupied_[l] = 0;
+    }
+    freeHead_ = 0;
+    pending_  = 0;
+}
+
+// =====================================
+//  SLOT LISTS
+// =====================================
+// The level is the highest digit in which the deadline differs from now_;
+// the slot is the deadline's digit at that level. A deadline equal to now_
+// lands in level 0 at the current slot, which runTick() fires next.
+void TimerWheel::link(uint16_t id) {
+    Timer&   t    = timers_[id];
+    uint32_t diff = t.at ^ now_;
+    t.level = diff ? (31 - __builtin_clz(diff)) / SLOT_BITS : 0;
+    t.slot  = (t.at >> (t.level * SLOT_BITS)) & (SLOTS - 1);
+    t.prev  = NO_TIMER;
+    t.next  = heads_[t.level][t.slot];
+    if (t.next != NO_TIMER) timers_[t.next].prev = id;
+    heads_[t.level][t.slot] = id;
+    occupied_[t.level] |= 1ULL << t.slot;
+}
+
+void TimerWheel::unlink(uint16_t id) {
+    Timer& t = timers_[id];
+    if (t.prev != NO_TIMER) timers_[t.prev].next = t.next;
+    else                    heads_[t.level][t.slot] = t.next;
+    if (t.next != NO_TIMER) timers_[t.next].prev = t.prev;
+    if (heads_[t.level][t.slot] == NO_TIMER) occupied_[t.level] &= ~(1ULL << t.slot);
+}
+
+void TimerWheel::release(uint16_t id) {
+    timers_[id].fn   = nullptr;
+    timers_[id].next = freeHead_;
+    freeHead_        = id;
+    pending_--;
+}
+
+// =====================================
+//  API
+// =====================================
+uint16_t TimerWheel::schedule(uint32_t atTick, Callback fn, void* ctx, uint32_t arg) {
+    if (freeHead_ == NO_TIMER || !fn) return NO_TIMER;
+    uint16_t id = freeHead_;
+    Timer&   t  = timers_[id];
+    freeHead_ = t.next;
+    t.at  = atTick > now_ ? atTick : now_ + 1;
+    t.fn  = fn;
+    t.ctx = ctx;
+    t.arg = arg;
+    link(id);
+    pending_++;
+    return id;
+}
+
+bool TimerWheel::cancel(uint16_t id) {
+    if (id >= MAX_TIMERS || !timers_[id].fn) return false;
+    unlink(id);
+    release(id);
+    return true;
+}
+
+// Upper slots whose boundary is this tick cascade first, highest level
+// down, so each timer settles at its final level before level 0 fires. Lists
+// are popped from the head because a callback may cancel a sibling.
+uint16_t TimerWheel::runTick(uint32_t tick) {
+    for (uint8_t l = LEVELS - 1; l > 0; l--) {
+        uint8_t shift = l * SLOT_BITS;
+        if (tick & ((1UL << shift) - 1)) continue;
+        uint8_t slot = (tick >> shift) & (SLOTS - 1);
+        uint16_t id;
+        while ((id = heads_[l][slot]) != NO_TIMER) {
+            unlink(id);
+            link(id);
+        }
+    }
+
+    uint8_t  slot  = tick & (SLOTS - 1);
+    uint16_t fired = 0;
+    uint16_t id;
+    while ((id = heads_[0][slot]) != NO_TIMER) {
+        Timer&   t   = timers_[id];
+        Callback fn  = t.fn;
+        void*    ctx = t.ctx;
+        uint32_t arg = t.arg;
+        unlink(id);
+        release(id);
+        fn(ctx, arg);
+        fired++;
+    }
+    return fired;
+}
+
+uint16_t TimerWheel::advance(uint32_t nowTick) {
+    uint16_t fired = 0;
+    for (;;) {
+        uint32_t tick = nextDeadline();
+        if (tick == NEVER || tick > nowTick) break;
+        now_   = tick;
+        fired += runTick(tick);
+    }
+    if (nowTick > now_) now_ = nowTick;
+    return fired;
+}
+
+// A pending timer always has a larger digit than now_ at its level, so the
+// first occupied slot above now_'s digit, on the lowest level that has one,
+// is the next tick with work to do.
+uint32_t TimerWheel::nextDeadline() const {
+    for (uint8_t l = 0; l < LEVELS; l++) {
+        if (!occupied_[l]) continue;
+        uint8_t  shift = l * SLOT_BITS;
+        uint8_t  digit = (now_ >> shift) & (SLOTS - 1);
+        uint64_t above = digit == SLOTS - 1 ? 0 : occupied_[l] & (~0ULL << (digit + 1));
+        if (!above) continue;
+        uint64_t block = ((uint64_t)now_ >> (shift + SLOT_BITS)) << (shift + SLOT_BITS);
+        uint64_t tick  = block | ((uint64_t)__builtin_ctzll(above) << shift);
+        return tick > NEVER ? NEVER : (uint32_t)tick;
+    }
+    return NEVER;
+}
@@ -1,740 +1,1102 @@
 #include <Wire.h>
 #include <LiquidCrystal_I2C.h>
 #include <DHT.h>
-#include <BH1750.h>
-#include <Adafruit_BMP085.h>
 #include <WiFi.h>
 #include <AsyncTCP.h>
 #include <ESPAsyncWebServer.h>
-#include <ArduinoJson.h>
+#include <esp_timer.h>
+#include <esp_system.h>
+#include <esp_attr.h>
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <driver/adc.h>
+#include <driver/gpio.h>
+#include <soc/gpio_struct.h>
+#include <esp_adc_cal.h>
+#include <Preferences.h>
+#include <LittleFS.h>
+#include <stdarg.h>
+#include "App.h"
+#include "Hal.h"
+#include "ConnectionManager.h"
+#include "Pins.h"
+#include "WebAssets.h"
+#include <atomic>
+#include <memory>
+
+// =====================================
+//  ESP32 PLATFORM
+// =====================================
+// Board bring-up, the HAL implementation, FreeRTOS tasks and the web server.
+// Control, menu and telemetry logic live in App.cpp; the native simulator
+// (src/native/) links the same core against its own HAL.
 
 // ---------- WIFI CREDENTIALS ----------
 const char* ssid     = "moto 50";
 const char* password = "12340987";
 
-// ---------- PIN DEFINITIONS ----------
-#define DHT_PIN      2
-#define PH_PIN       34
-#define ENC_CLK      33
-#define ENC_DT       25
-#define ENC_SW       26
-#define RELAY_MOTOR  23
-#define RELAY_LIGHT  18
-#define RELAY_FAN    19
-
-#define RELAY_ON      LOW
-#define RELAY_OFF     HIGH
-#define FAN_RELAY_ON  LOW
-#define FAN_RELAY_OFF HIGH
+// Opened when the station has been down for AP_FALLBACK_MS, so the
+// dashboard stays reachable on site at 192.168.4.1.
+const char*    apSsid         = "hydro-setup";
+const char*    apPassword     = "hydroponic";   // WPA2 needs at least 8 characters
+const uint32_t AP_FALLBACK_MS = 120000;
+
+// ---------- WALL CLOCK ----------
+// POSIX TZ string for the schedules' time of day, set over NTP.
+const char* timezone   = "IST-5:30";
+const char* ntpServer  = "pool.ntp.org";
+const time_t CLOCK_SET = 1600000000;   // anything earlier is the unset RTC
+
+// ---------- I2C ----------
+// Blocking Wire calls for one short transfer; only the I2C owner task calls them.
+class WireBus : public I2cBus {
+public:
+    int transfer(uint8_t addr, const uint8_t* tx, uint8_t txLen, uint8_t* rx, uint8_t rxLen) override {
+        if (txLen) {
+            Wire.beginTransmission(addr);
+            Wire.write(tx, txLen);
+            uint8_t err = Wire.endTransmission(rxLen == 0);
+            if (err) return err;
+        }
+        if (rxLen) {
+            if (Wire.requestFrom(addr, rxLen) != rxLen) return 4;
+            for (uint8_t i = 0; i < rxLen; i++) rx[i] = Wire.read();
+        }
+        return 0;
+    }
+
+    // Clock out up to nine bits so a slave stuck mid-byte releases SDA.
+    void recover() override {
+        Wire.end();
+        pinMode(I2C_SDA, INPUT_PULLUP);
+        pinMode(I2C_SCL, OUTPUT_OPEN_DRAIN);
+        for (int i = 0; i < 9 && digitalRead(I2C_SDA) == LOW; i++) {
+            digitalWrite(I2C_SCL, LOW);  delayMicroseconds(5);
+            digitalWrite(I2C_SCL, HIGH); delayMicroseconds(5);
+        }
+        Wire.begin(I2C_SDA, I2C_SCL, I2C_FREQ_HZ);
+        Wire.setTimeOut(I2C_TIMEOUT_MS);
+    }
+};
+
+// ---------- SENSOR LOG ----------
+// One LittleFS file per segment, /log/segNN.bin.
+class LittleFsStorage : public LogStorage {
+public:
+    uint32_t size(uint8_t segment) override {
+        char path[20];
+        segmentPath(segment, path);
+        if (!LittleFS.exists(path)) return 0;
+        File f = LittleFS.open(path, "r");
+        return f ? f.size() : 0;
+    }
+
+    bool read(uint8_t segment, uint32_t offset, uint8_t* buf, size_t len) override {
+        char path[20];
+        segmentPath(segment, path);
+        if (!LittleFS.exists(path)) return false;
+        File f = LittleFS.open(path, "r");
+        return f && f.seek(offset) && f.read(buf, len) == len;
+    }
+
+    bool write(uint8_t segment, uint32_t offset, const uint8_t* buf, size_t len) override {
+        char path[20];
+        segmentPath(segment, path);
+        File f = LittleFS.exists(path) ? LittleFS.open(path, "r+") : LittleFS.open(path, "w");
+        return f && f.seek(offset) && f.write(buf, len) == len;
+    }
+
+    bool erase(uint8_t segment) override {
+        char path[20];
+        segmentPath(segment, path);
+        return !LittleFS.exists(path) || LittleFS.remove(path);
+    }
+
+private:
+    static void segmentPath(uint8_t segment, char* path) { snprintf(path, 20, "/log/seg%02u.bin", segment); }
+};
+
+LittleFsStorage logFiles;
+
+// ---------- CONFIG ----------
+// The config blob as one NVS entry. Its own Preferences handle, since the
+// "config" task and the pH calibration handler run on different tasks.
+class NvsConfigStorage : public ConfigStorage {
+public:
+    size_t load(uint8_t* buf, size_t cap) override {
+        Preferences p;
+        if (!p.begin("hydro", true)) return 0;   // namespace not created yet
+        size_t len = p.getBytesLength("cfg");
+        if (len && len <= cap && p.getBytes("cfg", buf, len) != len) len = 0;
+        p.end();
+        return len;
+    }
+
+    bool save(const uint8_t* buf, size_t len) override {
+        Preferences p;
+        if (!p.begin("hydro", false)) return false;
+        bool ok = p.putBytes("cfg", buf, len) == len;
+        p.end();
+        return ok;
+    }
+};
+
+NvsConfigStorage configBlob;
+
+TaskHandle_t sensorTaskHandle = nullptr;
+void wakeI2cOwner() { if (sensorTaskHandle) xTaskNotifyGive(sensorTaskHandle); }
+
+// ---------- POWER ----------
+// loop() and the sensor task run at full clock and wait at the minimum or in
+// automatic light sleep, so their cycle-counter timings stay in MAX_MHZ units.
+const int          PM_MAX_MHZ      = 240;
+const int          PM_MIN_MHZ      = 80;   // lowest the radio keeps working at
+TaskHandle_t       controlLoopTask = nullptr;
+esp_pm_lock_handle_t fullClockLock = nullptr;
+
+// PowerManager's wake hook, from a task or the encoder interrupt.
+void IRAM_ATTR wakeControlLoop() {
+    if (!controlLoopTask) return;
+    if (!xPortInIsrContext()) { xTaskNotifyGive(controlLoopTask); return; }
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(controlLoopTask, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+void holdFullClock(bool hold) {
+    if (!fullClockLock) return;
+    if (hold) esp_pm_lock_acquire(fullClockLock);
+    else      esp_pm_lock_release(fullClockLock);
+}
+
+WireBus wireBus;
+
+// ---------- pH ADC ----------
+// GPIO 34 is ADC1 channel 6. The digital controller samples it continuously
+// and DMAs into a driver-owned ring buffer; the pH task drains it in frames.
+const adc1_channel_t PH_ADC_CHANNEL  = ADC1_CHANNEL_6;
+const uint32_t       PH_SAMPLE_HZ    = 20000;   // lowest rate the ESP32 controller accepts
+const uint32_t       PH_RING_BYTES   = 2048;    // ~50 ms of samples
+const uint32_t       PH_FRAME_BYTES  = 256;     // one DMA interrupt's worth
+const uint32_t       PH_TASK_STACK   = 3072;
+const UBaseType_t    PH_TASK_PRIORITY = 1;      // below the I2C owner
+// The running DMA holds the APB clock, which keeps the chip out of light
+// sleep. With light sleep on, the ADC runs in bursts instead: the EMA keeps
+// its state across the gaps, and the probe drifts far slower than that.
+const uint32_t       PH_BURST_MS        = 250;    // ~30 EMA updates
+const uint32_t       PH_BURST_PERIOD_MS = 2000;   // one sensor cycle
+
+PhFilterChain                 phChain;            // pH task only
+esp_adc_cal_characteristics_t phAdcChars;
+std::atomic<float>            phFilteredMv(NAN);  // latest filtered probe voltage
+std::atomic<uint32_t>         phOverruns(0);      // frames lost because the task fell behind
+Preferences                   prefs;
 
 // ---------- OBJECTS ----------
 DHT dht(DHT_PIN, DHT11);
-BH1750 lightMeter;
-Adafruit_BMP085 bmp;
-LiquidCrystal_I2C lcd(0x27, 20, 4);
+LiquidCrystal_I2C lcd(LCD_ADDR, 20, 4);   // panel init only; runtime output goes through i2c
 AsyncWebServer server(80);
-AsyncEventSource events("/events");
+AsyncWebSocket ws("/ws");
+
+// ---------- RESPONSE BODIES ----------
+const size_t CONFIG_JSON_MAX = 2048;   // full schedule and limit tables
+const size_t ALERTS_JSON_MAX = 4096;   // every alert active, 16 events, 6 channels of stats
+const size_t SSE_CLIENTS_JSON_MAX = 96 + SseBroadcaster::MAX_CLIENTS * 80;
+const size_t TRACE_JSON_MAX       = 12288;   // 64 events and two stall snapshots of 32
+
+// ---------- /events ----------
+// Unacknowledged bytes one subscriber may have in lwIP. Bounds the pbufs
+// fifty dashboards can pin, and leaves the rest of TCP_SND_BUF to /ws.
+const size_t SSE_SEND_WINDOW = 2048;
+
+// ---------- TASKS ----------
+const uint32_t      SENSOR_TASK_STACK       = 4096;
+const UBaseType_t   SENSOR_TASK_PRIORITY    = 2;
+const BaseType_t    SENSOR_TASK_CORE        = 0;    // loop() and the UI run on core 1
+const unsigned long WIFI_POLL_MS            = 100;
+const unsigned long WIFI_LINKED_POLL_MS     = 1000;  // once joined, only to notice a drop
+
+// ---------- WIFI ----------
+// Joins with the BSSID and channel of the last good connection when it has
+// them. They are cached in NVS so a reboot rejoins without scanning. Uses
+// its own Preferences handle; the shared one belongs to the web handlers.
+class EspRadio : public WifiRadio {
+public:
+    EspRadio() : hintValid_(false) {}
+
+    void load() {
+        Preferences p;
+        p.begin("wifi", true);
+        hintValid_ = p.getBytes("hint", &hint_, sizeof(hint_)) == sizeof(hint_) && hint_.channel;
+        p.end();
+    }
 
-// ---------- MENU STATE ----------
-enum MenuState {
-    WELCOME, MAIN_MENU, DHT_DISPLAY, DS18B20_DISPLAY,
-    BH1750_DISPLAY, PH_DISPLAY, PRESSURE_DISPLAY,
-    RELAY_MENU, MOTOR_SETTINGS, LIGHT_CONTROL, FAN_CONTROL
-};
+    void begin(bool useHint) override {
+        if (useHint) WiFi.begin(ssid, password, hint_.channel, hint_.bssid);
+        else         WiFi.begin(ssid, password);
+    }
 
-MenuState currentState  = WELCOME;
-MenuState previousState = WELCOME;
-
-int menuIndex      = 0;
-int relayMenuIndex = 0;
-
-// ---------- RELAY / MOTOR STATE ----------
-unsigned long motorOnTime     = 15 * 60000UL;
-unsigned long motorOffTime    = 45 * 60000UL;
-unsigned long motorLastToggle = 0;
-bool motorState    = false;
-bool motorAutoMode = true;
-bool lightState    = false;
-bool fanAutoMode   = true;
-bool fanState      = false;
-
-// ---------- DISPLAY TIMING ----------
-unsigned long lastDisplayUpdate = 0;
-const unsigned long displayUpdateInterval = 1000;
-bool forceDisplayUpdate = true;
-
-// ---------- SENSOR VALUES ----------
-float bmpTemp      = 0.0;   // BMP180 temperature (used everywhere)
-float dhtHumidity  = 50.0;  // Simulated humidity
-float ds18b20Temp  = 20.0;
-float lux          = 0;
-float phValue      = 5.85;  // Simulated pH (centre of 5.5–6.2)
-float pressure_hPa = 0;
-
-// ---------- ENCODER ----------
-volatile int encoderPos = 0;
-int lastEncoderPos = 0;
-int lastCLK        = HIGH;
-unsigned long swPressTime = 0;
-bool swWasPressed  = false;
-const unsigned long LONG_PRESS_MS = 800;
-
-// ---------- SSE TIMING ----------
-unsigned long lastSSESend = 0;
-const unsigned long SSE_INTERVAL = 2000;
-
-// ---------- EMBEDDED HTML PAGE ----------
-const char INDEX_HTML[] PROGMEM = R"rawliteral(
-<!DOCTYPE html>
-<html lang="en">
-<head>
-<meta charset="UTF-8">
-<meta name="viewport" content="width=device-width, initial-scale=1.0">
-<title>Hydroponic Control Panel</title>
-<link href="https://fonts.googleapis.com/css2?family=Rajdhani:wght@400;500;600;700&family=Share+Tech+Mono&display=swap" rel="stylesheet">
-<style>
-  *, *::before, *::after { box-sizing: border-box; margin: 0; padding: 0; }
-
-  :root {
-    --bg:      #0a0e14;
-    --card:    #141f2e;
-    --border:  #1e3048;
-    --accent:  #00c896;
-    --accent2: #0af0b0;
-    --warn:    #f0a500;
-    --danger:  #e84545;
-    --text:    #c8dff0;
-    --muted:   #4a6680;
-    --font-head: 'Rajdhani', sans-serif;
-    --font-mono: 'Share Tech Mono', monospace;
-  }
-
-  body {
-    background: var(--bg);
-    color: var(--text);
-    font-family: var(--font-head);
-    min-height: 100vh;
-    overflow-x: hidden;
-  }
-
-  body::before {
-    content: '';
-    position: fixed; inset: 0;
-    background-image:
-      linear-gradient(rgba(0,200,150,.03) 1px, transparent 1px),
-      linear-gradient(90deg, rgba(0,200,150,.03) 1px, transparent 1px);
-    background-size: 40px 40px;
-    pointer-events: none;
-    z-index: 0;
-  }
-
-  body::after {
-    content: '';
-    position: fixed; inset: 0;
-    background: repeating-linear-gradient(
-      0deg, transparent, transparent 2px,
-      rgba(0,0,0,.04) 2px, rgba(0,0,0,.04) 4px
-    );
-    pointer-events: none;
-    z-index: 999;
-  }
-
-  header {
-    position: sticky; top: 0; z-index: 100;
-    background: rgba(10,14,20,.92);
-    backdrop-filter: blur(12px);
-    border-bottom: 1px solid var(--border);
-    padding: 0 24px;
-    display: flex; align-items: center; justify-content: space-between;
-    height: 62px;
-  }
-
-  .logo {
-    font-size: 1.35rem; font-weight: 700;
-    letter-spacing: .12em; text-transform: uppercase;
-    color: var(--accent);
-  }
-  .logo span { color: var(--text); font-weight: 500; }
-
-  .header-right {
-    display: flex; align-items: center; gap: 8px;
-    font-size: .85rem; color: var(--muted);
-    font-family: var(--font-mono);
-  }
-
-  .status-dot {
-    width: 10px; height: 10px; border-radius: 50%;
-    background: var(--accent); box-shadow: 0 0 8px var(--accent);
-    animation: pulse 2s infinite; display: inline-block; margin-right: 8px;
-  }
-  .status-dot.off { background: var(--danger); box-shadow: 0 0 8px var(--danger); animation: none; }
-
-  @keyframes pulse { 0%,100%{opacity:1} 50%{opacity:.4} }
-
-  main {
-    position: relative; z-index: 1;
-    max-width: 1280px; margin: 0 auto;
-    padding: 32px 20px 60px;
-  }
-
-  .section-title {
-    font-size: .7rem; letter-spacing: .2em;
-    text-transform: uppercase; color: var(--muted);
-    margin-bottom: 16px; border-left: 2px solid var(--accent);
-    padding-left: 10px;
-  }
-
-  .sensor-grid {
-    display: grid;
-    grid-template-columns: repeat(auto-fill, minmax(200px, 1fr));
-    gap: 16px; margin-bottom: 40px;
-  }
-
-  .card {
-    background: var(--card); border: 1px solid var(--border);
-    border-radius: 10px; padding: 22px 20px;
-    position: relative; overflow: hidden;
-    transition: border-color .25s, transform .2s;
-  }
-  .card::before {
-    content: ''; position: absolute; top: 0; left: 0; right: 0; height: 2px;
-    background: linear-gradient(90deg, transparent, var(--accent), transparent);
-    opacity: 0; transition: opacity .3s;
-  }
-  .card:hover { border-color: var(--accent); transform: translateY(-2px); }
-  .card:hover::before { opacity: 1; }
-
-  .card-label {
-    font-size: .7rem; letter-spacing: .16em;
-    text-transform: uppercase; color: var(--muted); margin-bottom: 14px;
-  }
-  .card-value {
-    font-family: var(--font-mono); font-size: 2.2rem;
-    font-weight: 700; color: var(--accent2); line-height: 1;
-    transition: color .4s;
-  }
-  .card-unit { font-family: var(--font-mono); font-size: .8rem; color: var(--muted); margin-top: 6px; }
-  .card-icon { position: absolute; top: 18px; right: 18px; font-size: 1.4rem; opacity: .18; }
-
-  .relay-grid {
-    display: grid;
-    grid-template-columns: repeat(auto-fill, minmax(280px, 1fr));
-    gap: 20px;
-  }
-
-  .relay-card {
-    background: var(--card); border: 1px solid var(--border);
-    border-radius: 10px; padding: 24px;
-    transition: border-color .25s;
-  }
-  .relay-card.active { border-color: rgba(0,200,150,.45); }
-
-  .relay-header {
-    display: flex; align-items: center; justify-content: space-between;
-    margin-bottom: 18px;
-  }
-  .relay-name { font-size: 1.1rem; font-weight: 700; letter-spacing: .06em; text-transform: uppercase; }
-
-  .relay-badge {
-    font-family: var(--font-mono); font-size: .68rem;
-    padding: 3px 10px; border-radius: 20px; font-weight: 600; letter-spacing: .05em;
-  }
-  .relay-badge.on  { background: rgba(0,200,150,.12);  color: var(--accent); border: 1px solid rgba(0,200,150,.3); }
-  .relay-badge.off { background: rgba(232,69,69,.10); color: var(--danger); border: 1px solid rgba(232,69,69,.3); }
-
-  .relay-controls { display: flex; gap: 10px; flex-wrap: wrap; }
-
-  .btn {
-    flex: 1; min-width: 80px; padding: 11px 18px;
-    border: none; border-radius: 7px;
-    font-family: var(--font-head); font-size: .88rem;
-    font-weight: 600; letter-spacing: .08em; text-transform: uppercase;
-    cursor: pointer; transition: background .2s, transform .15s, box-shadow .2s;
-  }
-  .btn:active { transform: scale(.97); }
-
-  .btn-on  { background: rgba(0,200,150,.15); color: var(--accent); border: 1px solid rgba(0,200,150,.4); }
-  .btn-on:hover  { background: rgba(0,200,150,.28); box-shadow: 0 0 14px rgba(0,200,150,.2); }
-  .btn-off { background: rgba(232,69,69,.12); color: var(--danger); border: 1px solid rgba(232,69,69,.35); }
-  .btn-off:hover { background: rgba(232,69,69,.24); box-shadow: 0 0 14px rgba(232,69,69,.18); }
-
-  .btn-auto {
-    background: rgba(240,165,0,.12); color: var(--warn);
-    border: 1px solid rgba(240,165,0,.35);
-    width: 100%; flex: unset; margin-top: 8px;
-  }
-  .btn-auto:hover { background: rgba(240,165,0,.24); }
-  .btn-auto.active-auto { background: rgba(240,165,0,.22); box-shadow: 0 0 10px rgba(240,165,0,.2); }
-
-  .auto-label { font-size: .72rem; color: var(--muted); margin-top: 12px; font-family: var(--font-mono); text-align: center; }
-
-  #lastUpdated { font-family: var(--font-mono); font-size: .72rem; color: var(--muted); text-align: right; margin-top: 32px; }
-
-  @media (max-width: 600px) {
-    header { padding: 0 16px; }
-    main   { padding: 20px 14px 50px; }
-    .card-value { font-size: 1.8rem; }
-    .sensor-grid { grid-template-columns: 1fr 1fr; gap: 12px; }
-    .relay-grid  { grid-template-columns: 1fr; }
-  }
-</style>
-</head>
-<body>
-
-<header>
-  <div class="logo">Hydro<span>Control</span></div>
-  <div class="header-right">
-    <span class="status-dot" id="connDot"></span>
-    <span id="connLabel">Connecting...</span>
-  </div>
-</header>
-
-<main>
-  <p class="section-title">Live Sensor Readings</p>
-  <div class="sensor-grid">
-    <div class="card">
-      <div class="card-label">Air Temperature</div>
-      <div class="card-value" id="bmpTemp">--</div>
-      <div class="card-unit">Degrees C &middot; BMP180</div>
-      <div class="card-icon">T</div>
-    </div>
-    <div class="card">
-      <div class="card-label">Humidity</div>
-      <div class="card-value" id="dhtHumidity">--</div>
-      <div class="card-unit">Percent RH &middot; DHT11</div>
-      <div class="card-icon">%</div>
-    </div>
-    <div class="card">
-      <div class="card-label">Water Temperature</div>
-      <div class="card-value" id="ds18b20">--</div>
-      <div class="card-unit">Degrees C &middot; DS18B20</div>
-      <div class="card-icon">W</div>
-    </div>
-    <div class="card">
-      <div class="card-label">Light Intensity</div>
-      <div class="card-value" id="lux">--</div>
-      <div class="card-unit">Lux &middot; BH1750</div>
-      <div class="card-icon">L</div>
-    </div>
-    <div class="card">
-      <div class="card-label">pH Level</div>
-      <div class="card-value" id="ph">--</div>
-      <div class="card-unit">pH Units &middot; Analog</div>
-      <div class="card-icon">H</div>
-    </div>
-    <div class="card">
-      <div class="card-label">Barometric Pressure</div>
-      <div class="card-value" id="pressure">--</div>
-      <div class="card-unit">hPa &middot; BMP180</div>
-      <div class="card-icon">P</div>
-    </div>
-  </div>
-
-  <p class="section-title">Relay Controls</p>
-  <div class="relay-grid">
-    <div class="relay-card" id="motorCard">
-      <div class="relay-header">
-        <div class="relay-name">Water Pump</div>
-        <div class="relay-badge off" id="motorBadge">OFF</div>
-      </div>
-      <div class="relay-controls">
-        <button class="btn btn-on"  onclick="relayCmd('motor','1')">Turn On</button>
-        <button class="btn btn-off" onclick="relayCmd('motor','0')">Turn Off</button>
-      </div>
-      <button class="btn btn-auto" id="motorAutoBtn" onclick="toggleAuto('motor')">Auto Cycle Mode</button>
-      <div class="auto-label" id="motorAutoLabel">Manual mode active</div>
-    </div>
-    <div class="relay-card" id="lightCard">
-      <div class="relay-header">
-        <div class="relay-name">Grow Light</div>
-        <div class="relay-badge off" id="lightBadge">OFF</div>
-      </div>
-      <div class="relay-controls">
-        <button class="btn btn-on"  onclick="relayCmd('light','1')">Turn On</button>
-        <button class="btn btn-off" onclick="relayCmd('light','0')">Turn Off</button>
-      </div>
-    </div>
-    <div class="relay-card" id="fanCard">
-      <div class="relay-header">
-        <div class="relay-name">Ventilation Fan</div>
-        <div class="relay-badge off" id="fanBadge">OFF</div>
-      </div>
-      <div class="relay-controls">
-        <button class="btn btn-on"  onclick="relayCmd('fan','1')">Turn On</button>
-        <button class="btn btn-off" onclick="relayCmd('fan','0')">Turn Off</button>
-      </div>
-      <button class="btn btn-auto" id="fanAutoBtn" onclick="toggleAuto('fan')">Auto Mode</button>
-      <div class="auto-label" id="fanAutoLabel">Manual mode active</div>
-    </div>
-  </div>
-
-  <div id="lastUpdated">Awaiting data...</div>
-</main>
-
-<script>
-  const dot   = document.getElementById('connDot');
-  const label = document.getElementById('connLabel');
-
-  const evtSource = new EventSource('/events');
-
-  evtSource.onopen = () => {
-    dot.classList.remove('off');
-    label.textContent = 'Connected';
-  };
-  evtSource.onerror = () => {
-    dot.classList.add('off');
-    label.textContent = 'Disconnected';
-  };
-
-  evtSource.addEventListener('sensors', e => {
-    const d = JSON.parse(e.data);
-    set('bmpTemp',     (d.bmpTemp / 10).toFixed(1));
-    set('dhtHumidity', (d.dhtHumidity / 10).toFixed(1));
-    set('ds18b20',     (d.ds18b20 / 100).toFixed(2));
-    set('lux',         d.lux.toFixed(0));
-    set('ph',          (d.ph / 100).toFixed(2));
-    set('pressure',    (d.pressure / 10).toFixed(1));
-
-    setRelay('motor', d.motor, d.motorAuto);
-    setRelay('light', d.light, null);
-    setRelay('fan',   d.fan,   d.fanAuto);
-
-    document.getElementById('lastUpdated').textContent =
-      'Last updated: ' + new Date().toLocaleTimeString();
-  });
-
-  function set(id, val) {
-    const el = document.getElementById(id);
-    if (el) el.textContent = val;
-  }
-
-  function setRelay(name, state, auto) {
-    const badge     = document.getElementById(name + 'Badge');
-    const card      = document.getElementById(name + 'Card');
-    const autoBtn   = document.getElementById(name + 'AutoBtn');
-    const autoLabel = document.getElementById(name + 'AutoLabel');
-
-    if (badge) { badge.textContent = state ? 'ON' : 'OFF'; badge.className = 'relay-badge ' + (state ? 'on' : 'off'); }
-    if (card)  { card.classList.toggle('active', !!state); }
-    if (auto !== null && autoBtn) {
-      autoBtn.classList.toggle('active-auto', !!auto);
-      if (autoLabel) autoLabel.textContent = auto ? 'Auto cycle active' : 'Manual mode active';
+    bool connected() override { return WiFi.status() == WL_CONNECTED; }
+    void disconnect() override { WiFi.disconnect(false, false); }
+    bool hasHint() override { return hintValid_; }
+
+    void joined() override {
+        Hint now;
+        memcpy(now.bssid, WiFi.BSSID(), sizeof(now.bssid));
+        now.channel = WiFi.channel();
+        if (hintValid_ && !memcmp(&now, &hint_, sizeof(now))) return;   // spare the flash
+        hint_      = now;
+        hintValid_ = true;
+        Preferences p;
+        p.begin("wifi", false);
+        p.putBytes("hint", &hint_, sizeof(hint_));
+        p.end();
     }
-  }
-
-  function relayCmd(device, state) {
-    const fd = new FormData();
-    fd.append('device', device);
-    fd.append('state', state);
-    fetch('/relay', { method: 'POST', body: fd });
-  }
-
-  function toggleAuto(device) {
-    const btn    = document.getElementById(device + 'AutoBtn');
-    const isAuto = btn && btn.classList.contains('active-auto');
-    const fd = new FormData();
-    fd.append('device', device + 'Auto');
-    fd.append('state', isAuto ? '0' : '1');
-    fetch('/relay', { method: 'POST', body: fd });
-  }
-</script>
-</body>
-</html>
-)rawliteral";
 
-// =====================================
-//  RELAY HELPERS
-// =====================================
-void setMotorRelay(bool state) { motorState = state; digitalWrite(RELAY_MOTOR, state ? RELAY_ON : RELAY_OFF); }
-void setLightRelay(bool state) { lightState = state; digitalWrite(RELAY_LIGHT, state ? RELAY_ON : RELAY_OFF); }
-void setFanRelay(bool state)   { fanState   = state; digitalWrite(RELAY_FAN,   state ? FAN_RELAY_ON : FAN_RELAY_OFF); }
+    void startAp() override {
+        WiFi.mode(WIFI_AP_STA);
+        WiFi.softAP(apSsid, apPassword);
+        hal::log("WiFi: station down, access point %s open\n", apSsid);
+    }
 
-// =====================================
-//  ENCODER ISR
-// =====================================
-void IRAM_ATTR encoderISR() {
-    int clk = digitalRead(ENC_CLK);
-    int dt  = digitalRead(ENC_DT);
-    if (clk != lastCLK) { encoderPos += (dt != clk) ? 1 : -1; lastCLK = clk; }
+    void stopAp() override {
+        WiFi.softAPdisconnect(true);
+        WiFi.mode(WIFI_STA);
+    }
+
+private:
+    struct Hint {
+        uint8_t bssid[6];
+        uint8_t channel;
+    };
+    Hint hint_;
+    bool hintValid_;
+};
+
+void onWifiLink(bool up);
+
+EspRadio          wifiRadio;
+ConnectionManager wifiLink(wifiRadio, hal::millis, onWifiLink);
+bool              clockConfigured = false;
+
+void onWifiLink(bool up) {
+    if (!up) { hal::log("WiFi: link lost, rejoining\n"); return; }
+    hal::log("WiFi: joined in %u ms, IP %s\n", (unsigned)wifiLink.stats().lastJoinMs,
+             WiFi.localIP().toString().c_str());
+    markBoot(BOOT_NETWORK_UP);
+    if (clockConfigured) return;
+    configTzTime(timezone, ntpServer);   // SNTP runs in the background
+    clockConfigured = true;
+}
+
+uint8_t wifiTask = Scheduler::NO_TASK;
+
+void pollWifi() {
+    wifiLink.poll();
+    if (wifiLink.state() == ConnectionManager::CM_CONNECTED)
+        scheduler.rescheduleAt(wifiTask, scheduler.now() + WIFI_LINKED_POLL_MS * 1000ULL);
 }
 
+#if HYDRO_METRICS
+uint32_t wifiAttempts() { return wifiLink.stats().attempts; }
+uint32_t wifiDrops()    { return wifiLink.stats().drops; }
+#endif
+
 // =====================================
-//  LCD MENU
+//  HAL
 // =====================================
-void displayWelcome() {
-    lcd.clear();
-    lcd.setCursor(3, 1); lcd.print("WELCOME TO");
-    lcd.setCursor(3, 2); lcd.print("HYDROPONIC");
-    delay(2000);
-    currentState = MAIN_MENU;
-    forceDisplayUpdate = true;
-}
-
-void handleUpButton() {
-    if (currentState == MAIN_MENU)       { if (--menuIndex < 0)      menuIndex = 5; }
-    else if (currentState == RELAY_MENU) { if (--relayMenuIndex < 0) relayMenuIndex = 3; }
-    else if (currentState == MOTOR_SETTINGS) { motorAutoMode = false; setMotorRelay(!motorState); }
-    else if (currentState == LIGHT_CONTROL)  { setLightRelay(!lightState); }
-    else if (currentState == FAN_CONTROL)    { fanAutoMode = false; setFanRelay(!fanState); }
-}
-void handleDownButton() {
-    if (currentState == MAIN_MENU)       { if (++menuIndex > 5)      menuIndex = 0; }
-    else if (currentState == RELAY_MENU) { if (++relayMenuIndex > 3) relayMenuIndex = 0; }
-    else if (currentState == MOTOR_SETTINGS) { motorAutoMode = false; setMotorRelay(!motorState); }
-    else if (currentState == LIGHT_CONTROL)  { setLightRelay(!lightState); }
-    else if (currentState == FAN_CONTROL)    { fanAutoMode = false; setFanRelay(!fanState); }
-}
-void handleOkButton() {
-    if (currentState == MAIN_MENU) {
-        if      (menuIndex == 0) currentState = DHT_DISPLAY;
-        else if (menuIndex == 1) currentState = DS18B20_DISPLAY;
-        else if (menuIndex == 2) currentState = BH1750_DISPLAY;
-        else if (menuIndex == 3) currentState = PH_DISPLAY;
-        else if (menuIndex == 4) currentState = PRESSURE_DISPLAY;
-        else if (menuIndex == 5) currentState = RELAY_MENU;
-    } else if (currentState == RELAY_MENU) {
-        if      (relayMenuIndex == 0) currentState = MOTOR_SETTINGS;
-        else if (relayMenuIndex == 1) currentState = LIGHT_CONTROL;
-        else if (relayMenuIndex == 2) currentState = FAN_CONTROL;
-        else                          currentState = MAIN_MENU;
-    } else if (currentState == MOTOR_SETTINGS || currentState == LIGHT_CONTROL || currentState == FAN_CONTROL) {
-        currentState = RELAY_MENU;
-    } else {
-        currentState = MAIN_MENU;
-    }
+uint32_t hal::millis()      { return ::millis(); }
+uint32_t hal::micros()      { return ::micros(); }
+uint64_t hal::monotonicUs() { return (uint64_t)esp_timer_get_time(); }
+uint32_t hal::cycles()      { return ESP.getCycleCount(); }
+uint32_t hal::cyclesPerUs() { return getCpuFrequencyMhz(); }
+
+bool hal::timeOfDay(uint32_t& sec) {
+    time_t now = time(nullptr);
+    if (now < CLOCK_SET) return false;
+    struct tm local;
+    localtime_r(&now, &local);
+    sec = local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec;
+    return true;
 }
-void handleBackButton() {
-    if (currentState == MOTOR_SETTINGS || currentState == LIGHT_CONTROL || currentState == FAN_CONTROL)
-        currentState = RELAY_MENU;
-    else if (currentState != MAIN_MENU)
-        currentState = MAIN_MENU;
-}
-
-void handleEncoder() {
-    int pos   = encoderPos;
-    int delta = pos - lastEncoderPos;
-    if (delta >= 2)       { lastEncoderPos = pos; handleDownButton(); forceDisplayUpdate = true; }
-    else if (delta <= -2) { lastEncoderPos = pos; handleUpButton();   forceDisplayUpdate = true; }
-
-    bool swPressed = (digitalRead(ENC_SW) == LOW);
-    if (swPressed && !swWasPressed)  { swPressTime = millis(); swWasPressed = true; }
-    if (!swPressed && swWasPressed) {
-        swWasPressed = false;
-        if (millis() - swPressTime >= LONG_PRESS_MS) handleBackButton();
-        else                                          handleOkButton();
-        forceDisplayUpdate = true;
-    }
+
+bool hal::unixTime(uint32_t& sec) {
+    time_t now = time(nullptr);
+    if (now < CLOCK_SET) return false;
+    sec = (uint32_t)now;
+    return true;
 }
 
+void hal::pinOutput(uint8_t pin, bool level) { pinMode(pin, OUTPUT); digitalWrite(pin, level); }
+void hal::pinInputPullup(uint8_t pin)        { pinMode(pin, INPUT_PULLUP); }
+void hal::pinWrite(uint8_t pin, bool level)  { digitalWrite(pin, level); }
+bool hal::pinRead(uint8_t pin)               { return digitalRead(pin) == HIGH; }
+
+I2cBus& hal::i2cBus() { return wireBus; }
+
 // =====================================
-//  SENSORS
+//  /events SOCKETS
 // =====================================
-void updateSensors() {
-    static unsigned long lastUpdate = 0;
-    if (millis() - lastUpdate < 2000) return;
-    lastUpdate = millis();
-
-    // BMP180 temperature used everywhere
-    float t = bmp.readTemperature();
-    if (!isnan(t)) bmpTemp = t;
+// The web server only sets up the stream: SseResponse sends the headers and,
+// once they are acked, hands the socket over. From then on SseBroadcaster
+// decides what goes out and when; this table maps its client ids to the
+// AsyncClients. Connects and disconnects arrive on the async_tcp task and
+// writes come from loop(), so the table is behind a recursive mutex (a close
+// from loop() disconnects on the same task).
+struct SseSocket {
+    uint32_t     id;
+    AsyncClient* client;
+};
 
-    // Simulated humidity 49.7 to 52.6
-    dhtHumidity += random(-5, 6) / 100.0;
-    dhtHumidity  = constrain(dhtHumidity, 49.7, 52.6);
+SseSocket         sseSockets[SseBroadcaster::MAX_CLIENTS];
+SemaphoreHandle_t sseSocketMutex = nullptr;
+uint32_t          sseNextId      = 1;
 
-    // Simulated water temp 19.7 to 21.2
-    ds18b20Temp += random(-5, 6) / 100.0;
-    ds18b20Temp  = constrain(ds18b20Temp, 19.7, 21.2);
+struct SseSocketLock {
+    SseSocketLock()  { xSemaphoreTakeRecursive(sseSocketMutex, portMAX_DELAY); }
+    ~SseSocketLock() { xSemaphoreGiveRecursive(sseSocketMutex); }
+};
 
-    lux          = lightMeter.readLightLevel();
-    // Simulated pH: gradual random drift within 5.5 – 6.2
-    phValue     += random(-3, 4) / 100.0;
-    phValue      = constrain(phValue, 5.5, 6.2);
-    pressure_hPa = bmp.readPressure() / 100.0;
+SseSocket* sseFind(uint32_t id) {
+    for (uint8_t i = 0; i < SseBroadcaster::MAX_CLIENTS; i++)
+        if (sseSockets[i].client && sseSockets[i].id == id) return &sseSockets[i];
+    return nullptr;
 }
 
-// =====================================
-//  LCD DISPLAY
-// =====================================
-void updateDisplay() {
-    if (currentState == previousState && !forceDisplayUpdate &&
-        millis() - lastDisplayUpdate < displayUpdateInterval) return;
-
-    lcd.clear();
-    lastDisplayUpdate  = millis();
-    previousState      = currentState;
-    forceDisplayUpdate = false;
-
-    if (currentState == MAIN_MENU) {
-        const char* items[] = {"Temp & Humidity","Water Temp","Light Intensity","pH Sensor","Pressure","Controls"};
-        lcd.setCursor(0,0); lcd.print("     MAIN MENU     ");
-        for (int i = 0; i < 3; i++) {
-            int idx = (menuIndex + i - 1 + 6) % 6;
-            lcd.setCursor(0, i+1);
-            lcd.print(i == 1 ? ">" : " ");
-            lcd.print(items[idx]);
-        }
+void sseDetach(uint32_t id) {
+    {
+        SseSocketLock lock;
+        SseSocket*    s = sseFind(id);
+        if (!s) return;
+        s->client = nullptr;
     }
-    else if (currentState == DHT_DISPLAY) {
-        lcd.setCursor(0,0); lcd.print("      DHT11      ");
-        lcd.setCursor(0,1); lcd.print("Temp: ");
-        lcd.print(bmpTemp, 1); lcd.print(" C");
-        lcd.setCursor(0,2); lcd.print("Humidity: ");
-        lcd.print(dhtHumidity, 1); lcd.print(" %");
-    }
-    else if (currentState == DS18B20_DISPLAY) {
-        lcd.setCursor(0,0); lcd.print(" Water Temp");
-        lcd.setCursor(0,1); lcd.print("Water Temp:");
-        lcd.setCursor(0,2); lcd.print(ds18b20Temp, 2); lcd.print(" C");
+    sse.disconnected(id);
+    power.wake(WAKE_NETWORK);
+}
+
+// Takes the connection over from the request, as AsyncEventSourceClient does.
+void sseAttach(AsyncWebServerRequest* req) {
+    AsyncClient* c      = req->client();
+    uint32_t     lastId = 0;
+    if (req->hasHeader("Last-Event-ID")) lastId = strtoul(req->getHeader("Last-Event-ID")->value().c_str(), nullptr, 10);
+    delete req;
+
+    SseSocket* slot = nullptr;
+    uint32_t   id;
+    {
+        SseSocketLock lock;
+        for (uint8_t i = 0; i < SseBroadcaster::MAX_CLIENTS && !slot; i++)
+            if (!sseSockets[i].client) slot = &sseSockets[i];
+        id = sseNextId++;
+        if (slot) { slot->id = id; slot->client = c; }
     }
-    else if (currentState == BH1750_DISPLAY) {
-        lcd.setCursor(0,0); lcd.print(" Light Intensity");
-        lcd.setCursor(0,1); lcd.print("Light Intensity:");
-        lcd.setCursor(0,2); lcd.print(lux, 1); lcd.print(" lux");
+    c->setRxTimeout(0);
+    c->onError(nullptr, nullptr);
+    c->onAck(nullptr, nullptr);
+    c->onPoll(nullptr, nullptr);
+    c->onData(nullptr, nullptr);
+    c->onTimeout([](void*, AsyncClient* client, uint32_t) { client->close(true); }, nullptr);
+    c->onDisconnect([](void* arg, AsyncClient* client) {
+        sseDetach((uint32_t)(uintptr_t)arg);
+        delete client;
+    }, (void*)(uintptr_t)id);
+
+    if (!slot || !sse.connected(id, lastId)) {
+        if (slot) { SseSocketLock lock; slot->client = nullptr; }
+        c->close(true);
+        return;
     }
-    else if (currentState == PH_DISPLAY) {
-        lcd.setCursor(0,0); lcd.print("     pH SENSOR");
-        lcd.setCursor(0,1); lcd.print("pH Value:");
-        lcd.setCursor(0,2); lcd.print(phValue, 2);
+    power.wake(WAKE_NETWORK);
+}
+
+// Overrides ESPAsyncWebServer internals (_respond, _ack, _sourceValid and
+// the _state and _headLength members), which are not public API and change
+// between releases. lib_deps pins the release this was written against;
+// check these hooks before moving the pin. The head is built here rather
+// than by _assembleHead(), which returns a heap String.
+class SseResponse : public AsyncWebServerResponse {
+public:
+    SseResponse() {
+        _code              = 200;
+        _sendContentLength = false;
     }
-    else if (currentState == PRESSURE_DISPLAY) {
-        lcd.setCursor(0,0); lcd.print("   PRESSURE");
-        lcd.setCursor(0,1); lcd.print("Pressure:");
-        lcd.setCursor(0,2); lcd.print(pressure_hPa, 1); lcd.print(" hPa");
+    void _respond(AsyncWebServerRequest* req) override {
+        char head[128];
+        int  len = snprintf(head, sizeof(head),
+                            "HTTP/1.%u 200 OK\r\n"
+                            "Content-Type: text/event-stream\r\n"
+                            "Cache-Control: no-cache\r\n"
+                            "Connection: keep-alive\r\n\r\n",
+                            (unsigned)req->version());
+        _headLength = len;
+        req->client()->write(head, len);
+        _state = RESPONSE_WAIT_ACK;
     }
-    else if (currentState == RELAY_MENU) {
-        const char* items[] = {"Motor","Light","Fan","Back"};
-        lcd.setCursor(0,0); lcd.print(" Controls");
-        for (int i = 0; i < 3; i++) {
-            int idx = (relayMenuIndex + i - 1 + 4) % 4;
-            lcd.setCursor(0, i+1);
-            lcd.print(i == 1 ? ">" : " ");
-            lcd.print(items[idx]);
-        }
+    size_t _ack(AsyncWebServerRequest* req, size_t len, uint32_t) override {
+        if (len) sseAttach(req);
+        return 0;
     }
-    else if (currentState == MOTOR_SETTINGS) {
-        lcd.setCursor(0,0); lcd.print("    WATER PUMP");
-        lcd.setCursor(0,1); lcd.print("State: ");
-        lcd.print(motorState ? "ON " : "OFF");
-        lcd.setCursor(0,2); lcd.print("Mode: ");
-        lcd.print(motorAutoMode ? "AUTO  " : "MANUAL");
+    bool _sourceValid() const override { return true; }
+};
+
+LogStorage& hal::logStorage() { return logFiles; }
+
+ConfigStorage& hal::configStorage() { return configBlob; }
+
+float hal::phMillivolts() { return phFilteredMv.load(std::memory_order_relaxed); }
+
+// No DHT11 or DS18B20 driver yet: both are random walks within a plausible
+// band, in whole steps of the reading's resolution. The input trace keeps
+// the values they produced, so a replay does not depend on the seed.
+bool hal::readHumidity(DeciPercent& rh) {
+    rh = (rh + DeciPercent::fromRaw(random(-1, 2))).clamp(DeciPercent::fromRaw(497), DeciPercent::fromRaw(526));
+    return true;
+}
+
+bool hal::readWaterTemp(CentiCelsius& t) {
+    t = (t + CentiCelsius::fromRaw(random(-5, 6))).clamp(CentiCelsius::fromRaw(1970), CentiCelsius::fromRaw(2120));
+    return true;
+}
+
+void hal::displayBegin() {
+    lcd.init();
+    lcd.backlight();
+}
+
+// ---------- FLIGHT RECORDER ----------
+// RTC slow memory is left alone by everything short of a power cycle.
+RTC_NOINIT_ATTR TraceMemory traceMem;
+
+TraceMemory& hal::traceMemory() { return traceMem; }
+
+ResetCause hal::resetCause() {
+    switch (esp_reset_reason()) {
+    case ESP_RST_POWERON:   return RESET_POWER_ON;
+    case ESP_RST_EXT:       return RESET_EXTERNAL;
+    case ESP_RST_SW:        return RESET_SOFTWARE;
+    case ESP_RST_PANIC:     return RESET_PANIC;
+    case ESP_RST_INT_WDT:   return RESET_INT_WDT;
+    case ESP_RST_TASK_WDT:  return RESET_TASK_WDT;
+    case ESP_RST_WDT:       return RESET_OTHER_WDT;
+    case ESP_RST_DEEPSLEEP: return RESET_DEEP_SLEEP;
+    case ESP_RST_BROWNOUT:  return RESET_BROWNOUT;
+    default:                return RESET_UNKNOWN;
     }
-    else if (currentState == LIGHT_CONTROL) {
-        lcd.setCursor(0,0); lcd.print("    GROW LIGHT");
-        lcd.setCursor(0,1); lcd.print("State: ");
-        lcd.print(lightState ? "ON " : "OFF");
+}
+
+uint32_t hal::heapFree()    { return ESP.getFreeHeap(); }
+uint32_t hal::heapMinFree() { return ESP.getMinFreeHeap(); }
+
+size_t hal::sseWrite(uint32_t client, const char* data, size_t len) {
+    SseSocketLock lock;
+    SseSocket*    s = sseFind(client);
+    if (!s || !s->client->canSend()) return 0;
+    size_t space    = s->client->space();
+    size_t inFlight = TCP_SND_BUF > space ? TCP_SND_BUF - space : 0;
+    if (inFlight >= SSE_SEND_WINDOW) return 0;
+    size_t n = len;
+    if (n > space)                      n = space;
+    if (n > SSE_SEND_WINDOW - inFlight) n = SSE_SEND_WINDOW - inFlight;
+    if (!n) return 0;
+    n = s->client->add(data, n);
+    if (n) s->client->send();
+    return n;
+}
+
+void hal::sseClose(uint32_t client) {
+    SseSocketLock lock;
+    SseSocket*    s = sseFind(client);
+    if (s) s->client->close(true);   // onDisconnect clears the slot, on this task
+}
+
+void hal::wsSend(uint32_t client, const uint8_t* frame, size_t len) {
+    if (client) ws.binary(client, frame, len);
+    else        ws.binaryAll(frame, len);
+}
+
+void hal::wsClose(uint32_t client) { ws.close(client); }
+
+void hal::log(const char* fmt, ...) {
+    char    line[160];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    Serial.print(line);
+}
+
+// =====================================
+//  ENCODER ISR
+// =====================================
+// Fires on every change of CLK, DT or the button. All levels come from the
+// GPIO input registers in one read each (CLK is GPIO 33, in the upper bank),
+// so they are sampled together and no digitalRead() runs in the ISR. The
+// GPIO interrupt service runs it during flash writes too, so everything it
+// calls is in IRAM (IramAttr.h).
+//
+// Light sleep can only be left on a GPIO level, not an edge, so each pin is
+// armed for the level it does not have and re-armed on every interrupt.
+// That makes the level interrupt behave like CHANGE and lets the same pins
+// wake the chip.
+static inline bool IRAM_ATTR gpioLevel(uint8_t pin, uint32_t in0, uint32_t in1) {
+    return pin < 32 ? (in0 >> pin) & 1 : (in1 >> (pin - 32)) & 1;
+}
+
+static inline void IRAM_ATTR armForChange(uint8_t pin, bool level) {
+    GPIO.pin[pin].int_type = level ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL;
+}
+
+void IRAM_ATTR encoderISR() {
+    uint32_t in0 = REG_READ(GPIO_IN_REG);
+    uint32_t in1 = REG_READ(GPIO_IN1_REG);
+    bool clk = gpioLevel(ENC_CLK, in0, in1), dt = gpioLevel(ENC_DT, in0, in1);
+    armForChange(ENC_CLK, clk);
+    armForChange(ENC_DT, dt);
+    armForChange(ENC_SW, gpioLevel(ENC_SW, in0, in1));
+    encoderInput.pinEdge(clk << 1 | dt);
+    power.wake(WAKE_INPUT);
+}
+
+void attachEncoder() {
+    const uint8_t PINS[] = { ENC_CLK, ENC_DT, ENC_SW };
+    for (uint8_t pin : PINS) {
+        attachInterrupt(digitalPinToInterrupt(pin), encoderISR, digitalRead(pin) ? ONLOW_WE : ONHIGH_WE);
     }
-    else if (currentState == FAN_CONTROL) {
-        lcd.setCursor(0,0); lcd.print("   VENTIL. FAN");
-        lcd.setCursor(0,1); lcd.print("State: ");
-        lcd.print(fanState ? "ON " : "OFF");
-        lcd.setCursor(0,2); lcd.print("Mode: ");
-        lcd.print(fanAutoMode ? "AUTO  " : "MANUAL");
+    esp_sleep_enable_gpio_wakeup();
+}
+
+// =====================================
+//  POWER MANAGEMENT
+// =====================================
+// Automatic light sleep needs CONFIG_PM_ENABLE and
+// CONFIG_FREERTOS_USE_TICKLESS_IDLE in the SDK configuration. Without them
+// esp_pm_configure() refuses, and the board waits between deadlines at full
+// clock as before.
+void startPowerManagement() {
+    esp_pm_config_esp32_t pm = {};
+    pm.max_freq_mhz       = PM_MAX_MHZ;
+    pm.min_freq_mhz       = PM_MIN_MHZ;
+    pm.light_sleep_enable = true;
+    esp_err_t err = esp_pm_configure(&pm);
+    if (err != ESP_OK) {
+        hal::log("power: no light sleep (%s)\n", esp_err_to_name(err));
+        return;
     }
+    if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "control", &fullClockLock) != ESP_OK) fullClockLock = nullptr;
+    power.setSleepEnabled(true);
 }
 
 // =====================================
-//  SSE - push sensor data to browser
+//  SENSOR TASK
 // =====================================
-void sendSSEData() {
-    if (millis() - lastSSESend < SSE_INTERVAL) return;
-    lastSSESend = millis();
-    if (!events.count()) return;
-
-    JsonDocument doc;
-    doc["bmpTemp"]     = (int)(bmpTemp * 10);
-    doc["dhtHumidity"] = (int)(dhtHumidity * 10);
-    doc["ds18b20"]     = (int)(ds18b20Temp * 100);
-    doc["lux"]         = (int)lux;
-    doc["ph"]          = (int)(phValue * 100);
-    doc["pressure"]    = (int)(pressure_hPa * 10);
-    doc["motor"]       = motorState    ? 1 : 0;
-    doc["light"]       = lightState    ? 1 : 0;
-    doc["fan"]         = fanState      ? 1 : 0;
-    doc["motorAuto"]   = motorAutoMode ? 1 : 0;
-    doc["fanAuto"]     = fanAutoMode   ? 1 : 0;
-
-    String out;
-    serializeJson(doc, out);
-    events.send(out.c_str(), "sensors", millis());
+// Pinned to core 0 and the only caller of sensorStep(), so it owns the I2C
+// bus. Sleeps between conversion deadlines or until the LCD submits work; the
+// UI on core 1 never waits on I2C.
+void sensorTask(void*) {
+    for (;;) {
+        holdFullClock(true);
+        uint32_t wakeAt = sensorStep();
+        holdFullClock(false);
+        if (!wakeAt) { taskYIELD(); continue; }   // results are ready to step
+        int32_t waitUs = (int32_t)(wakeAt - ::micros());
+        if (waitUs > 0) ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS((waitUs + 999) / 1000));
+    }
 }
 
 // =====================================
-//  SETUP
+//  pH ACQUISITION
 // =====================================
-void setup() {
-    Serial.begin(115200);
-    Wire.begin(21, 22);
-    lcd.init();
-    lcd.backlight();
+bool startPhAdc() {
+    adc_digi_init_config_t init = {};
+    init.max_store_buf_size = PH_RING_BYTES;
+    init.conv_num_each_intr = PH_FRAME_BYTES;
+    init.adc1_chan_mask     = BIT(PH_ADC_CHANNEL);
+    if (adc_digi_initialize(&init) != ESP_OK) return false;
+
+    adc_digi_pattern_config_t pattern = {};
+    pattern.atten     = ADC_ATTEN_DB_11;
+    pattern.channel   = PH_ADC_CHANNEL;
+    pattern.unit      = 0;   // ADC1
+    pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en  = true;
+    config.conv_limit_num = 250;
+    config.pattern_num    = 1;
+    config.adc_pattern    = &pattern;
+    config.sample_freq_hz = PH_SAMPLE_HZ;
+    config.conv_mode      = ADC_CONV_SINGLE_UNIT_1;
+    config.format         = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+    if (adc_digi_controller_configure(&config) != ESP_OK) return false;
+
+    esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, 1100, &phAdcChars);
+    return adc_digi_start() == ESP_OK;
+}
 
-    dht.begin();
-    lightMeter.begin(BH1750::CONTINUOUS_HIGH_RES_MODE);
-    bmp.begin();
+// eFuse-corrected millivolts for fractional counts, interpolated between the
+// two neighbouring codes.
+float phCountsToMv(float counts) {
+    uint32_t lo   = (uint32_t)counts;
+    float    frac = counts - lo;
+    float    a    = esp_adc_cal_raw_to_voltage(lo,     &phAdcChars);
+    float    b    = esp_adc_cal_raw_to_voltage(lo + 1, &phAdcChars);
+    return a + (b - a) * frac;
+}
 
-    pinMode(ENC_CLK, INPUT_PULLUP);
-    pinMode(ENC_DT,  INPUT_PULLUP);
-    pinMode(ENC_SW,  INPUT_PULLUP);
-    lastCLK = digitalRead(ENC_CLK);
-    attachInterrupt(digitalPinToInterrupt(ENC_CLK), encoderISR, CHANGE);
+// Pinned to core 0 beside the I2C owner. Blocks until the DMA ring holds a
+// frame, so it costs nothing while waiting, then runs the filter chain.
+void phTask(void*) {
+    uint8_t  raw[PH_FRAME_BYTES];
+    uint16_t samples[PH_FRAME_BYTES / sizeof(adc_digi_output_data_t)];
+    uint32_t burstStart = ::millis();
+    for (;;) {
+        if (power.sleepEnabled() && ::millis() - burstStart >= PH_BURST_MS) {
+            adc_digi_stop();
+            vTaskDelay(pdMS_TO_TICKS(PH_BURST_PERIOD_MS - PH_BURST_MS));
+            adc_digi_start();
+            burstStart = ::millis();
+        }
+        uint32_t  got = 0;
+        esp_err_t err = adc_digi_read_bytes(raw, sizeof(raw), &got, ADC_MAX_DELAY);
+        if (err == ESP_ERR_INVALID_STATE) phOverruns.fetch_add(1, std::memory_order_relaxed);
+        else if (err != ESP_OK) continue;
+
+        size_t n = 0;
+        for (uint32_t i = 0; i + sizeof(adc_digi_output_data_t) <= got; i += sizeof(adc_digi_output_data_t)) {
+            const adc_digi_output_data_t* d = (const adc_digi_output_data_t*)&raw[i];
+            if (d->type1.channel == PH_ADC_CHANNEL) samples[n++] = d->type1.data;
+        }
+        phChain.feed(samples, n);
+        if (phChain.ready()) phFilteredMv.store(phCountsToMv(phChain.counts()), std::memory_order_relaxed);
+    }
+}
 
-    pinMode(RELAY_MOTOR, OUTPUT); digitalWrite(RELAY_MOTOR, RELAY_OFF);
-    pinMode(RELAY_LIGHT, OUTPUT); digitalWrite(RELAY_LIGHT, RELAY_OFF);
-    pinMode(RELAY_FAN,   OUTPUT); digitalWrite(RELAY_FAN,   FAN_RELAY_OFF);
+void loadPhCalibration() {
+    PhCalibration cal = PhCalibration::defaults();
+    PhCalibration stored;
+    prefs.begin("ph", true);
+    if (prefs.getBytes("cal", &stored, sizeof(stored)) == sizeof(stored) && stored.valid()) cal = stored;
+    prefs.end();
+    phCalibration.write(cal);
+}
 
-    randomSeed(analogRead(0));
+void savePhCalibration(const PhCalibration& cal) {
+    phCalibration.write(cal);
+    prefs.begin("ph", false);
+    prefs.putBytes("cal", &cal, sizeof(cal));
+    prefs.end();
+}
+
+size_t phStatusJson(char* buf, size_t cap) {
+    const PhCalibration cal = phCalibration.read();
+    float mv = hal::phMillivolts();
+    int len = snprintf(buf, cap, "{\"mv\":%.1f,\"ph\":%.2f,\"overruns\":%u,\"points\":[",
+                       isnan(mv) ? 0.0f : mv, isnan(mv) ? 0.0f : cal.toPh(mv),
+                       (unsigned)phOverruns.load(std::memory_order_relaxed));
+    for (uint8_t i = 0; i < cal.count && len < (int)cap; i++)
+        len += snprintf(buf + len, cap - len, "%s{\"mv\":%.1f,\"ph\":%.2f}", i ? "," : "", cal.mv[i], cal.ph[i]);
+    if (len < (int)cap) len += snprintf(buf + len, cap - len, "]}");
+    return len < (int)cap ? len : cap - 1;
+}
+// "HH:MM" to seconds after midnight.
+bool parseClock(const String& s, uint32_t& sec) {
+    int colon = s.indexOf(':');
+    if (colon < 1) return false;
+    long h = s.substring(0, colon).toInt(), m = s.substring(colon + 1).toInt();
+    if (h < 0 || h > 23 || m < 0 || m > 59) return false;
+    sec = h * 3600 + m * 60;
+    return true;
+}
+
+// The form fields of PUT /config for one schedule entry.
+bool parseScheduleEntry(AsyncWebServerRequest* req, ScheduleEntry& e, const char*& error) {
+    Actuator a;
+    if (!req->hasParam("device", true) || !ActuatorController::fromName(req->getParam("device", true)->value().c_str(), a)) {
+        error = "unknown device";
+        return false;
+    }
+    if (!req->hasParam("start", true) || !req->hasParam("end", true) ||
+        !parseClock(req->getParam("start", true)->value(), e.startSec) ||
+        !parseClock(req->getParam("end", true)->value(), e.endSec)) {
+        error = "start and end must be HH:MM";
+        return false;
+    }
+    long on  = req->hasParam("on", true)  ? req->getParam("on", true)->value().toInt()  : 0;
+    long off = req->hasParam("off", true) ? req->getParam("off", true)->value().toInt() : 0;
+    if (on < 0 || off < 0 || on > 1440 || off > 1440) { error = "on and off are 0-1440 minutes"; return false; }
+    e.actuator = a;
+    e.onSec    = on * 60;
+    e.offSec   = off * 60;
+    return true;
+}
 
+// The form fields of PUT /config for one sensor's alert limits. Fields that
+// are not given keep their current value; an empty low or high, or "none",
+// switches that bound off.
+bool parseLimits(AsyncWebServerRequest* req, ChannelLimits& l, const char*& error) {
+    auto bound = [req](const char* name, float& v) {
+        if (!req->hasParam(name, true)) return;
+        const String& s = req->getParam(name, true)->value();
+        v = s.length() == 0 || s == "none" ? NAN : s.toFloat();
+    };
+    bound("low", l.low);
+    bound("high", l.high);
+    if (req->hasParam("hysteresis", true)) l.hysteresis    = req->getParam("hysteresis", true)->value().toFloat();
+    if (req->hasParam("rate", true))       l.maxRatePerMin = req->getParam("rate", true)->value().toFloat();
+    if (req->hasParam("stuck", true)) {
+        long stuck = req->getParam("stuck", true)->value().toInt();
+        if (stuck < 0 || stuck > 65535) { error = "stuck is 0-65535 seconds"; return false; }
+        l.stuckSec = stuck;
+    }
+    if (l.hysteresis < 0 || l.maxRatePerMin < 0) { error = "hysteresis and rate must not be negative"; return false; }
+    if (!isnan(l.low) && !isnan(l.high) && l.low >= l.high) { error = "low must be below high"; return false; }
+    return true;
+}
+
+// =====================================
+//  STATIC DASHBOARD ASSETS
+// =====================================
+// web/ is minified and gzipped into WebAssets.h by tools/build_web.py.
+// Served straight from flash with Content-Encoding: gzip. A matching
+// If-None-Match gets a bodiless 304, so repeat page loads cost a few bytes.
+void serveAsset(AsyncWebServerRequest* req, const WebAsset& asset) {
+    AsyncWebServerResponse* res;
+    if (req->hasHeader("If-None-Match") && req->header("If-None-Match") == asset.etag) {
+        res = req->beginResponse(304);
+    } else {
+        res = req->beginResponse_P(200, asset.contentType, asset.gzip, asset.gzipLen);
+        res->addHeader("Content-Encoding", "gzip");
+    }
+    res->addHeader("ETag", asset.etag);
+    res->addHeader("Cache-Control", asset.cacheControl);
+    req->send(res);
+}
+// =====================================
+//  WEB SERVER
+// =====================================
+// Nothing here waits for the radio. The server listens from the start and
+// the connection manager joins in the background, so relays, sensors and
+// the menu run from the first millisecond whether or not WiFi ever comes up.
+void startNetwork() {
     // ---------- WiFi ----------
-    WiFi.begin(ssid, password);
-    Serial.print("Connecting to WiFi");
-    while (WiFi.status() != WL_CONNECTED) { delay(500); Serial.print("."); }
-    Serial.println("\nIP: " + WiFi.localIP().toString());
+    WiFi.persistent(false);          // the manager keeps its own cache; no flash write per join
+    WiFi.setAutoReconnect(false);    // and does its own reconnecting
+    WiFi.mode(WIFI_STA);
+    WiFi.setSleep(WIFI_PS_MIN_MODEM);   // radio off between DTIM beacons; needed for light sleep
+    wifiRadio.load();
+    wifiLink.setApFallback(AP_FALLBACK_MS);
+    wifiLink.start();
+    wifiTask = scheduler.addPeriodic("wifi", pollWifi, WIFI_POLL_MS * 1000ULL);
+    flight.setBudget(wifiTask, FlightRecorder::DEFAULT_BUDGET_US, true);
+    sseSocketMutex = xSemaphoreCreateRecursiveMutex();
+#if HYDRO_METRICS
+    metrics.addCounter("hydro_wifi_join_attempts_total", "WiFi station join attempts", wifiAttempts);
+    metrics.addCounter("hydro_wifi_drops_total", "WiFi links lost after joining", wifiDrops);
+#endif
 
     // ---------- Routes ----------
-    server.on("/", HTTP_GET, [](AsyncWebServerRequest* req) {
-        req->send_P(200, "text/html", INDEX_HTML);
-    });
+    for (size_t i = 0; i < WEB_ASSET_COUNT; i++) {
+        const WebAsset& asset = WEB_ASSETS[i];
+        server.on(asset.path, HTTP_GET, [&asset](AsyncWebServerRequest* req) { serveAsset(req, asset); });
+    }
 
     server.on("/relay", HTTP_POST, [](AsyncWebServerRequest* req) {
         if (req->hasParam("device", true) && req->hasParam("state", true)) {
-            String device = req->getParam("device", true)->value();
-            bool   on     = req->getParam("state", true)->value() == "1";
-
-            if      (device == "motor")     { motorAutoMode = false; setMotorRelay(on); }
-            else if (device == "light")     { setLightRelay(on); }
-            else if (device == "fan")       { fanAutoMode = false; setFanRelay(on); }
-            else if (device == "motorAuto") { motorAutoMode = on; }
-            else if (device == "fanAuto")   { fanAutoMode = on; }
+            Actuator  a;
+            CommandOp op;
+            if (!ActuatorController::commandFromName(req->getParam("device", true)->value().c_str(), a, op)) {
+                req->send(400, "text/plain", "unknown device");
+                return;
+            }
+            bool     on  = req->getParam("state", true)->value() == "1";
+            uint32_t seq = actuators.submit(a, op, on, SRC_WEB);
+            if (!seq) { req->send(503, "text/plain", "command queue full"); return; }
+
+            char body[24];
+            snprintf(body, sizeof(body), "{\"seq\":%u}", (unsigned)seq);
+            req->send(202, "application/json", body);
+            return;
         }
-        req->send(200, "text/plain", "OK");
+        req->send(400, "text/plain", "device and state required");
     });
 
-    events.onConnect([](AsyncEventSourceClient* client) {
-        Serial.println("SSE client connected");
+    // GET /relay/ack?seq=N - whether command N (from POST /relay) has been applied.
+    server.on("/relay/ack", HTTP_GET, [](AsyncWebServerRequest* req) {
+        uint32_t seq   = req->hasParam("seq") ? req->getParam("seq")->value().toInt() : 0;
+        uint32_t acked = actuators.ackedSeq();
+        char body[96];
+        snprintf(body, sizeof(body), "{\"seq\":%u,\"acked\":%u,\"done\":%s}",
+                 (unsigned)seq, (unsigned)acked, seq && seq <= acked ? "true" : "false");
+        req->send(200, "application/json", body);
+    });
+
+    // GET /history?sensor=ph&res=1m&from=0&to=86400  (times in seconds since boot)
+    server.on("/history", HTTP_GET, [](AsyncWebServerRequest* req) {
+        SensorHistory::Channel ch;
+        SensorHistory::Tier    tier = SensorHistory::RAW;
+        if (!req->hasParam("sensor") ||
+            !SensorHistory::channelFromName(req->getParam("sensor")->value().c_str(), ch)) {
+            req->send(400, "text/plain", "unknown sensor");
+            return;
+        }
+        if (req->hasParam("res") &&
+            !SensorHistory::tierFromName(req->getParam("res")->value().c_str(), tier)) {
+            req->send(400, "text/plain", "res must be raw, 1m or 1h");
+            return;
+        }
+        uint32_t from = req->hasParam("from") ? req->getParam("from")->value().toInt() : 0;
+        uint32_t to   = req->hasParam("to")   ? req->getParam("to")->value().toInt()   : UINT32_MAX;
+
+        std::shared_ptr<HistoryReader> reader(new HistoryReader(history, ch, tier, from, to));
+        req->send(req->beginChunkedResponse("application/json",
+            [reader](uint8_t* buf, size_t maxLen, size_t) -> size_t {
+                return reader->read((char*)buf, maxLen);
+            }));
+    });
+
+    // GET /export?from=1767225600&to=1769904000  (unix seconds, both optional)
+    // The flash log as CSV, decoded one block at a time while it streams.
+    server.on("/export", HTTP_GET, [](AsyncWebServerRequest* req) {
+        uint32_t from = req->hasParam("from") ? strtoul(req->getParam("from")->value().c_str(), nullptr, 10) : 0;
+        uint32_t to   = req->hasParam("to")   ? strtoul(req->getParam("to")->value().c_str(), nullptr, 10) : UINT32_MAX;
+
+        std::shared_ptr<LogExporter> exporter(new LogExporter(sensorLog, from, to));
+        AsyncWebServerResponse* res = req->beginChunkedResponse("text/csv",
+            [exporter](uint8_t* buf, size_t maxLen, size_t) -> size_t {
+                return exporter->read((char*)buf, maxLen);
+            });
+        res->addHeader("Content-Disposition", "attachment; filename=\"hydro-log.csv\"");
+        req->send(res);
+    });
+
+    // GET /trace - the input trace ring (InputTrace.h) as a binary file for
+    // the simulator's --replay. Blocks are copied out one at a time while the
+    // board keeps recording.
+    server.on("/trace", HTTP_GET, [](AsyncWebServerRequest* req) {
+        std::shared_ptr<InputTraceReader> reader(new InputTraceReader(inputTrace));
+        AsyncWebServerResponse* res = req->beginChunkedResponse("application/octet-stream",
+            [reader](uint8_t* buf, size_t maxLen, size_t) -> size_t {
+                return reader->read(buf, maxLen);
+            });
+        res->addHeader("Content-Disposition", "attachment; filename=\"hydro-trace.bin\"");
+        req->send(res);
+    });
+
+    // GET /config - the persisted auto modes, manual relay states, schedule
+    // and alert limits. A full table is ~2 KB, too much for the async_tcp
+    // stack, so the body goes on the heap for the length of the request.
+    server.on("/config", HTTP_GET, [](AsyncWebServerRequest* req) {
+        const HydroConfig cfg = configStore.snapshot();
+        std::unique_ptr<char[]> body(new char[CONFIG_JSON_MAX]);
+        ConfigStore::toJson(cfg, body.get(), CONFIG_JSON_MAX);
+        req->send(200, "application/json", body.get());
+    });
+
+    // GET /alerts - active alerts, the last few raise/clear events and the
+    // running statistics per sensor.
+    server.on("/alerts", HTTP_GET, [](AsyncWebServerRequest* req) {
+        const SensorAnalytics::State st = analytics.state();
+        std::unique_ptr<char[]> body(new char[ALERTS_JSON_MAX]);
+        SensorAnalytics::stateJson(st, body.get(), ALERTS_JSON_MAX);
+        req->send(200, "application/json", body.get());
+    });
+
+    // PUT /config entry=N device=light start=06:00 end=20:00 on=0 off=0
+    // Sets schedule entry N (N = the current count appends). entry=N remove=1
+    // deletes it, reset=1 restores the default schedule.
+    // PUT /config limit=ph low=5.6 high=6.4 hysteresis=0.05 rate=0.2 stuck=900
+    // sets that sensor's alert limits; fields left out are kept. Applied by the
+    // "config" task within CONFIG_SYNC_MS and saved to flash once edits
+    // settle. Auto modes and relays go through /relay and are saved too.
+    // POST is accepted as well, for forms that cannot PUT.
+    server.on("/config", HTTP_PUT | HTTP_POST, [](AsyncWebServerRequest* req) {
+        ConfigEdit e = {};
+        if (req->hasParam("reset", true)) {
+            e.op = ConfigEdit::RESET_SCHEDULE;
+        } else if (req->hasParam("entry", true)) {
+            long index = req->getParam("entry", true)->value().toInt();
+            if (index < 0 || index >= HydroConfig::MAX_SCHEDULE) { req->send(400, "text/plain", "entry out of range"); return; }
+            e.index = index;
+            const char* error = nullptr;
+            if (req->hasParam("remove", true))                   e.op = ConfigEdit::REMOVE_ENTRY;
+            else if (parseScheduleEntry(req, e.entry, error))    e.op = ConfigEdit::SET_ENTRY;
+            else { req->send(400, "text/plain", error); return; }
+        } else if (req->hasParam("limit", true)) {
+            SensorHistory::Channel ch;
+            if (!SensorHistory::channelFromName(req->getParam("limit", true)->value().c_str(), ch)) {
+                req->send(400, "text/plain", "unknown sensor");
+                return;
+            }
+            e.op       = ConfigEdit::SET_LIMITS;
+            e.index    = ch;
+            e.limits   = configStore.snapshot().limits.ch[ch];
+            const char* error = nullptr;
+            if (!parseLimits(req, e.limits, error)) { req->send(400, "text/plain", error); return; }
+        } else {
+            req->send(400, "text/plain", "entry, limit or reset required");
+            return;
+        }
+        if (!configStore.submit(e)) { req->send(503, "text/plain", "config queue full"); return; }
+        req->send(202, "application/json", "{\"queued\":true}");
+    });
+
+    // GET /ph - filtered probe voltage, pH and the calibration in use.
+    server.on("/ph", HTTP_GET, [](AsyncWebServerRequest* req) {
+        char body[256];
+        phStatusJson(body, sizeof(body));
+        req->send(200, "application/json", body);
+    });
+
+    // POST /ph/calibrate ph=7.00 - with the probe settled in that buffer
+    // solution, records the current voltage as a calibration point.
+    // reset=1 restores the defaults.
+    server.on("/ph/calibrate", HTTP_POST, [](AsyncWebServerRequest* req) {
+        PhCalibration cal = phCalibration.read();
+        if (req->hasParam("reset", true)) {
+            cal = PhCalibration::defaults();
+        } else if (req->hasParam("ph", true)) {
+            float ph = req->getParam("ph", true)->value().toFloat();
+            float mv = phFilteredMv.load(std::memory_order_relaxed);
+            if (isnan(mv))               { req->send(503, "text/plain", "pH signal not settled"); return; }
+            if (ph < 0.0f || ph > 14.0f) { req->send(400, "text/plain", "ph must be 0-14"); return; }
+            cal.addPoint(mv, ph);
+            if (!cal.valid()) { req->send(400, "text/plain", "points too close together"); return; }
+        } else {
+            req->send(400, "text/plain", "ph or reset required");
+            return;
+        }
+        savePhCalibration(cal);
+        char body[256];
+        phStatusJson(body, sizeof(body));
+        req->send(200, "application/json", body);
+    });
+
+    // GET /debug/trace - the reset cause, the last events before it, the
+    // task that was running, and the latest stall snapshots (FlightRecorder.h).
+    server.on("/debug/trace", HTTP_GET, [](AsyncWebServerRequest* req) {
+        const StallTrace stall = flight.stall();
+        std::unique_ptr<char[]> body(new char[TRACE_JSON_MAX]);
+        FlightRecorder::traceJson(flight.previous(), stall, traceTaskName, body.get(), TRACE_JSON_MAX);
+        req->send(200, "application/json", body.get());
+    });
+
+    // GET /power - time the control loop spent running, waiting and allowed
+    // to sleep, what woke it, and whether the display is lit (PowerManager.h).
+    server.on("/power", HTTP_GET, [](AsyncWebServerRequest* req) {
+        char body[512];
+        PowerManager::statsJson(power.stats(), body, sizeof(body));
+        req->send(200, "application/json", body);
+    });
+
+#if HYDRO_METRICS
+    // GET /metrics - hot-path latency histograms, counters and heap gauges
+    // in Prometheus text format.
+    server.on("/metrics", HTTP_GET, [](AsyncWebServerRequest* req) {
+        std::shared_ptr<MetricsReader> reader(new MetricsReader(metrics, hal::cyclesPerUs()));
+        req->send(req->beginChunkedResponse("text/plain; version=0.0.4",
+            [reader](uint8_t* buf, size_t maxLen, size_t) -> size_t {
+                return reader->read((char*)buf, maxLen);
+            }));
+    });
+#endif
+
+    // /ws - binary relay commands with acks (ControlChannel.h). Only whole
+    // single-frame binary messages are passed on; the channel checks the rest.
+    ws.onEvent([](AsyncWebSocket*, AsyncWebSocketClient* client, AwsEventType type, void* arg,
+                  uint8_t* data, size_t len) {
+        if (type == WS_EVT_CONNECT) {
+            ws.cleanupClients(ControlChannel::MAX_CLIENTS);
+            control.connected(client->id());
+        } else if (type == WS_EVT_DISCONNECT) {
+            control.disconnected(client->id());
+        } else if (type == WS_EVT_DATA) {
+            AwsFrameInfo* info = (AwsFrameInfo*)arg;
+            if (!info->final || info->index != 0 || info->len != len || info->opcode != WS_BINARY) return;
+            control.received(client->id(), data, len);
+        } else {
+            return;
+        }
+        power.wake(WAKE_COMMAND);   // the actuator task drains the channel's inbox
+    });
+    server.addHandler(&ws);
+
+    // GET /events/clients - each subscriber's backlog and what it has been
+    // sent, refreshed once a second. The table is ~3 KB, so it and the body
+    // go on the heap for the length of the request. Registered ahead of
+    // /events, which would otherwise take it as a subpath.
+    server.on("/events/clients", HTTP_GET, [](AsyncWebServerRequest* req) {
+        std::unique_ptr<SseBroadcaster::ClientTable> table(new SseBroadcaster::ClientTable(sse.clientTable()));
+        std::unique_ptr<char[]> body(new char[SSE_CLIENTS_JSON_MAX]);
+        SseBroadcaster::clientsJson(*table, sse.stats(), body.get(), SSE_CLIENTS_JSON_MAX);
+        req->send(200, "application/json", body.get());
+    });
+
+    // GET /events - telemetry and alerts as server-sent events, fanned out by
+    // SseBroadcaster. A reconnecting browser whose Last-Event-ID is the
+    // current version is already in sync; everyone else starts with the
+    // latest full snapshot. 503 once MAX_CLIENTS are subscribed.
+    server.on("/events", HTTP_GET, [](AsyncWebServerRequest* req) {
+        if (sse.full()) { req->send(503, "text/plain", "too many subscribers"); return; }
+        req->send(new SseResponse());
     });
-    server.addHandler(&events);
     server.begin();
     Serial.println("Web server started");
+}
 
-    displayWelcome();
+
+// =====================================
+//  SETUP
+// =====================================
+void setup() {
+    Serial.begin(115200);
+    Wire.begin(I2C_SDA, I2C_SCL, I2C_FREQ_HZ);
+    Wire.setTimeOut(I2C_TIMEOUT_MS);
+    hal::displayBegin();
+    i2c.setWake(wakeI2cOwner);
+
+    dht.begin();
+    if (!LittleFS.begin(true) || !(LittleFS.exists("/log") || LittleFS.mkdir("/log")))
+        Serial.println("LittleFS mount failed; sensor log will not persist");
+
+    controlLoopTask = xTaskGetCurrentTaskHandle();   // setup() runs on the loop task
+    power.setWake(wakeControlLoop);
+    startPowerManagement();
+    appSetup();
+    attachEncoder();
+
+    randomSeed(analogRead(0));
+    loadPhCalibration();
+    if (startPhAdc())
+        xTaskCreatePinnedToCore(phTask, "ph", PH_TASK_STACK, nullptr, PH_TASK_PRIORITY, nullptr, SENSOR_TASK_CORE);
+    else
+        Serial.println("pH ADC start failed");
+    xTaskCreatePinnedToCore(sensorTask, "sensors", SENSOR_TASK_STACK, nullptr,
+                            SENSOR_TASK_PRIORITY, &sensorTaskHandle, SENSOR_TASK_CORE);
+
+    startNetwork();
+
+    // loop() is fed to the task watchdog after every pass. A task that holds
+    // it for the watchdog timeout (5 s by default) resets the board, and
+    // /debug/trace then names the task and shows what led up to it.
+    enableLoopWDT();
 }
 
 // =====================================
 //  LOOP
 // =====================================
+// Runs what is due at full clock, then blocks until the next deadline or a
+// wake from the power manager. With both cores blocked, the tickless idle
+// enters light sleep on its own.
 void loop() {
-    handleEncoder();
-    updateSensors();
-    updateDisplay();
-    sendSSEData();
-
-    // Motor auto-cycle
-    if (motorAutoMode) {
-        unsigned long now      = millis();
-        unsigned long interval = motorState ? motorOnTime : motorOffTime;
-        if (now - motorLastToggle >= interval) {
-            motorLastToggle = now;
-            setMotorRelay(!motorState);
-        }
-    }
-}
\ No newline at end of file
+    uint64_t start = esp_timer_get_time();
+    holdFullClock(true);
+    uint64_t idleUs = appLoop();
+    holdFullClock(false);
+    uint64_t ran = esp_timer_get_time();
+    power.ran(ran - start);
+
+    uint64_t waitUs = power.waitFor(idleUs);
+    if (waitUs < 1000) return;
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitUs / 1000));
+    power.waited(waitUs, esp_timer_get_time() - ran);
+}
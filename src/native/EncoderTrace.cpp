@@ -0,0 +1,137 @@
+#include "EncoderTrace.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "RotaryInput.h"
+
+bool EncoderTrace::load(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    char line[128];
+    edges_.clear();
+    while (fgets(line, sizeof(line), f)) {
+        Counts c;
+        if (sscanf(line, "# expect cw=%u ccw=%u clicks=%u long=%u", &c.cw, &c.ccw, &c.clicks, &c.longs) == 4) {
+            expected_    = c;
+            hasExpected_ = true;
+            continue;
+        }
+        unsigned us, clk, dt, sw;
+        if (line[0] == '#' || sscanf(line, "%u %u %u %u", &us, &clk, &dt, &sw) != 4) continue;
+        pins_.clk = clk != 0;
+        pins_.dt  = dt != 0;
+        pins_.sw  = sw != 0;
+        add(us);
+    }
+    fclose(f);
+    return true;
+}
+
+void EncoderTrace::add(uint32_t us) {
+    pins_.us = us;
+    edges_.push_back(pins_);
+}
+
+// =====================================
+//  SYNTHETIC TRACE
+// =====================================
+static uint32_t nextRandom(uint32_t& rng) {
+    rng = rng * 1664525u + 1013904223u;
+    return rng >> 8;
+}
+
+// Moves one pin to level, chattering a few times on the way like a worn
+// contact.
+void EncoderTrace::bounce(uint32_t& us, uint8_t& pin, uint8_t level, uint32_t& rng) {
+    uint32_t chatter = nextRandom(rng) % 4;
+    for (uint32_t i = 0; i < chatter; i++) {
+        pin = level;  add(us); us += 5 + nextRandom(rng) % 25;
+        pin = !level; add(us); us += 5 + nextRandom(rng) % 25;
+    }
+    pin = level;
+    add(us);
+}
+
+void EncoderTrace::synthesize(uint32_t seed) {
+    const uint32_t DETENTS = 50;
+    uint32_t rng = seed * 2654435761u + 1;
+    uint32_t us  = 0;
+
+    edges_.clear();
+    pins_.clk = pins_.dt = pins_.sw = 1;
+    add(us);
+
+    for (int dir = 1; dir >= -1; dir -= 2) {
+        us += 100000;
+        for (uint32_t d = 0; d < DETENTS; d++) {
+            // 10 ms per detent slowing to 1 ms, i.e. up to 1000 detents/s.
+            uint32_t quarter = (10000 - d * 9000 / (DETENTS - 1)) / 4;
+            for (uint8_t q = 0; q < 4; q++) {
+                bool    clkEdge = (q % 2 == 0) == (dir > 0);
+                uint8_t level   = q < 2 ? 0 : 1;
+                bounce(us, clkEdge ? pins_.clk : pins_.dt, level, rng);
+                // Every seventh detent two edges land inside one ISR latency.
+                us += (d % 7 == 3 && q == 1) ? 1 : quarter;
+            }
+        }
+    }
+
+    // A bouncy click, a long press, then a glitch shorter than the debounce.
+    us += 100000;
+    bounce(us, pins_.sw, 0, rng); us += 150000;
+    bounce(us, pins_.sw, 1, rng); us += 300000;
+    bounce(us, pins_.sw, 0, rng); us += 1500000;
+    bounce(us, pins_.sw, 1, rng); us += 300000;
+    pins_.sw = 0; add(us); us += 8000;
+    pins_.sw = 1; add(us); us += 300000;
+    add(us);
+
+    Counts c = { DETENTS, DETENTS, 1, 1 };
+    expected_    = c;
+    hasExpected_ = true;
+}
+
+// =====================================
+//  REPLAY
+// =====================================
+static void tally(RotaryInput& input, EncoderTrace::Counts& c) {
+    InputEvent ev;
+    while (input.next(ev)) {
+        if      (ev.type == EV_STEP)       { if (ev.dir > 0) c.cw++; else c.ccw++; }
+        else if (ev.type == EV_CLICK)      c.clicks++;
+        else if (ev.type == EV_LONG_PRESS) c.longs++;
+    }
+}
+
+EncoderTrace::Result EncoderTrace::replay(uint32_t isrLatencyUs, uint32_t pollMs) const {
+    RotaryInput input;
+    Result      r;
+    memset(&r, 0, sizeof(r));
+    if (edges_.empty()) return r;
+
+    uint8_t  lastAb = 0x3;
+    uint32_t nextPollUs = edges_[0].us;
+    for (size_t i = 0; i < edges_.size(); i++) {
+        const Edge& e = edges_[i];
+
+        // Button samples due before this edge see the previous level.
+        while (nextPollUs < e.us) {
+            input.sampleButton(!edges_[i - 1].sw, nextPollUs / 1000);
+            tally(input, r.got);
+            nextPollUs += pollMs * 1000;
+        }
+
+        uint8_t ab = e.clk << 1 | e.dt;
+        if (ab == lastAb) continue;
+        // The ISR for this edge reads the pins after the next one has landed.
+        if (i + 1 < edges_.size() && edges_[i + 1].us - e.us < isrLatencyUs) continue;
+        input.pinEdge(ab);
+        lastAb = ab;
+    }
+
+    tally(input, r.got);   // whatever the last edges produced
+    r.skipped = input.skipped();
+    r.dropped = input.dropped();
+    return r;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// =====================================
+//  ENCODER TRACE REPLAY
+// =====================================
+// Pin-level traces of the rotary encoder, replayed through RotaryInput the
+// way the board drives it: every CLK/DT change is a pin-change interrupt and
+// the button is sampled on the "encoder" task period. Two edges closer
+// together than the interrupt latency reach the decoder as one, just as the
+// ISR would read them.
+//
+// Text format, one line per pin change, times in microseconds:
+//
+//   # expect cw=50 ccw=50 clicks=1 long=1
+//   0 1 1 1          <us> <clk> <dt> <sw>, levels as read (sw low = pressed)
+//   1200 0 1 1
+//
+// synthesize() builds a hard trace: spins accelerating to 1000 detents/s
+// with contact bounce on every edge and some edges coalesced, plus a
+// bouncy click, a long press and a glitch shorter than the debounce.
+class EncoderTrace {
+public:
+    struct Edge {
+        uint32_t us;
+        uint8_t  clk, dt, sw;
+    };
+
+    struct Counts {
+        uint32_t cw, ccw, clicks, longs;
+    };
+
+    struct Result {
+        Counts   got;
+        uint32_t skipped;   // double transitions the decoder inferred
+        uint32_t dropped;   // events lost to a full queue
+    };
+
+    bool load(const char* path);
+    void synthesize(uint32_t seed);
+
+    Result replay(uint32_t isrLatencyUs, uint32_t pollMs) const;
+
+    bool          hasExpected() const { return hasExpected_; }
+    const Counts& expected() const    { return expected_; }
+    size_t        edges() const       { return edges_.size(); }
+
+private:
+    void add(uint32_t us);
+    void bounce(uint32_t& us, uint8_t& pin, uint8_t level, uint32_t& rng);
+
+    std::vector<Edge> edges_;
+    Edge              pins_ = {};   // levels the next add() records
+    Counts            expected_ = {};
+    bool              hasExpected_ = false;
+};
@@ -0,0 +1,141 @@
+#include "FixedBench.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+#include "PhPipeline.h"
+#include "SensorHistory.h"
+#include "SensorSnapshot.h"
+
+namespace {
+
+// What the drivers and probes hand over each cycle.
+struct Input {
+    int32_t tempDeci;     // BMP180 compensated temperature, 0.1 C
+    int32_t pressurePa;
+    int32_t luxCounts;    // BH1750 raw
+    int8_t  humidityStep; // random walk steps, in the fixed path's counts
+    int8_t  waterStep;
+    float   phMv;
+};
+
+uint32_t xorshift(uint32_t& s) {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+}
+
+// The pre-fixed-point history encoding.
+const float FLOAT_SCALES[SensorHistory::CHANNEL_COUNT] = { 10.0f, 10.0f, 100.0f, 0.5f, 100.0f, 10.0f };
+
+int16_t floatEncode(uint8_t ch, float v) {
+    float s = roundf(v * FLOAT_SCALES[ch]);
+    if (isnan(s))      return 0;
+    if (s > 32767.0f)  return 32767;
+    if (s < -32768.0f) return -32768;
+    return (int16_t)s;
+}
+
+double clampD(double v, double lo, double hi) { return v < lo ? lo : v > hi ? hi : v; }
+
+uint32_t sum(const char* s) {
+    uint32_t h = 0;
+    while (*s) h = h * 31 + (uint8_t)*s++;
+    return h;
+}
+
+}  // namespace
+
+FixedBench::Result FixedBench::run(uint32_t samples, uint32_t seed) {
+    std::vector<Input> in(samples);
+    uint32_t rng = seed ? seed : 1;
+    for (Input& x : in) {
+        x.tempDeci     = 150 + xorshift(rng) % 200;
+        x.pressurePa   = 100800 + xorshift(rng) % 800;
+        x.luxCounts    = xorshift(rng) % 12000;
+        x.humidityStep = (int8_t)(xorshift(rng) % 3) - 1;
+        x.waterStep    = (int8_t)(xorshift(rng) % 11) - 5;
+        x.phMv         = 1150.0f + (xorshift(rng) % 2000) / 10.0f;
+    }
+    const PhCalibration cal = PhCalibration::defaults();
+
+    Result r = {};
+    r.samples = samples;
+    char     buf[16];
+    uint32_t check = 0;
+
+    // ---------- float path ----------
+    auto t0 = std::chrono::steady_clock::now();
+    double humidity = 50.0, water = 20.0;
+    for (const Input& x : in) {
+        float v[SensorHistory::CHANNEL_COUNT];
+        humidity = clampD(humidity + x.humidityStep / 10.0, 49.7, 52.6);
+        water    = clampD(water + x.waterStep / 100.0, 19.7, 21.2);
+        v[SensorHistory::AIR_TEMP]   = x.tempDeci / 10.0f;
+        v[SensorHistory::HUMIDITY]   = humidity;
+        v[SensorHistory::WATER_TEMP] = water;
+        v[SensorHistory::LUX]        = x.luxCounts / 1.2f;
+        v[SensorHistory::PH]         = cal.toPh(x.phMv);
+        v[SensorHistory::PRESSURE]   = x.pressurePa / 100.0f;
+
+        int32_t tel[SensorHistory::CHANNEL_COUNT] = {
+            (int)(v[0] * 10), (int)(v[1] * 10), (int)(v[2] * 100), (int)v[3], (int)(v[4] * 100), (int)(v[5] * 10)
+        };
+        for (uint8_t c = 0; c < SensorHistory::CHANNEL_COUNT; c++) {
+            snprintf(buf, sizeof(buf), "%.*f", SensorHistory::channelDecimals((SensorHistory::Channel)c), (double)v[c]);
+            check += floatEncode(c, v[c]) + tel[c] + sum(buf);
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    // ---------- fixed path ----------
+    DeciPercent  rh = DeciPercent::fromRaw(500);
+    CentiCelsius wt = CentiCelsius::fromRaw(2000);
+    for (const Input& x : in) {
+        SensorSnapshot s;
+        s.bmpTemp     = DeciCelsius::fromRaw(x.tempDeci);
+        s.pressure    = DeciHpa::fromRaw((x.pressurePa + 5) / 10);
+        s.lux         = Lux::fromRaw((x.luxCounts * 5 + 3) / 6);
+        rh            = (rh + DeciPercent::fromRaw(x.humidityStep)).clamp(DeciPercent::fromRaw(497), DeciPercent::fromRaw(526));
+        wt            = (wt + CentiCelsius::fromRaw(x.waterStep)).clamp(CentiCelsius::fromRaw(1970), CentiCelsius::fromRaw(2120));
+        s.dhtHumidity = rh;
+        s.ds18b20Temp = wt;
+        s.phValue     = CentiPh::fromFloat(cal.toPh(x.phMv));
+
+        const int32_t sample[SensorHistory::CHANNEL_COUNT] = {
+            s.bmpTemp.raw, s.dhtHumidity.raw, s.ds18b20Temp.raw, s.lux.raw, s.phValue.raw, s.pressure.raw
+        };
+        s.bmpTemp.format(buf, sizeof(buf));     check += sum(buf);
+        s.dhtHumidity.format(buf, sizeof(buf)); check += sum(buf);
+        s.ds18b20Temp.format(buf, sizeof(buf)); check += sum(buf);
+        s.lux.format(buf, sizeof(buf));         check += sum(buf);
+        s.phValue.format(buf, sizeof(buf));     check += sum(buf);
+        s.pressure.format(buf, sizeof(buf));    check += sum(buf);
+        for (uint8_t c = 0; c < SensorHistory::CHANNEL_COUNT; c++)
+            check += SensorHistory::encode((SensorHistory::Channel)c, sample[c]) + sample[c];
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    // ---------- exactness, untimed ----------
+    // The float path's telemetry casts truncate instead of rounding, so a
+    // reading went out a count low whenever it sat in the lower half of one
+    // (pH 5.849 as 584), or a hair below it (20.15 C as 2014).
+    humidity = 50.0;
+    water    = 20.0;
+    for (const Input& x : in) {
+        humidity = clampD(humidity + x.humidityStep / 10.0, 49.7, 52.6);
+        water    = clampD(water + x.waterStep / 100.0, 19.7, 21.2);
+        const float v[]     = { (float)humidity, (float)water, cal.toPh(x.phMv) };
+        const float scale[] = { 10.0f, 100.0f, 100.0f };
+        for (uint8_t c = 0; c < 3; c++)
+            if ((int)(v[c] * scale[c]) != (int)lroundf(v[c] * scale[c])) { r.truncated++; break; }
+    }
+
+    r.floatNs  = std::chrono::duration<double, std::nano>(t1 - t0).count() / samples;
+    r.fixedNs  = std::chrono::duration<double, std::nano>(t2 - t1).count() / samples;
+    r.checksum = check;
+    return r;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+
+// =====================================
+//  FIXED-POINT VS FLOAT BENCHMARK
+// =====================================
+// Times the per-acquisition sensor path both ways on the host, over the same
+// synthetic driver readings:
+//
+//   float   the old path: float snapshot, double random walks clamped with
+//           double bounds, roundf() into history units, value * scale casts
+//           for telemetry, "%.*f" for the LCD
+//   fixed   the SensorSnapshot path: integer driver conversions, integer
+//           walks, raw counts straight into history and telemetry, integer
+//           LCD formatting
+//
+// It also counts samples where the float path's truncating casts sent the
+// humidity, water temperature or pH one count below the reading.
+//
+// Host numbers only show the relative cost of the extra conversions and
+// formatting; on the ESP32 the float path also pays for software doubles.
+struct FixedBench {
+    struct Result {
+        uint32_t samples;
+        double   floatNs, fixedNs;     // per sample
+        uint32_t truncated;            // float path sent a count low
+        uint32_t checksum;             // keeps the work from being optimised away
+    };
+
+    static Result run(uint32_t samples, uint32_t seed);
+};
@@ -0,0 +1,331 @@
+#include "I2cCheck.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "FakeI2cBus.h"
+#include "I2cEngine.h"
+#include "I2cLcdSink.h"
+#include "LcdFramebuffer.h"
+#include "Pins.h"
+#include "SensorDrivers.h"
+
+namespace {
+
+const uint8_t  MAX_REPORTED = 5;
+const uint32_t SETTLE_US    = 30000;    // past any conversion wait
+const uint32_t STALL_US     = 25000;    // owner task held up past SENSOR_TXN_TIMEOUT_US
+
+// Bosch BMP180 datasheet example: calibration block, UT and UP at oss 0,
+// and what they compensate to.
+const int16_t  BMP_CALIB[11]  = { 408, -72, -14383, (int16_t)32741, (int16_t)32757, (int16_t)23153,
+                                  6190, 4, -32768, -8711, 2868 };
+const uint16_t BMP_UT         = 27898;
+const uint16_t BMP_UP         = 23843;
+const int32_t  BMP_TEMP_DECI  = 150;     // 15.0 C
+const int32_t  BMP_PRESS_DECI = 6996;    // 69964 Pa
+const uint16_t LUX_COUNTS     = 1200;
+const int32_t  LUX_RAW        = 1000;
+
+uint32_t fakeUs = 0;
+uint32_t fakeClock() { return fakeUs; }
+void     advance(uint32_t us) { fakeUs += us; }
+
+FakeI2cBus     bus;
+I2cEngine      engine(bus, fakeClock);
+Bmp180Driver   bmp(engine, 0);
+Bh1750Driver   lux(engine);
+I2cLcdSink     sink(engine, LCD_ADDR);
+LcdFramebuffer frame(sink);
+
+I2cCheck::Result result;
+
+void fail(const char* what, long a = 0, long b = 0) {
+    if (result.failures++ >= MAX_REPORTED) return;
+    printf("i2c check: ");
+    printf(what, a, b);
+    printf("\n");
+}
+
+// ---------- FAKE SLAVES ----------
+void bmpOnWrite(FakeI2cBus::Device& d, const uint8_t* tx, uint8_t len) {
+    if (len < 2 || tx[0] != 0xF4) return;
+    uint32_t raw = tx[1] == 0x2E ? (uint32_t)BMP_UT << 8 : (uint32_t)BMP_UP << 8;
+    d.regs[0xF6] = raw >> 16;
+    d.regs[0xF7] = raw >> 8;
+    d.regs[0xF8] = raw;
+}
+
+void luxOnWrite(FakeI2cBus::Device& d, const uint8_t*, uint8_t) { d.ptr = 0; }
+
+// HD44780 behind a PCF8574: a nibble is latched from each write with EN
+// high, two make a byte; RS tells data from commands. Only DDRAM addressing
+// and data matter here.
+const uint8_t LCD_RS = 0x01, LCD_EN = 0x04;
+const uint8_t ROW_OFFSETS[] = { 0x00, 0x40, 0x14, 0x54 };
+char    ddram[128];
+uint8_t ddramAddr = 0;
+bool    lowNibble = false;
+uint8_t highNibble = 0;
+
+void lcdOnWrite(FakeI2cBus::Device&, const uint8_t* tx, uint8_t len) {
+    for (uint8_t i = 0; i < len; i++) {
+        if (!(tx[i] & LCD_EN)) continue;
+        if (!lowNibble) { highNibble = tx[i] & 0xF0; lowNibble = true; continue; }
+        lowNibble = false;
+        uint8_t value = highNibble | (tx[i] >> 4);
+        if (tx[i] & LCD_RS)  ddram[ddramAddr++ & 0x7F] = (char)value;
+        else if (value & 0x80) ddramAddr = value & 0x7F;
+    }
+}
+
+bool panelMatches() {
+    for (uint8_t r = 0; r < LcdFramebuffer::ROWS; r++)
+        if (memcmp(&ddram[ROW_OFFSETS[r]], frame.row(r), LcdFramebuffer::COLS) != 0) return false;
+    return true;
+}
+
+// ---------- OWNER STEPS ----------
+// The I2C half of sensorStep().
+void step() {
+    uint32_t start = fakeUs;
+    bmp.poll(fakeUs);
+    lux.poll(fakeUs);
+    while (engine.poll()) {}
+    if (fakeUs - start > result.maxStepUs) result.maxStepUs = fakeUs - start;
+}
+
+// One measurement by the drivers asked for; true when every one was valid.
+bool cycle(bool withBmp, bool withLux) {
+    result.cycles++;
+    if (withBmp) bmp.startCycle();
+    if (withLux) lux.startCycle();
+    for (uint16_t i = 0; i < 100; i++) {
+        step();
+        if (bmp.idle() && lux.idle()) return (!withBmp || bmp.valid()) && (!withLux || lux.valid());
+        uint32_t wake = bmp.wakeAtUs();
+        fakeUs = wake && (int32_t)(wake - fakeUs) > 0 ? wake : fakeUs + 100;
+    }
+    fail("driver cycle never finished");
+    return false;
+}
+
+bool bmpReads(const char* when) {
+    if (cycle(true, false) && bmp.temperature().raw == BMP_TEMP_DECI && bmp.pressure().raw == BMP_PRESS_DECI)
+        return true;
+    if (result.failures++ < MAX_REPORTED)
+        printf("i2c check: BMP180 %s: valid %d, %d dC, %d dhPa\n", when, (int)bmp.valid(),
+               (int)bmp.temperature().raw, (int)bmp.pressure().raw);
+    return false;
+}
+
+bool luxReads(const char* when) {
+    if (cycle(false, true) && lux.lux().raw == LUX_RAW) return true;
+    if (result.failures++ < MAX_REPORTED)
+        printf("i2c check: BH1750 %s: valid %d, %d lx\n", when, (int)lux.valid(), (int)lux.lux().raw);
+    return false;
+}
+
+// ---------- CASES ----------
+I2cTransaction probe;
+
+I2cTransaction::Status runProbe(uint8_t addr, uint32_t timeoutUs, uint32_t delayUs) {
+    probe.addr      = addr;
+    probe.txLen     = 1;
+    probe.rxLen     = 2;
+    probe.tx[0]     = 0xAA;
+    probe.timeoutUs = timeoutUs;
+    probe.state.store(I2cTransaction::IDLE);
+    if (!engine.submit(I2cEngine::LANE_SENSOR, &probe)) fail("submit refused on an empty lane");
+    fakeUs += delayUs;
+    while (engine.poll()) {}
+    return probe.status();
+}
+
+void checkStates() {
+    uint32_t transfers = bus.transfers;
+    if (runProbe(Bmp180Driver::ADDRESS, 10000, 0) != I2cTransaction::DONE) fail("good transfer not DONE");
+    bus.failNext(1);
+    if (runProbe(Bmp180Driver::ADDRESS, 10000, 0) != I2cTransaction::FAILED) fail("bus error not FAILED");
+    if (runProbe(0x55, 10000, 0) != I2cTransaction::FAILED) fail("absent slave not FAILED");
+    uint32_t before = bus.transfers;
+    if (runProbe(Bmp180Driver::ADDRESS, 10000, 15000) != I2cTransaction::TIMED_OUT)
+        fail("transfer queued 15 ms with a 10 ms timeout not TIMED_OUT");
+    if (bus.transfers != before) fail("timed-out transfer still went on the wire");
+    if (runProbe(Bmp180Driver::ADDRESS, 0, 15000) != I2cTransaction::DONE) fail("transfer without timeout not DONE");
+    if (bus.transfers - transfers != 4) fail("%ld transfers on the wire, expected 4", (long)(bus.transfers - transfers));
+}
+
+void checkRecovery() {
+    const uint8_t N = I2cEngine::ERRORS_BEFORE_RESET;
+    uint32_t busBefore = bus.recoveries, engineBefore = engine.stats().recoveries;
+
+    // N - 1 failures, a success, N - 1 failures: the count starts over.
+    bus.failNext(N - 1);
+    for (uint8_t i = 0; i < N - 1; i++) runProbe(Bmp180Driver::ADDRESS, 0, 0);
+    runProbe(Bmp180Driver::ADDRESS, 0, 0);
+    bus.failNext(N - 1);
+    for (uint8_t i = 0; i < N - 1; i++) runProbe(Bmp180Driver::ADDRESS, 0, 0);
+    if (bus.recoveries != busBefore) fail("recovered after failures a success had interrupted");
+
+    // A success, then N + 1 failures in a row: one recovery at the Nth.
+    runProbe(Bmp180Driver::ADDRESS, 0, 0);
+    bus.failNext(N + 1);
+    for (uint8_t i = 0; i < N + 1; i++) {
+        runProbe(Bmp180Driver::ADDRESS, 0, 0);
+        uint32_t want = i + 1 >= N ? 1 : 0;
+        if (bus.recoveries - busBefore != want)
+            fail("%ld recoveries after %ld failures in a row", (long)(bus.recoveries - busBefore), i + 1);
+    }
+    if (engine.stats().recoveries - engineBefore != bus.recoveries - busBefore)
+        fail("engine counted %ld recoveries, the bus saw %ld", (long)(engine.stats().recoveries - engineBefore),
+             (long)(bus.recoveries - busBefore));
+    if (runProbe(Bmp180Driver::ADDRESS, 0, 0) != I2cTransaction::DONE) fail("bus not usable after recovery");
+}
+
+void checkDrivers() {
+    // First cycles: calibration and configuration. The BH1750's first cycle
+    // only configures, so it reports nothing.
+    bmpReads("first cycle");
+    if (cycle(false, true)) fail("BH1750 reported a value from its configuring cycle");
+    luxReads("first read");
+
+    // A calibrated BMP180 cycle is four transfers; fail each in turn.
+    for (uint8_t k = 0; k < 4; k++) {
+        bus.failNext(1, k);
+        if (cycle(true, false)) fail("BMP180 cycle valid with transfer %ld failed", k);
+        bmpReads("after a failed transfer");
+    }
+    // Calibration read lost on a fresh driver.
+    Bmp180Driver fresh(engine, 0);
+    bus.failNext(1);
+    fresh.startCycle();
+    for (uint8_t i = 0; i < 10 && !fresh.idle(); i++) { fresh.poll(fakeUs); while (engine.poll()) {} }
+    if (fresh.valid()) fail("BMP180 valid after its calibration read failed");
+
+    // A failed BH1750 read makes it reconfigure: one cycle without a value.
+    bus.failNext(1);
+    if (cycle(false, true)) fail("BH1750 valid with its read failed");
+    if (cycle(false, true)) fail("BH1750 valid in the cycle that reconfigures it");
+    luxReads("after a failed read");
+
+    // The owner stalls past the driver's transaction timeout.
+    bmp.startCycle();
+    bmp.poll(fakeUs);
+    fakeUs += STALL_US;
+    while (engine.poll()) {}
+    for (uint8_t i = 0; i < 10 && !bmp.idle(); i++) step();
+    if (bmp.valid() || !bmp.idle()) fail("BMP180 cycle not abandoned after a timed-out transfer");
+    fakeUs += SETTLE_US;
+    bmpReads("after a timeout");
+
+    // Both together, as every sensor cycle runs them.
+    if (!cycle(true, true)) fail("joint cycle invalid");
+}
+
+void draw(const char* const rows[LcdFramebuffer::ROWS]) {
+    frame.beginFrame();
+    for (uint8_t r = 0; r < LcdFramebuffer::ROWS; r++) {
+        frame.setCursor(0, r);
+        frame.print(rows[r]);
+    }
+}
+
+// As App's flushFrame(): queue the differences, then redraw everything
+// next time if the panel lost any.
+bool flushFrame() {
+    frame.flush();
+    sink.commit();
+    while (engine.poll()) {}
+    if (!sink.takeError()) return false;
+    frame.invalidate();
+    return true;
+}
+
+void checkDisplay() {
+    const char* const first[]  = { "pH 5.85   EC --", "Air 23.4C  61%", "Water 21.2C", "Light 12000 lx" };
+    const char* const second[] = { "pH 5.91   EC --", "Air 23.9C  60%", "Water 21.0C", "Light 11800 lx" };
+    const char* const third[]  = { "Pump   AUTO  ON", "Light  AUTO  ON", "Fan    MANUAL OFF", "Back" };
+
+    frame.invalidate();
+    draw(first);
+    if (flushFrame()) fail("clean LCD frame reported an error");
+    if (!panelMatches()) fail("panel differs from the framebuffer after a clean frame");
+
+    // Lose the first transaction of a partial update.
+    draw(second);
+    bus.failNext(1);
+    if (!flushFrame()) fail("lost LCD transaction not reported");
+    if (panelMatches()) fail("lost LCD transaction left no trace on the panel");
+    draw(second);
+    if (flushFrame()) fail("redraw reported an error");
+    result.redraws++;
+    if (!panelMatches()) fail("panel differs from the framebuffer after the redraw");
+
+    // Lose one in the middle of a full redraw.
+    draw(third);
+    bus.failNext(1, 3);
+    if (!flushFrame()) fail("lost LCD transaction mid-frame not reported");
+    draw(third);
+    if (flushFrame()) fail("second redraw reported an error");
+    result.redraws++;
+    if (!panelMatches()) fail("panel differs from the framebuffer after the second redraw");
+}
+
+// A full redraw queued on the display lane while a sensor cycle runs: the
+// sensor transfers take turns with it and stay inside their timeout.
+void checkLatency() {
+    const char* const rows[] = { "####################", "--------------------", "....................",
+                                 "||||||||||||||||||||" };
+    const char* const inverse[] = { "--------------------", "####################", "||||||||||||||||||||",
+                                    "...................." };
+    draw(rows);
+    frame.invalidate();
+    frame.flush();
+    sink.commit();
+    if (!cycle(true, true)) fail("sensor cycle failed behind a full LCD redraw");
+    draw(inverse);
+    frame.flush();
+    sink.commit();
+    step();
+    if (sink.takeError()) fail("LCD lost output behind a sensor cycle");
+    if (!panelMatches()) fail("panel differs from the framebuffer after the busy frames");
+}
+
+}  // namespace
+
+I2cCheck::Result I2cCheck::run() {
+    result = Result();
+    bus.setByteTime(BYTE_US, advance);
+
+    FakeI2cBus::Device* d = bus.attach(Bmp180Driver::ADDRESS);
+    for (uint8_t i = 0; i < 11; i++) {
+        d->regs[0xAA + 2 * i]     = (uint16_t)BMP_CALIB[i] >> 8;
+        d->regs[0xAA + 2 * i + 1] = (uint16_t)BMP_CALIB[i] & 0xFF;
+    }
+    d->onWrite = bmpOnWrite;
+    d = bus.attach(Bh1750Driver::ADDRESS);
+    d->regs[0]  = LUX_COUNTS >> 8;
+    d->regs[1]  = LUX_COUNTS & 0xFF;
+    d->onWrite  = luxOnWrite;
+    bus.attach(LCD_ADDR)->onWrite = lcdOnWrite;
+    memset(ddram, ' ', sizeof(ddram));
+
+    checkStates();
+    checkRecovery();
+    checkDrivers();
+    checkDisplay();
+    checkLatency();
+
+    const I2cEngine::Stats s = engine.stats();
+    const uint32_t longest = (1 + I2cTransaction::MAX_TX + I2cTransaction::MAX_RX) * BYTE_US;
+    result.transactions  = s.completed + s.failed + s.timedOut;
+    result.failed        = s.failed;
+    result.timedOut      = s.timedOut;
+    result.recoveries    = s.recoveries;
+    result.maxTransferUs = s.maxTransferUs;
+    if (s.maxTransferUs > longest) fail("a transfer took %ld us, longer than %ld us of bytes", s.maxTransferUs, longest);
+    if (result.maxStepUs > STEP_BOUND_US) fail("an owner step took %ld us (bound %ld us)", result.maxStepUs, STEP_BOUND_US);
+    if (s.recoveries != 1) fail("%ld bus recoveries in all, expected exactly 1", s.recoveries);
+    return result;
+}
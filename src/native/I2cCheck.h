@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+
+// =====================================
+//  I2C CHECK
+// =====================================
+// Runs an I2cEngine with the BMP180 and BH1750 drivers and the LCD sink on
+// a FakeI2cBus at 100 kHz wire time, on a fake clock, and injects faults:
+//
+//   states     a good transfer ends DONE, an injected error or an absent
+//              slave FAILED, and one that waits past its timeout TIMED_OUT
+//              without touching the bus
+//   recovery   ERRORS_BEFORE_RESET failures in a row recover the bus
+//              exactly once; a success in between resets the count
+//   drivers    a failure at each transfer of a BMP180 cycle, a failed
+//              BH1750 read and a timed-out conversion each spoil only that
+//              cycle; the next cycles read the datasheet values again
+//   display    a lost LCD transaction shows up in takeError(), and the full
+//              redraw that follows leaves the panel matching the framebuffer
+//   latency    one step of the I2C owner (the drivers' poll() and a drained
+//              engine, as sensorStep() does) with a full LCD redraw queued
+//              stays within STEP_BOUND_US, and no transfer takes longer than
+//              its bytes on the wire
+struct I2cCheck {
+    static const uint32_t BYTE_US       = 90;      // 100 kHz, as the simulator
+    static const uint32_t STEP_BOUND_US = 80000;
+
+    struct Result {
+        uint32_t transactions;
+        uint32_t failed;
+        uint32_t timedOut;
+        uint32_t recoveries;
+        uint32_t cycles;          // driver cycles run
+        uint32_t redraws;         // after a lost LCD transaction
+        uint32_t maxTransferUs;
+        uint32_t maxStepUs;
+        uint32_t failures;
+    };
+
+    // Prints the first few failures.
+    static Result run();
+};
@@ -0,0 +1,108 @@
+#include "LcdBench.h"
+
+#include <string.h>
+
+#include "App.h"
+#include "LcdFramebuffer.h"
+
+namespace {
+
+const uint8_t REFRESHES_PER_READING = 2;   // display every 1 s, sensors every 2 s
+
+// Starting readings in raw counts, and how far one cycle moves them: up to
+// a channel's telemetry deadband plus one count, so some steps fall inside
+// it and some do not.
+const int32_t START[SensorHistory::CHANNEL_COUNT] = { 235, 650, 2150, 12000, 610, 10132 };
+#define BENCH_DEADBAND(id, key, field, type, shift, deadband, ...) deadband,
+const int32_t STEP[SensorHistory::CHANNEL_COUNT] = { HYDRO_SENSORS(BENCH_DEADBAND) };
+#undef BENCH_DEADBAND
+
+uint32_t xorshift(uint32_t& s) {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+}
+
+void toSnapshot(const int32_t v[SensorHistory::CHANNEL_COUNT], SensorSnapshot& s) {
+#define FROM_SAMPLE(id, key, field, type, ...) s.field = type::fromRaw(v[SensorHistory::id]);
+    HYDRO_SENSORS(FROM_SAMPLE)
+#undef FROM_SAMPLE
+}
+
+// What the old updateDisplay() sent for the same frame: the clear command,
+// then each row's text from a setCursor.
+uint32_t clearAndReprintBytes(const LcdFramebuffer& fb) {
+    uint32_t bytes = 1;
+    for (uint8_t r = 0; r < LcdFramebuffer::ROWS; r++) {
+        const char* row = fb.row(r);
+        uint8_t     len = LcdFramebuffer::COLS;
+        while (len && row[len - 1] == ' ') len--;
+        if (len) bytes += 1 + len;
+    }
+    return bytes;
+}
+
+}  // namespace
+
+LcdBench::Result LcdBench::run(uint32_t refreshes, uint32_t seed) {
+    CountingLcdSink sink;
+    LcdFramebuffer  fb(sink);
+    SensorSnapshot  s = {};
+    int32_t         v[SensorHistory::CHANNEL_COUNT];
+    uint32_t        rng = seed ? seed : 1;
+    memcpy(v, START, sizeof(v));
+    toSnapshot(v, s);
+
+    Result r = {};
+    r.refreshes   = refreshes;
+    uint8_t count = menuScreenCount();
+    if (count > MAX_SCREENS) count = MAX_SCREENS;
+
+    for (uint8_t i = 0; i < count; i++) {
+        uint32_t before = 0, enter = 0, later = 0;
+        for (uint32_t k = 0; k <= refreshes; k++) {
+            const char* name = drawMenuScreen(i, s, fb);
+            sink.reset();
+            fb.flush();
+            if (k == 0) enter = sink.lcdBytes();
+            else        later += sink.lcdBytes();
+            before += clearAndReprintBytes(fb);
+
+            if (k % REFRESHES_PER_READING == REFRESHES_PER_READING - 1) {
+                for (uint8_t c = 0; c < SensorHistory::CHANNEL_COUNT; c++)
+                    v[c] += (int32_t)(xorshift(rng) % (2 * STEP[c] + 3)) - (STEP[c] + 1);
+                toSnapshot(v, s);
+            }
+
+            if (k) continue;
+            if (!r.count || strcmp(r.screens[r.count - 1].name, name)) {
+                Screen& n = r.screens[r.count++];
+                n = Screen();
+                n.name = name;
+            }
+            r.screens[r.count - 1].positions++;
+        }
+
+        Screen& sc = r.screens[r.count - 1];
+        sc.beforeBytes  += (double)before / (refreshes + 1);
+        sc.enterBytes   += enter;
+        sc.refreshBytes += refreshes ? (double)later / refreshes : 0;
+    }
+
+    for (uint8_t i = 0; i < r.count; i++) {
+        Screen& sc = r.screens[i];
+        r.beforeBytes  += sc.beforeBytes;
+        r.enterBytes   += sc.enterBytes;
+        r.refreshBytes += sc.refreshBytes;
+        sc.beforeBytes  /= sc.positions;
+        sc.enterBytes   /= sc.positions;
+        sc.refreshBytes /= sc.positions;
+    }
+    if (count) {
+        r.beforeBytes  /= count;
+        r.enterBytes   /= count;
+        r.refreshBytes /= count;
+    }
+    return r;
+}
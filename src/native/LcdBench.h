@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+
+// =====================================
+//  LCD TRAFFIC BENCHMARK
+// =====================================
+// Draws every menu screen with the real menu code (drawMenuScreen()) into a
+// framebuffer on a CountingLcdSink, the way scrolling through the menus
+// shows them, and refreshes each one with readings that drift like the
+// sensors' (a step per sensor cycle, two display refreshes per cycle).
+// Bytes are HD44780 command and data bytes; each costs six PCF8574 writes
+// on the wire.
+//
+//   before  the clear-and-reprint path the framebuffer replaced: lcd.clear(),
+//           then a setCursor and the text up to its last visible cell on
+//           each row. An estimate from the drawn frame and a lower bound:
+//           the old menus also printed some trailing blanks, and clear()
+//           cost a 2 ms busy wait on top.
+//   enter   the framebuffer's first flush after the previous screen
+//   refresh the framebuffer's later flushes on the same screen
+struct LcdBench {
+    static const uint8_t MAX_SCREENS = 32;
+
+    struct Screen {
+        const char* name;
+        uint8_t     positions;      // menu positions sharing the name
+        double      beforeBytes;    // per refresh
+        double      enterBytes;     // per position
+        double      refreshBytes;   // per refresh after the first
+    };
+
+    struct Result {
+        uint32_t refreshes;         // per position, after entering it
+        uint8_t  count;
+        Screen   screens[MAX_SCREENS];
+        double   beforeBytes, enterBytes, refreshBytes;   // over all positions
+    };
+
+    static Result run(uint32_t refreshes, uint32_t seed);
+};
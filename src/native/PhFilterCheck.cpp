@@ -0,0 +1,208 @@
+#include "PhFilterCheck.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#include "PhPipeline.h"
+
+namespace {
+
+const uint8_t  MAX_REPORTED = 5;
+const float    FULL_MV      = 2450.0f;   // 11 dB attenuation, ideal ADC
+const uint16_t FULL_COUNTS  = 4095;
+const float    NOISE_SD     = 25.0f;     // counts; what the ESP32 ADC shows on a quiet pin
+const uint32_t SETTLE_MIN_MS = 1000;     // 1 % of a step takes ln(100) time constants,
+const uint32_t SETTLE_MAX_MS = 2500;     // ~1.85 s with EMA_ALPHA at 125 Hz
+
+PhFilterCheck::Result result;
+uint32_t rng = 0x2545F491;
+
+uint32_t nextRand() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+float uniform() { return (nextRand() >> 8) / 16777216.0f; }
+
+float gaussian() {
+    float u = uniform() + 1e-7f, v = uniform();
+    return sqrtf(-2.0f * logf(u)) * cosf(6.2831853f * v);
+}
+
+uint16_t adc(float counts) {
+    float c = floorf(counts + 0.5f);
+    return c < 0 ? 0 : c > FULL_COUNTS ? FULL_COUNTS : (uint16_t)c;
+}
+
+void fail(const char* fmt, double a, double b = 0) {
+    if (result.failures++ >= MAX_REPORTED) return;
+    printf("ph filter check: ");
+    printf(fmt, a, b);
+    printf("\n");
+}
+
+// One synthetic signal run through a fresh chain frame by frame. observe()
+// sees the output after every frame that produced one.
+template <typename Sample, typename Observe>
+void feed(PhFilterChain& chain, uint32_t ms, Sample sample, Observe observe) {
+    uint16_t frame[PhFilterCheck::FRAME];
+    uint32_t total = ms * (PhFilterCheck::SAMPLE_HZ / 1000);
+    for (uint32_t i = 0; i < total;) {
+        uint16_t n = 0;
+        for (; n < PhFilterCheck::FRAME && i < total; n++, i++) frame[n] = sample(i);
+        uint32_t before = chain.outputs();
+        chain.feed(frame, n);
+        if (chain.outputs() != before) observe(i * 1000.0 / PhFilterCheck::SAMPLE_HZ, chain.counts());
+    }
+}
+
+// ---------- SPIKES ----------
+// Up to two spikes per median window, at random places in it: relay
+// switching and WiFi bursts at their worst.
+void checkSpikes() {
+    const uint16_t LEVEL = 1550;
+    PhFilterChain chain;
+    uint8_t inWindow = 0;
+    feed(chain, 2000, [&](uint32_t i) -> uint16_t {
+        if (i % MedianDecimator::N == 0) inWindow = 0;
+        if (inWindow < 2 && nextRand() % 3 == 0) {
+            inWindow++;
+            result.spikes++;
+            return (nextRand() & 1) ? FULL_COUNTS : 0;
+        }
+        return LEVEL;
+    }, [&](double, float out) {
+        float err = fabsf(out - LEVEL);
+        if (err > result.spikeErr) result.spikeErr = err;
+    });
+    if (!chain.ready())         fail("spikes: no output after %.0f ms", 2000);
+    if (result.spikeErr > 0.01f) fail("spikes: output off by %.2f counts (level %.0f)", result.spikeErr, LEVEL);
+}
+
+// ---------- NOISE ----------
+// The level sits between two codes so the check also shows the chain
+// averaging below one count. The first two seconds are the EMA settling.
+void checkNoise() {
+    const float LEVEL = 1550.4f;
+    PhFilterChain chain;
+    double inSum = 0, inSq = 0, outSum = 0, outSq = 0;
+    uint32_t inN = 0, outN = 0;
+    feed(chain, 10000, [&](uint32_t) {
+        float x = LEVEL + NOISE_SD * gaussian();
+        inSum += x - LEVEL; inSq += (x - LEVEL) * (x - LEVEL); inN++;
+        return adc(x);
+    }, [&](double ms, float out) {
+        if (ms < 2000) return;
+        outSum += out - LEVEL; outSq += (out - LEVEL) * (out - LEVEL); outN++;
+    });
+    double outMean = outN ? outSum / outN : 0;
+    result.noiseInSd  = (float)sqrt(inSq / inN - (inSum / inN) * (inSum / inN));
+    result.noiseOutSd = outN ? (float)sqrt(outSq / outN - outMean * outMean) : 0;
+    result.noiseBias  = (float)outMean;
+    if (!outN)                          fail("noise: no output after %.0f ms", 10000);
+    if (fabsf(result.noiseBias) > 0.5f) fail("noise: output biased by %.2f counts", result.noiseBias);
+    if (result.noiseOutSd > 1.0f)       fail("noise: output spread %.2f counts from %.1f in", result.noiseOutSd,
+                                             result.noiseInSd);
+}
+
+// ---------- STEP ----------
+uint32_t checkStep(float from, float to) {
+    PhFilterChain chain;
+    const uint32_t STEP_MS = 2000;
+    const float    band    = fabsf(to - from) * 0.01f;
+    double settledAt = -1, prev = from;
+    feed(chain, STEP_MS + 4000, [&](uint32_t i) {
+        return adc(i < STEP_MS * (PhFilterCheck::SAMPLE_HZ / 1000) ? from : to);
+    }, [&](double ms, float out) {
+        if (ms <= STEP_MS) return;
+        float past = to > from ? out - to : to - out;
+        if (past > result.overshoot) result.overshoot = past;
+        if ((to > from) ? out < prev - 0.01 : out > prev + 0.01)
+            fail("step: output turned back at %.1f ms (%.2f counts)", ms, out);
+        prev = out;
+        if (settledAt < 0 && fabsf(out - to) <= band) settledAt = ms - STEP_MS;
+    });
+    if (settledAt < 0) { fail("step %.0f -> %.0f: never settled", from, to); return 0; }
+    if (settledAt < SETTLE_MIN_MS || settledAt > SETTLE_MAX_MS)
+        fail("step: settled in %.0f ms, expected about %.0f ms", settledAt, (SETTLE_MIN_MS + SETTLE_MAX_MS) / 2);
+    return (uint32_t)settledAt;
+}
+
+// ---------- CALIBRATION ----------
+void expectNear(float got, float want, const char* what) {
+    result.calCases++;
+    if (fabsf(got - want) > 1e-3f) {
+        if (result.failures++ < MAX_REPORTED)
+            printf("ph filter check: calibration: %s is %.4f, expected %.4f\n", what, got, want);
+    }
+}
+
+void expectTrue(bool ok, const char* what) {
+    result.calCases++;
+    if (!ok && result.failures++ < MAX_REPORTED) printf("ph filter check: calibration: %s\n", what);
+}
+
+void checkCalibration() {
+    PhCalibration c = PhCalibration::defaults();
+    expectTrue(c.valid(), "defaults are not valid");
+    expectNear(c.toPh(1250.0f), 7.0f, "pH at the default 1250 mV point");
+    expectNear(c.toPh(1515.0f), 4.0f, "pH at the default 1515 mV point");
+    expectNear(c.toPh(1382.5f), 5.5f, "pH between the default points");
+
+    c.addPoint(985.0f, 10.0f);
+    expectTrue(c.count == 3 && c.mv[0] == 985.0f && c.mv[2] == 1515.0f, "third point not added in order");
+    expectNear(c.toPh(1117.5f), 8.5f, "pH on the low segment");
+    expectNear(c.toPh(1382.5f), 5.5f, "pH on the high segment");
+    expectNear(c.toPh(900.0f), 10.0f + 85.0f * 3.0f / 265.0f, "pH below the calibrated range");
+    expectNear(c.toPh(1600.0f), 4.0f - 85.0f * 3.0f / 265.0f, "pH above the calibrated range");
+
+    c.addPoint(1245.0f, 7.2f);   // within 0.5 pH of the 7.0 point
+    expectTrue(c.count == 3 && c.mv[1] == 1245.0f && c.ph[1] == 7.2f, "a near point did not replace 7.0");
+    c.addPoint(1080.0f, 9.0f);   // full: replaces the closest, 10.0
+    expectTrue(c.count == 3 && c.mv[0] == 1080.0f && c.ph[0] == 9.0f && c.valid(),
+               "a new point on a full table did not replace the closest");
+    c.addPoint(1600.0f, 3.0f);   // replaces 4.0
+    expectTrue(c.mv[2] == 1600.0f && c.ph[2] == 3.0f, "points not kept sorted by millivolts");
+
+    PhCalibration close = c;
+    close.addPoint(1245.5f, 5.0f);   // replaces 3.0 and lands 0.5 mV from 7.2
+    expectTrue(!close.valid(), "points 0.5 mV apart accepted");
+    PhCalibration bad = c;
+    bad.mv[1] = NAN;
+    expectTrue(!bad.valid(), "NaN point accepted");
+    bad = c;
+    bad.version = PhCalibration::VERSION + 1;
+    expectTrue(!bad.valid(), "other layout version accepted");
+}
+
+// ---------- END TO END ----------
+void checkEndToEnd() {
+    const float PH = 6.0f;
+    PhCalibration cal = PhCalibration::defaults();
+    float mv     = cal.mv[0] + (PH - cal.ph[0]) * (cal.mv[1] - cal.mv[0]) / (cal.ph[1] - cal.ph[0]);
+    float counts = mv * FULL_COUNTS / FULL_MV;
+    PhFilterChain chain;
+    feed(chain, 4000, [&](uint32_t) -> uint16_t {
+        if (nextRand() % 300 == 0) return (nextRand() & 1) ? FULL_COUNTS : 0;
+        return adc(counts + NOISE_SD * gaussian());
+    }, [](double, float) {});
+    result.phErr = fabsf(cal.toPh(chain.counts() * FULL_MV / FULL_COUNTS) - PH);
+    if (result.phErr > 0.02f) fail("end to end: read pH %.3f for %.1f", PH + result.phErr, PH);
+}
+
+}  // namespace
+
+PhFilterCheck::Result PhFilterCheck::run() {
+    result = Result();
+    rng    = 0x2545F491;
+    checkSpikes();
+    checkNoise();
+    result.settleUpMs   = checkStep(1500.0f, 1800.0f);
+    result.settleDownMs = checkStep(1800.0f, 1500.0f);
+    if (result.overshoot > 0.5f) fail("step: overshot by %.2f counts", result.overshoot);
+    checkCalibration();
+    checkEndToEnd();
+    return result;
+}
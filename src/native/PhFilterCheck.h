@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+
+// =====================================
+//  pH FILTER CHECK
+// =====================================
+// Feeds synthetic ADC traces through PhFilterChain at the board's 20 kHz,
+// in DMA-sized frames, and checks what comes out:
+//
+//   spikes     a steady level with rail-to-rail spikes, up to two in every
+//              median window, must come out as exactly that level
+//   noise      a level between two ADC codes plus gaussian noise must come
+//              out unbiased and with far less spread than the input
+//   step       a step up and a step down must settle to within 1 % without
+//              overshoot, in the time the EMA constant implies
+//   end to end a noisy, spiky probe voltage through the chain and the
+//              default calibration must read back the pH it was made from
+//
+// PhCalibration is checked on its own too: the defaults, three-point
+// piecewise-linear conversion and extrapolation, addPoint() replacing and
+// sorting points, and valid() rejecting points too close together.
+struct PhFilterCheck {
+    static const uint32_t SAMPLE_HZ = 20000;
+    static const uint16_t FRAME     = 128;    // samples per DMA frame
+
+    struct Result {
+        uint32_t spikes;
+        float    spikeErr;        // worst output error with spikes, counts
+        float    noiseInSd;       // counts
+        float    noiseOutSd;
+        float    noiseBias;
+        uint32_t settleUpMs;
+        uint32_t settleDownMs;
+        float    overshoot;       // counts past the step
+        float    phErr;
+        uint32_t calCases;
+        uint32_t failures;
+    };
+
+    // Prints the first few failures.
+    static Result run();
+};
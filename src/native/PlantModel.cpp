@@ -0,0 +1,62 @@
+#include "PlantModel.h"
+
+#include <math.h>
+
+static const double DAY_S         = 86400.0;
+static const float  SUN_PEAK_LUX  = 900.0f;    // through the greenhouse roof
+static const float  GROW_LUX      = 6000.0f;
+static const float  LIGHT_HEAT_C  = 3.0f;      // grow light at equilibrium
+static const float  SUN_HEAT_C    = 2.0f;      // at SUN_PEAK_LUX
+static const float  TAU_SEALED_S  = 1800.0f;
+static const float  TAU_VENTED_S  = 300.0f;
+static const float  PH_CEILING    = 6.4f;
+static const float  PH_TAU_S      = 86400.0f;
+
+PlantModel::PlantModel(uint32_t seed) : rng_(seed ? seed : 1) {
+    s_.airTemp     = 21.0f;
+    s_.humidity    = 60.0f;
+    s_.waterTemp   = 20.0f;
+    s_.lux         = 0.0f;
+    s_.ph          = 5.8f;
+    s_.pressureHpa = 1013.0f;
+}
+
+float PlantModel::uniform() {
+    rng_ = rng_ * 1664525u + 1013904223u;
+    return (int32_t)rng_ / 2147483648.0f;
+}
+
+float PlantModel::measure(float value, float noise) {
+    return value + noise * uniform();
+}
+
+// Moves x toward target by the exact first-order response over dt.
+static float relax(float x, float target, float dt, float tau) {
+    return target + (x - target) * expf(-dt / tau);
+}
+
+void PlantModel::step(float dt, double t, const Inputs& in) {
+    double day      = fmod(t, DAY_S) / DAY_S;
+    float  outside  = 22.0f + 4.0f * (float)sin(2 * M_PI * (day - 0.375));   // peak mid-afternoon
+    float  sun      = (float)sin(M_PI * (day - 0.25) * 2);                    // 06:00 to 18:00
+    float  sunLux   = sun > 0 ? sun * SUN_PEAK_LUX : 0.0f;
+    float  tau      = in.fan ? TAU_VENTED_S : TAU_SEALED_S;
+
+    s_.lux = sunLux + (in.light ? GROW_LUX : 0.0f);
+
+    float tempTarget = outside + SUN_HEAT_C * sunLux / SUN_PEAK_LUX + (in.light ? LIGHT_HEAT_C : 0.0f);
+    s_.airTemp = relax(s_.airTemp, tempTarget, dt, tau);
+
+    float rhTarget = in.fan ? 55.0f : 70.0f;
+    if (s_.lux > 100.0f) rhTarget += 8.0f;   // stomata open under light
+    if (in.pump)         rhTarget += 5.0f;
+    if (rhTarget > 95.0f) rhTarget = 95.0f;
+    s_.humidity = relax(s_.humidity, rhTarget, dt, tau * 0.8f);
+
+    s_.waterTemp = relax(s_.waterTemp, s_.airTemp - 1.0f + (in.pump ? 0.3f : 0.0f), dt,
+                         in.pump ? 1200.0f : 3600.0f);
+
+    s_.ph = relax(s_.ph, PH_CEILING, dt, PH_TAU_S) + 0.0005f * uniform();
+
+    s_.pressureHpa = 1013.0f + 3.0f * (float)sin(2 * M_PI * t / (3 * DAY_S));
+}
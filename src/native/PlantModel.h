@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+
+// =====================================
+//  SIMULATED GREENHOUSE
+// =====================================
+// A lumped first-order model of one grow box, stepped by the native
+// simulator. Every state relaxes toward a target set by the outside weather
+// and the actuators, with a time constant that the fan shortens:
+//
+//   air temp    outside daily cycle, plus sun and grow-light heat
+//   humidity    transpiration under light and pump splash, vented by the fan
+//   water temp  follows air temp, faster while the pump circulates
+//   lux         sun through the roof plus the grow light
+//   pH          creeps up as plants take up nutrients
+//   pressure    slow synoptic swing around 1013 hPa
+//
+// Noise comes from a seeded generator, so a run is reproducible.
+class PlantModel {
+public:
+    struct Inputs {
+        bool pump;
+        bool light;
+        bool fan;
+    };
+
+    struct State {
+        float airTemp;       // C
+        float humidity;      // %RH
+        float waterTemp;     // C
+        float lux;
+        float ph;
+        float pressureHpa;
+    };
+
+    explicit PlantModel(uint32_t seed = 1);
+
+    // Advances the model by dtSec; timeSec is seconds since simulated midnight.
+    void step(float dtSec, double timeSec, const Inputs& in);
+
+    const State& state() const { return s_; }
+    // A sensor reading of value with a little measurement noise.
+    float measure(float value, float noise);
+
+private:
+    float uniform();   // -1 .. 1
+
+    State    s_;
+    uint32_t rng_;
+};
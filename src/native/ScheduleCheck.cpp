@@ -0,0 +1,376 @@
+#include "ScheduleCheck.h"
+
+#include <stdio.h>
+
+#include "ActuatorSchedule.h"
+#include "Actuators.h"
+#include "TimerWheel.h"
+
+namespace {
+
+const uint8_t MAX_REPORTED = 5;
+
+ScheduleCheck::Result result;
+
+void fail(const char* what, long a = 0, long b = 0, long c = 0) {
+    if (result.failures++ >= MAX_REPORTED) return;
+    printf("schedule check: ");
+    printf(what, a, b, c);
+    printf("\n");
+}
+
+uint32_t rng = 0x9E3779B9;
+uint32_t nextRand() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+// =====================================
+//  WHEEL
+// =====================================
+const uint8_t  LEVELS    = 6;
+const uint16_t PER_ROUND = 160;   // leaves room in the pool for callbacks' timers
+
+struct Probe {
+    uint32_t at;
+    uint16_t id;
+    uint8_t  level;
+    bool     live, fired, cancelled;
+};
+
+TimerWheel wheel;
+Probe      probes[TimerWheel::MAX_TIMERS * 2];
+uint16_t   probeCount = 0;
+uint32_t   lastFired  = 0;
+uint32_t   firedAt[LEVELS];
+
+uint8_t levelOf(uint32_t at, uint32_t now) {
+    uint32_t diff = at ^ now;
+    return diff ? (31 - __builtin_clz(diff)) / 6 : 0;
+}
+
+void onProbe(void*, uint32_t index);
+
+uint16_t addProbe(uint32_t at) {
+    Probe& p = probes[probeCount];
+    p.at        = at > wheel.now() ? at : wheel.now() + 1;   // as schedule() does
+    p.level     = levelOf(at, wheel.now());
+    p.fired     = false;
+    p.cancelled = false;
+    p.id        = wheel.schedule(at, onProbe, nullptr, probeCount);
+    p.live      = p.id != TimerWheel::NO_TIMER;
+    if (!p.live) fail("schedule() refused a timer with %ld pending", wheel.pending());
+    result.timers++;
+    return probeCount++;
+}
+
+void cancelProbe(uint16_t i) {
+    Probe& p = probes[i];
+    if (!wheel.cancel(p.id)) fail("cancel() of a pending timer failed");
+    p.live      = false;
+    p.cancelled = true;
+    result.cancelled++;
+}
+
+// Every sixteenth firing cancels a random sibling still pending, and every
+// tenth schedules a follow-up, as a schedule edge arms the next one.
+void onProbe(void*, uint32_t index) {
+    Probe& p = probes[index];
+    if (!p.live || p.fired)     fail("timer %ld fired twice or after cancel()", (long)index);
+    if (wheel.now() != p.at)    fail("timer due at %ld fired at %ld", (long)p.at, (long)wheel.now());
+    if (p.at < lastFired)       fail("timer due at %ld fired after one due at %ld", (long)p.at, (long)lastFired);
+    p.fired   = true;
+    p.live    = false;
+    lastFired = p.at;
+    firedAt[p.level]++;
+
+    if (index % 16 == 0) {
+        uint16_t j = nextRand() % probeCount;
+        if (probes[j].live && probes[j].at > p.at) cancelProbe(j);
+    }
+    if (index % 10 == 0 && probeCount < sizeof(probes) / sizeof(probes[0]) && p.at < TimerWheel::NEVER - 5001)
+        addProbe(p.at + 1 + nextRand() % 5000);
+}
+
+uint32_t earliestLive() {
+    uint32_t best = TimerWheel::NEVER;
+    for (uint16_t i = 0; i < probeCount; i++)
+        if (probes[i].live && probes[i].at < best) best = probes[i].at;
+    return best;
+}
+
+// maxLevel bounds how far out deadlines go; jumps moves the clock by random
+// strides instead of deadline to deadline.
+void wheelRound(uint8_t maxLevel, bool jumps) {
+    probeCount = 0;
+    uint32_t now = wheel.now();
+    for (uint16_t i = 0; i < PER_ROUND; i++) {
+        uint8_t  level = i % (maxLevel + 1);
+        uint64_t span  = 1ULL << (6 * (level + 1));
+        uint64_t at    = ((uint64_t)now & ~(span - 1)) + nextRand() % span;
+        if (at <= now) at += span;
+        if (at >= TimerWheel::NEVER) at = TimerWheel::NEVER - 1 - nextRand() % 1000;
+        addProbe((uint32_t)at);
+    }
+    for (uint16_t i = 0; i < probeCount; i++)
+        if (nextRand() % 4 == 0) cancelProbe(i);
+
+    lastFired = now;
+    for (uint32_t guard = 0; wheel.pending() && guard < 100000; guard++) {
+        uint32_t next = wheel.nextDeadline();
+        uint32_t first = earliestLive();
+        if (next == TimerWheel::NEVER || next > first)
+            fail("nextDeadline() %ld is past the earliest pending timer %ld", (long)next, (long)first);
+        if (next <= wheel.now()) { fail("nextDeadline() not in the future"); break; }
+        uint32_t to = next;
+        if (jumps) {
+            uint32_t stride = 1 + nextRand() % (1u << (6 * (nextRand() % (maxLevel + 1)) + 5));
+            to = wheel.now() + stride < wheel.now() ? TimerWheel::NEVER - 1 : wheel.now() + stride;
+            if (to < next) to = next;
+        }
+        wheel.advance(to);
+    }
+    for (uint16_t i = 0; i < probeCount; i++) {
+        const Probe& p = probes[i];
+        if (p.cancelled && p.fired) fail("cancelled timer %ld fired", (long)i);
+        if (!p.cancelled && !p.fired) fail("timer due at %ld never fired", (long)p.at);
+    }
+    if (wheel.pending() || wheel.nextDeadline() != TimerWheel::NEVER) fail("wheel not empty after a round");
+}
+
+void checkWheel() {
+    for (uint8_t r = 0; r < 40; r++) wheelRound(3, r & 1);   // up to 2^24 ticks out
+    wheelRound(5, false);   // out to the end of the 32-bit range
+    wheelRound(5, true);
+    for (uint8_t l = 0; l < LEVELS; l++) {
+        if (firedAt[l]) result.levels++;
+        else            fail("no timer fired from level %ld", l);
+    }
+
+    // A lone timer cancelled, then its id reused.
+    TimerWheel w(100);
+    uint16_t id = w.schedule(5000, onProbe, nullptr, 0);
+    if (!w.cancel(id) || w.cancel(id)) fail("cancel() of a pending timer not exactly once");
+    if (w.pending() || w.nextDeadline() != TimerWheel::NEVER) fail("cancelled timer still pending");
+    if (w.advance(10000) != 0) fail("cancelled timer fired");
+}
+
+// =====================================
+//  DAYS
+// =====================================
+#define HM(h, m) ((h) * 3600UL + (m) * 60UL)
+// App.cpp's DEFAULT_SCHEDULE, whose windows all hold whole cycles, plus a
+// late fan window that cuts its second on phase short.
+const ScheduleEntry TABLE[] = {
+    { ACT_LIGHT, HM(6, 0),  HM(20, 0), 0,          0          },
+    { ACT_MOTOR, HM(6, 0),  HM(20, 0), HM(0, 15),  HM(0, 45)  },
+    { ACT_MOTOR, HM(20, 0), HM(6, 0),  HM(0, 10),  HM(1, 50)  },
+    { ACT_FAN,   HM(10, 0), HM(18, 0), HM(0, 10),  HM(0, 20)  },
+    { ACT_FAN,   HM(22, 0), HM(23, 5), HM(0, 20),  HM(0, 30)  },
+};
+const uint8_t TABLE_SIZE = sizeof(TABLE) / sizeof(TABLE[0]);
+
+// Boot at 05:30 local. A clock correction an hour forward on day 2 at
+// 13:00:30, and one 20 minutes back on day 3 at 20:10:30, which brings the
+// light back on for ten minutes.
+const uint32_t BOOT_TOD = HM(5, 30);
+struct Anchor { uint32_t atSec; int32_t shift; };
+const Anchor ANCHORS[] = {
+    { 86400 + HM(13, 0) + 30 - BOOT_TOD,      3600 },
+    { 2 * 86400 + HM(20, 10) + 30 - BOOT_TOD, -1200 },
+};
+const uint8_t ANCHOR_COUNT = sizeof(ANCHORS) / sizeof(ANCHORS[0]);
+
+const uint16_t MAX_EDGES = 512;
+struct Edge { uint32_t t; uint8_t a; bool on; };
+
+Edge     edges[MAX_EDGES];
+uint16_t edgeCount = 0;
+uint32_t simSec    = 0;
+uint32_t commands[ACT_COUNT][2];   // submitted per actuator, [off, on]
+
+void     recordEdge(Actuator a, bool on) {
+    if (edgeCount < MAX_EDGES) edges[edgeCount++] = { simSec, (uint8_t)a, on };
+}
+uint32_t controllerClock() { return simSec * 1000; }
+void     tap(const ActuatorCommand& c) { if (c.op == OP_SET) commands[c.actuator][c.value ? 1 : 0]++; }
+
+bool wantedAt(Actuator a, uint32_t tod) {
+    for (uint8_t i = 0; i < TABLE_SIZE; i++) {
+        const ScheduleEntry& e = TABLE[i];
+        if (e.actuator != a) continue;
+        uint32_t len  = e.endSec == e.startSec ? 86400 : (e.endSec + 86400 - e.startSec) % 86400;
+        uint32_t into = (tod + 86400 - e.startSec) % 86400;
+        if (into >= len) continue;
+        if (!e.onSec || !e.offSec || into % (e.onSec + e.offSec) < e.onSec) return true;
+    }
+    return false;
+}
+
+// Time of day at uptime t, with the corrections made so far.
+uint32_t todAt(uint32_t t) {
+    int64_t tod = BOOT_TOD + (int64_t)t;
+    for (uint8_t i = 0; i < ANCHOR_COUNT; i++)
+        if (t >= ANCHORS[i].atSec) tod += ANCHORS[i].shift;
+    return (uint32_t)(((tod % 86400) + 86400) % 86400);
+}
+
+void checkDays() {
+    static ActuatorController actuators(recordEdge, controllerClock);
+    static ActuatorSchedule   schedule(actuators);
+    for (uint8_t a = 0; a < ACT_COUNT; a++) actuators.restore((Actuator)a, false, true);
+    actuators.setTap(tap);
+    edgeCount = 0;   // restore() drives the outputs too
+    schedule.replace(TABLE, TABLE_SIZE);
+
+    const uint32_t end = ScheduleCheck::DAYS * 86400;
+    simSec = 0;
+    schedule.start(0, BOOT_TOD);
+    actuators.process();
+    uint8_t  anchor = 0;
+    uint32_t next   = schedule.advance(0);
+    while (simSec < end) {
+        uint32_t to = next < end ? next : end;
+        if (anchor < ANCHOR_COUNT && ANCHORS[anchor].atSec <= to) {
+            simSec = ANCHORS[anchor].atSec;
+            schedule.start(simSec, todAt(simSec));
+            anchor++;
+            next = schedule.advance(simSec);
+        } else {
+            simSec = to;
+            next   = schedule.advance(simSec);
+        }
+        actuators.process();
+        result.wheelStops++;
+        if (next != ActuatorSchedule::NEVER && next <= simSec) { fail("wheel deadline not in the future"); break; }
+    }
+
+    // The same table evaluated every second.
+    uint16_t i = 0;
+    bool     on[ACT_COUNT] = {};
+    for (uint32_t t = 0; t < end; t++) {
+        uint32_t tod = todAt(t);
+        for (uint8_t a = 0; a < ACT_COUNT; a++) {
+            bool want = wantedAt((Actuator)a, tod);
+            if (want == on[a]) continue;
+            on[a] = want;
+            if (i >= edgeCount || edges[i].t != t || edges[i].a != a || edges[i].on != want) {
+                fail("expected %s %s at %ld s", (long)ActuatorController::name((Actuator)a),
+                     (long)(want ? "on" : "off"), (long)t);
+                return;
+            }
+            i++;
+        }
+    }
+    if (i != edgeCount) fail("%ld relay changes, the table gives %ld", edgeCount, i);
+    uint32_t sent = 0;
+    for (uint8_t a = 0; a < ACT_COUNT; a++) sent += commands[a][0] + commands[a][1];
+    if (sent != edgeCount) fail("%ld commands for %ld relay changes", (long)sent, edgeCount);
+    result.relayEdges = edgeCount;
+}
+
+// =====================================
+//  EDITS
+// =====================================
+struct EditRig {
+    ActuatorController actuators;
+    ActuatorSchedule   schedule;
+
+    EditRig() : actuators(recordEdge, controllerClock), schedule(actuators) {
+        for (uint8_t a = 0; a < ACT_COUNT; a++) actuators.restore((Actuator)a, false, true);
+        actuators.setTap(tap);
+    }
+};
+
+const ScheduleEntry ALL_DAY_LIGHT = { ACT_LIGHT, 0, 0, 0, 0 };
+const ScheduleEntry ALL_DAY_FAN   = { ACT_FAN, 0, 0, 0, 0 };
+const ScheduleEntry DAY_MOTOR     = { ACT_MOTOR, HM(6, 0), HM(20, 0), 0, 0 };
+const ScheduleEntry NIGHT_MOTOR   = { ACT_MOTOR, HM(20, 0), HM(6, 0), 0, 0 };
+
+void resetCommands() {
+    for (uint8_t a = 0; a < ACT_COUNT; a++) commands[a][0] = commands[a][1] = 0;
+}
+
+// One case: the off and on commands sent to a since it was last checked,
+// and its relay afterwards.
+void expect(EditRig& r, const char* what, Actuator a, uint32_t offs, uint32_t ons, bool relay) {
+    r.actuators.process();
+    result.editCases++;
+    if (commands[a][0] != offs || commands[a][1] != ons || r.actuators.state(a) != relay) {
+        if (result.failures++ < MAX_REPORTED)
+            printf("schedule check: %s: %s got %u off and %u on commands, relay %s; expected %u, %u, %s\n", what,
+                   ActuatorController::name(a), (unsigned)commands[a][0], (unsigned)commands[a][1],
+                   r.actuators.state(a) ? "on" : "off", (unsigned)offs, (unsigned)ons, relay ? "on" : "off");
+    }
+    commands[a][0] = commands[a][1] = 0;
+}
+
+void checkEdits() {
+    simSec = 0;
+    resetCommands();
+    {
+        static EditRig r;
+        int light = r.schedule.add(ALL_DAY_LIGHT);
+        r.schedule.add(DAY_MOTOR);
+        int night = r.schedule.add(NIGHT_MOTOR);
+        r.schedule.start(0, HM(12, 0));
+        expect(r, "start", ACT_LIGHT, 0, 1, true);
+        resetCommands();
+
+        r.schedule.remove(light);
+        expect(r, "remove() of the last entry while on", ACT_LIGHT, 1, 0, false);
+        r.schedule.remove(night);
+        expect(r, "remove() of another, off entry", ACT_MOTOR, 0, 0, true);
+
+        const ScheduleEntry keep[] = { ALL_DAY_LIGHT, DAY_MOTOR };
+        r.schedule.replace(keep, 2);
+        expect(r, "replace() adding an entry", ACT_LIGHT, 0, 1, true);
+        r.schedule.replace(keep, 2);
+        expect(r, "replace() keeping a lit light", ACT_LIGHT, 0, 0, true);
+        expect(r, "replace() keeping a running pump", ACT_MOTOR, 0, 0, true);
+
+        const ScheduleEntry noLight[] = { DAY_MOTOR };
+        r.schedule.replace(noLight, 1);
+        expect(r, "replace() dropping a lit light", ACT_LIGHT, 1, 0, false);
+
+        r.schedule.add(ALL_DAY_FAN);
+        r.schedule.sync();
+        expect(r, "add() and sync()", ACT_FAN, 0, 1, true);
+        r.schedule.clear();
+        expect(r, "clear() with the fan on", ACT_FAN, 1, 0, false);
+        expect(r, "clear() with the pump on", ACT_MOTOR, 1, 0, false);
+        if (r.schedule.entries() != 0) fail("entries left after clear()");
+    }
+    {
+        // A relay in manual mode belongs to the user: no off on remove(),
+        // and none later when auto comes back on without entries.
+        static EditRig r;
+        int fan = r.schedule.add(ALL_DAY_FAN);
+        r.schedule.start(0, HM(12, 0));
+        r.actuators.process();
+        r.actuators.submit(ACT_FAN, OP_SET, true, SRC_WEB);   // manual, and on
+        r.actuators.process();
+        resetCommands();
+        r.schedule.remove(fan);
+        expect(r, "remove() in manual mode", ACT_FAN, 0, 0, true);
+        r.actuators.submit(ACT_FAN, OP_AUTO, true, SRC_WEB);
+        r.actuators.process();
+        r.schedule.sync();
+        expect(r, "auto back on without entries", ACT_FAN, 0, 0, true);
+    }
+}
+#undef HM
+
+}  // namespace
+
+ScheduleCheck::Result ScheduleCheck::run() {
+    result = Result();
+    rng    = 0x9E3779B9;
+    for (uint8_t l = 0; l < LEVELS; l++) firedAt[l] = 0;
+    checkWheel();
+    checkDays();
+    checkEdits();
+    return result;
+}
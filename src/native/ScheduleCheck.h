@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+
+// =====================================
+//  SCHEDULE CHECK
+// =====================================
+// Exercises the TimerWheel and the ActuatorSchedule built on it, faster
+// than real time:
+//
+//   wheel     rounds of timers on deadlines at every one of the six levels,
+//             some cancelled up front and some by a sibling's callback,
+//             with the clock moved both one deadline at a time and in long
+//             jumps. Every timer fires once, exactly at its tick and in
+//             deadline order, unless cancelled; nextDeadline() never lies
+//             past the earliest pending one.
+//   days      the default schedule table, with a window across midnight,
+//             runs for DAYS days by jumping from edge to edge. Its relay
+//             changes must equal those of a second-by-second evaluation of
+//             the same table, through a clock corrected forward and back
+//             with start().
+//   edits     remove() of an actuator's last entry while on sends one off,
+//             replace() keeps a relay its new table still wants on without
+//             an off/on pair, clear() switches off what was on, and an
+//             actuator in manual mode gets nothing.
+struct ScheduleCheck {
+    static const uint32_t DAYS = 4;
+
+    struct Result {
+        uint32_t timers;
+        uint32_t cancelled;
+        uint32_t levels;          // wheel levels that fired timers
+        uint32_t relayEdges;
+        uint32_t wheelStops;      // advance() calls over DAYS days
+        uint32_t editCases;
+        uint32_t failures;
+    };
+
+    // Prints the first few failures.
+    static Result run();
+};
@@ -0,0 +1,236 @@
+#include "SchedulerCheck.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "App.h"
+#include "Scheduler.h"
+#include "TaskCosts.h"
+
+namespace {
+
+struct TaskDef {
+    const char* name;
+    uint32_t    periodMs;    // 0 = one-shot
+    uint32_t    firstMs;
+    bool        parks;
+    uint32_t    costUs;
+};
+
+// What the platforms register after appSetup(); both poll WiFi this often.
+const TaskDef PLATFORM_TASKS[] = {
+    { "wifi", 100, 0, false, 0 },
+};
+const uint8_t PLATFORM_TASK_COUNT = sizeof(PLATFORM_TASKS) / sizeof(PLATFORM_TASKS[0]);
+
+const uint8_t  MAX_TASKS    = Scheduler::MAX_TASKS;
+const uint32_t TRIGGER_AT_S = 100;
+const uint32_t BUSY_RUNS    = 4;        // most polls a woken task makes before it parks again
+const uint32_t WAKE_GAP_US  = 400000;   // mean time between appLoop() wakes
+const uint8_t  MAX_REPORTED = 5;
+
+TaskDef tasks[MAX_TASKS];
+uint8_t taskCount = 0;
+uint8_t LOG, ALERTS, WS, WELCOME;   // found by name
+
+uint64_t fakeUs = 0;
+uint64_t fakeClock() { return fakeUs; }
+
+uint32_t rng = 1;
+uint32_t nextRand() {
+    rng = rng * 1103515245 + 12345;
+    return rng >> 8;
+}
+
+Scheduler sched(fakeClock);
+uint8_t   ids[MAX_TASKS];
+uint8_t   running     = Scheduler::NO_TASK;
+bool      overran     = false;
+bool      triggered   = false;
+bool      served      = false;   // the triggered run happened
+uint64_t  triggerAt   = 0;
+uint64_t  overrunEnd  = 0;
+uint64_t  busySince   = 0;   // the loop last came out of a wait
+uint64_t  lastDeadline = 0;
+uint64_t  startUs     = 0;
+uint64_t  servedDeadline = 0;
+uint64_t  lastEnd[MAX_TASKS];
+uint64_t  lastLate[MAX_TASKS];
+uint32_t  runsOf[MAX_TASKS];
+// Parking tasks: asleep until woken, or until the deadline they moved to.
+bool      parked[MAX_TASKS];
+bool      woken[MAX_TASKS];      // triggered since; must run before the loop waits
+bool      offCycle[MAX_TASKS];   // this run was woken or moved, not periodic
+uint32_t  busy[MAX_TASKS];       // polls left before parking
+uint64_t  movedTo[MAX_TASKS];
+SchedulerCheck::Result result;
+
+uint8_t defOf(uint8_t id) {
+    for (uint8_t i = 0; i < taskCount; i++)
+        if (ids[i] == id) return i;
+    return 0;
+}
+
+uint8_t defNamed(const char* name) {
+    for (uint8_t i = 0; i < taskCount; i++)
+        if (!strcmp(tasks[i].name, name)) return i;
+    return 0;
+}
+
+void fail(const char* what, uint8_t def, uint64_t atUs) {
+    if (result.failures++ < MAX_REPORTED)
+        printf("scheduler check: %s: %s at %.6f s\n", tasks[def].name, what, atUs / 1e6);
+}
+
+// appSetup()'s tasks and the platform's, each with its cost.
+void buildTasks() {
+    taskCount = 0;
+    for (uint8_t i = 0; i < APP_TASK_COUNT + PLATFORM_TASK_COUNT && taskCount < MAX_TASKS; i++) {
+        TaskDef& t = tasks[taskCount++];
+        if (i < APP_TASK_COUNT) {
+            const AppTask& a = APP_TASKS[i];
+            t = { a.name, a.periodMs, a.firstMs, a.parks, 0 };
+        } else {
+            t = PLATFORM_TASKS[i - APP_TASK_COUNT];
+        }
+        t.costUs = TaskCosts::of(t.name);
+        if (!t.costUs) fail("has no cost", taskCount - 1, 0);
+    }
+    LOG     = defNamed("log");       // overruns once
+    WS      = defNamed("ws");        // triggers ALERTS once
+    ALERTS  = defNamed("alerts");
+    WELCOME = defNamed("welcome");
+}
+
+// A parking task polls for a few periods after it is woken, then sleeps:
+// every other time until triggered, otherwise until a later deadline, as
+// "timers" waits for the next schedule edge.
+void park(uint8_t def) {
+    if (busy[def]) { busy[def]--; return; }
+    parked[def] = true;
+    result.parks++;
+    if (result.parks & 1) {
+        sched.rescheduleAt(ids[def], Scheduler::NEVER);
+        movedTo[def] = Scheduler::NEVER;
+    } else {
+        movedTo[def] = fakeUs + 200000 + nextRand() % 3000000;
+        sched.rescheduleAt(ids[def], movedTo[def]);
+    }
+}
+
+// What appLoop() does with a wake: triggers the task that handles it.
+void wake(uint8_t def) {
+    sched.trigger(ids[def]);
+    woken[def] = true;
+    busy[def]  = nextRand() % BUSY_RUNS;
+    result.triggers++;
+}
+
+void work() {
+    uint8_t def = defOf(running);
+    fakeUs += tasks[def].costUs;
+    if (!overran && def == LOG && fakeUs >= SchedulerCheck::OVERRUN_AT_S * 1000000ULL) {
+        overran    = true;
+        fakeUs    += SchedulerCheck::OVERRUN_US;
+        overrunEnd = fakeUs;
+    }
+    if (!triggered && def == WS && fakeUs >= TRIGGER_AT_S * 1000000ULL) {
+        triggered = true;
+        triggerAt = fakeUs;
+        sched.trigger(ids[ALERTS]);
+    }
+    if (tasks[def].parks) park(def);
+}
+
+void observe(uint8_t id, bool done, uint32_t) {
+    running = id;
+    uint8_t def = defOf(id);
+    if (!done) {
+        startUs        = fakeUs;
+        servedDeadline = sched.deadline(id);
+        if (parked[def] && !woken[def] && (movedTo[def] == Scheduler::NEVER || startUs < movedTo[def]))
+            fail("ran while parked", def, startUs);
+        offCycle[def] = parked[def] || woken[def];
+        if (parked[def] && !woken[def]) result.movedRuns++;
+        parked[def] = false;
+        woken[def]  = false;
+        return;
+    }
+
+    uint64_t deadline = servedDeadline;
+    uint64_t late     = startUs - deadline;
+    uint64_t period   = tasks[def].periodMs * 1000ULL;
+    result.runs++;
+
+    if (startUs < deadline)                { fail("ran before its deadline", def, startUs); late = 0; }
+    if (deadline < lastDeadline)           fail("ran after a later deadline", def, startUs);
+    if (late > startUs - busySince)        fail("was left due while the loop waited", def, startUs);
+    if (deadline > overrunEnd) {
+        if (late > result.lateBoundUs)     fail("started later than one full pass", def, startUs);
+        if (late > result.maxLateUs)       result.maxLateUs = (uint32_t)late;
+    }
+    // A run that missed whole periods must push the next one a period past
+    // its end, unless something woke or moved the task meanwhile.
+    if (runsOf[def] && period && !offCycle[def] && lastLate[def] >= period && deadline < lastEnd[def] + period)
+        fail("caught up on missed periods", def, startUs);
+    if (period && late >= period) result.skippedPeriods += (uint32_t)(late / period);
+    if (triggered && !served && def == ALERTS) {
+        served = true;
+        if (busySince > triggerAt) fail("waited for its period after a trigger", def, startUs);
+    }
+
+    lastDeadline  = deadline;
+    lastEnd[def]  = fakeUs;
+    lastLate[def] = late;
+    runsOf[def]++;
+}
+
+}  // namespace
+
+SchedulerCheck::Result SchedulerCheck::run() {
+    result = Result();
+    buildTasks();
+    result.tasks = taskCount;
+
+    // A full pass with every task due at once, plus the repeats of tasks
+    // whose period is shorter than that pass.
+    uint64_t pass = 0;
+    for (uint8_t i = 0; i < taskCount; i++) pass += tasks[i].costUs;
+    uint64_t bound = 0;
+    for (uint8_t i = 0; i < taskCount; i++)
+        bound += tasks[i].costUs * (1 + (tasks[i].periodMs ? pass / (tasks[i].periodMs * 1000ULL) : 0));
+    result.lateBoundUs = (uint32_t)bound;
+
+    sched.setObserver(observe);
+    for (uint8_t i = 0; i < taskCount; i++) {
+        const TaskDef& t = tasks[i];
+        ids[i] = t.periodMs ? sched.addPeriodic(t.name, work, t.periodMs * 1000ULL, t.firstMs * 1000ULL)
+                            : sched.addOneShot(t.name, work, t.firstMs * 1000ULL);
+        if (ids[i] == Scheduler::NO_TASK) fail("could not be added", i, 0);
+    }
+
+    uint64_t nextWake = WAKE_GAP_US;
+    while (fakeUs < RUN_S * 1000000ULL) {
+        if (fakeUs >= nextWake) {
+            uint8_t def;
+            do def = nextRand() % taskCount; while (!tasks[def].parks);
+            wake(def);
+            nextWake = fakeUs + nextRand() % (2 * WAKE_GAP_US);
+        }
+        uint64_t idle = sched.runDue();
+        if (idle == Scheduler::NEVER) break;
+        if (!idle) continue;   // stopped by the pass budget; nothing waited
+        for (uint8_t i = 0; i < taskCount; i++)
+            if (woken[i]) fail("waited for its period after a wake", i, fakeUs);
+        if (idle > nextWake - fakeUs && nextWake > fakeUs) idle = nextWake - fakeUs;   // woken early
+        fakeUs   += idle;
+        busySince = fakeUs;
+    }
+
+    if (!result.triggers || !result.movedRuns) fail("never woke or moved a parked task", 0, fakeUs);
+    if (!overran)                   fail("never overran", LOG, fakeUs);
+    if (!served)                    fail("never ran after its trigger", ALERTS, fakeUs);
+    if (runsOf[WELCOME] != 1)       fail("one-shot did not run exactly once", WELCOME, fakeUs);
+    if (sched.isActive(ids[WELCOME])) fail("one-shot kept its slot", WELCOME, fakeUs);
+    return result;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+
+// =====================================
+//  SCHEDULER CHECK
+// =====================================
+// Runs a Scheduler on a fake clock with the task set appSetup() registers,
+// taken from APP_TASKS, plus the platforms' WiFi poll, each charged its
+// modelled run time (TaskCosts.h). The loop jumps the clock to the next
+// deadline, as the simulator does, and every run is checked:
+//
+//   order     runs start in deadline order and never before their deadline
+//   lateness  a run starts no later than the time the loop has been busy
+//             since it last waited, and, outside the overrun, within one
+//             full pass of every task (LATE_BOUND)
+//   overrun   one "log" run at OVERRUN_AT_S takes OVERRUN_US longer. Every
+//             task that missed periods meanwhile runs once, and its next
+//             deadline is a whole period after that run ends, with no burst
+//             of catch-up runs.
+//
+//   parking   tasks that park poll for a few periods after a wake, then
+//             sleep until triggered or until a deadline they moved to. The
+//             loop wakes one now and then, as appLoop() does. A parked task
+//             never runs before either, and a woken one runs before the loop
+//             next waits.
+//
+// A trigger from inside a task is checked as well: the triggered task must
+// run in the same pass.
+struct SchedulerCheck {
+    static const uint32_t RUN_S        = 600;
+    static const uint32_t OVERRUN_AT_S = 300;
+    static const uint32_t OVERRUN_US   = 3500000;
+
+    struct Result {
+        uint32_t runs;
+        uint32_t tasks;
+        uint32_t maxLateUs;        // outside the overrun
+        uint32_t lateBoundUs;
+        uint32_t skippedPeriods;   // missed during the overrun, not run
+        uint32_t parks;
+        uint32_t triggers;         // wakes from the loop
+        uint32_t movedRuns;        // runs at a deadline a parked task moved to
+        uint32_t failures;
+    };
+
+    // Prints the first few failures.
+    static Result run();
+};
@@ -0,0 +1,105 @@
+#include "SeqlockStress.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <thread>
+
+#include "Seqlock.h"
+
+namespace {
+
+// Wider than a cache line and a mix of field sizes, like the snapshots the
+// firmware publishes.
+struct Payload {
+    uint32_t seq;
+    float    asFloat;
+    uint64_t wide;
+    uint16_t narrow;
+    uint8_t  tail[6];
+    uint32_t fields[16];
+    uint32_t last;
+};
+
+const uint8_t MAX_REPORTED = 5;
+
+Seqlock<Payload>      lock;
+std::atomic<bool>     writing;
+std::atomic<uint32_t> reported;
+
+Payload make(uint32_t seq) {
+    Payload p = {};
+    p.seq     = seq;
+    p.asFloat = (float)(seq & 0xFFFFFF);   // exact in a float
+    p.wide    = ((uint64_t)seq << 32) | seq;
+    p.narrow  = (uint16_t)seq;
+    for (uint8_t& b : p.tail) b = (uint8_t)seq;
+    for (uint32_t& f : p.fields) f = seq;
+    p.last    = seq;
+    return p;
+}
+
+bool consistent(const Payload& p) {
+    const uint32_t s = p.seq;
+    if (p.asFloat != (float)(s & 0xFFFFFF)) return false;
+    if (p.wide != (((uint64_t)s << 32) | s)) return false;
+    if (p.narrow != (uint16_t)s) return false;
+    for (uint8_t b : p.tail) if (b != (uint8_t)s) return false;
+    for (uint32_t f : p.fields) if (f != s) return false;
+    return p.last == s;
+}
+
+struct ReaderTally {
+    uint64_t reads, retries;
+    uint32_t torn, backwards;
+};
+
+void report(uint8_t reader, const char* what, const Payload& p, uint32_t prev) {
+    if (reported.fetch_add(1) < MAX_REPORTED)
+        printf("seqlock stress: reader %u: %s (seq %u, fields[7] %u, last %u, previous %u)\n",
+               (unsigned)reader, what, (unsigned)p.seq, (unsigned)p.fields[7], (unsigned)p.last,
+               (unsigned)prev);
+}
+
+void reader(uint8_t id, ReaderTally* t) {
+    uint32_t prev = 0;
+    bool useTry = id & 1;
+    while (writing.load(std::memory_order_relaxed)) {
+        Payload p;
+        if (useTry) {
+            if (!lock.tryRead(p)) { t->retries++; continue; }
+        } else {
+            p = lock.read();
+        }
+        useTry = !useTry;
+        t->reads++;
+        if (!consistent(p)) { t->torn++; report(id, "mixed fields", p, prev); continue; }
+        if (p.seq < prev) { t->backwards++; report(id, "went backwards", p, prev); }
+        prev = p.seq;
+    }
+}
+
+}  // namespace
+
+SeqlockStress::Result SeqlockStress::run() {
+    Result r = {};
+    ReaderTally tally[READERS] = {};
+    writing.store(true);
+    reported.store(0);
+
+    std::thread readers[READERS];
+    for (uint8_t i = 0; i < READERS; i++) readers[i] = std::thread(reader, i, &tally[i]);
+
+    for (uint32_t seq = 1; seq <= WRITES; seq++) lock.write(make(seq));
+    writing.store(false);
+    for (std::thread& t : readers) t.join();
+
+    r.writes  = WRITES;
+    r.version = lock.version();
+    for (const ReaderTally& t : tally) {
+        r.reads     += t.reads;
+        r.retries   += t.retries;
+        r.torn      += t.torn;
+        r.backwards += t.backwards;
+    }
+    return r;
+}
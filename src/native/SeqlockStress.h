@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+
+// =====================================
+//  SEQLOCK STRESS
+// =====================================
+// One std::thread writer publishes WRITES values through a Seqlock as fast
+// as it can while READERS threads read it the whole time. Every field of
+// the payload carries the write's sequence number, so a reader that gets a
+// copy mixing two writes sees fields that differ. Each reader also checks
+// that the values it reads never go backwards.
+//
+// Both read paths are hammered: read(), which spins until it gets a clean
+// copy, and tryRead(), which may give up when a write races it.
+struct SeqlockStress {
+    static const uint32_t WRITES  = 2000000;
+    static const uint8_t  READERS = 3;
+
+    struct Result {
+        uint64_t reads;        // clean copies checked
+        uint64_t retries;      // tryRead() calls a write raced
+        uint32_t writes;
+        uint32_t version;      // Seqlock::version() at the end
+        uint32_t torn;         // copies with mixed fields
+        uint32_t backwards;    // copies older than one already read
+    };
+
+    // Prints the first few failures.
+    static Result run();
+};
@@ -0,0 +1,24 @@
+#include "TaskCosts.h"
+
+#include <string.h>
+
+namespace {
+
+struct TaskCost {
+    const char* name;
+    uint32_t    us;
+};
+
+const TaskCost COSTS[] = {
+    { "encoder", 20 },  { "sse", 1500 },     { "sse-pump", 200 }, { "timers", 50 },   { "clock", 30 },
+    { "log", 2000 },    { "actuators", 30 }, { "ws", 50 },        { "config", 20 },   { "alerts", 300 },
+    { "display", 800 }, { "trace", 400 },    { "welcome", 600 },  { "wifi", 50 },
+};
+
+}  // namespace
+
+uint32_t TaskCosts::of(const char* name) {
+    for (const TaskCost& c : COSTS)
+        if (!strcmp(c.name, name)) return c.us;
+    return 0;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+// =====================================
+//  MODELLED TASK COSTS
+// =====================================
+// Virtual time has no cost of its own, so every task would run in 0 us. The
+// simulator and SchedulerCheck charge each run of a control task a fixed
+// time instead, in the range the board's /metrics histograms show. The I2C
+// owner's wire time is not in here: FakeI2cBus charges it per byte.
+struct TaskCosts {
+    // Microseconds for one run of the named task; 0 for a name without a
+    // cost, such as the simulator's own "stall".
+    static uint32_t of(const char* name);
+};
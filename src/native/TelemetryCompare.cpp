@@ -0,0 +1,86 @@
+#include "TelemetryCompare.h"
+
+#include <stdio.h>
+#include <vector>
+
+#include "InputTrace.h"
+#include "SseBroadcast.h"
+#include "Telemetry.h"
+
+namespace {
+
+#define COMPARE_DEADBAND(id, key, field, type, shift, deadband, ...) deadband,
+const int32_t DEADBAND[SensorHistory::CHANNEL_COUNT] = { HYDRO_SENSORS(COMPARE_DEADBAND) };
+#undef COMPARE_DEADBAND
+
+const size_t FRAME_MAX = TelemetryEncoder::MAX_FRAME + 48;
+
+void count(TelemetryCompare::Way& w, const char* event, const char* data, uint32_t id, bool snapshot) {
+    char frame[FRAME_MAX];
+    w.bytes += SseBroadcaster::format(frame, sizeof(frame), event, data, id);
+    w.frames++;
+    if (snapshot) w.snapshots++;
+}
+
+void sendDelta(TelemetryEncoder& enc, TelemetryCompare::Way& w, const TelemetryFrame& f) {
+    char data[TelemetryEncoder::MAX_FRAME];
+    bool snapshot;
+    if (!enc.update(f, data, sizeof(data), snapshot)) return;
+    count(w, snapshot ? "snapshot" : "delta", data, enc.version(), snapshot);
+}
+
+}  // namespace
+
+bool TelemetryCompare::run(const char* path, Result& out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    std::vector<uint8_t> data;
+    uint8_t chunk[4096];
+    size_t  n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) data.insert(data.end(), chunk, chunk + n);
+    fclose(f);
+
+    InputTraceParser parser(data.data(), data.size());
+    if (!parser.valid()) return false;
+
+    TelemetryEncoder delta, deadband;
+    delta.setKeyframeInterval(KEYFRAME_EVERY);
+    deadband.setKeyframeInterval(KEYFRAME_EVERY);
+    for (uint8_t ch = 0; ch < SensorHistory::CHANNEL_COUNT; ch++)
+        deadband.setDeadband((TelemetryField)ch, DEADBAND[ch]);
+
+    out = Result();
+    TelemetryFrame frame = {};
+    uint8_t        relays = 0;
+    bool           any = false;
+    uint32_t       firstMs = 0, lastMs = 0;
+    InputRecord    r;
+    while (parser.next(r)) {
+        if (!any) { relays = parser.block().relays; firstMs = r.ms; any = true; }
+        lastMs = r.ms;
+        if (r.kind == IN_RELAY && r.a < ACT_COUNT) relays = (relays & ~(1u << r.a)) | (r.b ? 1u << r.a : 0);
+        if (r.kind != IN_SAMPLE) continue;
+
+        for (uint8_t ch = 0; ch < SensorHistory::CHANNEL_COUNT; ch++) frame.v[ch] = r.v[ch];
+        for (uint8_t a = 0; a < ACT_COUNT; a++) {
+            frame.v[SensorHistory::CHANNEL_COUNT + a]             = relays >> a & 1;
+            frame.v[SensorHistory::CHANNEL_COUNT + ACT_COUNT + a] = parser.block().autos >> a & 1;
+        }
+        out.cycles++;
+
+        // The old "sensors" event: every field, no protocol or version keys.
+        char full[TelemetryEncoder::MAX_FRAME];
+        size_t len = 0;
+        full[len++] = '{';
+        for (uint8_t t = 0; t < TF_COUNT; t++)
+            len += snprintf(full + len, sizeof(full) - len, "%s\"%s\":%ld", t ? "," : "",
+                            TelemetryEncoder::fieldName((TelemetryField)t), (long)frame.v[t]);
+        snprintf(full + len, sizeof(full) - len, "}");
+        count(out.full, "sensors", full, r.ms, false);
+
+        sendDelta(delta, out.delta, frame);
+        sendDelta(deadband, out.deadband, frame);
+    }
+    out.hours10 = (uint32_t)((lastMs - firstMs) / 360000);
+    return any;
+}
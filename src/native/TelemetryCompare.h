@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+
+// =====================================
+//  TELEMETRY WIRE COMPARISON
+// =====================================
+// Encodes the sensor cycles and relay states of a recorded input trace
+// (GET /trace or the simulator's --record) three ways and counts the bytes
+// of the SSE frames each would put on the wire, framing included:
+//
+//   full      the format the delta stream replaced: every field in every
+//             frame, as event "sensors" with the uptime as its id
+//   delta     protocol 2 with keyframes but no deadbands: only fields that
+//             changed at all
+//   deadband  protocol 2 as the board sends it: keyframes every
+//             KEYFRAME_EVERY frames, deltas left out below the registry's
+//             deadbands, nothing sent when nothing moved past them
+//
+// One frame per recorded sensor cycle, as the "sse" task sends one per
+// cycle. Relay states follow the trace's relay records; auto modes come
+// from each block's header, so a mode switch shows up at the next block.
+struct TelemetryCompare {
+    static const uint16_t KEYFRAME_EVERY = 15;   // App.cpp's SSE_KEYFRAME_EVERY
+
+    struct Way {
+        uint64_t bytes;
+        uint32_t frames;      // sent; the rest were left out
+        uint32_t snapshots;
+    };
+
+    struct Result {
+        uint32_t cycles;
+        uint32_t hours10;     // trace length in tenths of an hour
+        Way      full, delta, deadband;
+    };
+
+    // False if the file cannot be read or is not a trace for this build.
+    static bool run(const char* path, Result& out);
+};
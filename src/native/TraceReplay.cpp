@@ -0,0 +1,210 @@
+#include "TraceReplay.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// =====================================
+//  LOADING
+// =====================================
+bool TraceReplay::load(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    std::vector<uint8_t> data;
+    uint8_t chunk[4096];
+    size_t  n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) data.insert(data.end(), chunk, chunk + n);
+    fclose(f);
+
+    InputTraceParser parser(data.data(), data.size());
+    if (!parser.valid()) return false;
+
+    InputRecord r;
+    uint8_t     state = 0;
+    bool        any   = false;
+    while (parser.next(r)) {
+        if (!any) {
+            first_ = parser.block();
+            shift_ = first_.startMs > LEAD_MS ? first_.startMs - LEAD_MS : 0;
+            state  = first_.relays;
+            any    = true;
+        }
+        r.ms = toReplayMs(r.ms);
+        counts_.records++;
+        switch (r.kind) {
+        case IN_SAMPLE:  samples_.push_back(r); counts_.samples++;  break;
+        case IN_ENCODER: events_.push_back(r);  counts_.encoder++;  break;
+        case IN_COMMAND: events_.push_back(r);  counts_.commands++; break;
+        case IN_CLOCK:   events_.push_back(r);  counts_.clocks++;   break;
+        case IN_RELAY:   addChange(recorded_, state, r.ms, r.a, r.b); break;
+        }
+        endMs_ = r.ms;
+    }
+    counts_.gaps   = parser.gaps();
+    replayedState_ = first_.relays;
+    // The replay's own trace grows during the run; keep it off the heap then.
+    replayed_.reserve(recorded_.size() * 2 + 256);
+    return any;
+}
+
+// =====================================
+//  PLAYBACK
+// =====================================
+bool TraceReplay::sampleAt(uint32_t nowMs, int32_t v[SensorHistory::CHANNEL_COUNT]) {
+    while (nextSample_ < samples_.size() && samples_[nextSample_].ms <= nowMs + SAMPLE_SLACK_MS) {
+        nextSample_++;
+        held_ = true;
+    }
+    if (!held_) return false;
+    memcpy(v, samples_[nextSample_ - 1].v, sizeof(samples_[0].v));
+    return true;
+}
+
+uint32_t TraceReplay::nextEventMs() const {
+    return nextEvent_ < events_.size() ? events_[nextEvent_].ms : UINT32_MAX;
+}
+
+bool TraceReplay::nextEvent(uint32_t nowMs, InputRecord& r) {
+    if (nextEvent_ >= events_.size() || events_[nextEvent_].ms > nowMs) return false;
+    r = events_[nextEvent_++];
+    return true;
+}
+
+// =====================================
+//  RELAY CHANGES
+// =====================================
+// Only real changes count: the boot restore and repeated states record a
+// relay record without switching anything.
+void TraceReplay::addChange(std::vector<Change>& list, uint8_t& state, uint32_t ms, uint8_t a, bool on) {
+    if (a >= ACT_COUNT || ((state >> a & 1) != 0) == on) return;
+    state ^= 1u << a;
+    Change c = { ms, a, on };
+    list.push_back(c);
+}
+
+void TraceReplay::addReplayedBlock(const uint8_t* block) {
+    uint8_t file[InputTrace::FILE_HEADER + InputTrace::BLOCK_SIZE];
+    InputTrace::fileHeader(file);
+    memcpy(file + InputTrace::FILE_HEADER, block, InputTrace::BLOCK_SIZE);
+
+    // The records from before the run started are the restores that set
+    // where the replay starts, not changes. Past the board's last record
+    // there is nothing to compare with.
+    InputTraceParser parser(file, sizeof(file));
+    InputRecord      r;
+    while (parser.next(r)) {
+        bool setup = skip_ && skip_--;
+        if (r.kind != IN_RELAY || r.a >= ACT_COUNT || r.ms > endMs_) continue;
+        if (setup) replayedState_ = (replayedState_ & ~(1u << r.a)) | (r.b ? 1u << r.a : 0);
+        else       addChange(replayed_, replayedState_, r.ms, r.a, r.b);
+    }
+}
+
+TraceReplay::Comparison TraceReplay::compare() const {
+    Comparison c = {};
+    c.recorded = (uint32_t)recorded_.size();
+    c.replayed = (uint32_t)replayed_.size();
+
+    // Walk both in time order; an unpaired change is skipped on its side.
+    size_t i = 0, j = 0;
+    while (i < recorded_.size() || j < replayed_.size()) {
+        const Change* a = i < recorded_.size() ? &recorded_[i] : nullptr;
+        const Change* b = j < replayed_.size() ? &replayed_[j] : nullptr;
+        if (a && b && a->actuator == b->actuator && a->on == b->on &&
+            (a->ms > b->ms ? a->ms - b->ms : b->ms - a->ms) <= MATCH_MS) {
+            c.matched++;
+            i++;
+            j++;
+            continue;
+        }
+        bool takeRecorded = a && (!b || a->ms <= b->ms);
+        if (!c.differs) {
+            c.differs       = true;
+            c.first         = takeRecorded ? *a : *b;
+            c.firstRecorded = takeRecorded;
+        }
+        if (takeRecorded) i++;
+        else              j++;
+    }
+    return c;
+}
+
+uint32_t TraceReplay::digest() const {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < replayed_.size(); i++) {
+        const Change& c = replayed_[i];
+        uint32_t words[2] = { c.ms / 1000, (uint32_t)c.actuator << 1 | c.on };
+        for (uint8_t w = 0; w < 2; w++)
+            for (uint8_t k = 0; k < 4; k++) h = (h ^ (uint8_t)(words[w] >> (8 * k))) * 16777619u;
+    }
+    return h;
+}
+
+// =====================================
+//  BASELINES
+// =====================================
+bool TraceReplay::writeBaseline(const char* path, const Baseline& b) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "# hydro replay baseline; all but ns_per_loop must match exactly\n");
+    fprintf(f, "sse_clients %u\n", (unsigned)b.sseClients);
+    fprintf(f, "records %u\n", (unsigned)b.records);
+    fprintf(f, "loop_passes %llu\n", (unsigned long long)b.loopPasses);
+    fprintf(f, "sse_frames %u\n", (unsigned)b.sseFrames);
+    fprintf(f, "sse_bytes %u\n", (unsigned)b.sseBytes);
+    fprintf(f, "relay_changes %u\n", (unsigned)b.relayChanges);
+    fprintf(f, "relay_digest %08x\n", (unsigned)b.relayDigest);
+    fprintf(f, "ns_per_loop %.1f\n", b.nsPerLoop);
+    return fclose(f) == 0;
+}
+
+bool TraceReplay::checkBaseline(const char* path, const Baseline& b, double tolerancePct) {
+    FILE* f = fopen(path, "r");
+    if (!f) { perror(path); return false; }
+
+    struct Key { const char* name; unsigned long long now; bool hex; bool seen; };
+    Key keys[] = {
+        { "sse_clients",   b.sseClients,   false, false },
+        { "records",       b.records,      false, false },
+        { "loop_passes",   b.loopPasses,   false, false },
+        { "sse_frames",    b.sseFrames,    false, false },
+        { "sse_bytes",     b.sseBytes,     false, false },
+        { "relay_changes", b.relayChanges, false, false },
+        { "relay_digest",  b.relayDigest,  true,  false },
+    };
+    const size_t KEYS = sizeof(keys) / sizeof(keys[0]);
+
+    bool   ok   = true;
+    double base = NAN;
+    char   line[128], name[32], value[32];
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || sscanf(line, "%31s %31s", name, value) != 2) continue;
+        if (!strcmp(name, "ns_per_loop")) { base = strtod(value, nullptr); continue; }
+        for (size_t k = 0; k < KEYS; k++) {
+            if (strcmp(name, keys[k].name)) continue;
+            keys[k].seen = true;
+            unsigned long long want = strtoull(value, nullptr, keys[k].hex ? 16 : 10);
+            if (want == keys[k].now) break;
+            if (keys[k].hex) printf("baseline: %s %08llx, now %08llx\n", name, want, keys[k].now);
+            else             printf("baseline: %s %llu, now %llu\n", name, want, keys[k].now);
+            ok = false;
+        }
+    }
+    fclose(f);
+
+    for (size_t k = 0; k < KEYS; k++) {
+        if (keys[k].seen) continue;
+        printf("baseline: no %s\n", keys[k].name);
+        ok = false;
+    }
+    if (isnan(base)) {
+        printf("baseline: no ns_per_loop\n");
+        ok = false;
+    } else {
+        double limit = base * (1 + tolerancePct / 100);
+        printf("baseline: %.1f ns per loop pass against %.1f (limit %.1f)\n", b.nsPerLoop, base, limit);
+        if (b.nsPerLoop > limit) ok = false;
+    }
+    return ok;
+}
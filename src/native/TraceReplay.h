@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "InputTrace.h"
+
+// =====================================
+//  INPUT TRACE REPLAY
+// =====================================
+// Loads a trace from GET /trace or from the simulator's --record and plays
+// it back through the application core in virtual time. Recorded sensor
+// cycles replace the plant model's readings, encoder events and web
+// commands are fed in when they happened, and the wall clock follows the
+// board's. Replay time starts at the simulated boot; a trace that starts
+// later than LEAD_MS into the board's uptime is shifted so the first block
+// begins LEAD_MS after boot, which gives the WiFi link and the dashboards
+// time to come up.
+//
+// Relay changes are compared both ways: the board's, from the trace, and
+// the replay's, from the simulator's own input trace. Changes line up when
+// they switch the same relay the same way within MATCH_MS of each other.
+//
+// A baseline is a small text file of what a replay must reproduce exactly
+// (loop passes, SSE frames and bytes, relay changes and a digest of them)
+// and the host's time per loop pass, which may only grow by a tolerance.
+class TraceReplay {
+public:
+    static const uint32_t LEAD_MS         = 10000;
+    static const uint32_t SAMPLE_SLACK_MS = 1000;    // half a sensor cycle
+    static const uint32_t MATCH_MS        = 2000;
+
+    struct Change {
+        uint32_t ms;         // replay time
+        uint8_t  actuator;
+        bool     on;
+    };
+
+    struct Counts {
+        uint32_t records, samples, encoder, commands, clocks, gaps;
+    };
+
+    struct Comparison {
+        uint32_t recorded, replayed, matched;
+        bool     differs;
+        Change   first;      // earliest change without a partner
+        bool     firstRecorded;   // ...and which side it was on
+    };
+
+    struct Baseline {
+        uint32_t sseClients;
+        uint32_t records;
+        uint64_t loopPasses;
+        uint32_t sseFrames;
+        uint32_t sseBytes;
+        uint32_t relayChanges;
+        uint32_t relayDigest;
+        double   nsPerLoop;
+    };
+
+    // False if the file cannot be read or is not a trace for this build.
+    bool load(const char* path);
+
+    const InputBlockInfo& first() const    { return first_; }
+    const Counts&         counts() const   { return counts_; }
+    uint32_t              endMs() const    { return endMs_; }   // replay time of the last record
+    uint32_t              toReplayMs(uint32_t boardMs) const { return boardMs - shift_; }
+
+    // Sample and hold: the newest recorded cycle due by nowMs plus half a
+    // cycle; false until the first one.
+    bool     sampleAt(uint32_t nowMs, int32_t v[SensorHistory::CHANNEL_COUNT]);
+    // Encoder, command and clock records, in order, with replay times.
+    uint32_t nextEventMs() const;   // UINT32_MAX when there are no more
+    bool     nextEvent(uint32_t nowMs, InputRecord& r);
+
+    // Fed every block of the replay's own input trace. Its first `records`
+    // records come from setting up the run.
+    void       skipReplayed(uint32_t records) { skip_ = records; }
+    void       addReplayedBlock(const uint8_t* block);
+    Comparison compare() const;
+    // FNV-1a over the replay's relay changes, in whole seconds.
+    uint32_t   digest() const;
+    uint32_t   replayedChanges() const { return (uint32_t)replayed_.size(); }
+
+    static bool writeBaseline(const char* path, const Baseline& b);
+    // Prints every difference; false if anything differs or the host time
+    // per loop pass grew by more than tolerancePct.
+    static bool checkBaseline(const char* path, const Baseline& b, double tolerancePct);
+
+private:
+    static void addChange(std::vector<Change>& list, uint8_t& state, uint32_t ms, uint8_t a, bool on);
+
+    std::vector<InputRecord> samples_;
+    std::vector<InputRecord> events_;
+    std::vector<Change>      recorded_;
+    std::vector<Change>      replayed_;
+    size_t                   nextSample_ = 0;
+    size_t                   nextEvent_  = 0;
+    bool                     held_       = false;
+    InputBlockInfo           first_      = {};
+    Counts                   counts_     = {};
+    uint32_t                 shift_      = 0;
+    uint32_t                 endMs_      = 0;
+    uint8_t                  replayedState_ = 0;
+    uint32_t                 skip_       = 0;
+};
@@ -0,0 +1,1276 @@
+#include <chrono>
+#include <new>
+#include <errno.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "App.h"
+#include "Hal.h"
+#include "Pins.h"
+#include "FakeI2cBus.h"
+#include "SensorDrivers.h"
+#include "PlantModel.h"
+#include "EncoderTrace.h"
+#include "FixedBench.h"
+#include "I2cCheck.h"
+#include "LcdBench.h"
+#include "LcdFramebuffer.h"
+#include "PhFilterCheck.h"
+#include "ScheduleCheck.h"
+#include "SchedulerCheck.h"
+#include "SeqlockStress.h"
+#include "TaskCosts.h"
+#include "TelemetryCompare.h"
+#include "TraceReplay.h"
+#include "ConnectionManager.h"
+
+// =====================================
+//  NATIVE SIMULATOR
+// =====================================
+// Runs the application core on Linux against the greenhouse in
+// PlantModel.h. Time is virtual: the loop jumps straight to the next
+// scheduler or sensor deadline, so a simulated day takes well under a second
+// of wall time. The BMP180, BH1750 and LCD are register fakes on a
+// FakeI2cBus whose wire time advances the virtual clock. Each control task
+// run advances it by a modelled cost (TaskCosts.h), so the summary's max
+// late and max run columns show a loaded loop. Everything runs in one
+// thread: a task that falls due during an I2C step starts late by the rest
+// of that step, which the board hides on core 0.
+//
+// The loop waits as the board's does (PowerManager.h): up to the next
+// deadline but never more than a second, cut short by encoder input, web
+// commands and dashboards coming or going. The WiFi poll slows to once a
+// second while the link is up. Light sleep counts as available, so the
+// summary's power line shows how much of the day the board could sleep.
+//
+//   .pio/build/native/program [--hours H] [--start-hour H] [--seed N]
+//                             [--report-min M] [--quiet] [--metrics]
+//                             [--no-alloc] [--log-dir DIR] [--export FILE]
+//                             [--encoder-trace FILE|synthetic] [--ap-outage A-B]
+//                             [--config FILE] [--bench-fixed N] [--bench-lcd N]
+//                             [--sse-clients N] [--stall-at M] [--trace] [--record FILE]
+//                             [--check NAME[,NAME]|all] [--compare-telemetry FILE]
+//                             [--export-trace FILE] [--replay FILE] [--baseline FILE]
+//                             [--write-baseline FILE] [--tolerance PCT]
+//
+// --no-alloc exits non-zero if anything allocates from the heap once the
+// first simulated minute is over, which is how CI holds the core to fixed
+// buffers.
+//
+// --bench-fixed N times N acquisitions through the float and the fixed-point
+// sensor paths (FixedBench.h) and exits. --bench-lcd N draws every menu
+// screen and refreshes it N times through a CountingLcdSink, prints the
+// LCD bytes per frame with the framebuffer and with the clear-and-reprint
+// path it replaced (LcdBench.h), and exits.
+//
+// --check runs the host checks of core modules named, comma separated, or
+// all of them, prints what each verified and exits non-zero if one fails:
+//   scheduler  dispatch order, lateness, overrun recovery and parked tasks
+//              on a fake clock with appSetup()'s task set (SchedulerCheck.h)
+//   seqlock    a writer thread and reader threads hammering one Seqlock;
+//              no reader may see a torn or stale copy (SeqlockStress.h)
+//   ph         the pH filter chain on spiky, noisy and stepped ADC traces,
+//              and the calibration maths (PhFilterCheck.h)
+//   i2c        the engine, sensor drivers and LCD sink with injected bus
+//              errors, timeouts and a full display lane (I2cCheck.h)
+//   schedule   the timer wheel on all six levels with cancels, several days
+//              of the schedule table against a per-second evaluation, and
+//              remove/replace/clear edits (ScheduleCheck.h)
+//
+// --encoder-trace replays a pin-level encoder trace (EncoderTrace.h)
+// through the input decoder instead of simulating the greenhouse, and fails
+// if the decoded detents and presses differ from the trace's expectation.
+//
+// One simulated dashboard is connected to the control WebSocket while the
+// WiFi link is up. It sends a no-op auto-mode command every WS_CMD_EVERY_US
+// and answers server pings, and the summary reports how long its acks took
+// in virtual time.
+//
+// The link comes from the real ConnectionManager on a fake radio. A join
+// takes SCAN_JOIN_MS, or HINT_JOIN_MS once an access point is cached.
+// --ap-outage A-B takes the access point away from minute A to minute B, so
+// 0-30 boots without WiFi and 120-125 drops an established link. The
+// summary shows the boot timeline and how the manager got back on.
+//
+// --sse-clients N subscribes N simulated dashboards to /events (default 1)
+// while the link is up. Each has a socket buffer its reader empties at a
+// fixed rate: every tenth reads slower than the stream arrives, and every
+// twenty-fifth stops reading for two minutes each hour, long enough for the
+// broadcaster to evict it. Closed clients reconnect after three seconds
+// with their last event id, as EventSource does. Every client checks the
+// delta chain, and the summary reports what they received and what the
+// broadcaster coalesced, dropped and evicted.
+//
+// --stall-at M adds a task that holds the loop for STALL_DEMO_MS at minute
+// M, so the flight recorder has a stall to freeze. --trace ends the run
+// the way a software reset would and prints what /debug/trace then serves.
+// Trace times come from the host's clock, not the simulated one.
+//
+// The sensor log goes to segment files in --log-dir, emptied at start. The
+// wall clock starts at 2026-01-01 plus --start-hour (UTC). --export writes
+// the whole log as CSV at the end, as /export would serve it.
+//
+// The persistent config lives in RAM unless --config names a file, which is
+// kept between runs so a second run starts from what the first one saved.
+//
+// --record FILE writes the run's whole input trace (InputTrace.h) in the
+// format GET /trace serves; --export-trace FILE writes what /trace would
+// serve at the end, the last hour or so. --replay FILE plays such a trace back instead of the
+// plant model (TraceReplay.h): recorded sensor cycles, encoder events, web
+// commands and wall clock, from the board's relay states and auto modes. It
+// runs until the last record, leaves out the WebSocket dashboard's periodic
+// command, and reports how the replay's relay changes line up with the
+// board's. The replay uses this run's config, not the board's. With
+// --write-baseline it saves what the run produced; with --baseline it
+// fails if the loop passes, SSE frames and bytes or relay changes differ,
+// or if the host time per loop pass grew by more than --tolerance percent
+// (default 25). --compare-telemetry FILE encodes such a trace's sensor
+// cycles as full-snapshot frames, as deltas and as deltas with deadbands,
+// prints the SSE bytes of each (TelemetryCompare.h) and exits.
+
+// ---------- SETTINGS ----------
+const uint64_t PLANT_STEP_US  = 1000000;   // model integration step
+const uint32_t I2C_BYTE_US    = 90;        // 100 kHz
+const uint64_t WARMUP_US      = 60000000;  // allocations after this are steady-state
+const uint64_t WS_CMD_EVERY_US = 60000000;
+const uint32_t WS_CLIENT      = 1;
+const uint32_t ISR_LATENCY_US  = 3;    // edges closer than this reach the decoder as one
+const uint32_t SIM_EPOCH      = 1767225600;   // 2026-01-01T00:00:00Z
+const uint32_t HINT_JOIN_MS   = 300;
+const uint32_t SCAN_JOIN_MS   = 2500;
+const uint32_t AP_FALLBACK_MS = 120000;   // as on the board
+const uint32_t WIFI_POLL_MS   = 100;
+const uint32_t WIFI_LINKED_POLL_MS = 1000;   // as on the board
+const uint8_t  SSE_SIM_MAX    = 80;       // more than the broadcaster admits
+const uint32_t SSE_SOCK_BUF   = 2048;     // unread bytes a socket holds
+const uint32_t SSE_FAST_BPS   = 100000;
+const uint32_t SSE_SLOW_BPS   = 40;       // below the stream's average rate
+const uint64_t SSE_STALL_US   = 120000000; // a stalling client's pause, once an hour
+const uint64_t SSE_RETRY_US   = 3000000;  // EventSource's default retry
+const uint32_t STALL_DEMO_MS  = 3000;
+const size_t   TRACE_JSON_MAX = 12288;
+
+double   simHours    = 24.0;
+double   startHour   = 6.0;
+uint32_t seed        = 1;
+uint32_t reportMin   = 60;
+bool     quiet       = false;
+bool     dumpMetrics = false;
+bool     noAlloc     = false;
+const char* logDir   = "/tmp/hydro-sim-log";
+const char* exportTo = nullptr;
+const char* encoderTrace = nullptr;
+uint32_t    benchSamples = 0;
+uint32_t    lcdRefreshes = 0;
+const char* checks       = nullptr;
+const char* compareTrace = nullptr;
+const char* configFile   = nullptr;
+uint32_t apDownFromMin = 0;
+uint32_t apDownToMin   = 0;
+uint32_t sseClientCount = 1;
+uint32_t stallAtMin     = 0;
+bool     dumpTrace      = false;
+const char* recordTo      = nullptr;
+const char* exportTrace   = nullptr;
+const char* replayFrom    = nullptr;
+const char* baselineIn    = nullptr;
+const char* baselineOut   = nullptr;
+double      tolerancePct  = 25.0;
+
+// ---------- VIRTUAL CLOCK ----------
+uint64_t simUs       = 0;
+uint64_t nextPlantUs = 0;
+
+// ---------- SIMULATED HARDWARE ----------
+PlantModel plant;
+FakeI2cBus bus;
+bool       pins[40];
+
+FakeI2cBus::Device* bmpDev = nullptr;
+FakeI2cBus::Device* luxDev = nullptr;
+
+// ---------- COUNTERS ----------
+uint64_t loopPasses   = 0;
+uint64_t sensorStepMaxUs = 0;   // wire time of the longest sensorStep()
+uint32_t allocs       = 0;
+uint32_t steadyAllocs = 0;
+uint32_t onSeconds[3];   // pump, light, fan
+uint32_t wsAcks       = 0;
+uint32_t wsPongs      = 0;
+uint32_t wsStates     = 0;
+uint64_t wsAckMaxUs   = 0;
+uint64_t wsAckSumUs   = 0;
+uint64_t wsSentUs     = 0;
+uint16_t wsCmdId      = 0;
+uint32_t apOpened     = 0;
+
+// =====================================
+//  HEAP ACCOUNTING
+// =====================================
+// Every C++ allocation in the process goes through here.
+void* operator new(size_t size) {
+    allocs++;
+    if (simUs >= WARMUP_US) steadyAllocs++;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t size)          { return operator new(size); }
+void  operator delete(void* p) noexcept    { free(p); }
+void  operator delete[](void* p) noexcept  { free(p); }
+void  operator delete(void* p, size_t) noexcept   { free(p); }
+void  operator delete[](void* p, size_t) noexcept { free(p); }
+
+double simSeconds() { return startHour * 3600.0 + simUs / 1e6; }
+
+// ---------- REPLAY ----------
+TraceReplay replay;
+bool        replaying    = false;
+bool        replayWall   = false;   // the board's wall clock was set
+int64_t     replayUnixMs = 0;       // its unix time at simUs 0
+int32_t     replayOffset = 0;       // local minus UTC, seconds
+FILE*       recordFile   = nullptr;
+
+void replaySetWall(uint32_t unixSec, int16_t offsetMin, uint32_t atMs) {
+    replayWall   = true;
+    replayUnixMs = (int64_t)unixSec * 1000 - atMs;
+    replayOffset = offsetMin * 60;
+}
+
+void advanceClock(uint32_t us) { simUs += us; }
+
+// Every task run costs its modelled time on the virtual clock, so the
+// summary's run times and lateness are those of a loaded loop. The app's
+// own observer (the flight recorder) still sees every run.
+Scheduler::ObserverFn appObserver = nullptr;
+
+void chargeTask(uint8_t id, bool done, uint32_t runUs) {
+    if (appObserver) appObserver(id, done, runUs);
+    if (!done) advanceClock(TaskCosts::of(scheduler.taskName(id)));
+}
+
+// =====================================
+//  LOG STORAGE
+// =====================================
+// Segment files in logDir, opened per call like LittleFS on the board.
+class FileStorage : public LogStorage {
+public:
+    uint32_t size(uint8_t segment) override {
+        FILE* f = open(segment, "rb");
+        if (!f) return 0;
+        fseek(f, 0, SEEK_END);
+        long len = ftell(f);
+        fclose(f);
+        return len < 0 ? 0 : (uint32_t)len;
+    }
+
+    bool read(uint8_t segment, uint32_t offset, uint8_t* buf, size_t len) override {
+        FILE* f = open(segment, "rb");
+        if (!f) return false;
+        bool ok = fseek(f, offset, SEEK_SET) == 0 && fread(buf, 1, len, f) == len;
+        fclose(f);
+        return ok;
+    }
+
+    bool write(uint8_t segment, uint32_t offset, const uint8_t* buf, size_t len) override {
+        FILE* f = open(segment, "r+b");
+        if (!f) f = open(segment, "w+b");
+        if (!f) return false;
+        bool ok = fseek(f, offset, SEEK_SET) == 0 && fwrite(buf, 1, len, f) == len;
+        return fclose(f) == 0 && ok;
+    }
+
+    bool erase(uint8_t segment) override {
+        char path[256];
+        segmentPath(segment, path, sizeof(path));
+        return remove(path) == 0 || errno == ENOENT;
+    }
+
+private:
+    static void segmentPath(uint8_t segment, char* path, size_t len) {
+        snprintf(path, len, "%s/seg%02u.bin", logDir, segment);
+    }
+    static FILE* open(uint8_t segment, const char* mode) {
+        char path[256];
+        segmentPath(segment, path, sizeof(path));
+        return fopen(path, mode);
+    }
+};
+
+FileStorage logFiles;
+
+// =====================================
+//  CONFIG STORAGE
+// =====================================
+class SimConfigStorage : public ConfigStorage {
+public:
+    size_t load(uint8_t* buf, size_t cap) override {
+        if (!configFile) {
+            if (len_ <= cap) memcpy(buf, ram_, len_);
+            return len_;
+        }
+        FILE* f = fopen(configFile, "rb");
+        if (!f) return 0;
+        size_t n = fread(buf, 1, cap, f);
+        fclose(f);
+        return n;
+    }
+
+    bool save(const uint8_t* buf, size_t len) override {
+        if (!configFile) {
+            if (len > sizeof(ram_)) return false;
+            memcpy(ram_, buf, len);
+            len_ = len;
+            return true;
+        }
+        FILE* f = fopen(configFile, "wb");
+        if (!f) return false;
+        bool ok = fwrite(buf, 1, len, f) == len;
+        return fclose(f) == 0 && ok;
+    }
+
+private:
+    uint8_t ram_[ConfigStore::MAX_BLOB];
+    size_t  len_ = 0;
+};
+
+SimConfigStorage configBlob;
+
+// =====================================
+//  WIFI
+// =====================================
+bool apPresent() {
+    uint64_t min = simUs / 60000000ULL;
+    return min < apDownFromMin || min >= apDownToMin;
+}
+
+class SimRadio : public WifiRadio {
+public:
+    void begin(bool useHint) override {
+        joining_ = true;
+        joinAt_  = simUs + (useHint ? HINT_JOIN_MS : SCAN_JOIN_MS) * 1000ULL;
+    }
+
+    bool connected() override {
+        if (linked_ && !apPresent()) linked_ = false;
+        if (joining_ && simUs >= joinAt_ && apPresent()) { joining_ = false; linked_ = true; }
+        return linked_;
+    }
+
+    void disconnect() override { joining_ = linked_ = false; }
+    bool hasHint() override    { return hint_; }
+    void joined() override     { hint_ = true; }
+    void startAp() override    { apOpened++; hal::log("wifi: fallback access point open\n"); }
+    void stopAp() override     { hal::log("wifi: fallback access point closed\n"); }
+
+private:
+    bool     joining_ = false, linked_ = false, hint_ = false;
+    uint64_t joinAt_  = 0;
+};
+
+void onWifiLink(bool up);
+void sseClientsDown();
+
+SimRadio          radio;
+ConnectionManager wifiLink(radio, hal::millis, onWifiLink);
+bool              linkUp = false;
+
+// The dashboard reconnects whenever the link comes back.
+void onWifiLink(bool up) {
+    linkUp = up;
+    if (up) {
+        hal::log("wifi: joined after %u ms\n", (unsigned)wifiLink.stats().lastJoinMs);
+        markBoot(BOOT_NETWORK_UP);
+        control.connected(WS_CLIENT);
+    } else {
+        hal::log("wifi: link lost\n");
+        control.disconnected(WS_CLIENT);
+        sseClientsDown();
+    }
+    power.wake(WAKE_COMMAND);
+}
+
+uint8_t wifiTask = Scheduler::NO_TASK;
+
+void pollWifi() {
+    wifiLink.poll();
+    if (wifiLink.state() == ConnectionManager::CM_CONNECTED)
+        scheduler.rescheduleAt(wifiTask, scheduler.now() + WIFI_LINKED_POLL_MS * 1000ULL);
+}
+
+// =====================================
+//  BMP180 FAKE
+// =====================================
+// Holds the example calibration block from the Bosch datasheet. A
+// conversion command fills the result registers with the raw value that the
+// datasheet compensation maps back to the model's temperature and pressure,
+// found by bisection since both are monotonic in the raw count.
+const int16_t  BMP_AC1 = 408,   BMP_AC2 = -72,  BMP_AC3 = -14383;
+const uint16_t BMP_AC4 = 32741, BMP_AC5 = 32757, BMP_AC6 = 23153;
+const int16_t  BMP_B1  = 6190,  BMP_B2  = 4,    BMP_MB  = -32768, BMP_MC = -8711, BMP_MD = 2868;
+
+int32_t bmpB5(int32_t ut) {
+    int32_t x1 = ((ut - (int32_t)BMP_AC6) * (int32_t)BMP_AC5) >> 15;
+    int32_t x2 = (BMP_MC * 2048) / (x1 + BMP_MD);
+    return x1 + x2;
+}
+
+int32_t bmpPressure(int32_t up, int32_t b5, uint8_t oss) {
+    int32_t  b6 = b5 - 4000;
+    int32_t  x1 = (BMP_B2 * ((b6 * b6) >> 12)) >> 11;
+    int32_t  x2 = (BMP_AC2 * b6) >> 11;
+    int32_t  b3 = ((((int32_t)BMP_AC1 * 4 + x1 + x2) << oss) + 2) / 4;
+    x1 = (BMP_AC3 * b6) >> 13;
+    x2 = (BMP_B1 * ((b6 * b6) >> 12)) >> 16;
+    int32_t  x3 = ((x1 + x2) + 2) >> 2;
+    uint32_t b4 = ((uint32_t)BMP_AC4 * (uint32_t)(x3 + 32768)) >> 15;
+    uint32_t b7 = ((uint32_t)up - b3) * (uint32_t)(50000UL >> oss);
+    int32_t  p  = b7 < 0x80000000UL ? (int32_t)((b7 * 2) / b4) : (int32_t)((b7 / b4) * 2);
+    x1 = (p >> 8) * (p >> 8);
+    x1 = (x1 * 3038) >> 16;
+    x2 = (-7357 * p) >> 16;
+    return p + ((x1 + x2 + 3791) >> 4);
+}
+
+int32_t bmpLastB5 = 0;
+
+void bmpOnWrite(FakeI2cBus::Device& d, const uint8_t* tx, uint8_t len) {
+    if (len < 2 || tx[0] != 0xF4) return;
+    const PlantModel::State& s = plant.state();
+
+    if (tx[1] == 0x2E) {
+        int32_t want = (int32_t)lroundf(plant.measure(s.airTemp, 0.1f) * 10);
+        int32_t lo = 0, hi = 65535;
+        while (lo < hi) {
+            int32_t mid = (lo + hi) / 2;
+            if (((bmpB5(mid) + 8) >> 4) < want) lo = mid + 1; else hi = mid;
+        }
+        bmpLastB5  = bmpB5(lo);
+        d.regs[0xF6] = lo >> 8;
+        d.regs[0xF7] = lo & 0xFF;
+        return;
+    }
+
+    uint8_t oss  = tx[1] >> 6;
+    int32_t want = (int32_t)lroundf(plant.measure(s.pressureHpa, 0.05f) * 100);
+    int32_t lo = 0, hi = (1 << (16 + oss)) - 1;
+    while (lo < hi) {
+        int32_t mid = (lo + hi) / 2;
+        if (bmpPressure(mid, bmpLastB5, oss) < want) lo = mid + 1; else hi = mid;
+    }
+    uint32_t raw = (uint32_t)lo << (8 - oss);
+    d.regs[0xF6] = raw >> 16;
+    d.regs[0xF7] = raw >> 8;
+    d.regs[0xF8] = raw;
+}
+
+void bmpAttach() {
+    bmpDev = bus.attach(Bmp180Driver::ADDRESS);
+    const int16_t calib[11] = { BMP_AC1, BMP_AC2, BMP_AC3, (int16_t)BMP_AC4, (int16_t)BMP_AC5,
+                                (int16_t)BMP_AC6, BMP_B1, BMP_B2, BMP_MB, BMP_MC, BMP_MD };
+    for (int i = 0; i < 11; i++) {
+        bmpDev->regs[0xAA + 2 * i]     = (uint16_t)calib[i] >> 8;
+        bmpDev->regs[0xAA + 2 * i + 1] = (uint16_t)calib[i] & 0xFF;
+    }
+    bmpDev->onWrite = bmpOnWrite;
+}
+
+// =====================================
+//  BH1750 FAKE
+// =====================================
+// Reads carry no register byte, so any command resets the pointer to the
+// measurement, which the plant step keeps current.
+void luxOnWrite(FakeI2cBus::Device& d, const uint8_t*, uint8_t) { d.ptr = 0; }
+
+void luxRefresh() {
+    float    counts = plant.measure(plant.state().lux, 2.0f) * 1.2f;
+    uint16_t raw    = counts <= 0 ? 0 : counts >= 65535 ? 65535 : (uint16_t)counts;
+    luxDev->regs[0] = raw >> 8;
+    luxDev->regs[1] = raw & 0xFF;
+}
+
+// =====================================
+//  PLANT
+// =====================================
+// Integrates the model up to the virtual clock, with the relay outputs as
+// its inputs.
+bool relayOn(Actuator a) { return pins[RELAY_OUTPUTS[a].pin] == RELAY_OUTPUTS[a].level(true); }
+
+void plantCatchUp() {
+    while (nextPlantUs <= simUs) {
+        PlantModel::Inputs in;
+        in.pump  = relayOn(ACT_MOTOR);
+        in.light = relayOn(ACT_LIGHT);
+        in.fan   = relayOn(ACT_FAN);
+        plant.step(PLANT_STEP_US / 1e6f, startHour * 3600.0 + nextPlantUs / 1e6, in);
+        onSeconds[0] += in.pump;
+        onSeconds[1] += in.light;
+        onSeconds[2] += in.fan;
+        nextPlantUs += PLANT_STEP_US;
+    }
+    luxRefresh();
+}
+
+// =====================================
+//  HAL
+// =====================================
+uint32_t hal::millis()      { return (uint32_t)(simUs / 1000); }
+uint32_t hal::micros()      { return (uint32_t)simUs; }
+uint64_t hal::monotonicUs() { return simUs; }
+
+// Cycles are host nanoseconds of real time, so the metrics histograms show
+// what the core costs on this machine rather than on the virtual clock.
+uint32_t hal::cycles() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+uint32_t hal::cyclesPerUs() { return 1000; }
+
+bool hal::timeOfDay(uint32_t& sec) {
+    if (replaying) {
+        if (!replayWall) return false;
+        sec = (uint32_t)(((replayUnixMs + (int64_t)(simUs / 1000)) / 1000 + replayOffset) % 86400);
+        return true;
+    }
+    sec = (uint32_t)simSeconds() % 86400;
+    return true;
+}
+
+bool hal::unixTime(uint32_t& sec) {
+    if (replaying) {
+        if (!replayWall) return false;
+        sec = (uint32_t)((replayUnixMs + (int64_t)(simUs / 1000)) / 1000);
+        return true;
+    }
+    sec = SIM_EPOCH + (uint32_t)simSeconds();
+    return true;
+}
+
+void hal::pinOutput(uint8_t pin, bool level) { pins[pin] = level; }
+void hal::pinInputPullup(uint8_t pin)        { pins[pin] = true; }
+void hal::pinWrite(uint8_t pin, bool level)  { pins[pin] = level; }
+bool hal::pinRead(uint8_t pin)               { return pins[pin]; }
+
+I2cBus& hal::i2cBus() { return bus; }
+
+LogStorage& hal::logStorage() { return logFiles; }
+
+ConfigStorage& hal::configStorage() { return configBlob; }
+
+// The probe voltage that the default calibration maps to the model's pH.
+float hal::phMillivolts() {
+    const PhCalibration cal = PhCalibration::defaults();
+    float ph    = plant.measure(plant.state().ph, 0.01f);
+    float slope = (cal.mv[1] - cal.mv[0]) / (cal.ph[1] - cal.ph[0]);
+    return cal.mv[0] + (ph - cal.ph[0]) * slope;
+}
+
+bool hal::readHumidity(DeciPercent& rh) {
+    rh = DeciPercent::fromFloat(plant.measure(plant.state().humidity, 0.5f));
+    return true;
+}
+
+bool hal::readWaterTemp(CentiCelsius& t) {
+    t = CentiCelsius::fromFloat(plant.measure(plant.state().waterTemp, 0.05f));
+    return true;
+}
+
+TraceMemory traceMem;
+
+TraceMemory& hal::traceMemory() { return traceMem; }
+ResetCause   hal::resetCause()  { return RESET_POWER_ON; }
+
+// --stall-at: a task that hangs on to the loop, in virtual time.
+void stallLoop() { advanceClock(STALL_DEMO_MS * 1000); }
+
+uint32_t hal::heapFree()    { return 0; }
+uint32_t hal::heapMinFree() { return 0; }
+
+void hal::displayBegin() { bus.attach(LCD_ADDR); }
+
+// =====================================
+//  SIMULATED /events CLIENTS
+// =====================================
+struct SimSseClient {
+    uint32_t socket;          // 0 while disconnected
+    uint32_t lastId;          // Last-Event-ID for the next connect
+    uint32_t version;         // dashboard state, 0 for none
+    uint32_t readBps;
+    uint64_t retryAtUs;
+    uint64_t readUs;          // reader position in virtual time
+    uint32_t buffered;
+    char     sock[SSE_SOCK_BUF];
+    uint16_t frameLen;
+    char     frame[SseBroadcaster::FRAME_MAX];
+    bool     stalls;
+};
+
+SimSseClient sseSim[SSE_SIM_MAX];
+uint32_t     sseNextSocket = 100;
+uint32_t     sseEvents = 0, sseSnapshots = 0, sseAlerts = 0, sseBrokenChains = 0;
+uint32_t     sseConnects = 0, sseRefused = 0, sseClosed = 0, sseMaxLag = 0;
+
+SimSseClient* sseFind(uint32_t socket) {
+    for (uint8_t i = 0; i < sseClientCount; i++)
+        if (sseSim[i].socket == socket) return &sseSim[i];
+    return nullptr;
+}
+
+void sseDisconnect(SimSseClient& c, bool notify) {
+    if (!c.socket) return;
+    if (notify) {
+        sse.disconnected(c.socket);
+        power.wake(WAKE_NETWORK);
+    }
+    c.socket    = 0;
+    c.buffered  = 0;
+    c.frameLen  = 0;
+    c.version   = 0;
+    c.retryAtUs = simUs + SSE_RETRY_US;
+}
+
+uint32_t jsonField(const char* json, const char* key) {
+    const char* p = strstr(json, key);
+    return p ? strtoul(p + strlen(key), nullptr, 10) : 0;
+}
+
+// One complete event, as the dashboard's listeners would see it.
+void sseDispatch(SimSseClient& c) {
+    c.frame[c.frameLen] = '\0';
+    const char* id    = strstr(c.frame, "id: ");
+    const char* event = strstr(c.frame, "event: ");
+    const char* data  = strstr(c.frame, "data: ");
+    if (!event || !data) return;
+    if (id) c.lastId = strtoul(id + 4, nullptr, 10);
+    sseEvents++;
+    if (!strncmp(event + 7, "snapshot", 8)) {
+        sseSnapshots++;
+        c.version = jsonField(data, "\"v\":");
+    } else if (!strncmp(event + 7, "delta", 5)) {
+        if (!c.version || jsonField(data, "\"b\":") != c.version) {
+            // app.js resyncs by reconnecting without an id.
+            sseBrokenChains++;
+            sseDisconnect(c, true);
+            c.lastId    = 0;
+            c.retryAtUs = simUs;
+            return;
+        }
+        c.version = jsonField(data, "\"v\":");
+    } else if (!strncmp(event + 7, "alert", 5)) {
+        sseAlerts++;
+    }
+}
+
+// The browser reads what its socket holds, at its own pace.
+void sseRead(SimSseClient& c) {
+    uint64_t dueBytes = (simUs - c.readUs) * c.readBps / 1000000;
+    if (!dueBytes) return;
+    c.readUs = simUs;
+    if (c.stalls && (simUs / 1000000 + (&c - sseSim) * 60) % 3600 < SSE_STALL_US / 1000000) return;
+
+    uint32_t n = dueBytes < c.buffered ? (uint32_t)dueBytes : c.buffered;
+    for (uint32_t i = 0; i < n && c.socket; i++) {
+        char ch = c.sock[i];
+        if (c.frameLen < sizeof(c.frame) - 1) c.frame[c.frameLen++] = ch;
+        if (ch == '\n' && c.frameLen >= 2 && c.frame[c.frameLen - 2] == '\n') {
+            sseDispatch(c);
+            c.frameLen = 0;
+        }
+    }
+    if (!c.socket) return;
+    memmove(c.sock, c.sock + n, c.buffered - n);
+    c.buffered -= n;
+}
+
+void sseClientsStep() {
+    for (uint8_t i = 0; i < sseClientCount; i++) {
+        SimSseClient& c = sseSim[i];
+        if (c.socket) { sseRead(c); continue; }
+        if (!linkUp || simUs < c.retryAtUs) continue;
+        c.socket  = sseNextSocket++;
+        c.readUs  = simUs;
+        sseConnects++;
+        if (!sse.connected(c.socket, c.lastId)) {
+            sseRefused++;
+            sseDisconnect(c, false);
+        }
+        power.wake(WAKE_NETWORK);
+    }
+    uint32_t lag = sse.maxLagMs();
+    if (lag > sseMaxLag) sseMaxLag = lag;
+}
+
+void sseClientsDown() {
+    for (uint8_t i = 0; i < sseClientCount; i++) sseDisconnect(sseSim[i], true);
+}
+
+void sseClientsInit() {
+    for (uint8_t i = 0; i < sseClientCount; i++) {
+        sseSim[i].readBps = i % 10 == 9 ? SSE_SLOW_BPS : SSE_FAST_BPS;
+        sseSim[i].stalls  = i % 25 == 24;
+    }
+}
+
+size_t hal::sseWrite(uint32_t client, const char* data, size_t len) {
+    SimSseClient* c = sseFind(client);
+    if (!c) return 0;
+    size_t n = SSE_SOCK_BUF - c->buffered;
+    if (n > len) n = len;
+    memcpy(c->sock + c->buffered, data, n);
+    c->buffered += n;
+    return n;
+}
+
+// The server hung up; the platform reports that back as a disconnect.
+void hal::sseClose(uint32_t client) {
+    SimSseClient* c = sseFind(client);
+    if (!c) return;
+    sseClosed++;
+    sseDisconnect(*c, true);
+}
+
+// The simulated dashboard's side of the control channel.
+void hal::wsSend(uint32_t client, const uint8_t* frame, size_t len) {
+    if (!linkUp || (client && client != WS_CLIENT) || len != ControlChannel::FRAME_SIZE) return;
+    uint8_t type = frame[0] & ~ControlChannel::FROM_SERVER;
+    if (type == ControlChannel::FRAME_PING) {
+        uint8_t pong[ControlChannel::FRAME_SIZE];
+        ControlChannel::encode(pong, ControlChannel::FRAME_PONG, frame[1] | frame[2] << 8, 0, 0, 0);
+        control.received(WS_CLIENT, pong, sizeof(pong));
+        power.wake(WAKE_COMMAND);
+        wsPongs++;
+    } else if (type == ControlChannel::FRAME_ACK && (frame[1] | frame[2] << 8) == wsCmdId) {
+        uint64_t us = simUs - wsSentUs;
+        wsAcks++;
+        wsAckSumUs += us;
+        if (us > wsAckMaxUs) wsAckMaxUs = us;
+    } else if (type == ControlChannel::FRAME_STATE) {
+        wsStates++;
+    }
+}
+
+void hal::wsClose(uint32_t) {}
+
+void wsCommand() {
+    if (!linkUp) return;
+    uint8_t f[ControlChannel::FRAME_SIZE];
+    ControlChannel::encode(f, ControlChannel::FRAME_CMD, ++wsCmdId, ACT_FAN, OP_AUTO, actuators.autoMode(ACT_FAN));
+    wsSentUs = simUs;
+    control.received(WS_CLIENT, f, sizeof(f));
+    power.wake(WAKE_COMMAND);
+}
+
+// =====================================
+//  INPUT TRACE RECORD / REPLAY
+// =====================================
+// Every closed block of this run's own trace.
+void traceBlock(const uint8_t* block, size_t len) {
+    if (recordFile) fwrite(block, 1, len, recordFile);
+    if (replaying)  replay.addReplayedBlock(block);
+}
+
+// Replaces the drivers' readings with the recorded cycle.
+void replaySample(SensorSnapshot& s) {
+    int32_t v[SensorHistory::CHANNEL_COUNT];
+    if (!replay.sampleAt(hal::millis(), v)) return;
+#define FROM_SAMPLE(id, key, field, type, ...) s.field = type::fromRaw(v[SensorHistory::id]);
+    HYDRO_SENSORS(FROM_SAMPLE)
+#undef FROM_SAMPLE
+}
+
+void replayDue() {
+    InputRecord r;
+    while (replay.nextEvent(hal::millis(), r)) {
+        if (r.kind == IN_ENCODER) {
+            InputEvent e = { r.a, (int8_t)r.b };
+            encoderInput.inject(e);
+            power.wake(WAKE_INPUT);
+        } else if (r.kind == IN_COMMAND && r.a < ACT_COUNT) {
+            actuators.submit((Actuator)r.a, (CommandOp)r.b, r.c, SRC_WEB);
+        } else if (r.kind == IN_CLOCK) {
+            replaySetWall((uint32_t)r.v[0], (int16_t)r.v[1], r.ms);
+        }
+    }
+}
+
+void hal::log(const char* fmt, ...) {
+    if (quiet) return;
+    uint32_t t = (uint32_t)simSeconds();
+    printf("[%02u:%02u:%02u] ", (unsigned)(t / 3600 % 24), (unsigned)(t / 60 % 60), (unsigned)(t % 60));
+    va_list args;
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+}
+
+// =====================================
+//  REPORTS
+// =====================================
+void report() {
+    const SensorSnapshot s = sensorFeed.read();
+    hal::log("air %5.1f C  rh %4.1f %%  water %5.2f C  lux %6ld  pH %4.2f  %6.1f hPa  pump %s light %s fan %s\n",
+             s.bmpTemp.toFloat(), s.dhtHumidity.toFloat(), s.ds18b20Temp.toFloat(), (long)s.lux.raw,
+             s.phValue.toFloat(), s.pressure.toFloat(),
+             actuators.state(ACT_MOTOR) ? "ON " : "off", actuators.state(ACT_LIGHT) ? "ON " : "off",
+             actuators.state(ACT_FAN) ? "ON " : "off");
+}
+
+void summary(double wallSec) {
+    double simSec = simUs / 1e6;
+    printf("\nsimulated %.0f s in %.3f s wall (%.0fx real time)\n", simSec, wallSec,
+           wallSec > 0 ? simSec / wallSec : 0.0);
+    const SseBroadcaster::Stats& ss = sse.stats();
+    printf("loop passes %llu, i2c transfers %u (%u bytes, %u recoveries), sse frames %u (%u bytes)\n",
+           (unsigned long long)loopPasses, (unsigned)bus.transfers, (unsigned)bus.bytes,
+           (unsigned)bus.recoveries, (unsigned)ss.frames, (unsigned)ss.bytes);
+    printf("i2c: longest transfer %u us, longest sensorStep() %llu us\n", (unsigned)i2c.stats().maxTransferUs,
+           (unsigned long long)sensorStepMaxUs);
+    printf("relay on-time: pump %.2f h, light %.2f h, fan %.2f h\n",
+           onSeconds[0] / 3600.0, onSeconds[1] / 3600.0, onSeconds[2] / 3600.0);
+    printf("heap allocations %u, %u after warm-up\n", (unsigned)allocs, (unsigned)steadyAllocs);
+    printf("history samples: raw %u, 1 min %u, 1 h %u\n", (unsigned)history.endSeq(SensorHistory::RAW),
+           (unsigned)history.endSeq(SensorHistory::MINUTE), (unsigned)history.endSeq(SensorHistory::HOUR));
+    const ControlChannel::Stats& cs = control.stats();
+    printf("control ws: %u commands, %u acks (%u timed out), ack latency avg %.1f ms max %.1f ms, "
+           "%u pings answered, %u state frames\n", (unsigned)cs.commands, (unsigned)wsAcks,
+           (unsigned)cs.timeouts, wsAcks ? wsAckSumUs / 1e3 / wsAcks : 0.0, wsAckMaxUs / 1e3,
+           (unsigned)wsPongs, (unsigned)wsStates);
+    const SensorLog::Stats& ls = sensorLog.stats();
+    const ConnectionManager::Stats& ws = wifiLink.stats();
+    printf("wifi: %s, %u join attempts (%u cached, %u scanned, %u cached misses), %u drops, "
+           "last join %.1f s, fallback AP opened %u times\n", ConnectionManager::stateName(wifiLink.state()),
+           (unsigned)ws.attempts, (unsigned)ws.hintJoins, (unsigned)ws.scanJoins, (unsigned)ws.hintMisses,
+           (unsigned)ws.drops, ws.lastJoinMs / 1e3, (unsigned)apOpened);
+    printf("boot:");
+    for (uint8_t p = 0; p < BOOT_PHASE_COUNT; p++) {
+        if (bootTimeline.reached((BootPhase)p))
+            printf("%s %s %.3f ms", p ? "," : "", BootTimeline::name((BootPhase)p),
+                   bootTimeline.atUs((BootPhase)p) / 1e3);
+        else
+            printf("%s %s never", p ? "," : "", BootTimeline::name((BootPhase)p));
+    }
+    putchar('\n');
+    const ConfigStore::Stats& cfs = configStore.stats();
+    printf("config: %s, %u changes, %u saves (%u failed)\n",
+           cfs.loadedVersion ? "restored" : "defaults", (unsigned)cfs.updates, (unsigned)cfs.saves,
+           (unsigned)cfs.saveErrors);
+    const SensorAnalytics::State as = analytics.state();
+    printf("sse: %u clients (peak %u), %u connects (%u refused, %u closed by the server), %u events read "
+           "(%u snapshots, %u broken delta chains), %u frames coalesced, %u dropped, max lag %.1f s\n",
+           (unsigned)sseClientCount, (unsigned)ss.peakClients, (unsigned)sseConnects, (unsigned)sseRefused,
+           (unsigned)sseClosed, (unsigned)sseEvents, (unsigned)sseSnapshots, (unsigned)sseBrokenChains,
+           (unsigned)ss.coalesced, (unsigned)ss.dropped, sseMaxLag / 1e3);
+    printf("alerts: %u raised, %u events (%u read by dashboards), active:", (unsigned)as.raised,
+           (unsigned)as.events, (unsigned)sseAlerts);
+    bool anyActive = false;
+    for (uint8_t ch = 0; ch < SensorAnalytics::CHANNELS; ch++)
+        for (uint8_t k = 0; k < ALERT_KIND_COUNT; k++)
+            if (as.active[ch] & (1u << k)) {
+                printf(" %s %s", SensorHistory::channelName((SensorHistory::Channel)ch), SensorAnalytics::kindName((AlertKind)k));
+                anyActive = true;
+            }
+    printf("%s\n", anyActive ? "" : " none");
+    const StallTrace st = flight.stall();
+    printf("trace: %u stalls", (unsigned)flight.stalls());
+    if (st.task != FlightRecorder::NO_TASK) printf(", last in %s after %u ms", traceTaskName(st.task) ? traceTaskName(st.task) : "?", (unsigned)st.ms);
+    putchar('\n');
+    printf("sensor log: %u samples, %u block writes (%u failed), %u torn at start\n", (unsigned)ls.samples,
+           (unsigned)ls.blocksWritten, (unsigned)ls.writeErrors, (unsigned)ls.tornBlocks);
+    const PowerManager::Stats ps = power.stats();
+    uint64_t psTotal = ps.activeUs + ps.idleUs + ps.sleepUs;
+    double   psScale = psTotal ? 100.0 / psTotal : 0.0;
+    printf("power: active %.2f %%, idle %.2f %%, sleep %.2f %% (%u of %u waits could sleep), display %s, "
+           "%u times dark; wakes:", ps.activeUs * psScale, ps.idleUs * psScale, ps.sleepUs * psScale,
+           (unsigned)ps.sleeps, (unsigned)ps.waits, ps.displayOn ? "on" : "off", (unsigned)ps.displayOffs);
+    for (uint8_t w = 0; w < WAKE_SOURCE_COUNT; w++)
+        printf(" %u %s", (unsigned)ps.wakes[w], PowerManager::wakeName((WakeSource)w));
+    putchar('\n');
+    const InputTrace::Stats& its = inputTrace.stats();
+    printf("input trace: %u records in %u blocks, %u dropped\n", (unsigned)its.records, (unsigned)its.blocks,
+           (unsigned)its.dropped);
+    if (replaying) {
+        const TraceReplay::Counts&    rc = replay.counts();
+        const TraceReplay::Comparison cmp = replay.compare();
+        printf("replay: %s, %u records over %.2f h (%u samples, %u encoder events, %u commands, %u clock sets), "
+               "%u blocks missing\n", replayFrom, (unsigned)rc.records, replay.endMs() / 3.6e6,
+               (unsigned)rc.samples, (unsigned)rc.encoder, (unsigned)rc.commands, (unsigned)rc.clocks,
+               (unsigned)rc.gaps);
+        printf("relay changes: %u on the board, %u in the replay, %u matched within %u ms", (unsigned)cmp.recorded,
+               (unsigned)cmp.replayed, (unsigned)cmp.matched, (unsigned)TraceReplay::MATCH_MS);
+        if (cmp.differs)
+            printf("; first unmatched: %s %s at %.3f s, %s only", ActuatorController::name((Actuator)cmp.first.actuator),
+                   cmp.first.on ? "on" : "off", cmp.first.ms / 1e3, cmp.firstRecorded ? "board" : "replay");
+        putchar('\n');
+    }
+
+    printf("\n%-10s %8s %10s %10s\n", "task", "runs", "max late", "max run");
+    for (uint8_t id = 0; id < scheduler.taskCount(); id++) {
+        if (!scheduler.isActive(id)) continue;
+        const Scheduler::TaskStats& st = scheduler.stats(id);
+        printf("%-10s %8u %8u us %8u us\n", scheduler.taskName(id), (unsigned)st.runs,
+               (unsigned)st.maxLateUs, (unsigned)st.maxRunUs);
+    }
+}
+
+// =====================================
+//  MAIN
+// =====================================
+void parseArgs(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        const char* a    = argv[i];
+        const char* next = i + 1 < argc ? argv[i + 1] : nullptr;
+        if      (!strcmp(a, "--hours")      && next) { simHours  = atof(next); i++; }
+        else if (!strcmp(a, "--start-hour") && next) { startHour = atof(next); i++; }
+        else if (!strcmp(a, "--seed")       && next) { seed      = strtoul(next, nullptr, 0); i++; }
+        else if (!strcmp(a, "--report-min") && next) { reportMin = strtoul(next, nullptr, 0); i++; }
+        else if (!strcmp(a, "--quiet"))              { quiet     = true; }
+        else if (!strcmp(a, "--metrics"))            { dumpMetrics = true; }
+        else if (!strcmp(a, "--no-alloc"))           { noAlloc     = true; }
+        else if (!strcmp(a, "--log-dir")    && next) { logDir    = next; i++; }
+        else if (!strcmp(a, "--export")     && next) { exportTo  = next; i++; }
+        else if (!strcmp(a, "--encoder-trace") && next) { encoderTrace = next; i++; }
+        else if (!strcmp(a, "--bench-fixed") && next) { benchSamples = strtoul(next, nullptr, 0); i++; }
+        else if (!strcmp(a, "--bench-lcd")  && next) { lcdRefreshes = strtoul(next, nullptr, 0); i++; }
+        else if (!strcmp(a, "--check")      && next) { checks = next; i++; }
+        else if (!strcmp(a, "--compare-telemetry") && next) { compareTrace = next; i++; }
+        else if (!strcmp(a, "--config")     && next) { configFile = next; i++; }
+        else if (!strcmp(a, "--stall-at")   && next) { stallAtMin = strtoul(next, nullptr, 0); i++; }
+        else if (!strcmp(a, "--trace"))              { dumpTrace  = true; }
+        else if (!strcmp(a, "--record")     && next) { recordTo   = next; i++; }
+        else if (!strcmp(a, "--export-trace") && next) { exportTrace = next; i++; }
+        else if (!strcmp(a, "--replay")     && next) { replayFrom = next; i++; }
+        else if (!strcmp(a, "--baseline")   && next) { baselineIn = next; i++; }
+        else if (!strcmp(a, "--write-baseline") && next) { baselineOut = next; i++; }
+        else if (!strcmp(a, "--tolerance")  && next) { tolerancePct = atof(next); i++; }
+        else if (!strcmp(a, "--sse-clients") && next && atoi(next) >= 0 && atoi(next) <= SSE_SIM_MAX) {
+            sseClientCount = atoi(next);
+            i++;
+        }
+        else if (!strcmp(a, "--ap-outage") && next &&
+                 sscanf(next, "%u-%u", &apDownFromMin, &apDownToMin) == 2) { i++; }
+        else {
+            fprintf(stderr, "usage: %s [--hours H] [--start-hour H] [--seed N] [--report-min M] [--quiet] [--metrics] [--no-alloc]\n"
+                            "       [--log-dir DIR] [--export FILE] [--encoder-trace FILE|synthetic] [--ap-outage A-B]\n"
+                            "       [--config FILE] [--bench-fixed N] [--bench-lcd N] [--sse-clients N] [--stall-at M]\n"
+                            "       [--trace] [--record FILE] [--export-trace FILE] [--replay FILE] [--baseline FILE]\n"
+                            "       [--write-baseline FILE] [--tolerance PCT] [--check NAME[,NAME]|all]\n"
+                            "       [--compare-telemetry FILE]\n",
+                    argv[0]);
+            exit(2);
+        }
+    }
+    if ((baselineIn || baselineOut) && !replayFrom) {
+        fprintf(stderr, "%s: baselines are taken from a --replay run\n", argv[0]);
+        exit(2);
+    }
+}
+
+int runEncoderTrace(const char* source) {
+    EncoderTrace trace;
+    if (!strcmp(source, "synthetic")) trace.synthesize(seed);
+    else if (!trace.load(source)) { perror(source); return 2; }
+
+    EncoderTrace::Result r = trace.replay(ISR_LATENCY_US, appTask("encoder")->periodMs);
+    printf("encoder trace: %u edges -> %u cw, %u ccw, %u clicks, %u long presses "
+           "(%u double transitions inferred, %u events dropped)\n", (unsigned)trace.edges(),
+           (unsigned)r.got.cw, (unsigned)r.got.ccw, (unsigned)r.got.clicks, (unsigned)r.got.longs,
+           (unsigned)r.skipped, (unsigned)r.dropped);
+    if (!trace.hasExpected()) return 0;
+
+    const EncoderTrace::Counts& e = trace.expected();
+    if (r.got.cw == e.cw && r.got.ccw == e.ccw && r.got.clicks == e.clicks && r.got.longs == e.longs) return 0;
+    fprintf(stderr, "FAIL: expected %u cw, %u ccw, %u clicks, %u long presses\n",
+            (unsigned)e.cw, (unsigned)e.ccw, (unsigned)e.clicks, (unsigned)e.longs);
+    return 1;
+}
+
+int runFixedBench(uint32_t samples) {
+    FixedBench::Result r = FixedBench::run(samples, seed);
+    printf("sensor path, %u samples: float %.1f ns, fixed %.1f ns per sample (%.2fx); "
+           "float telemetry a count low in %u samples (checksum %08x)\n", (unsigned)r.samples, r.floatNs,
+           r.fixedNs, r.fixedNs > 0 ? r.floatNs / r.fixedNs : 0.0, (unsigned)r.truncated,
+           (unsigned)r.checksum);
+    return 0;
+}
+
+int runLcdBench(uint32_t refreshes) {
+    LcdBench::Result r = LcdBench::run(refreshes, seed);
+    printf("LCD bytes per frame, %u refreshes per screen (x%u PCF8574 writes on the wire)\n",
+           (unsigned)r.refreshes, (unsigned)CountingLcdSink::I2C_WRITES_PER_BYTE);
+    printf("%-20s %9s %7s %8s\n", "screen", "before", "enter", "refresh");
+    for (uint8_t i = 0; i < r.count; i++) {
+        const LcdBench::Screen& s = r.screens[i];
+        char name[32];
+        if (s.positions > 1) snprintf(name, sizeof(name), "%s (%u)", s.name, (unsigned)s.positions);
+        else                 snprintf(name, sizeof(name), "%s", s.name);
+        printf("%-20s %9.1f %7.1f %8.1f\n", name, s.beforeBytes, s.enterBytes, s.refreshBytes);
+    }
+    printf("all screens: before %.1f bytes per refresh, framebuffer %.1f (%.1fx fewer), %.1f entering a screen\n",
+           r.beforeBytes, r.refreshBytes, r.refreshBytes > 0 ? r.beforeBytes / r.refreshBytes : 0.0, r.enterBytes);
+    return 0;
+}
+
+int runTelemetryCompare(const char* path) {
+    TelemetryCompare::Result r;
+    if (!TelemetryCompare::run(path, r)) {
+        fprintf(stderr, "%s: not an input trace for this build\n", path);
+        return 2;
+    }
+    printf("telemetry for %u sensor cycles (%.1f h), SSE bytes with framing:\n", (unsigned)r.cycles,
+           r.hours10 / 10.0);
+    const struct { const char* name; const TelemetryCompare::Way& w; } ways[] = {
+        { "full snapshots", r.full }, { "deltas", r.delta }, { "deltas + deadbands", r.deadband },
+    };
+    for (const auto& w : ways)
+        printf("  %-20s %10llu bytes, %7u frames (%u snapshots), %6.1f bytes per cycle, %5.1f %% of full\n",
+               w.name, (unsigned long long)w.w.bytes, (unsigned)w.w.frames, (unsigned)w.w.snapshots,
+               r.cycles ? (double)w.w.bytes / r.cycles : 0.0,
+               r.full.bytes ? 100.0 * w.w.bytes / r.full.bytes : 0.0);
+    return 0;
+}
+
+// ---------- HOST CHECKS ----------
+bool checkScheduler() {
+    SchedulerCheck::Result r = SchedulerCheck::run();
+    printf("scheduler: %u runs of %u tasks over %u s in deadline order, max lateness %u us (bound %u us); "
+           "a %.1f s overrun skipped %u periods without catch-up runs; %u parks, %u wakes, %u runs at a moved "
+           "deadline\n", (unsigned)r.runs, (unsigned)r.tasks, (unsigned)SchedulerCheck::RUN_S, (unsigned)r.maxLateUs,
+           (unsigned)r.lateBoundUs, SchedulerCheck::OVERRUN_US / 1e6, (unsigned)r.skippedPeriods, (unsigned)r.parks,
+           (unsigned)r.triggers, (unsigned)r.movedRuns);
+    return r.failures == 0;
+}
+
+bool checkSeqlock() {
+    SeqlockStress::Result r = SeqlockStress::run();
+    printf("seqlock: %u writes, version %u; %u readers took %llu copies (%llu tryRead retries), "
+           "%u torn, %u out of order\n", (unsigned)r.writes, (unsigned)r.version,
+           (unsigned)SeqlockStress::READERS, (unsigned long long)r.reads, (unsigned long long)r.retries,
+           (unsigned)r.torn, (unsigned)r.backwards);
+    return r.torn == 0 && r.backwards == 0 && r.version == r.writes && r.reads > 0;
+}
+
+bool checkPhFilter() {
+    PhFilterCheck::Result r = PhFilterCheck::run();
+    printf("ph: %u spikes rejected (worst error %.2f counts); noise %.1f -> %.2f counts sd, bias %.2f; "
+           "1 %% settling %u ms up, %u ms down, overshoot %.2f; pH 6.00 read back %.3f off; "
+           "%u calibration cases\n", (unsigned)r.spikes, r.spikeErr, r.noiseInSd, r.noiseOutSd, r.noiseBias,
+           (unsigned)r.settleUpMs, (unsigned)r.settleDownMs, r.overshoot, r.phErr, (unsigned)r.calCases);
+    return r.failures == 0;
+}
+
+bool checkI2c() {
+    I2cCheck::Result r = I2cCheck::run();
+    printf("i2c: %u transactions (%u failed, %u timed out), %u recovery; %u driver cycles, %u LCD redraws; "
+           "longest transfer %u us, longest owner step %u us (bound %u us)\n", (unsigned)r.transactions,
+           (unsigned)r.failed, (unsigned)r.timedOut, (unsigned)r.recoveries, (unsigned)r.cycles,
+           (unsigned)r.redraws, (unsigned)r.maxTransferUs, (unsigned)r.maxStepUs, (unsigned)I2cCheck::STEP_BOUND_US);
+    return r.failures == 0;
+}
+
+bool checkSchedule() {
+    ScheduleCheck::Result r = ScheduleCheck::run();
+    printf("schedule: %u wheel timers on %u levels (%u cancelled) fired on time; %u days, %u relay changes in "
+           "%u wheel stops match the table; %u edit cases\n", (unsigned)r.timers, (unsigned)r.levels,
+           (unsigned)r.cancelled, (unsigned)ScheduleCheck::DAYS, (unsigned)r.relayEdges, (unsigned)r.wheelStops,
+           (unsigned)r.editCases);
+    return r.failures == 0;
+}
+
+struct HostCheck {
+    const char* name;
+    bool (*run)();
+};
+const HostCheck HOST_CHECKS[] = {
+    { "scheduler", checkScheduler },
+    { "seqlock",   checkSeqlock },
+    { "ph",        checkPhFilter },
+    { "i2c",       checkI2c },
+    { "schedule",  checkSchedule },
+};
+
+bool listed(const char* list, const char* name) {
+    size_t n = strlen(name);
+    for (const char* p = list; *p; p += strcspn(p, ",") + (p[strcspn(p, ",")] ? 1 : 0))
+        if (!strncmp(p, name, n) && (p[n] == ',' || p[n] == '\0')) return true;
+    return false;
+}
+
+int runChecks(const char* list) {
+    bool all = listed(list, "all"), ok = true, any = false;
+    for (const HostCheck& c : HOST_CHECKS) {
+        if (!all && !listed(list, c.name)) continue;
+        any = true;
+        if (c.run()) continue;
+        printf("FAIL: %s\n", c.name);
+        ok = false;
+    }
+    if (!any) { fprintf(stderr, "--check: nothing called %s\n", list); return 2; }
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    parseArgs(argc, argv);
+    if (encoderTrace) return runEncoderTrace(encoderTrace);
+    if (benchSamples) return runFixedBench(benchSamples);
+    if (lcdRefreshes) return runLcdBench(lcdRefreshes);
+    if (checks)       return runChecks(checks);
+    if (compareTrace) return runTelemetryCompare(compareTrace);
+    static char outBuf[BUFSIZ];
+    setvbuf(stdout, outBuf, _IOLBF, sizeof(outBuf));   // stdio would otherwise malloc its buffer mid-run
+    plant = PlantModel(seed);
+
+    bmpAttach();
+    luxDev = bus.attach(Bh1750Driver::ADDRESS);
+    luxDev->onWrite = luxOnWrite;
+    bus.setByteTime(I2C_BYTE_US, advanceClock);
+
+    mkdir(logDir, 0755);
+    for (uint8_t seg = 0; seg < SensorLog::MAX_SEGMENTS; seg++) logFiles.erase(seg);
+
+    if (replayFrom) {
+        if (!replay.load(replayFrom)) {
+            fprintf(stderr, "%s: not an input trace for this build\n", replayFrom);
+            return 2;
+        }
+        replaying = true;
+        const InputBlockInfo& first = replay.first();
+        if (first.unixSec) replaySetWall(first.unixSec, first.offsetMin, replay.toReplayMs(first.startMs));
+        setSampleSource(replaySample);
+    }
+    if (recordTo) {
+        recordFile = fopen(recordTo, "wb");
+        if (!recordFile) { perror(recordTo); return 1; }
+        uint8_t header[InputTrace::FILE_HEADER];
+        InputTrace::fileHeader(header);
+        fwrite(header, 1, sizeof(header), recordFile);
+    }
+    if (recordFile || replaying) inputTrace.setBlockSink(traceBlock);
+
+    hal::displayBegin();
+    phCalibration.write(PhCalibration::defaults());
+    appSetup();
+    if (replaying) {
+        for (uint8_t a = 0; a < ACT_COUNT; a++)
+            actuators.restore((Actuator)a, replay.first().relays >> a & 1, replay.first().autos >> a & 1);
+        inputTrace.drain();
+        replay.skipReplayed(inputTrace.stats().records);
+    }
+    sseClientsInit();
+    wifiLink.setApFallback(AP_FALLBACK_MS);
+    wifiLink.start();
+    wifiTask = scheduler.addPeriodic("wifi", pollWifi, WIFI_POLL_MS * 1000ULL);
+    flight.setBudget(wifiTask, FlightRecorder::DEFAULT_BUDGET_US, true);
+    power.setSleepEnabled(true);   // residency as the board with light sleep would see it
+    if (stallAtMin) scheduler.addOneShot("stall", stallLoop, stallAtMin * 60000000ULL);
+    appObserver = scheduler.observer();
+    scheduler.setObserver(chargeTask);
+    plantCatchUp();
+
+    const uint64_t endUs    = replaying ? (replay.endMs() + 5000ULL) * 1000ULL : (uint64_t)(simHours * 3600e6);
+    const uint64_t reportUs = reportMin * 60000000ULL;
+    uint64_t       nextReport = reportUs;
+    uint64_t       nextWsCmd  = replaying ? UINT64_MAX : WS_CMD_EVERY_US;   // not an input the trace has
+
+    auto wallStart = std::chrono::steady_clock::now();
+    while (simUs < endUs) {
+        uint64_t passUs = simUs;
+        sseClientsStep();
+        uint64_t idleUs = appLoop();
+        uint64_t stepUs = simUs;
+        uint32_t wakeAt = sensorStep();
+        if (simUs - stepUs > sensorStepMaxUs) sensorStepMaxUs = simUs - stepUs;
+        loopPasses++;
+        power.ran(simUs - passUs);
+
+        // Jump to whichever comes first: a scheduler deadline, the sensor
+        // owner's deadline, a plant step or a report. Only the first two
+        // would wake the board, so they decide whether the wait could sleep.
+        uint64_t next = simUs + power.waitFor(idleUs);
+        int32_t  waitUs = wakeAt ? (int32_t)(wakeAt - hal::micros()) : 0;
+        if (waitUs <= 0)                        next = simUs;
+        else if (simUs + waitUs < next)         next = simUs + waitUs;
+        uint64_t planned = next - simUs;
+        if (nextPlantUs < next)                 next = nextPlantUs;
+        if (reportUs && nextReport < next)      next = nextReport;
+        if (nextWsCmd < next)                   next = nextWsCmd;
+        if (replaying && replay.nextEventMs() * 1000ULL < next) next = replay.nextEventMs() * 1000ULL;
+        if (next > simUs) {
+            power.waited(planned, next - simUs);
+            simUs = next;
+        }
+
+        plantCatchUp();
+        if (reportUs && simUs >= nextReport) { report(); nextReport += reportUs; }
+        if (simUs >= nextWsCmd) { wsCommand(); nextWsCmd += WS_CMD_EVERY_US; }
+        if (replaying) replayDue();
+    }
+    double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    sensorLog.flush();
+    configStore.commit(true);
+    inputTrace.finish();
+    if (recordFile && fclose(recordFile) != 0) { perror(recordTo); return 1; }
+
+    summary(wallSec);
+#if HYDRO_METRICS
+    if (dumpMetrics) {
+        // The same text /metrics serves on the board.
+        MetricsReader reader(metrics, hal::cyclesPerUs());
+        char          chunk[256];
+        size_t        n;
+        putchar('\n');
+        while ((n = reader.read(chunk, sizeof(chunk))) > 0) fwrite(chunk, 1, n, stdout);
+    }
+#endif
+    if (dumpTrace) {
+        // A software reset: the recorder's memory carries over.
+        static char body[TRACE_JSON_MAX];
+        flight.begin(RESET_SOFTWARE, hal::cyclesPerUs());
+        FlightRecorder::traceJson(flight.previous(), flight.stall(), traceTaskName, body, sizeof(body));
+        printf("\n%s\n", body);
+    }
+    if (exportTo) {
+        FILE* out = fopen(exportTo, "w");
+        if (!out) { perror(exportTo); return 1; }
+        LogExporter exporter(sensorLog, 0, UINT32_MAX);
+        char        chunk[512];
+        size_t      n;
+        while ((n = exporter.read(chunk, sizeof(chunk))) > 0) fwrite(chunk, 1, n, out);
+        fclose(out);
+    }
+    if (exportTrace) {
+        FILE* out = fopen(exportTrace, "wb");
+        if (!out) { perror(exportTrace); return 1; }
+        InputTraceReader reader(inputTrace);
+        uint8_t          chunk[512];
+        size_t           n;
+        while ((n = reader.read(chunk, sizeof(chunk))) > 0) fwrite(chunk, 1, n, out);
+        fclose(out);
+    }
+    bool baselineOk = true;
+    if (baselineIn || baselineOut) {
+        TraceReplay::Baseline b;
+        b.sseClients   = sseClientCount;
+        b.records      = replay.counts().records;
+        b.loopPasses   = loopPasses;
+        b.sseFrames    = sse.stats().frames;
+        b.sseBytes     = sse.stats().bytes;
+        b.relayChanges = replay.replayedChanges();
+        b.relayDigest  = replay.digest();
+        b.nsPerLoop    = loopPasses ? wallSec * 1e9 / loopPasses : 0;
+        if (baselineOut && !TraceReplay::writeBaseline(baselineOut, b)) { perror(baselineOut); return 1; }
+        if (baselineIn) baselineOk = TraceReplay::checkBaseline(baselineIn, b, tolerancePct);
+    }
+    if (!baselineOk) {
+        fprintf(stderr, "FAIL: replay differs from %s\n", baselineIn);
+        return 1;
+    }
+    if (noAlloc && steadyAllocs) {
+        fprintf(stderr, "FAIL: %u heap allocations in steady state\n", (unsigned)steadyAllocs);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,211 @@
+"""Build the dashboard in web/ into gzipped PROGMEM blobs.
+
+Runs as a PlatformIO pre-build script (see extra_scripts in platformio.ini)
+and can also be run by hand:  python tools/build_web.py
+
+Each file is minified, gzipped deterministically (mtime 0) and given a
+strong ETag derived from the compressed bytes. index.html refers to the CSS
+and JS with ?v=<etag> so they can be cached forever. The output header is
+only rewritten when its content changes, which avoids needless rebuilds.
+
+The sensor and relay cards in index.html, and the SENSORS/DEVICES lists in
+app.js, are generated from the rows of include/Registry.h, so a sensor or
+relay added there shows up on the dashboard without touching web/.
+"""
+
+import gzip
+import hashlib
+import html
+import json
+import os
+import re
+
+ASSETS = [
+    # path        source        content type                       cache policy
+    ("/app.css", "app.css", "text/css",                          "public, max-age=31536000, immutable"),
+    ("/app.js",  "app.js",  "application/javascript",            "public, max-age=31536000, immutable"),
+    ("/",        "index.html", "text/html; charset=utf-8",       "no-cache"),
+]
+
+
+def minify_css(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    text = re.sub(r"\s+", " ", text)
+    text = re.sub(r"\s*([{};,])\s*", r"\1", text)
+    text = re.sub(r":\s+", ":", text)
+    return text.replace(";}", "}").strip()
+
+
+def minify_js(text):
+    # Conservative: keeps line breaks so automatic semicolon insertion is
+    # unaffected, and only drops whole-line comments.
+    lines = []
+    for line in text.splitlines():
+        line = line.strip()
+        if line and not line.startswith("//"):
+            lines.append(line)
+    return "\n".join(lines)
+
+
+def minify_html(text):
+    text = re.sub(r"<!--.*?-->", "", text, flags=re.S)
+    lines = [line.strip() for line in text.splitlines()]
+    return "\n".join(line for line in lines if line)
+
+
+MINIFIERS = {".css": minify_css, ".js": minify_js, ".html": minify_html}
+
+
+# ---------- registry ----------
+def registry_rows(text, name):
+    """The X(...) rows of a HYDRO_* list, each as a list of C tokens."""
+    m = re.search(r"#define %s\(X\)(.*?)(?:\n\s*\n|\Z)" % name, text, flags=re.S)
+    if not m:
+        raise SystemExit("build_web: %s not found in Registry.h" % name)
+    rows = []
+    for args in re.findall(r"\bX\((.*?)\)\s*\\?\n", m.group(1) + "\n"):
+        rows.append([t if not t.startswith('"') else t[1:-1]
+                     for t in re.findall(r'"[^"]*"|[^,\s]+', args)])
+    return rows
+
+
+def load_registry(project_dir):
+    inc = os.path.join(project_dir, "include")
+    with open(os.path.join(inc, "FixedPoint.h"), encoding="utf-8") as f:
+        scales = {name: int(scale) for scale, name in
+                  re.findall(r"typedef\s+Fixed<\w+,\s*(\d+)>\s+(\w+);", f.read())}
+    with open(os.path.join(inc, "Registry.h"), encoding="utf-8") as f:
+        text = f.read()
+    sensors = []
+    for sid, key, field, ctype, shift, deadband, label, unit, part in registry_rows(text, "HYDRO_SENSORS"):
+        scale = scales[ctype]
+        sensors.append({"key": key, "scale": scale, "decimals": len(str(scale)) - 1,
+                        "label": label, "unit": unit.strip(), "part": part})
+    actuators = [{"key": key, "label": label}
+                 for aid, key, pin, active_low, label in registry_rows(text, "HYDRO_ACTUATORS")]
+    return sensors, actuators
+
+
+def sensor_cards(sensors):
+    out = []
+    for s in sensors:
+        e = {k: html.escape(str(v)) for k, v in s.items()}
+        out.append('<div class="card">\n'
+                   '  <div class="card-label">%(label)s</div>\n'
+                   '  <div class="card-value" id="%(key)s">--</div>\n'
+                   '  <div class="card-unit">%(unit)s &middot; %(part)s</div>\n'
+                   '  <div class="card-icon">%(icon)s</div>\n'
+                   '</div>' % dict(e, icon=e["label"][:1].upper()))
+    return "\n".join(out)
+
+
+def relay_cards(actuators):
+    out = []
+    for a in actuators:
+        e = {k: html.escape(v) for k, v in a.items()}
+        out.append('<div class="relay-card" id="%(key)sCard">\n'
+                   '  <div class="relay-header">\n'
+                   '    <div class="relay-name">%(label)s</div>\n'
+                   '    <div class="relay-badge off" id="%(key)sBadge">OFF</div>\n'
+                   '  </div>\n'
+                   '  <div class="relay-controls">\n'
+                   '    <button class="btn btn-on"  onclick="relayCmd(\'%(key)s\',\'1\')">Turn On</button>\n'
+                   '    <button class="btn btn-off" onclick="relayCmd(\'%(key)s\',\'0\')">Turn Off</button>\n'
+                   '  </div>\n'
+                   '  <button class="btn btn-auto" id="%(key)sAutoBtn" onclick="toggleAuto(\'%(key)s\')">Auto Mode</button>\n'
+                   '  <div class="auto-label" id="%(key)sAutoLabel">Manual mode active</div>\n'
+                   '</div>' % e)
+    return "\n".join(out)
+
+
+def expand(source, text, sensors, actuators):
+    """Replaces the @-markers in index.html and app.js."""
+    if source == "index.html":
+        text = re.sub(r"<!-- @sensor-cards.*?-->", lambda m: sensor_cards(sensors), text)
+        text = re.sub(r"<!-- @relay-cards.*?-->", lambda m: relay_cards(actuators), text)
+    elif source == "app.js":
+        keys = [{"key": s["key"], "scale": s["scale"], "decimals": s["decimals"]} for s in sensors]
+        text = re.sub(r"const SENSORS = \[\];.*", "const SENSORS = %s;" % json.dumps(keys), text)
+        text = re.sub(r"const DEVICES = \[\];.*",
+                      "const DEVICES = %s;" % json.dumps([a["key"] for a in actuators]), text)
+    return text
+
+
+def symbol(source):
+    return "WEB_" + re.sub(r"[^A-Za-z0-9]", "_", source).upper() + "_GZ"
+
+
+def build(project_dir):
+    web_dir = os.path.join(project_dir, "web")
+    out_path = os.path.join(project_dir, "include", "WebAssets.h")
+
+    sensors, actuators = load_registry(project_dir)
+    etags = {}
+    blobs = []
+    # index.html goes last so it can reference the other assets' ETags.
+    for path, source, ctype, cache in ASSETS:
+        with open(os.path.join(web_dir, source), encoding="utf-8") as f:
+            text = expand(source, f.read(), sensors, actuators)
+        if source == "index.html":
+            for other, etag in etags.items():
+                text = text.replace('"%s"' % other, '"%s?v=%s"' % (other, etag))
+        text = MINIFIERS[os.path.splitext(source)[1]](text)
+        raw = text.encode("utf-8")
+        gz = gzip.compress(raw, compresslevel=9, mtime=0)
+        etag = hashlib.sha1(gz).hexdigest()[:16]
+        etags[path] = etag
+        blobs.append((path, source, ctype, cache, raw, gz, etag))
+
+    out = [
+        "// Generated by tools/build_web.py from web/ - do not edit.",
+        "#pragma once",
+        "",
+        "#include <stdint.h>",
+        "#include <stddef.h>",
+        "",
+        "#ifndef PROGMEM",
+        "#define PROGMEM",
+        "#endif",
+        "",
+        "struct WebAsset {",
+        "    const char*    path;",
+        "    const char*    contentType;",
+        "    const char*    cacheControl;",
+        "    const char*    etag;         // quoted, strong",
+        "    const uint8_t* gzip;",
+        "    size_t         gzipLen;",
+        "};",
+        "",
+    ]
+    for path, source, ctype, cache, raw, gz, etag in blobs:
+        out.append("// %s: %d bytes minified, %d bytes gzipped" % (source, len(raw), len(gz)))
+        out.append("static const uint8_t %s[] PROGMEM = {" % symbol(source))
+        for i in range(0, len(gz), 16):
+            out.append("    " + ", ".join("0x%02x" % b for b in gz[i:i + 16]) + ",")
+        out.append("};")
+        out.append("")
+    out.append("static const WebAsset WEB_ASSETS[] = {")
+    for path, source, ctype, cache, raw, gz, etag in blobs:
+        out.append('    { "%s", "%s", "%s", "\\"%s\\"", %s, sizeof(%s) },'
+                   % (path, ctype, cache, etag, symbol(source), symbol(source)))
+    out.append("};")
+    out.append("static const size_t WEB_ASSET_COUNT = sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]);")
+    content = "\n".join(out) + "\n"
+
+    old = None
+    if os.path.exists(out_path):
+        with open(out_path, encoding="utf-8") as f:
+            old = f.read()
+    if old != content:
+        with open(out_path, "w", encoding="utf-8", newline="\n") as f:
+            f.write(content)
+    for path, source, ctype, cache, raw, gz, etag in blobs:
+        print("web: %-10s %6d -> %5d bytes" % (source, len(raw), len(gz)))
+
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+    build(env.subst("$PROJECT_DIR"))  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        build(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
@@ -0,0 +1,158 @@
+"""Load generator for the /events telemetry stream.
+
+Opens N EventSource-style subscribers against a board and reports what each
+kind of reader got, then the board's own view from /events/clients:
+
+    python tools/sse_load.py 192.168.1.50 --clients 50 --slow 5 --stalled 2 --seconds 120
+
+Standard library only. Fast readers take everything as it arrives. Slow
+readers have a small receive buffer and read --slow-bps bytes a second, so
+the board has to coalesce their backlog into snapshots. Stalled readers stop
+reading after a few seconds and should be closed by the board within its
+stall timeout (SseBroadcast.h). Every reader follows the delta chain the way
+web/app.js does and counts breaks.
+"""
+
+import argparse
+import json
+import socket
+import threading
+import time
+import urllib.request
+
+
+# ---------- subscriber ----------
+class Subscriber(threading.Thread):
+    def __init__(self, args, kind):
+        super().__init__(daemon=True)
+        self.args = args
+        self.kind = kind
+        self.events = 0
+        self.snapshots = 0
+        self.deltas = 0
+        self.alerts = 0
+        self.broken = 0
+        self.version = None
+        self.outcome = "open"
+
+    def connect(self):
+        a = self.args
+        sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        if self.kind != "fast":
+            sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 2048)
+        sock.settimeout(10)
+        sock.connect((a.host, a.port))
+        sock.sendall(f"GET /events HTTP/1.1\r\nHost: {a.host}\r\nAccept: text/event-stream\r\n\r\n".encode())
+        head = b""
+        while b"\r\n\r\n" not in head:
+            chunk = sock.recv(512)
+            if not chunk:
+                raise ConnectionError("closed during handshake")
+            head += chunk
+        status = head.split(b"\r\n", 1)[0]
+        if b" 200 " not in status:
+            raise ConnectionRefusedError(status.decode(errors="replace"))
+        return sock, head.split(b"\r\n\r\n", 1)[1]
+
+    def run(self):
+        a = self.args
+        try:
+            sock, buf = self.connect()
+        except ConnectionRefusedError:
+            self.outcome = "refused"
+            return
+        except OSError:
+            self.outcome = "failed"
+            return
+
+        deadline = time.monotonic() + a.seconds
+        stall_at = time.monotonic() + 5 if self.kind == "stalled" else None
+        sock.settimeout(1)
+        try:
+            while time.monotonic() < deadline:
+                if stall_at and time.monotonic() >= stall_at:
+                    time.sleep(0.5)
+                    continue
+                size = max(1, a.slow_bps // 4) if self.kind == "slow" else 4096
+                try:
+                    chunk = sock.recv(size)
+                except socket.timeout:
+                    continue
+                if not chunk:
+                    self.outcome = "closed by board"
+                    return
+                buf += chunk
+                while b"\n\n" in buf:
+                    raw, buf = buf.split(b"\n\n", 1)
+                    self.dispatch(raw.decode(errors="replace"))
+                if self.kind == "slow":
+                    time.sleep(0.25)
+        except OSError:
+            self.outcome = "closed by board"
+        finally:
+            sock.close()
+
+    def dispatch(self, raw):
+        fields = dict(line.split(": ", 1) for line in raw.split("\n") if ": " in line)
+        event, data = fields.get("event"), fields.get("data")
+        if data is None:
+            return
+        self.events += 1
+        if event == "alert":
+            self.alerts += 1
+            return
+        d = json.loads(data)
+        if event == "snapshot":
+            self.snapshots += 1
+            self.version = d.get("v")
+        elif event == "delta":
+            self.deltas += 1
+            if self.version is None or d.get("b") != self.version:
+                self.broken += 1
+            self.version = d.get("v")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Fan-out behaviour of the /events stream")
+    parser.add_argument("host")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--clients", type=int, default=10)
+    parser.add_argument("--slow", type=int, default=1, help="how many of the clients read slowly")
+    parser.add_argument("--stalled", type=int, default=1, help="how many stop reading")
+    parser.add_argument("--slow-bps", type=int, default=40)
+    parser.add_argument("--seconds", type=float, default=60.0)
+    args = parser.parse_args()
+
+    kinds = ["stalled"] * args.stalled + ["slow"] * args.slow
+    kinds += ["fast"] * max(0, args.clients - len(kinds))
+    subs = [Subscriber(args, k) for k in kinds]
+    for s in subs:
+        s.start()
+        time.sleep(0.05)   # the board's async_tcp task accepts one at a time
+    for s in subs:
+        s.join(args.seconds + 15)
+
+    for kind in ("fast", "slow", "stalled"):
+        group = [s for s in subs if s.kind == kind]
+        if not group:
+            continue
+        outcomes = {}
+        for s in group:
+            outcomes[s.outcome] = outcomes.get(s.outcome, 0) + 1
+        print(f"{kind:8} x{len(group):<3} events {sum(s.events for s in group):6}  "
+              f"snapshots {sum(s.snapshots for s in group):5}  deltas {sum(s.deltas for s in group):6}  "
+              f"alerts {sum(s.alerts for s in group):3}  broken chains {sum(s.broken for s in group):3}  "
+              + ", ".join(f"{k} {n}" for k, n in sorted(outcomes.items())))
+
+    try:
+        with urllib.request.urlopen(f"http://{args.host}:{args.port}/events/clients", timeout=5) as r:
+            t = json.load(r)
+        print(f"board: peak {t['peak']}/{t['max']} clients, {t['coalesced']} frames coalesced, "
+              f"{t['dropped']} dropped, {t['evicted']} evicted, {t['rejected']} rejected, "
+              f"max lag {t['maxLagMs']} ms now")
+    except OSError as e:
+        print(f"/events/clients: {e}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,201 @@
+"""Load generator for the /ws control channel.
+
+Opens N WebSocket clients against a board, sends relay commands at a fixed
+rate from each and reports the command -> ack round trip:
+
+    python tools/ws_load.py 192.168.1.50 --clients 4 --rate 20 --seconds 30
+
+Standard library only. The default command re-sends each device's current
+auto mode, which goes through the whole queue/apply/ack path without
+switching anything. --op set toggles the relay instead. Relays hold a state
+for at least 1 s, so fast toggling shows the dwell and ack timeouts rather
+than the channel. --op ping measures the transport alone.
+
+Frames are the 6-byte binary format in include/ControlChannel.h.
+"""
+
+import argparse
+import base64
+import os
+import socket
+import struct
+import threading
+import time
+
+FRAME_CMD, FRAME_PING, FRAME_PONG, FRAME_ACK, FRAME_STATE = 1, 2, 3, 4, 5
+FROM_SERVER = 0x80
+OP_SET, OP_AUTO = 0, 2
+DEVICES = {"motor": 0, "light": 1, "fan": 2}
+STATUS = ["ok", "busy", "bad frame", "timeout"]
+
+
+# ---------- WebSocket framing (RFC 6455, client side) ----------
+def handshake(sock, host, path):
+    key = base64.b64encode(os.urandom(16)).decode()
+    sock.sendall((f"GET {path} HTTP/1.1\r\nHost: {host}\r\nUpgrade: websocket\r\n"
+                  f"Connection: Upgrade\r\nSec-WebSocket-Key: {key}\r\n"
+                  "Sec-WebSocket-Version: 13\r\n\r\n").encode())
+    response = b""
+    while b"\r\n\r\n" not in response:
+        chunk = sock.recv(1024)
+        if not chunk:
+            raise ConnectionError("closed during handshake")
+        response += chunk
+    if b" 101 " not in response.split(b"\r\n", 1)[0]:
+        raise ConnectionError(response.split(b"\r\n", 1)[0].decode(errors="replace"))
+
+
+def send_frame(sock, payload, opcode=0x2):
+    mask = os.urandom(4)
+    masked = bytes(b ^ mask[i % 4] for i, b in enumerate(payload))
+    sock.sendall(bytes([0x80 | opcode, 0x80 | len(payload)]) + mask + masked)
+
+
+def recv_exact(sock, n):
+    data = b""
+    while len(data) < n:
+        chunk = sock.recv(n - len(data))
+        if not chunk:
+            raise ConnectionError("closed")
+        data += chunk
+    return data
+
+
+def recv_frame(sock):
+    b0, b1 = recv_exact(sock, 2)
+    length = b1 & 0x7F
+    if length == 126:
+        length = struct.unpack(">H", recv_exact(sock, 2))[0]
+    elif length == 127:
+        length = struct.unpack(">Q", recv_exact(sock, 8))[0]
+    return b0 & 0x0F, recv_exact(sock, length)
+
+
+def frame(ftype, fid, a=0, b=0, c=0):
+    return struct.pack("<BHBBB", ftype, fid, a, b, c)
+
+
+# ---------- client ----------
+class Client(threading.Thread):
+    def __init__(self, args, results):
+        super().__init__(daemon=True)
+        self.args = args
+        self.results = results
+        self.sent = {}
+        self.relays = 0
+        self.autos = 0
+        self.ready = threading.Event()
+        self.lock = threading.Lock()
+
+    def run(self):
+        a = self.args
+        self.sock = socket.create_connection((a.host, a.port), timeout=10)
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        handshake(self.sock, a.host, "/ws")
+        self.sock.settimeout(None)
+        threading.Thread(target=self.sender, daemon=True).start()
+        try:
+            while True:
+                opcode, payload = recv_frame(self.sock)
+                if opcode == 0x8:
+                    return
+                if opcode == 0x9:
+                    send_frame(self.sock, payload, 0xA)
+                    continue
+                if opcode != 0x2 or len(payload) != 6:
+                    continue
+                self.handle(*struct.unpack("<BHBBB", payload))
+        except (ConnectionError, OSError):
+            pass
+
+    def handle(self, ftype, fid, a0, a1, a2):
+        now = time.perf_counter()
+        ftype &= ~FROM_SERVER
+        if ftype == FRAME_PING:
+            send_frame(self.sock, frame(FRAME_PONG, fid))
+            return
+        if ftype in (FRAME_ACK, FRAME_STATE):
+            self.relays, self.autos = a1, a2
+            self.ready.set()
+        if ftype in (FRAME_ACK, FRAME_PONG):
+            with self.lock:
+                sent = self.sent.pop(fid, None)
+            if sent is not None:
+                status = a0 if ftype == FRAME_ACK else 0
+                self.results.append((now - sent, status))
+
+    def sender(self):
+        a = self.args
+        device = DEVICES[a.device]
+        self.ready.wait(5)
+        interval = 1.0 / a.rate
+        deadline = time.perf_counter() + a.seconds
+        next_at = time.perf_counter()
+        fid = 0
+        while time.perf_counter() < deadline:
+            fid = (fid + 1) & 0xFFFF
+            if a.op == "ping":
+                data = frame(FRAME_PING, fid)
+            elif a.op == "set":
+                data = frame(FRAME_CMD, fid, device, OP_SET, 0 if self.relays >> device & 1 else 1)
+            else:
+                data = frame(FRAME_CMD, fid, device, OP_AUTO, self.autos >> device & 1)
+            with self.lock:
+                self.sent[fid] = time.perf_counter()
+            send_frame(self.sock, data)
+            next_at += interval
+            time.sleep(max(0.0, next_at - time.perf_counter()))
+        time.sleep(a.drain)
+        with self.lock:
+            self.results.lost += len(self.sent)
+        try:
+            send_frame(self.sock, b"", 0x8)
+        except OSError:
+            pass
+
+
+class Results(list):
+    lost = 0
+
+
+def percentile(sorted_values, p):
+    if not sorted_values:
+        return 0.0
+    k = min(len(sorted_values) - 1, int(round(p / 100.0 * (len(sorted_values) - 1))))
+    return sorted_values[k]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Round-trip latency of the /ws control channel")
+    parser.add_argument("host")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--clients", type=int, default=1)
+    parser.add_argument("--rate", type=float, default=10.0, help="commands per second per client")
+    parser.add_argument("--seconds", type=float, default=10.0)
+    parser.add_argument("--device", choices=sorted(DEVICES), default="fan")
+    parser.add_argument("--op", choices=["auto", "set", "ping"], default="auto")
+    parser.add_argument("--drain", type=float, default=4.0, help="seconds to wait for late acks")
+    args = parser.parse_args()
+
+    results = Results()
+    clients = [Client(args, results) for _ in range(args.clients)]
+    for c in clients:
+        c.start()
+    for c in clients:
+        c.join(args.seconds + args.drain + 15)
+
+    rtts = sorted(r[0] * 1000.0 for r in results)
+    counts = [0] * len(STATUS)
+    for _, status in results:
+        if status < len(counts):
+            counts[status] += 1
+
+    print(f"{len(results)} replies, {results.lost} unanswered, "
+          + ", ".join(f"{STATUS[i]} {n}" for i, n in enumerate(counts) if n))
+    if rtts:
+        print(f"round trip ms: min {rtts[0]:.1f}  p50 {percentile(rtts, 50):.1f}  "
+              f"p90 {percentile(rtts, 90):.1f}  p99 {percentile(rtts, 99):.1f}  max {rtts[-1]:.1f}")
+
+
+if __name__ == "__main__":
+    main()
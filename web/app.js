@@ -0,0 +1,158 @@
+// Filled in from include/Registry.h by tools/build_web.py.
+const SENSORS = [];   // @sensors: { key, scale, decimals }
+const DEVICES = [];   // @devices: relay keys, in ControlChannel order
+
+const dot   = document.getElementById('connDot');
+const label = document.getElementById('connLabel');
+
+// Telemetry protocol 2: a snapshot on connect, then deltas against version "b".
+let evtSource = null;
+let state     = null;
+
+function connect() {
+  evtSource = new EventSource('/events');
+  evtSource.onopen = () => {
+    dot.classList.remove('off');
+    label.textContent = 'Connected';
+  };
+  evtSource.onerror = () => {
+    dot.classList.add('off');
+    label.textContent = 'Disconnected';
+  };
+  evtSource.addEventListener('snapshot', e => {
+    const d = JSON.parse(e.data);
+    if (d.p !== 2) return;
+    // Mid-stream, a snapshot stands in for events the board skipped while
+    // this client lagged; alert events among them are not replayed.
+    if (state && d.v !== state.v + 1) loadAlerts();
+    state = d;
+    render(state);
+  });
+  evtSource.addEventListener('delta', e => {
+    const d = JSON.parse(e.data);
+    if (!state || d.b !== state.v) { resync(); return; }
+    Object.assign(state, d);
+    render(state);
+  });
+  evtSource.addEventListener('alert', e => {
+    const a = JSON.parse(e.data);
+    const key = a.sensor + ' ' + a.kind;
+    if (a.state === 'raised') alerts.add(key); else alerts.delete(key);
+    renderAlerts();
+  });
+  loadAlerts();
+}
+
+// Active alerts as "sensor kind"; a sensor's card turns red while it has any.
+// Alert events carry no id, so every (re)connect starts from GET /alerts.
+const alerts = new Set();
+
+function loadAlerts() {
+  fetch('/alerts').then(r => r.json()).then(d => {
+    alerts.clear();
+    d.active.forEach(a => alerts.add(a.sensor + ' ' + a.kind));
+    renderAlerts();
+  }).catch(() => {});
+}
+
+function renderAlerts() {
+  document.querySelectorAll('.card-value').forEach(el => {
+    const kinds = [...alerts].filter(k => k.startsWith(el.id + ' ')).map(k => k.split(' ')[1]);
+    el.parentElement.classList.toggle('alert', kinds.length > 0);
+    el.parentElement.title = kinds.length ? 'Alert: ' + kinds.join(', ') : '';
+  });
+}
+
+// A fresh EventSource carries no Last-Event-ID, so the server sends a snapshot.
+function resync() {
+  state = null;
+  evtSource.close();
+  connect();
+}
+
+connect();
+
+function render(d) {
+  SENSORS.forEach(s => set(s.key, (d[s.key] / s.scale).toFixed(s.decimals)));
+  DEVICES.forEach(name => setRelay(name, d[name], d[name + 'Auto']));
+
+  document.getElementById('lastUpdated').textContent =
+    'Last updated: ' + new Date().toLocaleTimeString();
+}
+
+function set(id, val) {
+  const el = document.getElementById(id);
+  if (el) el.textContent = val;
+}
+
+function setRelay(name, state, auto) {
+  const badge     = document.getElementById(name + 'Badge');
+  const card      = document.getElementById(name + 'Card');
+  const autoBtn   = document.getElementById(name + 'AutoBtn');
+  const autoLabel = document.getElementById(name + 'AutoLabel');
+
+  if (badge) { badge.textContent = state ? 'ON' : 'OFF'; badge.className = 'relay-badge ' + (state ? 'on' : 'off'); }
+  if (card)  { card.classList.toggle('active', !!state); }
+  if (auto !== null && autoBtn) {
+    autoBtn.classList.toggle('active-auto', !!auto);
+    if (autoLabel) autoLabel.textContent = auto ? 'Schedule active' : 'Manual mode active';
+  }
+}
+
+// Control channel: 6-byte binary frames on /ws (see ControlChannel.h).
+// Commands are acked with the resulting relays as soon as they apply; the
+// POST /relay route stays as the fallback while the socket is down.
+const FRAME       = { CMD: 1, PING: 2, PONG: 3, ACK: 4, STATE: 5 };
+const FROM_SERVER = 0x80;
+const OP_SET = 0, OP_AUTO = 2;
+let ws    = null;
+let cmdId = 0;
+
+function frame(type, id, a, b, c) {
+  return new Uint8Array([type, id & 0xff, id >> 8, a, b, c]);
+}
+
+function wsConnect() {
+  ws = new WebSocket((location.protocol === 'https:' ? 'wss://' : 'ws://') + location.host + '/ws');
+  ws.binaryType = 'arraybuffer';
+  ws.onmessage = e => {
+    const f = new Uint8Array(e.data);
+    if (f.length !== 6) return;
+    const type = f[0] & ~FROM_SERVER;
+    if (type === FRAME.PING) ws.send(frame(FRAME.PONG, f[1] | f[2] << 8, 0, 0, 0));
+    else if (type === FRAME.ACK || type === FRAME.STATE) applyRelays(f[4], f[5]);
+  };
+  ws.onclose = () => { ws = null; setTimeout(wsConnect, 2000); };
+}
+
+wsConnect();
+
+function applyRelays(relays, autos) {
+  DEVICES.forEach((name, i) => {
+    const on = relays >> i & 1, auto = autos >> i & 1;
+    if (state) { state[name] = on; state[name + 'Auto'] = auto; }
+    setRelay(name, on, auto);
+  });
+}
+
+function sendCmd(device, op, value, formDevice) {
+  if (ws && ws.readyState === WebSocket.OPEN) {
+    cmdId = (cmdId + 1) & 0xffff;
+    ws.send(frame(FRAME.CMD, cmdId, DEVICES.indexOf(device), op, value));
+    return;
+  }
+  const fd = new FormData();
+  fd.append('device', formDevice);
+  fd.append('state', value);
+  fetch('/relay', { method: 'POST', body: fd });
+}
+
+function relayCmd(device, state) {
+  sendCmd(device, OP_SET, Number(state), device);
+}
+
+function toggleAuto(device) {
+  const btn    = document.getElementById(device + 'AutoBtn');
+  const isAuto = btn && btn.classList.contains('active-auto');
+  sendCmd(device, OP_AUTO, isAuto ? 0 : 1, device + 'Auto');
+}